@@ -296,8 +296,32 @@ void gavl_video_frame_absdiff(gavl_video_frame_t * dst,
                 src2->planes[2], src2->strides[2],
                 format->image_width/sub_h, format->image_height/sub_v);
       break;
+    case GAVL_NV12:
+    case GAVL_NV21:
+      absdiff_8(dst->planes[0], dst->strides[0],
+                src1->planes[0], src1->strides[0],
+                src2->planes[0], src2->strides[0],
+                format->image_width, format->image_height);
+      /* Interleaved chroma */
+      absdiff_8(dst->planes[1], dst->strides[1],
+                src1->planes[1], src1->strides[1],
+                src2->planes[1], src2->strides[1],
+                (format->image_width/2)*2, format->image_height/2);
+      break;
+    case GAVL_P010:
+    case GAVL_P016:
+      absdiff_16(dst->planes[0], dst->strides[0],
+                 src1->planes[0], src1->strides[0],
+                 src2->planes[0], src2->strides[0],
+                 format->image_width, format->image_height);
+      absdiff_16(dst->planes[1], dst->strides[1],
+                 src1->planes[1], src1->strides[1],
+                 src2->planes[1], src2->strides[1],
+                 (format->image_width/2)*2, format->image_height/2);
+      break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_10:
       gavl_pixelformat_chroma_sub(format->pixelformat,
                                   &sub_h, &sub_v);
       absdiff_16(dst->planes[0], dst->strides[0],
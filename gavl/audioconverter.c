@@ -165,6 +165,114 @@ static void put_samplerate_context(gavl_audio_converter_t* cnv,
   add_context(cnv, ctx);
   }
 
+/*
+ *  Packed 24 bit formats are unpacked at the beginning. If
+ *  nothing else needs to be done, we unpack directly to the output format.
+ */
+
+static void put_unpack_context(gavl_audio_converter_t* cnv,
+                               gavl_audio_format_t * tmp_format,
+                               int convert_only)
+  {
+  gavl_audio_convert_context_t * ctx;
+  gavl_sample_format_t out_format = cnv->output_format.sample_format;
+
+  if((convert_only && gavl_sample_format_can_pack(out_format)) ||
+     (out_format == GAVL_SAMPLE_FLOAT) ||
+     (out_format == GAVL_SAMPLE_DOUBLE))
+    tmp_format->sample_format = out_format;
+  else
+    tmp_format->sample_format = GAVL_SAMPLE_S32;
+  
+  ctx = gavl_sampleformat_context_create(&cnv->opt,
+                                         cnv->current_format,
+                                         tmp_format);
+  add_context(cnv, ctx);
+  }
+
+/* Sample format conversion, interleaving and packing at the end */
+
+static void put_output_contexts(gavl_audio_converter_t* cnv,
+                                gavl_audio_format_t * tmp_format)
+  {
+  gavl_audio_convert_context_t * ctx;
+  gavl_sample_format_t out_format = cnv->output_format.sample_format;
+
+  /* Packed formats are created from the current format if possible */
+  
+  if(gavl_sample_format_is_packed(out_format) &&
+     (cnv->current_format->sample_format != out_format))
+    {
+    if(gavl_sample_format_can_pack(cnv->current_format->sample_format))
+      out_format = cnv->current_format->sample_format;
+    else
+      out_format = GAVL_SAMPLE_S32;
+    }
+  
+  /* Check, if we must change the sample format */
+  
+  ctx = NULL;
+  
+  if((cnv->current_format->sample_format != out_format) &&
+     (cnv->current_format->interleave_mode != cnv->output_format.interleave_mode))
+    {
+    /* Try to change the sample format and interleave in one pass */
+    tmp_format->sample_format = out_format;
+    tmp_format->interleave_mode = cnv->output_format.interleave_mode;
+    ctx = gavl_sampleformat_interleave_context_create(&cnv->opt,
+                                                      cnv->current_format,
+                                                      tmp_format);
+    if(ctx)
+      add_context(cnv, ctx);
+    else
+      {
+      tmp_format->sample_format = cnv->current_format->sample_format;
+      tmp_format->interleave_mode = cnv->current_format->interleave_mode;
+      }
+    }
+  
+  if(!ctx && (cnv->current_format->sample_format != out_format))
+    {
+    if(cnv->current_format->interleave_mode == GAVL_INTERLEAVE_2)
+      {
+      tmp_format->interleave_mode = GAVL_INTERLEAVE_NONE;
+      ctx = gavl_interleave_context_create(&cnv->opt,
+                                           cnv->current_format,
+                                           tmp_format);
+      add_context(cnv, ctx);
+      }
+
+    tmp_format->sample_format = out_format;
+    ctx = gavl_sampleformat_context_create(&cnv->opt,
+                                           cnv->current_format,
+                                           tmp_format);
+    add_context(cnv, ctx);
+    
+    }
+     
+  /* Final interleaving */
+
+  if(cnv->current_format->interleave_mode != cnv->output_format.interleave_mode)
+    {
+    tmp_format->interleave_mode = cnv->output_format.interleave_mode;
+    ctx = gavl_interleave_context_create(&cnv->opt,
+                                         cnv->current_format,
+                                         tmp_format);
+    add_context(cnv, ctx);
+    }
+
+  /* Packing */
+
+  if(cnv->current_format->sample_format != cnv->output_format.sample_format)
+    {
+    tmp_format->sample_format = cnv->output_format.sample_format;
+    ctx = gavl_sampleformat_context_create(&cnv->opt,
+                                           cnv->current_format,
+                                           tmp_format);
+    add_context(cnv, ctx);
+    }
+  }
+
 int gavl_audio_converter_reinit(gavl_audio_converter_t* cnv)
   {
   int do_mix, do_resample;
@@ -223,6 +331,14 @@ int gavl_audio_converter_reinit(gavl_audio_converter_t* cnv)
 
   do_resample = (input_format->samplerate != output_format->samplerate) ? 1 : 0;
 
+  /* Unpack 24 bit samples. They can't be interleaved */
+
+  if(gavl_sample_format_is_packed(input_format->sample_format) &&
+     (do_mix || do_resample ||
+      (input_format->sample_format != output_format->sample_format) ||
+      (input_format->interleave_mode != output_format->interleave_mode)))
+    put_unpack_context(cnv, &tmp_format, !do_mix && !do_resample);
+
   /* Check for resampling. We take care, that we do resampling for the least possible channels */
 
   if(do_resample &&
@@ -264,8 +380,9 @@ int gavl_audio_converter_reinit(gavl_audio_converter_t* cnv)
       add_context(cnv, ctx);
       }
 
-    else if(gavl_bytes_per_sample(cnv->current_format->sample_format) <
-            gavl_bytes_per_sample(cnv->output_format.sample_format))
+    else if(!gavl_sample_format_is_packed(cnv->output_format.sample_format) &&
+            (gavl_bytes_per_sample(cnv->current_format->sample_format) <
+             gavl_bytes_per_sample(cnv->output_format.sample_format)))
       {
       tmp_format.sample_format = cnv->output_format.sample_format;
       ctx = gavl_sampleformat_context_create(&cnv->opt,
@@ -288,37 +405,7 @@ int gavl_audio_converter_reinit(gavl_audio_converter_t* cnv)
     put_samplerate_context(cnv, &tmp_format, output_format->samplerate);
     }
   
-  /* Check, if we must change the sample format */
-  
-  if(cnv->current_format->sample_format != cnv->output_format.sample_format)
-    {
-    if(cnv->current_format->interleave_mode == GAVL_INTERLEAVE_2)
-      {
-      tmp_format.interleave_mode = GAVL_INTERLEAVE_NONE;
-      ctx = gavl_interleave_context_create(&cnv->opt,
-                                           cnv->current_format,
-                                           &tmp_format);
-      add_context(cnv, ctx);
-      }
-
-    tmp_format.sample_format = cnv->output_format.sample_format;
-    ctx = gavl_sampleformat_context_create(&cnv->opt,
-                                           cnv->current_format,
-                                           &tmp_format);
-    add_context(cnv, ctx);
-    
-    }
-     
-  /* Final interleaving */
-
-  if(cnv->current_format->interleave_mode != cnv->output_format.interleave_mode)
-    {
-    tmp_format.interleave_mode = cnv->output_format.interleave_mode;
-    ctx = gavl_interleave_context_create(&cnv->opt,
-                                         cnv->current_format,
-                                         &tmp_format);
-    add_context(cnv, ctx);
-    }
+  put_output_contexts(cnv, &tmp_format);
 
   //  fprintf(stderr, "Audio converter initialized, %d conversions\n", cnv->num_conversions);
   
@@ -454,7 +541,6 @@ int gavl_audio_converter_init_resample(gavl_audio_converter_t * cnv,
                                    const gavl_audio_format_t * format)
   {
   gavl_audio_format_t tmp_format;
-  gavl_audio_convert_context_t * ctx;
   
   gavl_audio_format_copy(&cnv->input_format, format);
   gavl_audio_format_copy(&cnv->output_format, format);
@@ -468,38 +554,14 @@ int gavl_audio_converter_init_resample(gavl_audio_converter_t * cnv,
 
   cnv->current_format = &cnv->input_format;
 
+  if(gavl_sample_format_is_packed(cnv->input_format.sample_format))
+    put_unpack_context(cnv, &tmp_format, 0);
+  
   put_samplerate_context(cnv, &tmp_format, cnv->output_format.samplerate);
 
   /* put_samplerate will automatically convert sample format and interleave format 
 	* we need to check to see if it did or not and add contexts to convert back */
-  if(cnv->current_format->sample_format != cnv->output_format.sample_format)
-    {
-    if(cnv->current_format->interleave_mode == GAVL_INTERLEAVE_2)
-      {
-      tmp_format.interleave_mode = GAVL_INTERLEAVE_NONE;
-      ctx = gavl_interleave_context_create(&cnv->opt,
-                                           cnv->current_format,
-                                           &tmp_format);
-      add_context(cnv, ctx);
-      }
-
-    tmp_format.sample_format = cnv->output_format.sample_format;
-    ctx = gavl_sampleformat_context_create(&cnv->opt,
-                                           cnv->current_format,
-                                           &tmp_format);
-    add_context(cnv, ctx);
-    }
-
-  /* Final interleaving */
-
-  if(cnv->current_format->interleave_mode != cnv->output_format.interleave_mode)
-    {
-    tmp_format.interleave_mode = cnv->output_format.interleave_mode;
-    ctx = gavl_interleave_context_create(&cnv->opt,
-                                         cnv->current_format,
-                                         &tmp_format);
-    add_context(cnv, ctx);
-    }
+  put_output_contexts(cnv, &tmp_format);
 
   cnv->input_format.samples_per_frame = 0;
 
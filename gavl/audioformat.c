@@ -43,6 +43,8 @@ sample_format_names[] =
     { GAVL_SAMPLE_S32,    "Signed 32 bit", "s32" },
     { GAVL_SAMPLE_FLOAT,  "Floating point", "float"},
     { GAVL_SAMPLE_DOUBLE, "Double precision", "double"},
+    { GAVL_SAMPLE_S24LE,  "Signed 24 bit little endian", "s24le" },
+    { GAVL_SAMPLE_S24BE,  "Signed 24 bit big endian", "s24be" },
   };
 
 const char * gavl_sample_format_to_string(gavl_sample_format_t format)
@@ -506,6 +508,10 @@ int gavl_bytes_per_sample(gavl_sample_format_t format)
     case     GAVL_SAMPLE_S16:
       return 2;
       break;
+    case     GAVL_SAMPLE_S24LE:
+    case     GAVL_SAMPLE_S24BE:
+      return 3;
+      break;
     case     GAVL_SAMPLE_S32:
       return 4;
       break;
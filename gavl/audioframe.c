@@ -111,6 +111,16 @@ gavl_audio_frame_create(const gavl_audio_format_t * format)
       for(i = 0; i < format->num_channels; i++)
         ret->channels.d[i] = &ret->samples.d[i*num_samples];
 
+      break;
+    case GAVL_SAMPLE_S24LE:
+    case GAVL_SAMPLE_S24BE:
+      ret->channel_stride = num_samples * 3;
+      ret->samples.u_8 =
+        gavl_memalign(ALIGNMENT_BYTES, 3 * num_samples * format->num_channels);
+
+      for(i = 0; i < format->num_channels; i++)
+        ret->channels.u_8[i] = &ret->samples.u_8[3*i*num_samples];
+
       break;
     case GAVL_SAMPLE_NONE:
       {
@@ -181,6 +191,10 @@ void gavl_audio_frame_mute_samples(gavl_audio_frame_t * frame,
       for(i = 0; i < imax; i++)
         frame->samples.d[i] = 0.0;
       break;
+    case GAVL_SAMPLE_S24LE:
+    case GAVL_SAMPLE_S24BE:
+      memset(frame->samples.u_8, 0, 3 * imax);
+      break;
     }
   frame->valid_samples = num_samples;
   }
@@ -261,6 +275,11 @@ void gavl_audio_frame_mute_channel(gavl_audio_frame_t * frame,
       for(i = 0; i < imax; i++)
         frame->samples.d[offset + advance * i] = 0.0;
       break;
+    case GAVL_SAMPLE_S24LE:
+    case GAVL_SAMPLE_S24BE:
+      for(i = 0; i < imax; i++)
+        memset(&frame->samples.u_8[3 * (offset + advance * i)], 0, 3);
+      break;
     }
   }
 
@@ -304,9 +323,9 @@ int gavl_audio_frame_copy(const gavl_audio_format_t * format,
       /* Last channel is not interleaved */
       if(format->num_channels & 1)
         {
-        gavl_memcpy(&dst->channels.s_8[format->num_channels-1][2 * out_pos * bytes_per_sample],
-                    &src->channels.s_8[format->num_channels-1][2 * in_pos * bytes_per_sample],
-                    2*samples_to_copy * bytes_per_sample);
+        gavl_memcpy(&dst->channels.s_8[format->num_channels-1][out_pos * bytes_per_sample],
+                    &src->channels.s_8[format->num_channels-1][in_pos * bytes_per_sample],
+                    samples_to_copy * bytes_per_sample);
         }
       break;
     case GAVL_INTERLEAVE_ALL:
@@ -504,6 +523,8 @@ static void do_plot(const gavl_audio_format_t * format,
           fprintf(out, " %f", frame->channels.d[i][j]);
 
         break;
+      case GAVL_SAMPLE_S24LE: /* Converted to S32 before */
+      case GAVL_SAMPLE_S24BE:
       case GAVL_SAMPLE_NONE:
         break;
       }
@@ -534,6 +555,9 @@ int gavl_audio_frame_plot(const gavl_audio_format_t * format,
   gavl_audio_format_copy(&plot_format, 
                          format);
   plot_format.interleave_mode = GAVL_INTERLEAVE_NONE;
+  if((plot_format.sample_format == GAVL_SAMPLE_S24LE) ||
+     (plot_format.sample_format == GAVL_SAMPLE_S24BE))
+    plot_format.sample_format = GAVL_SAMPLE_S32;
 
   plot_format.samples_per_frame = frame->valid_samples;
   
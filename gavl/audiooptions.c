@@ -30,6 +30,7 @@
 #include "config.h"
 #include "audio.h"
 #include <accel.h>
+#include <threadpool.h>
 
 #define SET_INT(p) opt->p = p
 
@@ -100,6 +101,9 @@ void gavl_audio_options_set_defaults(gavl_audio_options_t * opt)
   
   opt->accel_flags = gavl_accel_supported();
   opt->quality = GAVL_QUALITY_DEFAULT;
+  opt->num_threads = 1;
+  opt->run_func = gavl_run_func_default;
+  opt->stop_func = gavl_stop_func_default;
   gavl_init_memcpy();
   }
 
@@ -131,3 +135,55 @@ const double ** gavl_audio_options_get_mix_matrix(const gavl_audio_options_t * o
   {
   return opt->mix_matrix;
   }
+
+int gavl_audio_options_get_num_threads(const gavl_audio_options_t * opt)
+  {
+  return opt->num_threads;
+  }
+
+void gavl_audio_options_set_num_threads(gavl_audio_options_t * opt, int n)
+  {
+  opt->num_threads = n;
+  }
+
+void gavl_audio_options_set_run_func(gavl_audio_options_t * opt,
+                                     gavl_video_run_func run,
+                                     void * client_data)
+  {
+  opt->run_func = run ? run : gavl_run_func_default;
+  opt->run_data = client_data;
+  }
+
+gavl_video_run_func
+gavl_audio_options_get_run_func(const gavl_audio_options_t * opt,
+                                void ** client_data)
+  {
+  *client_data = opt->run_data;
+  return opt->run_func;
+  }
+
+void gavl_audio_options_set_stop_func(gavl_audio_options_t * opt,
+                                      gavl_video_stop_func stop,
+                                      void * client_data)
+  {
+  opt->stop_func = stop ? stop : gavl_stop_func_default;
+  opt->stop_data = client_data;
+  }
+
+gavl_video_stop_func
+gavl_audio_options_get_stop_func(const gavl_audio_options_t * opt,
+                                 void ** client_data)
+  {
+  *client_data = opt->stop_data;
+  return opt->stop_func;
+  }
+
+void gavl_audio_options_run(const gavl_audio_options_t * opt,
+                            gavl_video_process_func func,
+                            void * data, int num)
+  {
+  gavl_threads_run(opt->num_threads,
+                   opt->run_func, opt->run_data,
+                   opt->stop_func, opt->stop_data,
+                   func, data, num, 1);
+  }
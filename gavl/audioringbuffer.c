@@ -0,0 +1,288 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <stdlib.h>
+
+#include <gavl/connectors.h>
+
+/*
+ *  Single producer, single consumer FIFO. The read and write positions
+ *  count samples since the start and are only ever advanced by one side
+ *  each. The producer publishes samples with a release store of
+ *  write_pos, the consumer frees them with a release store of read_pos.
+ *
+ *  The windows handed out to both sides are subframes of one big frame,
+ *  so they never wrap around the end of the buffer.
+ */
+
+#define CACHE_LINE 64
+
+struct gavl_audio_ringbuffer_s
+  {
+  gavl_audio_format_t format;
+  int capacity;
+
+  gavl_audio_frame_t * buffer;
+
+  gavl_audio_sink_t * sink;
+  gavl_audio_source_t * source;
+
+  /* Timestamp of the first sample, set before the first write is published */
+  int64_t start_pts;
+
+  /* Producer side */
+  uint8_t pad_1[CACHE_LINE];
+  int64_t write_pos;
+  gavl_audio_frame_t * write_frame;
+  int have_pts;
+  int64_t overruns;
+  int eof;
+
+  /* Consumer side */
+  uint8_t pad_2[CACHE_LINE];
+  int64_t read_pos;
+  gavl_audio_frame_t * read_frame;
+  int read_pending;
+  int64_t underruns;
+  uint8_t pad_3[CACHE_LINE];
+  };
+
+static void commit_write(gavl_audio_ringbuffer_t * rb, int num,
+                         int64_t pts)
+  {
+  if(!num)
+    return;
+
+  if(!rb->have_pts)
+    {
+    rb->start_pts = pts;
+    rb->have_pts = 1;
+    }
+  __atomic_store_n(&rb->write_pos, rb->write_pos + num, __ATOMIC_RELEASE);
+  }
+
+int gavl_audio_ringbuffer_write_begin(gavl_audio_ringbuffer_t * rb,
+                                      gavl_audio_frame_t ** frame)
+  {
+  int idx, num;
+  int64_t read_pos = __atomic_load_n(&rb->read_pos, __ATOMIC_ACQUIRE);
+
+  idx = rb->write_pos % rb->capacity;
+  num = rb->capacity - (int)(rb->write_pos - read_pos);
+
+  if(num > rb->capacity - idx)
+    num = rb->capacity - idx;
+
+  gavl_audio_frame_get_subframe(&rb->format, rb->buffer,
+                                rb->write_frame, idx, num);
+  rb->write_frame->valid_samples = 0;
+  rb->write_frame->timestamp = rb->start_pts + rb->write_pos;
+  *frame = rb->write_frame;
+  return num;
+  }
+
+void gavl_audio_ringbuffer_write_end(gavl_audio_ringbuffer_t * rb, int num)
+  {
+  commit_write(rb, num, rb->write_frame->timestamp);
+  }
+
+int gavl_audio_ringbuffer_read_begin(gavl_audio_ringbuffer_t * rb,
+                                     gavl_audio_frame_t ** frame)
+  {
+  int idx, num;
+  int64_t write_pos = __atomic_load_n(&rb->write_pos, __ATOMIC_ACQUIRE);
+
+  idx = rb->read_pos % rb->capacity;
+  num = (int)(write_pos - rb->read_pos);
+
+  if(num > rb->capacity - idx)
+    num = rb->capacity - idx;
+
+  if(!num)
+    {
+    if(!gavl_audio_ringbuffer_get_eof(rb))
+      __atomic_add_fetch(&rb->underruns, 1, __ATOMIC_RELAXED);
+    return 0;
+    }
+
+  gavl_audio_frame_get_subframe(&rb->format, rb->buffer,
+                                rb->read_frame, idx, num);
+  rb->read_frame->timestamp = rb->start_pts + rb->read_pos;
+  *frame = rb->read_frame;
+  return num;
+  }
+
+void gavl_audio_ringbuffer_read_end(gavl_audio_ringbuffer_t * rb, int num)
+  {
+  __atomic_store_n(&rb->read_pos, rb->read_pos + num, __ATOMIC_RELEASE);
+  }
+
+/* Sink */
+
+static gavl_audio_frame_t * get_frame_func(void * priv)
+  {
+  gavl_audio_frame_t * ret;
+  gavl_audio_ringbuffer_t * rb = priv;
+
+  /* Only hand out the buffer if a whole frame fits without wrapping */
+  if(gavl_audio_ringbuffer_write_begin(rb, &ret) < rb->format.samples_per_frame)
+    return NULL;
+  return ret;
+  }
+
+static gavl_sink_status_t put_frame_func(void * priv, gavl_audio_frame_t * f)
+  {
+  int num, copied = 0;
+  gavl_audio_frame_t * dst;
+  gavl_audio_ringbuffer_t * rb = priv;
+
+  if(f == rb->write_frame)
+    {
+    commit_write(rb, f->valid_samples, f->timestamp);
+    return GAVL_SINK_OK;
+    }
+
+  /* Copy, at most 2 parts */
+  while(copied < f->valid_samples)
+    {
+    if(!(num = gavl_audio_ringbuffer_write_begin(rb, &dst)))
+      break;
+    num = gavl_audio_frame_copy(&rb->format, dst, f, 0, copied,
+                                num, f->valid_samples - copied);
+    commit_write(rb, num, f->timestamp + copied);
+    copied += num;
+    }
+
+  if(copied < f->valid_samples)
+    __atomic_add_fetch(&rb->overruns, 1, __ATOMIC_RELAXED);
+
+  return GAVL_SINK_OK;
+  }
+
+/* Source */
+
+static gavl_source_status_t read_frame_func(void * priv,
+                                            gavl_audio_frame_t ** frame)
+  {
+  int num;
+  gavl_audio_frame_t * f;
+  gavl_audio_ringbuffer_t * rb = priv;
+
+  /* The previous frame is released not before the next read call */
+  if(rb->read_pending)
+    {
+    gavl_audio_ringbuffer_read_end(rb, rb->read_pending);
+    rb->read_pending = 0;
+    }
+
+  if(!(num = gavl_audio_ringbuffer_read_begin(rb, &f)))
+    return gavl_audio_ringbuffer_get_eof(rb) ? GAVL_SOURCE_EOF : GAVL_SOURCE_AGAIN;
+
+  if(num > rb->format.samples_per_frame)
+    num = rb->format.samples_per_frame;
+
+  f->valid_samples = num;
+  rb->read_pending = num;
+  *frame = f;
+  return GAVL_SOURCE_OK;
+  }
+
+gavl_audio_ringbuffer_t *
+gavl_audio_ringbuffer_create(const gavl_audio_format_t * format,
+                             int capacity)
+  {
+  gavl_audio_format_t buffer_format;
+  gavl_audio_ringbuffer_t * ret = calloc(1, sizeof(*ret));
+
+  gavl_audio_format_copy(&ret->format, format);
+  ret->capacity = capacity;
+
+  gavl_audio_format_copy(&buffer_format, format);
+  buffer_format.samples_per_frame = capacity;
+  ret->buffer = gavl_audio_frame_create(&buffer_format);
+
+  ret->write_frame = gavl_audio_frame_create(NULL);
+  ret->read_frame = gavl_audio_frame_create(NULL);
+
+  ret->sink = gavl_audio_sink_create(get_frame_func, put_frame_func,
+                                     ret, &ret->format);
+  ret->source = gavl_audio_source_create(read_frame_func, ret,
+                                         GAVL_SOURCE_SRC_ALLOC |
+                                         GAVL_SOURCE_SRC_FRAMESIZE_MAX,
+                                         &ret->format);
+  return ret;
+  }
+
+void gavl_audio_ringbuffer_destroy(gavl_audio_ringbuffer_t * rb)
+  {
+  gavl_audio_sink_destroy(rb->sink);
+  gavl_audio_source_destroy(rb->source);
+
+  gavl_audio_frame_null(rb->write_frame);
+  gavl_audio_frame_destroy(rb->write_frame);
+  gavl_audio_frame_null(rb->read_frame);
+  gavl_audio_frame_destroy(rb->read_frame);
+
+  gavl_audio_frame_destroy(rb->buffer);
+  free(rb);
+  }
+
+gavl_audio_sink_t *
+gavl_audio_ringbuffer_get_sink(gavl_audio_ringbuffer_t * rb)
+  {
+  return rb->sink;
+  }
+
+gavl_audio_source_t *
+gavl_audio_ringbuffer_get_source(gavl_audio_ringbuffer_t * rb)
+  {
+  return rb->source;
+  }
+
+void gavl_audio_ringbuffer_set_eof(gavl_audio_ringbuffer_t * rb)
+  {
+  __atomic_store_n(&rb->eof, 1, __ATOMIC_RELEASE);
+  }
+
+int gavl_audio_ringbuffer_get_eof(gavl_audio_ringbuffer_t * rb)
+  {
+  /* EOF is reached after all samples are read */
+  if(!__atomic_load_n(&rb->eof, __ATOMIC_ACQUIRE))
+    return 0;
+  return (__atomic_load_n(&rb->write_pos, __ATOMIC_ACQUIRE) ==
+          __atomic_load_n(&rb->read_pos, __ATOMIC_ACQUIRE));
+  }
+
+int gavl_audio_ringbuffer_get_fill(gavl_audio_ringbuffer_t * rb)
+  {
+  int64_t read_pos = __atomic_load_n(&rb->read_pos, __ATOMIC_ACQUIRE);
+  return (int)(__atomic_load_n(&rb->write_pos, __ATOMIC_ACQUIRE) - read_pos);
+  }
+
+void gavl_audio_ringbuffer_get_stats(gavl_audio_ringbuffer_t * rb,
+                                     int64_t * overruns,
+                                     int64_t * underruns)
+  {
+  if(overruns)
+    *overruns = __atomic_load_n(&rb->overruns, __ATOMIC_RELAXED);
+  if(underruns)
+    *underruns = __atomic_load_n(&rb->underruns, __ATOMIC_RELAXED);
+  }
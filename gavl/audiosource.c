@@ -54,6 +54,13 @@ struct gavl_audio_source_s
 
   /* For buffering */
   gavl_audio_frame_t * buffer_frame;
+
+  /* Points into frame for GAVL_SOURCE_DST_SUBFRAMES */
+  gavl_audio_frame_t * sub_frame;
+
+  /* Statistics */
+  int64_t bytes_copied;
+  int64_t bytes_passed;
   
   gavl_audio_frame_t * frame;
   
@@ -189,7 +196,11 @@ void gavl_audio_source_destroy(gavl_audio_source_t * s)
     gavl_audio_frame_destroy(s->dst_frame);
   if(s->buffer_frame)
     gavl_audio_frame_destroy(s->buffer_frame);
-  
+  if(s->sub_frame)
+    {
+    gavl_audio_frame_null(s->sub_frame);
+    gavl_audio_frame_destroy(s->sub_frame);
+    }
   
   gavl_audio_converter_destroy(s->cnv);
 
@@ -336,9 +347,14 @@ read_frame_internal(void * sp, gavl_audio_frame_t ** frame, int num_samples)
   int samples_copied;
   gavl_source_status_t ret = GAVL_SOURCE_OK;
   int eat_all = 0;
+  int sample_size = s->dst_format.num_channels *
+    gavl_bytes_per_sample(s->dst_format.sample_format);
   
   s->incomplete_samples = 0;
   
+  /* Never write into our own subframe */
+  if(*frame && (*frame == s->sub_frame))
+    *frame = NULL;
   
   while(samples_read < num_samples)
     {
@@ -348,7 +364,7 @@ read_frame_internal(void * sp, gavl_audio_frame_t ** frame, int num_samples)
       {
       eat_all = 0;
       /* Check for passthrough */
-      if(s->flags & FLAG_PASSTHROUGH)
+      if((s->flags & FLAG_PASSTHROUGH) && !samples_read)
         {
         if((*frame && !(s->src_flags & GAVL_SOURCE_SRC_ALLOC)) ||
            (!(*frame) && (s->src_flags & GAVL_SOURCE_SRC_ALLOC)))
@@ -359,6 +375,7 @@ read_frame_internal(void * sp, gavl_audio_frame_t ** frame, int num_samples)
             {
             process_input(s, *frame);
             process_output(s, *frame);
+            s->bytes_passed += (*frame)->valid_samples * sample_size;
             }
           return ret;
           }
@@ -423,6 +440,24 @@ read_frame_internal(void * sp, gavl_audio_frame_t ** frame, int num_samples)
       s->frame_samples = s->frame->valid_samples;
       }
 
+    /* Hand out a part of the current frame if the request fits inside */
+    if(!(*frame) && !samples_read &&
+       (s->dst_flags & GAVL_SOURCE_DST_SUBFRAMES) &&
+       (s->frame->valid_samples >= num_samples))
+      {
+      if(!s->sub_frame)
+        s->sub_frame = gavl_audio_frame_create(NULL);
+      
+      gavl_audio_frame_get_subframe(&s->dst_format, s->frame, s->sub_frame,
+                                    s->frame_samples - s->frame->valid_samples,
+                                    num_samples);
+      *frame = s->sub_frame;
+      s->frame->valid_samples -= num_samples;
+      samples_read = num_samples;
+      s->bytes_passed += num_samples * sample_size;
+      break;
+      }
+    
     /* Make sure we have a frame to write to */
     if(!(*frame))
       {
@@ -444,6 +479,7 @@ read_frame_internal(void * sp, gavl_audio_frame_t ** frame, int num_samples)
                             s->frame->valid_samples);                   // src_size
     s->frame->valid_samples -= samples_copied;
     samples_read += samples_copied;
+    s->bytes_copied += samples_copied * sample_size;
     }
   
   if(ret == GAVL_SOURCE_AGAIN)
@@ -458,8 +494,11 @@ read_frame_internal(void * sp, gavl_audio_frame_t ** frame, int num_samples)
     (*frame)->valid_samples = samples_read;
     process_output(s, *frame);
 
-    /* Buffer samples for next time (we need to eat up all samples in this call) */
-    if(eat_all && s->frame->valid_samples)
+    /* Buffer samples for next time (we need to eat up all samples in this call).
+       With subframes, the caller already accepts that the frame is only valid
+       until the next call, so we keep the source frame until the next read. */
+    if(eat_all && s->frame->valid_samples &&
+       !(s->dst_flags & GAVL_SOURCE_DST_SUBFRAMES))
       {
       if(!s->buffer_frame)
         s->buffer_frame = gavl_audio_frame_create(&s->src_format);
@@ -475,6 +514,7 @@ read_frame_internal(void * sp, gavl_audio_frame_t ** frame, int num_samples)
       
       s->frame = s->buffer_frame;
       s->frame_samples = s->frame->valid_samples;
+      s->bytes_copied += s->frame_samples * sample_size;
       }
     }
   else if(*frame)
@@ -528,6 +568,16 @@ int gavl_audio_source_read_samples(void * sp, gavl_audio_frame_t * frame,
   return frame->valid_samples;
   }
 
+void gavl_audio_source_get_copy_stats(gavl_audio_source_t * s,
+                                      int64_t * bytes_copied,
+                                      int64_t * bytes_passed)
+  {
+  if(bytes_copied)
+    *bytes_copied = s->bytes_copied;
+  if(bytes_passed)
+    *bytes_passed = s->bytes_passed;
+  }
+
 void 
 gavl_audio_source_skip(gavl_audio_source_t * s, int num_samples)
   {
@@ -0,0 +1,510 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/*
+ *  Helpers for the AVX2 colorspace converters. All conversions work
+ *  on 16 pixels at once. Internally, the 8 bit components are expanded to
+ *  16 bit and the matrix is applied with pmaddwd (fixed point).
+ *  The results can differ by one LSB from the table based C versions.
+ */
+
+#include <immintrin.h>
+
+/* Fixed point precision */
+
+#define YUV_RGB_SHIFT 13
+#define RGB_YUV_SHIFT 15
+
+/* 2 int16 coefficients in one 32 bit word, a gets multiplied with
+   the even (first) element */
+
+#define COEFF_PAIR(a, b) \
+  _mm256_set1_epi32((int)(((uint32_t)(uint16_t)(b) << 16) | (uint16_t)(a)))
+
+/*
+ *  YUV -> RGB
+ */
+
+typedef struct
+  {
+  __m256i yv_r;
+  __m256i yu_g;
+  __m256i v1_g; /* v * cvg + round */
+  __m256i yu_b;
+  __m256i round;
+  __m256i y_off;
+  __m256i uv_off;
+  __m256i one;
+  /* 16 bit input (mpeg range only) is shifted to 14 bit */
+  __m256i y_off_16;
+  __m256i uv_off_16;
+  __m256i round_16;
+  __m256i one_16; /* one_16 * round in v1_g is round_16 */
+  } yuv_rgb_avx2_t;
+
+static inline void yuv_rgb_avx2_init(yuv_rgb_avx2_t * c, int jpeg)
+  {
+  const int round = 1 << (YUV_RGB_SHIFT - 1);
+
+  if(jpeg)
+    {
+    c->yv_r = COEFF_PAIR(8192,  11485);
+    c->yu_g = COEFF_PAIR(8192,  -2819);
+    c->v1_g = COEFF_PAIR(-5850, round);
+    c->yu_b = COEFF_PAIR(8192,  14516);
+    c->y_off = _mm256_setzero_si256();
+    }
+  else
+    {
+    c->yv_r = COEFF_PAIR(9539,  13075);
+    c->yu_g = COEFF_PAIR(9539,  -3209);
+    c->v1_g = COEFF_PAIR(-6660, round);
+    c->yu_b = COEFF_PAIR(9539,  16525);
+    c->y_off = _mm256_set1_epi16(16);
+    }
+  c->round = _mm256_set1_epi32(round);
+  c->uv_off = _mm256_set1_epi16(128);
+  c->one = _mm256_set1_epi16(1);
+
+  c->y_off_16 = _mm256_set1_epi16(0x1000 >> 2);
+  c->uv_off_16 = _mm256_set1_epi16(0x8000 >> 2);
+  c->round_16 = _mm256_set1_epi32(1 << (YUV_RGB_SHIFT + 6 - 1));
+  c->one_16 = _mm256_set1_epi16(1 << 6);
+  }
+
+/* Pack 2x8 32 bit values (as returned by pmaddwd on unpacklo/unpackhi)
+   to 16 signed 16 bit values in the original order */
+
+static inline __m256i pack_32_to_16_avx2(__m256i lo, __m256i hi, int shift)
+  {
+  lo = _mm256_srai_epi32(lo, shift);
+  hi = _mm256_srai_epi32(hi, shift);
+  return _mm256_packs_epi32(lo, hi);
+  }
+
+/* Convert 16 pixels with offsets already subtracted. The results are
+   shifted right by shift, round and one * (round in v1_g) must match */
+
+static inline void yuv_to_rgb_24_avx2(const yuv_rgb_avx2_t * c,
+                                      __m256i y, __m256i u, __m256i v,
+                                      __m256i round, __m256i one, int shift,
+                                      __m128i * r, __m128i * g, __m128i * b)
+  {
+  __m256i lo, hi, r16, g16, b16, tmp;
+
+  /* R */
+  lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(y, v), c->yv_r);
+  hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(y, v), c->yv_r);
+  lo = _mm256_add_epi32(lo, round);
+  hi = _mm256_add_epi32(hi, round);
+  r16 = pack_32_to_16_avx2(lo, hi, shift);
+
+  /* G */
+  lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(y, u), c->yu_g);
+  hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(y, u), c->yu_g);
+  lo = _mm256_add_epi32(lo,
+                        _mm256_madd_epi16(_mm256_unpacklo_epi16(v, one), c->v1_g));
+  hi = _mm256_add_epi32(hi,
+                        _mm256_madd_epi16(_mm256_unpackhi_epi16(v, one), c->v1_g));
+  g16 = pack_32_to_16_avx2(lo, hi, shift);
+
+  /* B */
+  lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(y, u), c->yu_b);
+  hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(y, u), c->yu_b);
+  lo = _mm256_add_epi32(lo, round);
+  hi = _mm256_add_epi32(hi, round);
+  b16 = pack_32_to_16_avx2(lo, hi, shift);
+
+  /* Saturate to 8 bit */
+  tmp = _mm256_permute4x64_epi64(_mm256_packus_epi16(r16, g16), 0xd8);
+  *r = _mm256_castsi256_si128(tmp);
+  *g = _mm256_extracti128_si256(tmp, 1);
+  tmp = _mm256_permute4x64_epi64(_mm256_packus_epi16(b16, b16), 0xd8);
+  *b = _mm256_castsi256_si128(tmp);
+  }
+
+/* Convert 16 pixels. u and v must be already upsampled */
+
+static inline void yuv_8_to_rgb_24_avx2(const yuv_rgb_avx2_t * c,
+                                        __m128i y8, __m128i u8, __m128i v8,
+                                        __m128i * r, __m128i * g, __m128i * b)
+  {
+  yuv_to_rgb_24_avx2(c,
+                     _mm256_sub_epi16(_mm256_cvtepu8_epi16(y8), c->y_off),
+                     _mm256_sub_epi16(_mm256_cvtepu8_epi16(u8), c->uv_off),
+                     _mm256_sub_epi16(_mm256_cvtepu8_epi16(v8), c->uv_off),
+                     c->round, c->one, YUV_RGB_SHIFT, r, g, b);
+  }
+
+/* Same for 16 bit input. The lowest 2 bits are dropped so the values fit
+   into signed 16 bit */
+
+static inline void yuv_16_to_rgb_24_avx2(const yuv_rgb_avx2_t * c,
+                                         __m256i y16, __m256i u16, __m256i v16,
+                                         __m128i * r, __m128i * g, __m128i * b)
+  {
+  yuv_to_rgb_24_avx2(c,
+                     _mm256_sub_epi16(_mm256_srli_epi16(y16, 2), c->y_off_16),
+                     _mm256_sub_epi16(_mm256_srli_epi16(u16, 2), c->uv_off_16),
+                     _mm256_sub_epi16(_mm256_srli_epi16(v16, 2), c->uv_off_16),
+                     c->round_16, c->one_16, YUV_RGB_SHIFT + 6, r, g, b);
+  }
+
+/*
+ *  RGB -> YUV
+ */
+
+typedef struct
+  {
+  __m256i rg_y;
+  __m256i bo_y; /* b * cb + 256 * (offset + round) / 256 */
+  __m256i rg_u;
+  __m256i bo_u;
+  __m256i rg_v;
+  __m256i bo_v;
+  __m256i rg_uv; /* u in the lower, v in the upper lane */
+  __m256i bo_uv;
+  __m256i c256;
+  __m256i round; /* Rounding included in bo_*, not wanted for 16 bit */
+  } rgb_yuv_avx2_t;
+
+static inline void rgb_yuv_avx2_init(rgb_yuv_avx2_t * c, int jpeg)
+  {
+  if(jpeg)
+    {
+    c->rg_y = COEFF_PAIR(9798,   19235);
+    c->bo_y = COEFF_PAIR(3736,   64);
+    c->rg_u = COEFF_PAIR(-5529,  -10855);
+    c->bo_u = COEFF_PAIR(16384,  16448);
+    c->rg_v = COEFF_PAIR(16384,  -13720);
+    c->bo_v = COEFF_PAIR(-2664,  16448);
+    }
+  else
+    {
+    c->rg_y = COEFF_PAIR(8414,   16519);
+    c->bo_y = COEFF_PAIR(3208,   2112);
+    c->rg_u = COEFF_PAIR(-4857,  -9535);
+    c->bo_u = COEFF_PAIR(14392,  16448);
+    c->rg_v = COEFF_PAIR(14392,  -12052);
+    c->bo_v = COEFF_PAIR(-2340,  16448);
+    }
+  c->rg_uv = _mm256_blend_epi32(c->rg_u, c->rg_v, 0xf0);
+  c->bo_uv = _mm256_blend_epi32(c->bo_u, c->bo_v, 0xf0);
+  c->c256 = _mm256_set1_epi16(256);
+  c->round = _mm256_set1_epi32(1 << (RGB_YUV_SHIFT - 1));
+  }
+
+static inline __m256i rgb_dot_avx2(__m256i rg_lo, __m256i rg_hi,
+                                   __m256i bo_lo, __m256i bo_hi,
+                                   __m256i c_rg, __m256i c_bo)
+  {
+  __m256i lo, hi;
+  lo = _mm256_add_epi32(_mm256_madd_epi16(rg_lo, c_rg),
+                        _mm256_madd_epi16(bo_lo, c_bo));
+  hi = _mm256_add_epi32(_mm256_madd_epi16(rg_hi, c_rg),
+                        _mm256_madd_epi16(bo_hi, c_bo));
+  return pack_32_to_16_avx2(lo, hi, RGB_YUV_SHIFT);
+  }
+
+/* 16 bit results. These are non-negative for all inputs, the C versions
+   truncate as well */
+
+static inline __m256i rgb_dot_16_avx2(const rgb_yuv_avx2_t * c,
+                                      __m256i rg_lo, __m256i rg_hi,
+                                      __m256i bo_lo, __m256i bo_hi,
+                                      __m256i c_rg, __m256i c_bo)
+  {
+  __m256i lo, hi;
+  lo = _mm256_add_epi32(_mm256_madd_epi16(rg_lo, c_rg),
+                        _mm256_madd_epi16(bo_lo, c_bo));
+  hi = _mm256_add_epi32(_mm256_madd_epi16(rg_hi, c_rg),
+                        _mm256_madd_epi16(bo_hi, c_bo));
+  lo = _mm256_srli_epi32(_mm256_sub_epi32(lo, c->round), RGB_YUV_SHIFT - 8);
+  hi = _mm256_srli_epi32(_mm256_sub_epi32(hi, c->round), RGB_YUV_SHIFT - 8);
+  return _mm256_packus_epi32(lo, hi);
+  }
+
+static inline __m128i pack_16_to_8_avx2(__m256i v)
+  {
+  return _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0xd8));
+  }
+
+/* Luma of 16 pixels, chroma of 16 pixels (if u and v are non-NULL) */
+
+static inline __m128i rgb_24_to_yuv_8_avx2(const rgb_yuv_avx2_t * c,
+                                           __m128i r8, __m128i g8, __m128i b8,
+                                           __m128i * u8, __m128i * v8)
+  {
+  __m256i r, g, b, rg_lo, rg_hi, bo_lo, bo_hi;
+
+  r = _mm256_cvtepu8_epi16(r8);
+  g = _mm256_cvtepu8_epi16(g8);
+  b = _mm256_cvtepu8_epi16(b8);
+
+  rg_lo = _mm256_unpacklo_epi16(r, g);
+  rg_hi = _mm256_unpackhi_epi16(r, g);
+  bo_lo = _mm256_unpacklo_epi16(b, c->c256);
+  bo_hi = _mm256_unpackhi_epi16(b, c->c256);
+
+  if(u8)
+    {
+    *u8 = pack_16_to_8_avx2(rgb_dot_avx2(rg_lo, rg_hi, bo_lo, bo_hi,
+                                         c->rg_u, c->bo_u));
+    *v8 = pack_16_to_8_avx2(rgb_dot_avx2(rg_lo, rg_hi, bo_lo, bo_hi,
+                                         c->rg_v, c->bo_v));
+    }
+  return pack_16_to_8_avx2(rgb_dot_avx2(rg_lo, rg_hi, bo_lo, bo_hi,
+                                        c->rg_y, c->bo_y));
+  }
+
+/* Chroma of the 8 even pixels (horizontally subsampled formats).
+   u and v are returned in the lower 8 bytes */
+
+static inline void rgb_24_to_uv_8_sub_avx2(const rgb_yuv_avx2_t * c,
+                                           __m128i r8, __m128i g8, __m128i b8,
+                                           __m128i * u8, __m128i * v8)
+  {
+  const __m128i even = _mm_set1_epi16(0x00ff);
+  __m256i r, g, b, uv;
+
+  /* Even pixels as 16 bit values, duplicated into both lanes. The
+     lower lane calculates u, the upper lane v */
+  r = _mm256_broadcastsi128_si256(_mm_and_si128(r8, even));
+  g = _mm256_broadcastsi128_si256(_mm_and_si128(g8, even));
+  b = _mm256_broadcastsi128_si256(_mm_and_si128(b8, even));
+
+  uv = rgb_dot_avx2(_mm256_unpacklo_epi16(r, g), _mm256_unpackhi_epi16(r, g),
+                    _mm256_unpacklo_epi16(b, c->c256),
+                    _mm256_unpackhi_epi16(b, c->c256),
+                    c->rg_uv, c->bo_uv);
+  
+  uv = _mm256_packus_epi16(uv, uv);
+  *u8 = _mm256_castsi256_si128(uv);
+  *v8 = _mm256_extracti128_si256(uv, 1);
+  }
+
+/* 16 bit versions of the above */
+
+static inline __m256i rgb_24_to_yuv_16_avx2(const rgb_yuv_avx2_t * c,
+                                            __m128i r8, __m128i g8, __m128i b8,
+                                            __m256i * u16, __m256i * v16)
+  {
+  __m256i r, g, b, rg_lo, rg_hi, bo_lo, bo_hi;
+
+  r = _mm256_cvtepu8_epi16(r8);
+  g = _mm256_cvtepu8_epi16(g8);
+  b = _mm256_cvtepu8_epi16(b8);
+
+  rg_lo = _mm256_unpacklo_epi16(r, g);
+  rg_hi = _mm256_unpackhi_epi16(r, g);
+  bo_lo = _mm256_unpacklo_epi16(b, c->c256);
+  bo_hi = _mm256_unpackhi_epi16(b, c->c256);
+
+  if(u16)
+    {
+    *u16 = rgb_dot_16_avx2(c, rg_lo, rg_hi, bo_lo, bo_hi, c->rg_u, c->bo_u);
+    *v16 = rgb_dot_16_avx2(c, rg_lo, rg_hi, bo_lo, bo_hi, c->rg_v, c->bo_v);
+    }
+  return rgb_dot_16_avx2(c, rg_lo, rg_hi, bo_lo, bo_hi, c->rg_y, c->bo_y);
+  }
+
+/* u of the 8 even pixels in the lower lane, v in the upper lane */
+
+static inline __m256i rgb_24_to_uv_16_sub_avx2(const rgb_yuv_avx2_t * c,
+                                               __m128i r8, __m128i g8, __m128i b8)
+  {
+  const __m128i even = _mm_set1_epi16(0x00ff);
+  __m256i r, g, b;
+
+  r = _mm256_broadcastsi128_si256(_mm_and_si128(r8, even));
+  g = _mm256_broadcastsi128_si256(_mm_and_si128(g8, even));
+  b = _mm256_broadcastsi128_si256(_mm_and_si128(b8, even));
+
+  return rgb_dot_16_avx2(c,
+                         _mm256_unpacklo_epi16(r, g), _mm256_unpackhi_epi16(r, g),
+                         _mm256_unpacklo_epi16(b, c->c256),
+                         _mm256_unpackhi_epi16(b, c->c256),
+                         c->rg_uv, c->bo_uv);
+  }
+
+/*
+ *  Packing and unpacking of packed RGB pixels
+ */
+
+static inline void store_rgb_24_avx2(uint8_t * dst,
+                                     __m128i c0, __m128i c1, __m128i c2)
+  {
+  __m128i out;
+
+  out = _mm_or_si128(_mm_or_si128(
+     _mm_shuffle_epi8(c0, _mm_setr_epi8(0, -128, -128, 1, -128, -128, 2, -128,
+                                        -128, 3, -128, -128, 4, -128, -128, 5)),
+     _mm_shuffle_epi8(c1, _mm_setr_epi8(-128, 0, -128, -128, 1, -128, -128, 2,
+                                        -128, -128, 3, -128, -128, 4, -128, -128))),
+     _mm_shuffle_epi8(c2, _mm_setr_epi8(-128, -128, 0, -128, -128, 1, -128, -128,
+                                        2, -128, -128, 3, -128, -128, 4, -128)));
+  _mm_storeu_si128((__m128i*)dst, out);
+
+  out = _mm_or_si128(_mm_or_si128(
+     _mm_shuffle_epi8(c0, _mm_setr_epi8(-128, -128, 6, -128, -128, 7, -128, -128,
+                                        8, -128, -128, 9, -128, -128, 10, -128)),
+     _mm_shuffle_epi8(c1, _mm_setr_epi8(5, -128, -128, 6, -128, -128, 7, -128,
+                                        -128, 8, -128, -128, 9, -128, -128, 10))),
+     _mm_shuffle_epi8(c2, _mm_setr_epi8(-128, 5, -128, -128, 6, -128, -128, 7,
+                                        -128, -128, 8, -128, -128, 9, -128, -128)));
+  _mm_storeu_si128((__m128i*)(dst+16), out);
+
+  out = _mm_or_si128(_mm_or_si128(
+     _mm_shuffle_epi8(c0, _mm_setr_epi8(-128, 11, -128, -128, 12, -128, -128, 13,
+                                        -128, -128, 14, -128, -128, 15, -128, -128)),
+     _mm_shuffle_epi8(c1, _mm_setr_epi8(-128, -128, 11, -128, -128, 12, -128, -128,
+                                        13, -128, -128, 14, -128, -128, 15, -128))),
+     _mm_shuffle_epi8(c2, _mm_setr_epi8(10, -128, -128, 11, -128, -128, 12, -128,
+                                        -128, 13, -128, -128, 14, -128, -128, 15)));
+  _mm_storeu_si128((__m128i*)(dst+32), out);
+  }
+
+static inline void load_rgb_24_avx2(const uint8_t * src,
+                                    __m128i * c0, __m128i * c1, __m128i * c2)
+  {
+  __m128i in0, in1, in2;
+
+  in0 = _mm_loadu_si128((const __m128i*)src);
+  in1 = _mm_loadu_si128((const __m128i*)(src+16));
+  in2 = _mm_loadu_si128((const __m128i*)(src+32));
+
+  *c0 = _mm_or_si128(_mm_or_si128(
+     _mm_shuffle_epi8(in0, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -128, -128,
+                                         -128, -128, -128, -128, -128, -128, -128, -128)),
+     _mm_shuffle_epi8(in1, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, 2, 5,
+                                         8, 11, 14, -128, -128, -128, -128, -128))),
+     _mm_shuffle_epi8(in2, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128,
+                                         -128, -128, -128, 1, 4, 7, 10, 13)));
+  *c1 = _mm_or_si128(_mm_or_si128(
+     _mm_shuffle_epi8(in0, _mm_setr_epi8(1, 4, 7, 10, 13, -128, -128, -128,
+                                         -128, -128, -128, -128, -128, -128, -128, -128)),
+     _mm_shuffle_epi8(in1, _mm_setr_epi8(-128, -128, -128, -128, -128, 0, 3, 6,
+                                         9, 12, 15, -128, -128, -128, -128, -128))),
+     _mm_shuffle_epi8(in2, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128,
+                                         -128, -128, -128, 2, 5, 8, 11, 14)));
+  *c2 = _mm_or_si128(_mm_or_si128(
+     _mm_shuffle_epi8(in0, _mm_setr_epi8(2, 5, 8, 11, 14, -128, -128, -128,
+                                         -128, -128, -128, -128, -128, -128, -128, -128)),
+     _mm_shuffle_epi8(in1, _mm_setr_epi8(-128, -128, -128, -128, -128, 1, 4, 7,
+                                         10, 13, -128, -128, -128, -128, -128, -128))),
+     _mm_shuffle_epi8(in2, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128,
+                                         -128, -128, 0, 3, 6, 9, 12, 15)));
+  }
+
+static inline void store_rgb_32_avx2(uint8_t * dst,
+                                     __m128i c0, __m128i c1, __m128i c2,
+                                     __m128i c3)
+  {
+  __m128i c01_lo, c01_hi, c23_lo, c23_hi;
+
+  c01_lo = _mm_unpacklo_epi8(c0, c1);
+  c01_hi = _mm_unpackhi_epi8(c0, c1);
+  c23_lo = _mm_unpacklo_epi8(c2, c3);
+  c23_hi = _mm_unpackhi_epi8(c2, c3);
+
+  _mm_storeu_si128((__m128i*)dst,      _mm_unpacklo_epi16(c01_lo, c23_lo));
+  _mm_storeu_si128((__m128i*)(dst+16), _mm_unpackhi_epi16(c01_lo, c23_lo));
+  _mm_storeu_si128((__m128i*)(dst+32), _mm_unpacklo_epi16(c01_hi, c23_hi));
+  _mm_storeu_si128((__m128i*)(dst+48), _mm_unpackhi_epi16(c01_hi, c23_hi));
+  }
+
+static inline void load_rgb_32_avx2(const uint8_t * src,
+                                    __m128i * c0, __m128i * c1, __m128i * c2)
+  {
+  const __m128i mask = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13,
+                                     2, 6, 10, 14, 3, 7, 11, 15);
+  __m128i t0, t1, t2, t3, t01, t23;
+
+  /* Each block: c0 c0 c0 c0 c1 c1 c1 c1 c2 c2 c2 c2 c3 c3 c3 c3 */
+  t0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)src), mask);
+  t1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src+16)), mask);
+  t2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src+32)), mask);
+  t3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src+48)), mask);
+
+  t01 = _mm_unpacklo_epi32(t0, t1); /* c0 c0 c1 c1 */
+  t23 = _mm_unpacklo_epi32(t2, t3);
+  *c0 = _mm_unpacklo_epi64(t01, t23);
+  *c1 = _mm_unpackhi_epi64(t01, t23);
+
+  t01 = _mm_unpackhi_epi32(t0, t1); /* c2 c2 c3 c3 */
+  t23 = _mm_unpackhi_epi32(t2, t3);
+  *c2 = _mm_unpacklo_epi64(t01, t23);
+  }
+
+/*
+ *  Packed YUV 4:2:2 (16 pixels in 32 bytes)
+ */
+
+static inline void load_yuy2_avx2(const uint8_t * src,
+                                  __m128i * y, __m128i * u, __m128i * v)
+  {
+  const __m128i mask = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14,
+                                     1, 5, 9, 13, 3, 7, 11, 15);
+  __m128i a, b, uv;
+
+  /* y y y y y y y y u u u u v v v v */
+  a = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)src), mask);
+  b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src+16)), mask);
+
+  *y = _mm_unpacklo_epi64(a, b);
+  uv = _mm_unpackhi_epi32(a, b);
+  *u = uv;
+  *v = _mm_srli_si128(uv, 8);
+  }
+
+static inline void load_uyvy_avx2(const uint8_t * src,
+                                  __m128i * y, __m128i * u, __m128i * v)
+  {
+  const __m128i mask = _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15,
+                                     0, 4, 8, 12, 2, 6, 10, 14);
+  __m128i a, b, uv;
+
+  a = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)src), mask);
+  b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src+16)), mask);
+
+  *y = _mm_unpacklo_epi64(a, b);
+  uv = _mm_unpackhi_epi32(a, b);
+  *u = uv;
+  *v = _mm_srli_si128(uv, 8);
+  }
+
+/* u and v in the lower 8 bytes */
+
+static inline void store_yuy2_avx2(uint8_t * dst,
+                                   __m128i y, __m128i u, __m128i v)
+  {
+  __m128i uv = _mm_unpacklo_epi8(u, v);
+  _mm_storeu_si128((__m128i*)dst,      _mm_unpacklo_epi8(y, uv));
+  _mm_storeu_si128((__m128i*)(dst+16), _mm_unpackhi_epi8(y, uv));
+  }
+
+static inline void store_uyvy_avx2(uint8_t * dst,
+                                   __m128i y, __m128i u, __m128i v)
+  {
+  __m128i uv = _mm_unpacklo_epi8(u, v);
+  _mm_storeu_si128((__m128i*)dst,      _mm_unpacklo_epi8(uv, y));
+  _mm_storeu_si128((__m128i*)(dst+16), _mm_unpackhi_epi8(uv, y));
+  }
@@ -0,0 +1,300 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <video.h>
+#include <blend.h>
+
+#include <immintrin.h>
+
+/*
+ *  AVX2 blenders, identical to the C ones (see blend_sse2.c).
+ *  Packed RGB is blended 8 pixels at once, 24 bit pixels are expanded
+ *  to 32 bit with pshufb.
+ */
+
+#define BLEND_8(s, d, a) \
+  d = (((s - d) * a)>>8) + d;
+
+static inline __m256i blend_16(__m256i d, __m256i s, __m256i a)
+  {
+  return
+    _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(d, _mm256_sub_epi16(_mm256_set1_epi16(256), a)),
+                                       _mm256_mullo_epi16(s, a)), 8);
+  }
+
+/* 8 pixels of RGBA_32 over RGBX or BGRX. The 4th destination byte
+   is left unchanged */
+
+static inline __m256i blend_rgbx_32(__m256i d, __m256i o, int bgr)
+  {
+  __m256i zero, mask, d_16, o_16, a_16, ret[2];
+  int i;
+
+  zero = _mm256_setzero_si256();
+  mask = _mm256_set1_epi64x(0x0000ffffffffffffLL);
+
+  for(i = 0; i < 2; i++)
+    {
+    if(!i)
+      {
+      d_16 = _mm256_unpacklo_epi8(d, zero);
+      o_16 = _mm256_unpacklo_epi8(o, zero);
+      }
+    else
+      {
+      d_16 = _mm256_unpackhi_epi8(d, zero);
+      o_16 = _mm256_unpackhi_epi8(o, zero);
+      }
+    
+    a_16 = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(o_16, _MM_SHUFFLE(3, 3, 3, 3)),
+                                  _MM_SHUFFLE(3, 3, 3, 3));
+    a_16 = _mm256_and_si256(a_16, mask);
+
+    if(bgr)
+      o_16 = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(o_16, _MM_SHUFFLE(3, 0, 1, 2)),
+                                    _MM_SHUFFLE(3, 0, 1, 2));
+    
+    ret[i] = blend_16(d_16, o_16, a_16);
+    }
+  return _mm256_packus_epi16(ret[0], ret[1]);
+  }
+
+static inline void blend_pixel(uint8_t * dst_ptr, const uint8_t * ovl_ptr,
+                               int bgr)
+  {
+  int tmp;
+  
+  tmp = dst_ptr[bgr ? 2 : 0];
+  BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
+  dst_ptr[bgr ? 2 : 0] = tmp;
+  
+  tmp = dst_ptr[1];
+  BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
+  dst_ptr[1] = tmp;
+  
+  tmp = dst_ptr[bgr ? 0 : 2];
+  BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
+  dst_ptr[bgr ? 0 : 2] = tmp;
+  }
+
+static void blend_rgbx_32_avx2(gavl_overlay_blend_context_t * ctx,
+                               gavl_video_frame_t * frame,
+                               gavl_video_frame_t * overlay, int bgr)
+  {
+  int i, j;
+  uint8_t * ovl_ptr;
+  uint8_t * dst_ptr;
+  
+  for(i = 0; i < ctx->blend_rect.h; i++)
+    {
+    ovl_ptr = overlay->planes[0] + i * overlay->strides[0];
+    dst_ptr = frame->planes[0] + i * frame->strides[0];
+    
+    for(j = 0; j + 8 <= ctx->blend_rect.w; j += 8)
+      {
+      _mm256_storeu_si256((__m256i*)dst_ptr,
+                          blend_rgbx_32(_mm256_loadu_si256((const __m256i*)dst_ptr),
+                                        _mm256_loadu_si256((const __m256i*)ovl_ptr), bgr));
+      ovl_ptr += 32;
+      dst_ptr += 32;
+      }
+
+    for(; j < ctx->blend_rect.w; j++)
+      {
+      blend_pixel(dst_ptr, ovl_ptr, bgr);
+      ovl_ptr += 4;
+      dst_ptr += 4;
+      }
+    }
+  }
+
+static void blend_rgb_24_avx2_func(gavl_overlay_blend_context_t * ctx,
+                                   gavl_video_frame_t * frame,
+                                   gavl_video_frame_t * overlay, int bgr)
+  {
+  int i, j;
+  uint8_t * ovl_ptr;
+  uint8_t * dst_ptr;
+  __m128i expand_lo, expand_hi, pack, lo, hi;
+  __m256i d;
+
+  /* Pixels 0-3 are at bytes 0-11 of the first load, pixels 4-7 are
+     at bytes 4-15 of the second load (starting at byte 8) */
+  expand_lo = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                            6, 7, 8, -1, 9, 10, 11, -1);
+  expand_hi = _mm_setr_epi8(4, 5, 6, -1, 7, 8, 9, -1,
+                            10, 11, 12, -1, 13, 14, 15, -1);
+  pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9,
+                       10, 12, 13, 14, -1, -1, -1, -1);
+  
+  for(i = 0; i < ctx->blend_rect.h; i++)
+    {
+    ovl_ptr = overlay->planes[0] + i * overlay->strides[0];
+    dst_ptr = frame->planes[0] + i * frame->strides[0];
+    
+    for(j = 0; j + 8 <= ctx->blend_rect.w; j += 8)
+      {
+      lo = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)dst_ptr), expand_lo);
+      hi = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(dst_ptr + 8)), expand_hi);
+
+      d = blend_rgbx_32(_mm256_set_m128i(hi, lo),
+                        _mm256_loadu_si256((const __m256i*)ovl_ptr), bgr);
+
+      lo = _mm_shuffle_epi8(_mm256_castsi256_si128(d), pack);
+      hi = _mm_shuffle_epi8(_mm256_extracti128_si256(d, 1), pack);
+
+      _mm_storeu_si128((__m128i*)dst_ptr,
+                       _mm_or_si128(lo, _mm_slli_si128(hi, 12)));
+      _mm_storel_epi64((__m128i*)(dst_ptr + 16), _mm_srli_si128(hi, 4));
+      
+      ovl_ptr += 32;
+      dst_ptr += 24;
+      }
+
+    for(; j < ctx->blend_rect.w; j++)
+      {
+      blend_pixel(dst_ptr, ovl_ptr, bgr);
+      ovl_ptr += 4;
+      dst_ptr += 3;
+      }
+    }
+  }
+
+/* ovl: GAVL_RGBA_32 */
+
+static void blend_rgb_24_avx2(gavl_overlay_blend_context_t * ctx,
+                              gavl_video_frame_t * frame,
+                              gavl_video_frame_t * overlay)
+  {
+  blend_rgb_24_avx2_func(ctx, frame, overlay, 0);
+  }
+
+/* ovl: GAVL_RGBA_32 */
+
+static void blend_bgr_24_avx2(gavl_overlay_blend_context_t * ctx,
+                              gavl_video_frame_t * frame,
+                              gavl_video_frame_t * overlay)
+  {
+  blend_rgb_24_avx2_func(ctx, frame, overlay, 1);
+  }
+
+/* ovl: GAVL_RGBA_32 */
+
+static void blend_rgb_32_avx2(gavl_overlay_blend_context_t * ctx,
+                              gavl_video_frame_t * frame,
+                              gavl_video_frame_t * overlay)
+  {
+  blend_rgbx_32_avx2(ctx, frame, overlay, 0);
+  }
+
+/* ovl: GAVL_RGBA_32 */
+
+static void blend_bgr_32_avx2(gavl_overlay_blend_context_t * ctx,
+                              gavl_video_frame_t * frame,
+                              gavl_video_frame_t * overlay)
+  {
+  blend_rgbx_32_avx2(ctx, frame, overlay, 1);
+  }
+
+/* Planar 8 bit YUV with the premultiplied overlay (see blend_c.c) */
+
+static void blend_yuv_planar_8_avx2(gavl_overlay_blend_context_t * ctx,
+                                    gavl_video_frame_t * frame,
+                                    gavl_video_frame_t * overlay)
+  {
+  int i, j, plane, sub_h, sub_v, w, h, offset;
+  const uint16_t * sa;
+  const uint16_t * ia;
+  uint8_t * dst_ptr;
+  __m256i lo, hi;
+  
+  for(plane = 0; plane < 3; plane++)
+    {
+    sub_h = plane ? ctx->dst_sub_h : 1;
+    sub_v = plane ? ctx->dst_sub_v : 1;
+
+    w = ctx->blend_rect.w / sub_h;
+    h = ctx->blend_rect.h / sub_v;
+
+    offset = (ctx->blend_rect.y / sub_v) * ctx->pm_stride[plane] +
+      ctx->blend_rect.x / sub_h;
+    sa = ctx->pm_sa[plane] + offset;
+    ia = ctx->pm_ia[plane] + offset;
+    dst_ptr = frame->planes[plane];
+    
+    for(i = 0; i < h; i++)
+      {
+      for(j = 0; j + 32 <= w; j += 32)
+        {
+        lo = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(dst_ptr + j)));
+        hi = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(dst_ptr + j + 16)));
+
+        lo = _mm256_add_epi16(_mm256_mullo_epi16(lo, _mm256_loadu_si256((const __m256i*)(ia + j))),
+                              _mm256_loadu_si256((const __m256i*)(sa + j)));
+        hi = _mm256_add_epi16(_mm256_mullo_epi16(hi, _mm256_loadu_si256((const __m256i*)(ia + j + 16))),
+                              _mm256_loadu_si256((const __m256i*)(sa + j + 16)));
+
+        lo = _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8));
+        _mm256_storeu_si256((__m256i*)(dst_ptr + j),
+                            _mm256_permute4x64_epi64(lo, _MM_SHUFFLE(3, 1, 2, 0)));
+        }
+
+      for(; j < w; j++)
+        dst_ptr[j] = (dst_ptr[j] * ia[j] + sa[j]) >> 8;
+      
+      sa += ctx->pm_stride[plane];
+      ia += ctx->pm_stride[plane];
+      dst_ptr += frame->strides[plane];
+      }
+    }
+  }
+
+gavl_blend_func_t
+gavl_find_blend_func_avx2(gavl_overlay_blend_context_t * ctx,
+                          gavl_pixelformat_t frame_format)
+  {
+  switch(frame_format)
+    {
+    case GAVL_RGB_24:
+      return blend_rgb_24_avx2;
+    case GAVL_BGR_24:
+      return blend_bgr_24_avx2;
+    case GAVL_RGB_32:
+      return blend_rgb_32_avx2;
+    case GAVL_BGR_32:
+      return blend_bgr_32_avx2;
+    case GAVL_YUV_420_P:
+    case GAVL_YUV_422_P:
+    case GAVL_YUV_444_P:
+    case GAVL_YUV_411_P:
+    case GAVL_YUV_410_P:
+    case GAVL_YUVJ_420_P:
+    case GAVL_YUVJ_422_P:
+    case GAVL_YUVJ_444_P:
+      return blend_yuv_planar_8_avx2;
+    default:
+      break;
+    }
+  return NULL;
+  }
@@ -0,0 +1,116 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <video.h>
+#include <deinterlace.h>
+
+#include <immintrin.h>
+
+/* AVX2 versions of the motion adaptive interpolation, identical to the C ones */
+
+#define LOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+
+static inline __m256i absdiff_epu8(__m256i a, __m256i b)
+  {
+  return _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+  }
+
+static inline __m256i absdiff_epu16(__m256i a, __m256i b)
+  {
+  return _mm256_or_si256(_mm256_subs_epu16(a, b), _mm256_subs_epu16(b, a));
+  }
+
+static void temporal_func_8_avx2(const uint8_t * t, const uint8_t * b,
+                                 const uint8_t * p1, const uint8_t * p2t,
+                                 const uint8_t * p2b, const uint8_t * p3,
+                                 uint8_t * dst, int num)
+  {
+  int i;
+  __m256i vt, vb, vp1, s, diff;
+
+  for(i = 0; i + 32 <= num; i += 32)
+    {
+    vt  = LOAD(t + i);
+    vb  = LOAD(b + i);
+    vp1 = LOAD(p1 + i);
+
+    s = _mm256_avg_epu8(vt, vb);
+    diff = _mm256_max_epu8(absdiff_epu8(vp1, LOAD(p3 + i)),
+                           _mm256_avg_epu8(absdiff_epu8(vt, LOAD(p2t + i)),
+                                           absdiff_epu8(vb, LOAD(p2b + i))));
+
+    s = _mm256_max_epu8(s, _mm256_subs_epu8(vp1, diff));
+    s = _mm256_min_epu8(s, _mm256_adds_epu8(vp1, diff));
+    _mm256_storeu_si256((__m256i*)(dst + i), s);
+    }
+
+  for(; i < num; i++)
+    dst[i] = gavl_deinterlace_temporal_pixel(t[i], b[i], p1[i],
+                                             p2t[i], p2b[i], p3[i]);
+  }
+
+static void temporal_func_16_avx2(const uint8_t * t1, const uint8_t * b1,
+                                  const uint8_t * p11, const uint8_t * p2t1,
+                                  const uint8_t * p2b1, const uint8_t * p31,
+                                  uint8_t * dst1, int num)
+  {
+  int i;
+  __m256i vt, vb, vp1, s, diff;
+  const uint16_t * t   = (const uint16_t*)t1;
+  const uint16_t * b   = (const uint16_t*)b1;
+  const uint16_t * p1  = (const uint16_t*)p11;
+  const uint16_t * p2t = (const uint16_t*)p2t1;
+  const uint16_t * p2b = (const uint16_t*)p2b1;
+  const uint16_t * p3  = (const uint16_t*)p31;
+  uint16_t * dst = (uint16_t*)dst1;
+
+  for(i = 0; i + 16 <= num; i += 16)
+    {
+    vt  = LOAD(t + i);
+    vb  = LOAD(b + i);
+    vp1 = LOAD(p1 + i);
+
+    s = _mm256_avg_epu16(vt, vb);
+    diff = _mm256_max_epu16(absdiff_epu16(vp1, LOAD(p3 + i)),
+                            _mm256_avg_epu16(absdiff_epu16(vt, LOAD(p2t + i)),
+                                             absdiff_epu16(vb, LOAD(p2b + i))));
+
+    s = _mm256_max_epu16(s, _mm256_subs_epu16(vp1, diff));
+    s = _mm256_min_epu16(s, _mm256_adds_epu16(vp1, diff));
+    _mm256_storeu_si256((__m256i*)(dst + i), s);
+    }
+
+  for(; i < num; i++)
+    dst[i] = gavl_deinterlace_temporal_pixel(t[i], b[i], p1[i],
+                                             p2t[i], p2b[i], p3[i]);
+  }
+
+void
+gavl_find_deinterlacer_temporal_funcs_avx2(gavl_video_deinterlace_temporal_func_table_t * tab,
+                                           const gavl_video_options_t * opt,
+                                           const gavl_video_format_t * format)
+  {
+  tab->func_8  = temporal_func_8_avx2;
+  tab->func_16 = temporal_func_16_avx2;
+  }
@@ -0,0 +1,493 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <audio.h>
+#include <mix.h>
+
+#include <immintrin.h>
+
+/*
+ *  AVX2 mixers (see mix_sse2.c). 32 bit samples are multiplied to
+ *  64 bit with vpmuldq, separately for the even and odd samples.
+ */
+
+#define CLAMP(x,a,b) if(x<a)x=a;if(x>b)x=b;
+
+/* Divide by 0x10000 rounding towards zero like the C version */
+
+static inline __m256i div_16(__m256i x)
+  {
+  return _mm256_srai_epi32(_mm256_add_epi32(x, _mm256_srli_epi32(_mm256_srai_epi32(x, 31), 16)), 16);
+  }
+
+/*
+ *  Divide by 0x80000000 rounding towards zero and clamp to the 32 bit
+ *  range like the C version. The results are in the low halves of the
+ *  64 bit elements.
+ */
+
+static inline __m256i div_32(__m256i x)
+  {
+  const __m256i max_v = _mm256_set1_epi64x(0x3fffffffffffffffLL);
+  const __m256i min_v = _mm256_set1_epi64x(-0x4000000000000000LL);
+
+  x = _mm256_add_epi64(x, _mm256_and_si256(_mm256_cmpgt_epi64(_mm256_setzero_si256(), x),
+                                           _mm256_set1_epi64x(0x7fffffff)));
+  x = _mm256_blendv_epi8(x, max_v, _mm256_cmpgt_epi64(x, max_v));
+  x = _mm256_blendv_epi8(x, min_v, _mm256_cmpgt_epi64(min_v, x));
+  return _mm256_srli_epi64(x, 31);
+  }
+
+static inline __m256i pack_32(__m256i even, __m256i odd)
+  {
+  return _mm256_blend_epi32(div_32(even), _mm256_slli_epi64(div_32(odd), 32), 0xaa);
+  }
+
+static inline __m256i factor_pair(int f1, int f2)
+  {
+  return _mm256_set1_epi32((int)(((uint32_t)f2 << 16) | (uint16_t)f1));
+  }
+
+static inline void store_float(float * dst, __m256 acc)
+  {
+  _mm256_storeu_ps(dst, _mm256_min_ps(_mm256_max_ps(acc, _mm256_set1_ps(-1.0f)),
+                                      _mm256_set1_ps(1.0f)));
+  }
+
+/* Single output channel */
+
+static void mix_float_avx2(gavl_mix_output_channel_t * channel,
+                           const gavl_audio_frame_t * input_frame,
+                           gavl_audio_frame_t * output_frame)
+  {
+  int i, j;
+  float tmp;
+  const float * src[GAVL_MAX_CHANNELS];
+  float fac[GAVL_MAX_CHANNELS];
+  __m256 acc0, acc1, f;
+  int num = input_frame->valid_samples;
+  float * dst = output_frame->channels.f[channel->index];
+
+  for(j = 0; j < channel->num_inputs; j++)
+    {
+    src[j] = input_frame->channels.f[channel->inputs[j].index];
+    fac[j] = channel->inputs[j].factor.f_float;
+    }
+
+  for(i = 0; i + 16 <= num; i += 16)
+    {
+    f = _mm256_set1_ps(fac[0]);
+    acc0 = _mm256_mul_ps(_mm256_loadu_ps(src[0] + i), f);
+    acc1 = _mm256_mul_ps(_mm256_loadu_ps(src[0] + i + 8), f);
+
+    for(j = 1; j < channel->num_inputs; j++)
+      {
+      f = _mm256_set1_ps(fac[j]);
+      acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(src[j] + i), f));
+      acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(src[j] + i + 8), f));
+      }
+    store_float(dst + i, acc0);
+    store_float(dst + i + 8, acc1);
+    }
+
+  for(; i < num; i++)
+    {
+    tmp = src[0][i] * fac[0];
+    for(j = 1; j < channel->num_inputs; j++)
+      tmp += src[j][i] * fac[j];
+    CLAMP(tmp, -1.0f, 1.0f);
+    dst[i] = tmp;
+    }
+  }
+
+static void mix_s16_avx2(gavl_mix_output_channel_t * channel,
+                         const gavl_audio_frame_t * input_frame,
+                         gavl_audio_frame_t * output_frame)
+  {
+  int i, j, tmp, num_pairs;
+  const int16_t * src[GAVL_MAX_CHANNELS+1];
+  int fac[GAVL_MAX_CHANNELS+1];
+  __m256i f[GAVL_MAX_CHANNELS/2+1];
+  __m256i a, b, lo, hi;
+  int num = input_frame->valid_samples;
+  int16_t * dst = output_frame->channels.s_16[channel->index];
+
+  for(j = 0; j < channel->num_inputs; j++)
+    {
+    src[j] = input_frame->channels.s_16[channel->inputs[j].index];
+    fac[j] = channel->inputs[j].factor.f_int;
+    }
+
+  /* Odd number of inputs: Pad with a zero factor */
+  src[j] = src[0];
+  fac[j] = 0;
+
+  num_pairs = (channel->num_inputs + 1) / 2;
+
+  for(j = 0; j < num_pairs; j++)
+    f[j] = factor_pair(fac[2*j], fac[2*j+1]);
+
+  /* Unpacking and packing work within 128 bit lanes, so the sample
+     order is preserved */
+
+  for(i = 0; i + 16 <= num; i += 16)
+    {
+    lo = _mm256_setzero_si256();
+    hi = _mm256_setzero_si256();
+
+    for(j = 0; j < num_pairs; j++)
+      {
+      a = _mm256_loadu_si256((const __m256i*)(src[2*j] + i));
+      b = _mm256_loadu_si256((const __m256i*)(src[2*j+1] + i));
+      lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), f[j]));
+      hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), f[j]));
+      }
+    _mm256_storeu_si256((__m256i*)(dst + i),
+                        _mm256_packs_epi32(div_16(lo), div_16(hi)));
+    }
+
+  for(; i < num; i++)
+    {
+    tmp = 0;
+    for(j = 0; j < channel->num_inputs; j++)
+      tmp += src[j][i] * fac[j];
+    tmp /= 0x10000;
+    CLAMP(tmp, INT16_MIN, INT16_MAX);
+    dst[i] = tmp;
+    }
+  }
+
+static void mix_s32_avx2(gavl_mix_output_channel_t * channel,
+                         const gavl_audio_frame_t * input_frame,
+                         gavl_audio_frame_t * output_frame)
+  {
+  int i, j;
+  int64_t tmp;
+  const int32_t * src[GAVL_MAX_CHANNELS];
+  int fac[GAVL_MAX_CHANNELS];
+  __m256i even, odd, v, f;
+  int num = input_frame->valid_samples;
+  int32_t * dst = output_frame->channels.s_32[channel->index];
+
+  for(j = 0; j < channel->num_inputs; j++)
+    {
+    src[j] = input_frame->channels.s_32[channel->inputs[j].index];
+    fac[j] = channel->inputs[j].factor.f_int;
+    }
+
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    even = _mm256_setzero_si256();
+    odd = _mm256_setzero_si256();
+
+    for(j = 0; j < channel->num_inputs; j++)
+      {
+      v = _mm256_loadu_si256((const __m256i*)(src[j] + i));
+      f = _mm256_set1_epi32(fac[j]);
+      even = _mm256_add_epi64(even, _mm256_mul_epi32(v, f));
+      odd = _mm256_add_epi64(odd, _mm256_mul_epi32(_mm256_srli_epi64(v, 32), f));
+      }
+    _mm256_storeu_si256((__m256i*)(dst + i), pack_32(even, odd));
+    }
+
+  for(; i < num; i++)
+    {
+    tmp = 0;
+    for(j = 0; j < channel->num_inputs; j++)
+      tmp += (int64_t)src[j][i] * (int64_t)fac[j];
+    tmp /= 0x80000000LL;
+    CLAMP(tmp, INT32_MIN, INT32_MAX);
+    dst[i] = tmp;
+    }
+  }
+
+/* Several output channels */
+
+static void mix_group_float_avx2(const gavl_mix_group_t * g,
+                                 const gavl_audio_frame_t * input_frame,
+                                 gavl_audio_frame_t * output_frame)
+  {
+  int i, j, o;
+  float tmp;
+  const float * src[GAVL_MAX_CHANNELS+1];
+  float * dst[GAVL_MIX_GROUP_SIZE];
+  __m256 a0, a1, a2, a3, b0, b1, b2, b3;
+  __m256 f0, f1, f2, f3, v;
+  int num = input_frame->valid_samples;
+
+  for(j = 0; j < g->num_inputs; j++)
+    src[j] = input_frame->channels.f[g->inputs[j]];
+  for(o = 0; o < g->num_outputs; o++)
+    dst[o] = output_frame->channels.f[g->outputs[o]];
+
+  for(i = 0; i + 16 <= num; i += 16)
+    {
+    a0 = a1 = a2 = a3 = _mm256_setzero_ps();
+    b0 = b1 = b2 = b3 = _mm256_setzero_ps();
+
+    for(j = 0; j < g->num_inputs; j++)
+      {
+      f0 = _mm256_broadcast_ss(&g->factors.f_float[j][0]);
+      f1 = _mm256_broadcast_ss(&g->factors.f_float[j][1]);
+      f2 = _mm256_broadcast_ss(&g->factors.f_float[j][2]);
+      f3 = _mm256_broadcast_ss(&g->factors.f_float[j][3]);
+
+      v = _mm256_loadu_ps(src[j] + i);
+      a0 = _mm256_add_ps(a0, _mm256_mul_ps(v, f0));
+      a1 = _mm256_add_ps(a1, _mm256_mul_ps(v, f1));
+      a2 = _mm256_add_ps(a2, _mm256_mul_ps(v, f2));
+      a3 = _mm256_add_ps(a3, _mm256_mul_ps(v, f3));
+
+      v = _mm256_loadu_ps(src[j] + i + 8);
+      b0 = _mm256_add_ps(b0, _mm256_mul_ps(v, f0));
+      b1 = _mm256_add_ps(b1, _mm256_mul_ps(v, f1));
+      b2 = _mm256_add_ps(b2, _mm256_mul_ps(v, f2));
+      b3 = _mm256_add_ps(b3, _mm256_mul_ps(v, f3));
+      }
+
+    switch(g->num_outputs)
+      {
+      case 4:
+        store_float(dst[3] + i, a3);
+        store_float(dst[3] + i + 8, b3);
+        /* Fall through */
+      case 3:
+        store_float(dst[2] + i, a2);
+        store_float(dst[2] + i + 8, b2);
+        /* Fall through */
+      case 2:
+        store_float(dst[1] + i, a1);
+        store_float(dst[1] + i + 8, b1);
+        /* Fall through */
+      case 1:
+        store_float(dst[0] + i, a0);
+        store_float(dst[0] + i + 8, b0);
+      }
+    }
+
+  for(; i < num; i++)
+    {
+    for(o = 0; o < g->num_outputs; o++)
+      {
+      tmp = 0.0;
+      for(j = 0; j < g->num_inputs; j++)
+        tmp += src[j][i] * g->factors.f_float[j][o];
+      CLAMP(tmp, -1.0f, 1.0f);
+      dst[o][i] = tmp;
+      }
+    }
+  }
+
+static void mix_group_s16_avx2(const gavl_mix_group_t * g,
+                               const gavl_audio_frame_t * input_frame,
+                               gavl_audio_frame_t * output_frame)
+  {
+  int i, j, o, tmp;
+  const int16_t * src[GAVL_MAX_CHANNELS+1];
+  int16_t * dst[GAVL_MIX_GROUP_SIZE];
+  __m256i f[GAVL_MAX_CHANNELS/2+1][GAVL_MIX_GROUP_SIZE];
+  __m256i lo0, lo1, lo2, lo3, hi0, hi1, hi2, hi3;
+  __m256i a, b, ab;
+  int num = input_frame->valid_samples;
+
+  for(j = 0; j < g->num_inputs; j++)
+    src[j] = input_frame->channels.s_16[g->inputs[j]];
+
+  for(j = 0; j < g->num_inputs / 2; j++)
+    {
+    for(o = 0; o < GAVL_MIX_GROUP_SIZE; o++)
+      f[j][o] = factor_pair(g->factors.f_int[2*j][o],
+                            g->factors.f_int[2*j+1][o]);
+    }
+  for(o = 0; o < g->num_outputs; o++)
+    dst[o] = output_frame->channels.s_16[g->outputs[o]];
+
+  for(i = 0; i + 16 <= num; i += 16)
+    {
+    lo0 = lo1 = lo2 = lo3 = _mm256_setzero_si256();
+    hi0 = hi1 = hi2 = hi3 = _mm256_setzero_si256();
+
+    for(j = 0; j < g->num_inputs / 2; j++)
+      {
+      a = _mm256_loadu_si256((const __m256i*)(src[2*j] + i));
+      b = _mm256_loadu_si256((const __m256i*)(src[2*j+1] + i));
+
+      ab = _mm256_unpacklo_epi16(a, b);
+      lo0 = _mm256_add_epi32(lo0, _mm256_madd_epi16(ab, f[j][0]));
+      lo1 = _mm256_add_epi32(lo1, _mm256_madd_epi16(ab, f[j][1]));
+      lo2 = _mm256_add_epi32(lo2, _mm256_madd_epi16(ab, f[j][2]));
+      lo3 = _mm256_add_epi32(lo3, _mm256_madd_epi16(ab, f[j][3]));
+
+      ab = _mm256_unpackhi_epi16(a, b);
+      hi0 = _mm256_add_epi32(hi0, _mm256_madd_epi16(ab, f[j][0]));
+      hi1 = _mm256_add_epi32(hi1, _mm256_madd_epi16(ab, f[j][1]));
+      hi2 = _mm256_add_epi32(hi2, _mm256_madd_epi16(ab, f[j][2]));
+      hi3 = _mm256_add_epi32(hi3, _mm256_madd_epi16(ab, f[j][3]));
+      }
+
+    switch(g->num_outputs)
+      {
+      case 4:
+        _mm256_storeu_si256((__m256i*)(dst[3] + i),
+                            _mm256_packs_epi32(div_16(lo3), div_16(hi3)));
+        /* Fall through */
+      case 3:
+        _mm256_storeu_si256((__m256i*)(dst[2] + i),
+                            _mm256_packs_epi32(div_16(lo2), div_16(hi2)));
+        /* Fall through */
+      case 2:
+        _mm256_storeu_si256((__m256i*)(dst[1] + i),
+                            _mm256_packs_epi32(div_16(lo1), div_16(hi1)));
+        /* Fall through */
+      case 1:
+        _mm256_storeu_si256((__m256i*)(dst[0] + i),
+                            _mm256_packs_epi32(div_16(lo0), div_16(hi0)));
+      }
+    }
+
+  for(; i < num; i++)
+    {
+    for(o = 0; o < g->num_outputs; o++)
+      {
+      tmp = 0;
+      for(j = 0; j < g->num_inputs; j++)
+        tmp += src[j][i] * g->factors.f_int[j][o];
+      tmp /= 0x10000;
+      CLAMP(tmp, INT16_MIN, INT16_MAX);
+      dst[o][i] = tmp;
+      }
+    }
+  }
+
+static void mix_group_s32_avx2(const gavl_mix_group_t * g,
+                               const gavl_audio_frame_t * input_frame,
+                               gavl_audio_frame_t * output_frame)
+  {
+  int i, j, o;
+  int64_t tmp;
+  const int32_t * src[GAVL_MAX_CHANNELS+1];
+  int32_t * dst[GAVL_MIX_GROUP_SIZE];
+  __m256i e0, e1, e2, e3, o0, o1, o2, o3;
+  __m256i v, v_odd, f;
+  int num = input_frame->valid_samples;
+
+  for(j = 0; j < g->num_inputs; j++)
+    src[j] = input_frame->channels.s_32[g->inputs[j]];
+  for(o = 0; o < g->num_outputs; o++)
+    dst[o] = output_frame->channels.s_32[g->outputs[o]];
+
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    e0 = e1 = e2 = e3 = _mm256_setzero_si256();
+    o0 = o1 = o2 = o3 = _mm256_setzero_si256();
+
+    for(j = 0; j < g->num_inputs; j++)
+      {
+      v = _mm256_loadu_si256((const __m256i*)(src[j] + i));
+      v_odd = _mm256_srli_epi64(v, 32);
+
+      f = _mm256_set1_epi32(g->factors.f_int[j][0]);
+      e0 = _mm256_add_epi64(e0, _mm256_mul_epi32(v, f));
+      o0 = _mm256_add_epi64(o0, _mm256_mul_epi32(v_odd, f));
+      f = _mm256_set1_epi32(g->factors.f_int[j][1]);
+      e1 = _mm256_add_epi64(e1, _mm256_mul_epi32(v, f));
+      o1 = _mm256_add_epi64(o1, _mm256_mul_epi32(v_odd, f));
+      f = _mm256_set1_epi32(g->factors.f_int[j][2]);
+      e2 = _mm256_add_epi64(e2, _mm256_mul_epi32(v, f));
+      o2 = _mm256_add_epi64(o2, _mm256_mul_epi32(v_odd, f));
+      f = _mm256_set1_epi32(g->factors.f_int[j][3]);
+      e3 = _mm256_add_epi64(e3, _mm256_mul_epi32(v, f));
+      o3 = _mm256_add_epi64(o3, _mm256_mul_epi32(v_odd, f));
+      }
+
+    switch(g->num_outputs)
+      {
+      case 4:
+        _mm256_storeu_si256((__m256i*)(dst[3] + i), pack_32(e3, o3));
+        /* Fall through */
+      case 3:
+        _mm256_storeu_si256((__m256i*)(dst[2] + i), pack_32(e2, o2));
+        /* Fall through */
+      case 2:
+        _mm256_storeu_si256((__m256i*)(dst[1] + i), pack_32(e1, o1));
+        /* Fall through */
+      case 1:
+        _mm256_storeu_si256((__m256i*)(dst[0] + i), pack_32(e0, o0));
+      }
+    }
+
+  for(; i < num; i++)
+    {
+    for(o = 0; o < g->num_outputs; o++)
+      {
+      tmp = 0;
+      for(j = 0; j < g->num_inputs; j++)
+        tmp += (int64_t)src[j][i] * (int64_t)g->factors.f_int[j][o];
+      tmp /= 0x80000000LL;
+      CLAMP(tmp, INT32_MIN, INT32_MAX);
+      dst[o][i] = tmp;
+      }
+    }
+  }
+
+void gavl_setup_mix_funcs_avx2(gavl_mixer_table_t * t,
+                               gavl_audio_format_t * f)
+  {
+  switch(f->sample_format)
+    {
+    case GAVL_SAMPLE_S16:
+      t->mix_1_to_1 = mix_s16_avx2;
+      t->mix_2_to_1 = mix_s16_avx2;
+      t->mix_3_to_1 = mix_s16_avx2;
+      t->mix_4_to_1 = mix_s16_avx2;
+      t->mix_5_to_1 = mix_s16_avx2;
+      t->mix_6_to_1 = mix_s16_avx2;
+      t->mix_all_to_1 = mix_s16_avx2;
+      t->mix_group = mix_group_s16_avx2;
+      t->factors_16 = 1;
+      break;
+    case GAVL_SAMPLE_S32:
+      t->mix_1_to_1 = mix_s32_avx2;
+      t->mix_2_to_1 = mix_s32_avx2;
+      t->mix_3_to_1 = mix_s32_avx2;
+      t->mix_4_to_1 = mix_s32_avx2;
+      t->mix_5_to_1 = mix_s32_avx2;
+      t->mix_6_to_1 = mix_s32_avx2;
+      t->mix_all_to_1 = mix_s32_avx2;
+      t->mix_group = mix_group_s32_avx2;
+      break;
+    case GAVL_SAMPLE_FLOAT:
+      t->mix_1_to_1 = mix_float_avx2;
+      t->mix_2_to_1 = mix_float_avx2;
+      t->mix_3_to_1 = mix_float_avx2;
+      t->mix_4_to_1 = mix_float_avx2;
+      t->mix_5_to_1 = mix_float_avx2;
+      t->mix_6_to_1 = mix_float_avx2;
+      t->mix_all_to_1 = mix_float_avx2;
+      t->mix_group = mix_group_float_avx2;
+      break;
+    default:
+      break;
+    }
+  }
@@ -0,0 +1,739 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <colorspace.h>
+
+#include "avx2.h"
+
+/*
+ *  RGB -> YUV conversions for 16 pixels at once
+ */
+
+#define INIT_RGB_YUV(jpeg)            \
+  rgb_yuv_avx2_t c;                   \
+  __m128i y8, u8, v8, r8, g8, b8;     \
+  rgb_yuv_avx2_init(&c, jpeg);
+
+#define LOAD_RGB_24 load_rgb_24_avx2((const uint8_t*)src, &r8, &g8, &b8);
+#define LOAD_BGR_24 load_rgb_24_avx2((const uint8_t*)src, &b8, &g8, &r8);
+#define LOAD_RGB_32 load_rgb_32_avx2((const uint8_t*)src, &r8, &g8, &b8);
+#define LOAD_BGR_32 load_rgb_32_avx2((const uint8_t*)src, &b8, &g8, &r8);
+
+#define CONVERT_Y_16 \
+  y8 = rgb_24_to_yuv_8_avx2(&c, r8, g8, b8, NULL, NULL); \
+  _mm_storeu_si128((__m128i*)dst_y, y8);
+
+/* Chroma from the even pixels like in the C versions */
+
+#define CONVERT_YUV_SUB \
+  CONVERT_Y_16 \
+  rgb_24_to_uv_8_sub_avx2(&c, r8, g8, b8, &u8, &v8); \
+  _mm_storel_epi64((__m128i*)dst_u, u8); \
+  _mm_storel_epi64((__m128i*)dst_v, v8);
+
+#define CONVERT_YUV_444 \
+  y8 = rgb_24_to_yuv_8_avx2(&c, r8, g8, b8, &u8, &v8); \
+  _mm_storeu_si128((__m128i*)dst_y, y8); \
+  _mm_storeu_si128((__m128i*)dst_u, u8); \
+  _mm_storeu_si128((__m128i*)dst_v, v8);
+
+#define CONVERT_PACKED(store) \
+  y8 = rgb_24_to_yuv_8_avx2(&c, r8, g8, b8, NULL, NULL); \
+  rgb_24_to_uv_8_sub_avx2(&c, r8, g8, b8, &u8, &v8); \
+  store((uint8_t*)dst, y8, u8, v8);
+
+/* 16 bit planar output */
+
+#define INIT_RGB_YUV_16_SUB           \
+  rgb_yuv_avx2_t c;                   \
+  __m256i y16, uv16;                  \
+  __m128i r8, g8, b8;                 \
+  rgb_yuv_avx2_init(&c, 0);
+
+#define INIT_RGB_YUV_16_444           \
+  rgb_yuv_avx2_t c;                   \
+  __m256i y16, u16, v16;              \
+  __m128i r8, g8, b8;                 \
+  rgb_yuv_avx2_init(&c, 0);
+
+#define CONVERT_YUV_16_SUB \
+  y16 = rgb_24_to_yuv_16_avx2(&c, r8, g8, b8, NULL, NULL); \
+  _mm256_storeu_si256((__m256i*)dst_y, y16); \
+  uv16 = rgb_24_to_uv_16_sub_avx2(&c, r8, g8, b8); \
+  _mm_storeu_si128((__m128i*)dst_u, _mm256_castsi256_si128(uv16)); \
+  _mm_storeu_si128((__m128i*)dst_v, _mm256_extracti128_si256(uv16, 1));
+
+#define CONVERT_YUV_16_444 \
+  y16 = rgb_24_to_yuv_16_avx2(&c, r8, g8, b8, &u16, &v16); \
+  _mm256_storeu_si256((__m256i*)dst_y, y16); \
+  _mm256_storeu_si256((__m256i*)dst_u, u16); \
+  _mm256_storeu_si256((__m256i*)dst_v, v16);
+
+/* rgb_24_to_yuy2_avx2 */
+
+#define FUNC_NAME   rgb_24_to_yuy2_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  48
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_RGB_YUV(0)
+#define CONVERT     LOAD_RGB_24 CONVERT_PACKED(store_yuy2_avx2)
+
+#include "../csp_packed_packed.h"
+
+/* rgb_24_to_uyvy_avx2 */
+
+#define FUNC_NAME   rgb_24_to_uyvy_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  48
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_RGB_YUV(0)
+#define CONVERT     LOAD_RGB_24 CONVERT_PACKED(store_uyvy_avx2)
+
+#include "../csp_packed_packed.h"
+
+/* rgb_24_to_yuv_420_p_avx2 */
+
+#define FUNC_NAME      rgb_24_to_yuv_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_RGB_YUV(0)
+#define CONVERT_YUV    LOAD_RGB_24 CONVERT_YUV_SUB
+#define CONVERT_Y      LOAD_RGB_24 CONVERT_Y_16
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_yuv_422_p_avx2 */
+
+#define FUNC_NAME      rgb_24_to_yuv_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(0)
+#define CONVERT_YUV    LOAD_RGB_24 CONVERT_YUV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_yuv_444_p_avx2 */
+
+#define FUNC_NAME      rgb_24_to_yuv_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(0)
+#define CONVERT_YUV    LOAD_RGB_24 CONVERT_YUV_444
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_yuvj_420_p_avx2 */
+
+#define FUNC_NAME      rgb_24_to_yuvj_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_RGB_YUV(1)
+#define CONVERT_YUV    LOAD_RGB_24 CONVERT_YUV_SUB
+#define CONVERT_Y      LOAD_RGB_24 CONVERT_Y_16
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_yuvj_422_p_avx2 */
+
+#define FUNC_NAME      rgb_24_to_yuvj_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(1)
+#define CONVERT_YUV    LOAD_RGB_24 CONVERT_YUV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_yuvj_444_p_avx2 */
+
+#define FUNC_NAME      rgb_24_to_yuvj_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(1)
+#define CONVERT_YUV    LOAD_RGB_24 CONVERT_YUV_444
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_yuy2_avx2 */
+
+#define FUNC_NAME   bgr_24_to_yuy2_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  48
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_RGB_YUV(0)
+#define CONVERT     LOAD_BGR_24 CONVERT_PACKED(store_yuy2_avx2)
+
+#include "../csp_packed_packed.h"
+
+/* bgr_24_to_uyvy_avx2 */
+
+#define FUNC_NAME   bgr_24_to_uyvy_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  48
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_RGB_YUV(0)
+#define CONVERT     LOAD_BGR_24 CONVERT_PACKED(store_uyvy_avx2)
+
+#include "../csp_packed_packed.h"
+
+/* bgr_24_to_yuv_420_p_avx2 */
+
+#define FUNC_NAME      bgr_24_to_yuv_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_RGB_YUV(0)
+#define CONVERT_YUV    LOAD_BGR_24 CONVERT_YUV_SUB
+#define CONVERT_Y      LOAD_BGR_24 CONVERT_Y_16
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_yuv_422_p_avx2 */
+
+#define FUNC_NAME      bgr_24_to_yuv_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(0)
+#define CONVERT_YUV    LOAD_BGR_24 CONVERT_YUV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_yuv_444_p_avx2 */
+
+#define FUNC_NAME      bgr_24_to_yuv_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(0)
+#define CONVERT_YUV    LOAD_BGR_24 CONVERT_YUV_444
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_yuvj_420_p_avx2 */
+
+#define FUNC_NAME      bgr_24_to_yuvj_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_RGB_YUV(1)
+#define CONVERT_YUV    LOAD_BGR_24 CONVERT_YUV_SUB
+#define CONVERT_Y      LOAD_BGR_24 CONVERT_Y_16
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_yuvj_422_p_avx2 */
+
+#define FUNC_NAME      bgr_24_to_yuvj_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(1)
+#define CONVERT_YUV    LOAD_BGR_24 CONVERT_YUV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_yuvj_444_p_avx2 */
+
+#define FUNC_NAME      bgr_24_to_yuvj_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(1)
+#define CONVERT_YUV    LOAD_BGR_24 CONVERT_YUV_444
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_yuy2_avx2 */
+
+#define FUNC_NAME   rgb_32_to_yuy2_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  64
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_RGB_YUV(0)
+#define CONVERT     LOAD_RGB_32 CONVERT_PACKED(store_yuy2_avx2)
+
+#include "../csp_packed_packed.h"
+
+/* rgb_32_to_uyvy_avx2 */
+
+#define FUNC_NAME   rgb_32_to_uyvy_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  64
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_RGB_YUV(0)
+#define CONVERT     LOAD_RGB_32 CONVERT_PACKED(store_uyvy_avx2)
+
+#include "../csp_packed_packed.h"
+
+/* rgb_32_to_yuv_420_p_avx2 */
+
+#define FUNC_NAME      rgb_32_to_yuv_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_RGB_YUV(0)
+#define CONVERT_YUV    LOAD_RGB_32 CONVERT_YUV_SUB
+#define CONVERT_Y      LOAD_RGB_32 CONVERT_Y_16
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_yuv_422_p_avx2 */
+
+#define FUNC_NAME      rgb_32_to_yuv_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(0)
+#define CONVERT_YUV    LOAD_RGB_32 CONVERT_YUV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_yuv_444_p_avx2 */
+
+#define FUNC_NAME      rgb_32_to_yuv_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(0)
+#define CONVERT_YUV    LOAD_RGB_32 CONVERT_YUV_444
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_yuvj_420_p_avx2 */
+
+#define FUNC_NAME      rgb_32_to_yuvj_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_RGB_YUV(1)
+#define CONVERT_YUV    LOAD_RGB_32 CONVERT_YUV_SUB
+#define CONVERT_Y      LOAD_RGB_32 CONVERT_Y_16
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_yuvj_422_p_avx2 */
+
+#define FUNC_NAME      rgb_32_to_yuvj_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(1)
+#define CONVERT_YUV    LOAD_RGB_32 CONVERT_YUV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_yuvj_444_p_avx2 */
+
+#define FUNC_NAME      rgb_32_to_yuvj_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(1)
+#define CONVERT_YUV    LOAD_RGB_32 CONVERT_YUV_444
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_yuy2_avx2 */
+
+#define FUNC_NAME   bgr_32_to_yuy2_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  64
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_RGB_YUV(0)
+#define CONVERT     LOAD_BGR_32 CONVERT_PACKED(store_yuy2_avx2)
+
+#include "../csp_packed_packed.h"
+
+/* bgr_32_to_uyvy_avx2 */
+
+#define FUNC_NAME   bgr_32_to_uyvy_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  64
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_RGB_YUV(0)
+#define CONVERT     LOAD_BGR_32 CONVERT_PACKED(store_uyvy_avx2)
+
+#include "../csp_packed_packed.h"
+
+/* bgr_32_to_yuv_420_p_avx2 */
+
+#define FUNC_NAME      bgr_32_to_yuv_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_RGB_YUV(0)
+#define CONVERT_YUV    LOAD_BGR_32 CONVERT_YUV_SUB
+#define CONVERT_Y      LOAD_BGR_32 CONVERT_Y_16
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_yuv_422_p_avx2 */
+
+#define FUNC_NAME      bgr_32_to_yuv_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(0)
+#define CONVERT_YUV    LOAD_BGR_32 CONVERT_YUV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_yuv_444_p_avx2 */
+
+#define FUNC_NAME      bgr_32_to_yuv_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(0)
+#define CONVERT_YUV    LOAD_BGR_32 CONVERT_YUV_444
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_yuvj_420_p_avx2 */
+
+#define FUNC_NAME      bgr_32_to_yuvj_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_RGB_YUV(1)
+#define CONVERT_YUV    LOAD_BGR_32 CONVERT_YUV_SUB
+#define CONVERT_Y      LOAD_BGR_32 CONVERT_Y_16
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_yuvj_422_p_avx2 */
+
+#define FUNC_NAME      bgr_32_to_yuvj_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(1)
+#define CONVERT_YUV    LOAD_BGR_32 CONVERT_YUV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_yuvj_444_p_avx2 */
+
+#define FUNC_NAME      bgr_32_to_yuvj_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV(1)
+#define CONVERT_YUV    LOAD_BGR_32 CONVERT_YUV_444
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_yuv_422_p_16_avx2 */
+
+#define FUNC_NAME      rgb_24_to_yuv_422_p_16_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV_16_SUB
+#define CONVERT_YUV    LOAD_RGB_24 CONVERT_YUV_16_SUB
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_yuv_444_p_16_avx2 */
+
+#define FUNC_NAME      rgb_24_to_yuv_444_p_16_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV_16_444
+#define CONVERT_YUV    LOAD_RGB_24 CONVERT_YUV_16_444
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_yuv_422_p_16_avx2 */
+
+#define FUNC_NAME      bgr_24_to_yuv_422_p_16_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV_16_SUB
+#define CONVERT_YUV    LOAD_BGR_24 CONVERT_YUV_16_SUB
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_yuv_444_p_16_avx2 */
+
+#define FUNC_NAME      bgr_24_to_yuv_444_p_16_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV_16_444
+#define CONVERT_YUV    LOAD_BGR_24 CONVERT_YUV_16_444
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_yuv_422_p_16_avx2 */
+
+#define FUNC_NAME      rgb_32_to_yuv_422_p_16_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV_16_SUB
+#define CONVERT_YUV    LOAD_RGB_32 CONVERT_YUV_16_SUB
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_yuv_444_p_16_avx2 */
+
+#define FUNC_NAME      rgb_32_to_yuv_444_p_16_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV_16_444
+#define CONVERT_YUV    LOAD_RGB_32 CONVERT_YUV_16_444
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_yuv_422_p_16_avx2 */
+
+#define FUNC_NAME      bgr_32_to_yuv_422_p_16_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV_16_SUB
+#define CONVERT_YUV    LOAD_BGR_32 CONVERT_YUV_16_SUB
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_yuv_444_p_16_avx2 */
+
+#define FUNC_NAME      bgr_32_to_yuv_444_p_16_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_RGB_YUV_16_444
+#define CONVERT_YUV    LOAD_BGR_32 CONVERT_YUV_16_444
+
+#include "../csp_packed_planar.h"
+
+void gavl_init_rgb_yuv_funcs_avx2(gavl_pixelformat_function_table_t * tab,
+                                  int width, const gavl_video_options_t * opt)
+  {
+  if(width % 16)
+    return;
+
+  /* Fixed point versions, not bitexact with the C versions */
+  if(opt->quality && (opt->quality >= 3))
+    return;
+
+  tab->rgb_24_to_yuy2 = rgb_24_to_yuy2_avx2;
+  tab->rgb_24_to_uyvy = rgb_24_to_uyvy_avx2;
+  tab->rgb_24_to_yuv_420_p = rgb_24_to_yuv_420_p_avx2;
+  tab->rgb_24_to_yuv_422_p = rgb_24_to_yuv_422_p_avx2;
+  tab->rgb_24_to_yuv_444_p = rgb_24_to_yuv_444_p_avx2;
+  tab->rgb_24_to_yuvj_420_p = rgb_24_to_yuvj_420_p_avx2;
+  tab->rgb_24_to_yuvj_422_p = rgb_24_to_yuvj_422_p_avx2;
+  tab->rgb_24_to_yuvj_444_p = rgb_24_to_yuvj_444_p_avx2;
+
+  tab->bgr_24_to_yuy2 = bgr_24_to_yuy2_avx2;
+  tab->bgr_24_to_uyvy = bgr_24_to_uyvy_avx2;
+  tab->bgr_24_to_yuv_420_p = bgr_24_to_yuv_420_p_avx2;
+  tab->bgr_24_to_yuv_422_p = bgr_24_to_yuv_422_p_avx2;
+  tab->bgr_24_to_yuv_444_p = bgr_24_to_yuv_444_p_avx2;
+  tab->bgr_24_to_yuvj_420_p = bgr_24_to_yuvj_420_p_avx2;
+  tab->bgr_24_to_yuvj_422_p = bgr_24_to_yuvj_422_p_avx2;
+  tab->bgr_24_to_yuvj_444_p = bgr_24_to_yuvj_444_p_avx2;
+
+  tab->rgb_32_to_yuy2 = rgb_32_to_yuy2_avx2;
+  tab->rgb_32_to_uyvy = rgb_32_to_uyvy_avx2;
+  tab->rgb_32_to_yuv_420_p = rgb_32_to_yuv_420_p_avx2;
+  tab->rgb_32_to_yuv_422_p = rgb_32_to_yuv_422_p_avx2;
+  tab->rgb_32_to_yuv_444_p = rgb_32_to_yuv_444_p_avx2;
+  tab->rgb_32_to_yuvj_420_p = rgb_32_to_yuvj_420_p_avx2;
+  tab->rgb_32_to_yuvj_422_p = rgb_32_to_yuvj_422_p_avx2;
+  tab->rgb_32_to_yuvj_444_p = rgb_32_to_yuvj_444_p_avx2;
+
+  tab->bgr_32_to_yuy2 = bgr_32_to_yuy2_avx2;
+  tab->bgr_32_to_uyvy = bgr_32_to_uyvy_avx2;
+  tab->bgr_32_to_yuv_420_p = bgr_32_to_yuv_420_p_avx2;
+  tab->bgr_32_to_yuv_422_p = bgr_32_to_yuv_422_p_avx2;
+  tab->bgr_32_to_yuv_444_p = bgr_32_to_yuv_444_p_avx2;
+  tab->bgr_32_to_yuvj_420_p = bgr_32_to_yuvj_420_p_avx2;
+  tab->bgr_32_to_yuvj_422_p = bgr_32_to_yuvj_422_p_avx2;
+  tab->bgr_32_to_yuvj_444_p = bgr_32_to_yuvj_444_p_avx2;
+
+  tab->rgb_24_to_yuv_422_p_16 = rgb_24_to_yuv_422_p_16_avx2;
+  tab->rgb_24_to_yuv_444_p_16 = rgb_24_to_yuv_444_p_16_avx2;
+  tab->bgr_24_to_yuv_422_p_16 = bgr_24_to_yuv_422_p_16_avx2;
+  tab->bgr_24_to_yuv_444_p_16 = bgr_24_to_yuv_444_p_16_avx2;
+  tab->rgb_32_to_yuv_422_p_16 = rgb_32_to_yuv_422_p_16_avx2;
+  tab->rgb_32_to_yuv_444_p_16 = rgb_32_to_yuv_444_p_16_avx2;
+  tab->bgr_32_to_yuv_422_p_16 = bgr_32_to_yuv_422_p_16_avx2;
+  tab->bgr_32_to_yuv_444_p_16 = bgr_32_to_yuv_444_p_16_avx2;
+  }
@@ -0,0 +1,413 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <math.h>
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <audio.h>
+#include <sampleformat.h>
+
+#include <immintrin.h>
+
+/*
+ *  AVX2 sampleformat converters (see sampleformat_sse2.c)
+ */
+
+#define CLAMP(i, min, max) if(i<min)i=min;if(i>max)i=max;
+
+/* Conversions of arrays */
+
+static void s16_to_float(const int16_t * src, float * dst, int num)
+  {
+  int i;
+  const __m256 fac = _mm256_set1_ps(1.0 / 32768.0);
+
+  for(i = 0; i + 16 <= num; i += 16)
+    {
+    _mm256_storeu_ps(dst + i,
+                     _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i)))), fac));
+    _mm256_storeu_ps(dst + i + 8,
+                     _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i + 8)))), fac));
+    }
+  for(; i < num; i++)
+    dst[i] = (float)src[i] / 32768.0;
+  }
+
+static inline __m256i float_to_s16_8(__m256 x)
+  {
+  x = _mm256_mul_ps(x, _mm256_set1_ps(32768.0));
+  x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-32768.0)),
+                    _mm256_set1_ps(32767.0));
+  return _mm256_cvtps_epi32(x);
+  }
+
+/* Packing works within 128 bit lanes */
+
+static inline __m256i pack_s16(__m256i a, __m256i b)
+  {
+  return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xd8);
+  }
+
+static void float_to_s16(const float * src, int16_t * dst, int num)
+  {
+  int i;
+  long tmp;
+
+  for(i = 0; i + 16 <= num; i += 16)
+    {
+    _mm256_storeu_si256((__m256i*)(dst + i),
+                        pack_s16(float_to_s16_8(_mm256_loadu_ps(src + i)),
+                                 float_to_s16_8(_mm256_loadu_ps(src + i + 8))));
+    }
+  for(; i < num; i++)
+    {
+    tmp = lrintf(src[i] * 32768.0);
+    CLAMP(tmp, -32768, 32767);
+    dst[i] = tmp;
+    }
+  }
+
+static void s32_to_float(const int32_t * src, float * dst, int num)
+  {
+  int i;
+  const __m256 fac = _mm256_set1_ps(1.0 / 2147483648.0);
+
+  for(i = 0; i + 8 <= num; i += 8)
+    _mm256_storeu_ps(dst + i,
+                     _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(src + i))), fac));
+  for(; i < num; i++)
+    dst[i] = (float)src[i] / 2147483648.0;
+  }
+
+static void float_to_s32(const float * src, int32_t * dst, int num)
+  {
+  int i;
+  int64_t tmp;
+  __m256 x;
+  const __m256 fac = _mm256_set1_ps(2147483648.0);
+  
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    x = _mm256_mul_ps(_mm256_loadu_ps(src + i), fac);
+    _mm256_storeu_si256((__m256i*)(dst + i),
+                        _mm256_xor_si256(_mm256_cvtps_epi32(x),
+                                         _mm256_castps_si256(_mm256_cmp_ps(x, fac, _CMP_GE_OQ))));
+    }
+  for(; i < num; i++)
+    {
+    tmp = llrintf(src[i] * 2147483648.0);
+    CLAMP(tmp, -2147483648LL, 2147483647LL);
+    dst[i] = tmp;
+    }
+  }
+
+static void float_to_double(const float * src, double * dst, int num)
+  {
+  int i;
+
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    _mm256_storeu_pd(dst + i, _mm256_cvtps_pd(_mm_loadu_ps(src + i)));
+    _mm256_storeu_pd(dst + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(src + i + 4)));
+    }
+  for(; i < num; i++)
+    dst[i] = src[i];
+  }
+
+static void double_to_float(const double * src, float * dst, int num)
+  {
+  int i;
+
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    _mm_storeu_ps(dst + i, _mm256_cvtpd_ps(_mm256_loadu_pd(src + i)));
+    _mm_storeu_ps(dst + i + 4, _mm256_cvtpd_ps(_mm256_loadu_pd(src + i + 4)));
+    }
+  for(; i < num; i++)
+    dst[i] = src[i];
+  }
+
+/* Conversion functions for non interleaved and interleaved frames */
+
+#define CONVERT_FUNCS(name, src_type, dst_type)                        \
+static void name##_ni(gavl_audio_convert_context_t * ctx)              \
+  {                                                                     \
+  int i;                                                                \
+  for(i = 0; i < ctx->input_format.num_channels; i++)                   \
+    name(ctx->input_frame->channels.src_type[i],                        \
+         ctx->output_frame->channels.dst_type[i],                       \
+         ctx->input_frame->valid_samples);                              \
+  }                                                                     \
+                                                                        \
+static void name##_i(gavl_audio_convert_context_t * ctx)               \
+  {                                                                     \
+  name(ctx->input_frame->samples.src_type,                              \
+       ctx->output_frame->samples.dst_type,                             \
+       ctx->input_format.num_channels * ctx->input_frame->valid_samples); \
+  }
+
+CONVERT_FUNCS(s16_to_float, s_16, f)
+CONVERT_FUNCS(float_to_s16, f, s_16)
+CONVERT_FUNCS(s32_to_float, s_32, f)
+CONVERT_FUNCS(float_to_s32, f, s_32)
+CONVERT_FUNCS(float_to_double, f, d)
+CONVERT_FUNCS(double_to_float, d, f)
+
+/* Conversion and interleaving in one pass */
+
+static void convert_s16_i_to_float_ni_stereo(gavl_audio_convert_context_t * ctx)
+  {
+  int i;
+  __m256i v;
+  const __m256 fac = _mm256_set1_ps(1.0 / 32768.0);
+  const int16_t * src = ctx->input_frame->samples.s_16;
+  float * dst1 = ctx->output_frame->channels.f[0];
+  float * dst2 = ctx->output_frame->channels.f[1];
+  int num = ctx->input_frame->valid_samples;
+
+  /* Each 32 bit element is one stereo sample */
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    v = _mm256_loadu_si256((const __m256i*)(src + 2 * i));
+    _mm256_storeu_ps(dst1 + i,
+                     _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16)), fac));
+    _mm256_storeu_ps(dst2 + i,
+                     _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(v, 16)), fac));
+    }
+  for(; i < num; i++)
+    {
+    dst1[i] = (float)src[2*i] / 32768.0;
+    dst2[i] = (float)src[2*i+1] / 32768.0;
+    }
+  }
+
+static void convert_float_ni_to_s16_i_stereo(gavl_audio_convert_context_t * ctx)
+  {
+  int i;
+  long tmp;
+  __m256i v;
+  const float * src1 = ctx->input_frame->channels.f[0];
+  const float * src2 = ctx->input_frame->channels.f[1];
+  int16_t * dst = ctx->output_frame->samples.s_16;
+  int num = ctx->input_frame->valid_samples;
+
+  /* Interleave the 4 left and 4 right samples within each 128 bit lane */
+  const __m256i shuffle = _mm256_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11,
+                                           4, 5, 12, 13, 6, 7, 14, 15,
+                                           0, 1, 8, 9, 2, 3, 10, 11,
+                                           4, 5, 12, 13, 6, 7, 14, 15);
+  
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    v = _mm256_packs_epi32(float_to_s16_8(_mm256_loadu_ps(src1 + i)),
+                           float_to_s16_8(_mm256_loadu_ps(src2 + i)));
+    _mm256_storeu_si256((__m256i*)(dst + 2 * i), _mm256_shuffle_epi8(v, shuffle));
+    }
+  for(; i < num; i++)
+    {
+    tmp = lrintf(src1[i] * 32768.0);
+    CLAMP(tmp, -32768, 32767);
+    dst[2*i] = tmp;
+    tmp = lrintf(src2[i] * 32768.0);
+    CLAMP(tmp, -32768, 32767);
+    dst[2*i+1] = tmp;
+    }
+  }
+
+/*
+ *  Packed 24 bit samples. 8 samples are loaded as 2x12 bytes into the
+ *  2 lanes and expanded to 32 bit with vpshufb. The 16 byte loads and
+ *  stores touch 4 bytes of the next sample, so we need 2 more samples
+ *  after each block.
+ */
+
+#define MASK_LANE(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p) \
+  _mm256_setr_epi8(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p, \
+                   a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p)
+
+#define UNPACK_MASK_LE \
+  MASK_LANE(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11)
+#define UNPACK_MASK_BE \
+  MASK_LANE(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9)
+
+#define PACK_MASK_LE \
+  MASK_LANE(1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1)
+#define PACK_MASK_BE \
+  MASK_LANE(3, 2, 1, 7, 6, 5, 11, 10, 9, 15, 14, 13, -1, -1, -1, -1)
+
+/* Returns the samples shifted to the upper 24 bits */
+
+static inline __m256i load_s24(const uint8_t * src, __m256i mask)
+  {
+  __m256i v;
+  v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)src)),
+                              _mm_loadu_si128((const __m128i*)(src + 12)), 1);
+  return _mm256_shuffle_epi8(v, mask);
+  }
+
+/* Stores the upper 24 bits */
+
+static inline void store_s24(uint8_t * dst, __m256i v, __m256i mask)
+  {
+  v = _mm256_shuffle_epi8(v, mask);
+  _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(v));
+  _mm_storeu_si128((__m128i*)(dst + 12), _mm256_extracti128_si256(v, 1));
+  }
+
+static inline int32_t get_s24(const uint8_t * p, int be)
+  {
+  if(be)
+    return (int32_t)(((uint32_t)p[2] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[0] << 24));
+  else
+    return (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24));
+  }
+
+static inline void put_s24(uint8_t * p, int32_t v, int be)
+  {
+  if(be)
+    {
+    p[0] = (v >> 16) & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = v & 0xff;
+    }
+  else
+    {
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+    }
+  }
+
+static inline void s24_to_s32(const uint8_t * src, int32_t * dst, int num,
+                              __m256i mask, int be)
+  {
+  int i;
+  for(i = 0; i + 10 <= num; i += 8)
+    _mm256_storeu_si256((__m256i*)(dst + i), load_s24(src + 3 * i, mask));
+  for(; i < num; i++)
+    dst[i] = get_s24(src + 3 * i, be);
+  }
+
+static inline void s24_to_float(const uint8_t * src, float * dst, int num,
+                                __m256i mask, int be)
+  {
+  int i;
+  const __m256 fac = _mm256_set1_ps(1.0 / 2147483648.0);
+  for(i = 0; i + 10 <= num; i += 8)
+    _mm256_storeu_ps(dst + i,
+                     _mm256_mul_ps(_mm256_cvtepi32_ps(load_s24(src + 3 * i, mask)), fac));
+  for(; i < num; i++)
+    dst[i] = (float)(get_s24(src + 3 * i, be) >> 8) / 8388608.0;
+  }
+
+static inline void s32_to_s24(const int32_t * src, uint8_t * dst, int num,
+                              __m256i mask, int be)
+  {
+  int i;
+  for(i = 0; i + 10 <= num; i += 8)
+    store_s24(dst + 3 * i, _mm256_loadu_si256((const __m256i*)(src + i)), mask);
+  for(; i < num; i++)
+    put_s24(dst + 3 * i, src[i] >> 8, be);
+  }
+
+static inline void float_to_s24(const float * src, uint8_t * dst, int num,
+                                __m256i mask, int be)
+  {
+  int i;
+  long tmp;
+  __m256 x;
+  const __m256 fac = _mm256_set1_ps(8388608.0);
+  const __m256 min = _mm256_set1_ps(-8388608.0);
+  const __m256 max = _mm256_set1_ps(8388607.0);
+
+  for(i = 0; i + 10 <= num; i += 8)
+    {
+    x = _mm256_mul_ps(_mm256_loadu_ps(src + i), fac);
+    x = _mm256_min_ps(_mm256_max_ps(x, min), max);
+    store_s24(dst + 3 * i, _mm256_slli_epi32(_mm256_cvtps_epi32(x), 8), mask);
+    }
+  for(; i < num; i++)
+    {
+    tmp = lrintf(src[i] * 8388608.0);
+    CLAMP(tmp, -8388608, 8388607);
+    put_s24(dst + 3 * i, tmp, be);
+    }
+  }
+
+#define S24_FUNCS(name, unpack_mask, pack_mask, be)                      \
+static void name ## _to_s32(const void * src, void * dst, int num)      \
+  {                                                                     \
+  s24_to_s32(src, dst, num, unpack_mask, be);                           \
+  }                                                                     \
+static void name ## _to_float(const void * src, void * dst, int num)    \
+  {                                                                     \
+  s24_to_float(src, dst, num, unpack_mask, be);                         \
+  }                                                                     \
+static void name ## _from_s32(const void * src, void * dst, int num)    \
+  {                                                                     \
+  s32_to_s24(src, dst, num, pack_mask, be);                             \
+  }                                                                     \
+static void name ## _from_float(const void * src, void * dst, int num)  \
+  {                                                                     \
+  float_to_s24(src, dst, num, pack_mask, be);                           \
+  }
+
+S24_FUNCS(s24le, UNPACK_MASK_LE, PACK_MASK_LE, 0)
+S24_FUNCS(s24be, UNPACK_MASK_BE, PACK_MASK_BE, 1)
+
+void gavl_init_sampleformat_funcs_avx2(gavl_sampleformat_table_t * t,
+                                       gavl_interleave_mode_t interleave_mode)
+  {
+  t->unpack[GAVL_PACKED_S24LE][GAVL_UNPACKED_S32]   = s24le_to_s32;
+  t->unpack[GAVL_PACKED_S24LE][GAVL_UNPACKED_FLOAT] = s24le_to_float;
+  t->pack[GAVL_PACKED_S24LE][GAVL_UNPACKED_S32]     = s24le_from_s32;
+  t->pack[GAVL_PACKED_S24LE][GAVL_UNPACKED_FLOAT]   = s24le_from_float;
+
+  t->unpack[GAVL_PACKED_S24BE][GAVL_UNPACKED_S32]   = s24be_to_s32;
+  t->unpack[GAVL_PACKED_S24BE][GAVL_UNPACKED_FLOAT] = s24be_to_float;
+  t->pack[GAVL_PACKED_S24BE][GAVL_UNPACKED_S32]     = s24be_from_s32;
+  t->pack[GAVL_PACKED_S24BE][GAVL_UNPACKED_FLOAT]   = s24be_from_float;
+  
+
+  if(interleave_mode == GAVL_INTERLEAVE_NONE)
+    {
+    t->convert_s16_to_float    = s16_to_float_ni;
+    t->convert_float_to_s16    = float_to_s16_ni;
+    t->convert_s32_to_float    = s32_to_float_ni;
+    t->convert_float_to_s32    = float_to_s32_ni;
+    t->convert_float_to_double = float_to_double_ni;
+    t->convert_double_to_float = double_to_float_ni;
+    }
+  else if(interleave_mode == GAVL_INTERLEAVE_ALL)
+    {
+    t->convert_s16_to_float    = s16_to_float_i;
+    t->convert_float_to_s16    = float_to_s16_i;
+    t->convert_s32_to_float    = s32_to_float_i;
+    t->convert_float_to_s32    = float_to_s32_i;
+    t->convert_float_to_double = float_to_double_i;
+    t->convert_double_to_float = double_to_float_i;
+    }
+  
+  t->convert_s16_i_to_float_ni_stereo = convert_s16_i_to_float_ni_stereo;
+  t->convert_float_ni_to_s16_i_stereo = convert_float_ni_to_s16_i_stereo;
+  }
@@ -0,0 +1,347 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/*
+ *  AVX2 horizontal scaler for any number of taps. Needs FUNC_NAME,
+ *  NUM (components per pixel), CLIP and one of TYPE_UINT8, TYPE_UINT16
+ *  or TYPE_FLOAT.
+ *
+ *  8 destination pixels are calculated at once. Source components and
+ *  coefficients are fetched with gather instructions. The gathers read
+ *  32 bits, so pixels whose source is too close to the end of the line
+ *  are done in C.
+ *
+ *  8 bit samples are scaled with the integer coefficients.
+ *  16 bit samples are scaled in single precision, because the
+ *  products with the integer coefficients don't fit into 32 bits.
+ */
+
+static void (FUNC_NAME)(gavl_video_scale_context_t * ctx, int scanline,
+                        uint8_t * dest_start)
+  {
+  int i, j, k, c, fpp;
+  int src_advance, dst_advance, last_pos;
+  const gavl_video_scale_pixel_t * pixels;
+  const uint8_t * src_start, * src;
+  uint8_t * dst;
+  __m256i idx, fidx;
+
+#ifdef TYPE_UINT8
+  const int32_t * factors;
+  __m256i acc[NUM], f;
+  int32_t tmp[NUM];
+#if NUM == 1
+  const int32_t * fac;
+  __m256i dot[8];
+#endif
+#define SAMPLE_BYTES 1
+#else
+  const float * factors;
+  __m256 acc[NUM], f;
+  float tmp[NUM];
+#if NUM == 1
+  const float * fac;
+  __m256 dot[8];
+#endif
+#ifdef TYPE_UINT16
+#define SAMPLE_BYTES 2
+#else
+#define SAMPLE_BYTES 4
+#endif
+#endif
+
+#ifdef TYPE_FLOAT
+#if CLIP
+  __m256 min_v[NUM], max_v[NUM];
+#endif
+  float res[8];
+#else
+  __m256i out[NUM], mask, min_v[NUM], max_v[NUM];
+  int min_i[NUM], max_i[NUM];
+  int32_t res[8];
+#endif
+
+#if NUM == 1
+  int num_chunks;
+  __m256i tail_mask;
+#endif
+
+  fpp = ctx->table_h.factors_per_pixel;
+  pixels = ctx->table_h.pixels;
+  src_advance = ctx->offset->src_advance;
+  dst_advance = ctx->offset->dst_advance;
+  src_start = ctx->src + scanline * ctx->src_stride;
+  dst = dest_start;
+
+  for(c = 0; c < NUM; c++)
+    {
+    k = (NUM == 1) ? ctx->plane : c;
+#ifdef TYPE_FLOAT
+#if CLIP
+    min_v[c] = _mm256_set1_ps(ctx->min_values_f[k]);
+    max_v[c] = _mm256_set1_ps(ctx->max_values_f[k]);
+#endif
+#else
+#if CLIP
+    min_i[c] = ctx->min_values_h[k];
+    max_i[c] = ctx->max_values_h[k];
+#else
+    min_i[c] = 0;
+    max_i[c] = (1 << (8 * SAMPLE_BYTES)) - 1;
+#endif
+    min_v[c] = _mm256_set1_epi32(min_i[c]);
+    max_v[c] = _mm256_set1_epi32(max_i[c]);
+#endif
+    }
+
+#ifdef TYPE_UINT8
+  factors = ctx->table_h.factors_i;
+#else
+  factors = ctx->table_h.factors_f;
+#endif
+#ifndef TYPE_FLOAT
+  mask = _mm256_set1_epi32((1 << (8 * SAMPLE_BYTES)) - 1);
+#endif
+
+  last_pos = pixels[ctx->dst_size - 1].index * src_advance;
+
+#if NUM == 1
+  /* Planar: The taps of one pixel are contiguous, so we can load
+     8 of them at once */
+  num_chunks = (fpp + 7) / 8;
+  tail_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(fpp - 8 * (num_chunks - 1)),
+                                 _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+#endif
+
+  for(i = 0; i + 8 <= ctx->dst_size; i += 8)
+    {
+#if NUM == 1
+    if(src_advance == SAMPLE_BYTES)
+      {
+      if((pixels[i+7].index + num_chunks * 8) * SAMPLE_BYTES > last_pos + fpp * SAMPLE_BYTES)
+        break;
+
+      for(k = 0; k < 8; k++)
+        {
+        src = src_start + pixels[i+k].index * SAMPLE_BYTES;
+        fac = factors + (i + k) * fpp;
+#if defined(TYPE_UINT8)
+        dot[k] = _mm256_setzero_si256();
+        for(j = 1; j < num_chunks; j++)
+          {
+          dot[k] = _mm256_add_epi32(dot[k], _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i*)fac),
+                                                               _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)src))));
+          src += 8;
+          fac += 8;
+          }
+        dot[k] = _mm256_add_epi32(dot[k], _mm256_mullo_epi32(_mm256_maskload_epi32(fac, tail_mask),
+                                                             _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)src))));
+#elif defined(TYPE_UINT16)
+        dot[k] = _mm256_setzero_ps();
+        for(j = 1; j < num_chunks; j++)
+          {
+          dot[k] = _mm256_add_ps(dot[k], _mm256_mul_ps(_mm256_loadu_ps(fac),
+                                                       _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)src)))));
+          src += 16;
+          fac += 8;
+          }
+        dot[k] = _mm256_add_ps(dot[k], _mm256_mul_ps(_mm256_maskload_ps(fac, tail_mask),
+                                                     _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)src)))));
+#else
+        dot[k] = _mm256_setzero_ps();
+        for(j = 1; j < num_chunks; j++)
+          {
+          dot[k] = _mm256_add_ps(dot[k], _mm256_mul_ps(_mm256_loadu_ps(fac),
+                                                       _mm256_loadu_ps((const float*)src)));
+          src += 32;
+          fac += 8;
+          }
+        dot[k] = _mm256_add_ps(dot[k], _mm256_mul_ps(_mm256_maskload_ps(fac, tail_mask),
+                                                     _mm256_maskload_ps((const float*)src, tail_mask)));
+#endif
+        }
+#ifdef TYPE_UINT8
+      acc[0] = hsum8_epi32(dot);
+#else
+      acc[0] = hsum8_ps(dot);
+#endif
+      }
+    else
+#endif
+      {
+      if(pixels[i+7].index * src_advance + 4 - SAMPLE_BYTES > last_pos)
+        break;
+
+      idx = _mm256_set_epi32(pixels[i+7].index, pixels[i+6].index,
+                             pixels[i+5].index, pixels[i+4].index,
+                             pixels[i+3].index, pixels[i+2].index,
+                             pixels[i+1].index, pixels[i].index);
+      idx = _mm256_mullo_epi32(idx, _mm256_set1_epi32(src_advance));
+      fidx = _mm256_mullo_epi32(_mm256_set_epi32(i+7, i+6, i+5, i+4,
+                                                 i+3, i+2, i+1, i),
+                                _mm256_set1_epi32(fpp));
+      for(c = 0; c < NUM; c++)
+#ifdef TYPE_UINT8
+        acc[c] = _mm256_setzero_si256();
+#else
+        acc[c] = _mm256_setzero_ps();
+#endif
+
+      src = src_start;
+      for(j = 0; j < fpp; j++)
+        {
+#if defined(TYPE_UINT8)
+        f = _mm256_i32gather_epi32((const int*)(factors + j), fidx, 4);
+        for(c = 0; c < NUM; c++)
+          acc[c] =
+            _mm256_add_epi32(acc[c],
+                             _mm256_mullo_epi32(f, _mm256_and_si256(_mm256_i32gather_epi32((const int*)(src + c), idx, 1), mask)));
+#elif defined(TYPE_UINT16)
+        f = _mm256_i32gather_ps(factors + j, fidx, 4);
+        for(c = 0; c < NUM; c++)
+          acc[c] =
+            _mm256_add_ps(acc[c],
+                          _mm256_mul_ps(f, _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_i32gather_epi32((const int*)(src + c * 2), idx, 1), mask))));
+#else
+        f = _mm256_i32gather_ps(factors + j, fidx, 4);
+        for(c = 0; c < NUM; c++)
+          acc[c] =
+            _mm256_add_ps(acc[c],
+                          _mm256_mul_ps(f, _mm256_i32gather_ps((const float*)(src + c * 4), idx, 1)));
+#endif
+        src += src_advance;
+        }
+      }
+
+    /* Downshift and clip */
+    for(c = 0; c < NUM; c++)
+      {
+#if defined(TYPE_FLOAT)
+#if CLIP
+      acc[c] = _mm256_min_ps(_mm256_max_ps(acc[c], min_v[c]), max_v[c]);
+#endif
+#else
+#ifdef TYPE_UINT16
+      out[c] = _mm256_cvttps_epi32(acc[c]);
+#else
+      out[c] = _mm256_srai_epi32(acc[c], SCALE_BITS);
+#endif
+      out[c] = _mm256_min_epi32(_mm256_max_epi32(out[c], min_v[c]), max_v[c]);
+#endif
+      }
+
+    /* Store */
+    if((NUM == 1) && (dst_advance == SAMPLE_BYTES))
+      {
+#if defined(TYPE_FLOAT)
+      _mm256_storeu_ps((float*)dst, acc[0]);
+#elif defined(TYPE_UINT16)
+      _mm_storeu_si128((__m128i*)dst,
+                       _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi32(out[0], out[0]), 0x08)));
+#else
+      out[0] = _mm256_packus_epi16(_mm256_packus_epi32(out[0], out[0]),
+                                   _mm256_setzero_si256());
+      out[0] = _mm256_permutevar8x32_epi32(out[0], _mm256_set_epi32(0, 0, 0, 0, 0, 0, 4, 0));
+      _mm_storel_epi64((__m128i*)dst, _mm256_castsi256_si128(out[0]));
+#endif
+      dst += 8 * SAMPLE_BYTES;
+      }
+    else
+      {
+      for(c = 0; c < NUM; c++)
+        {
+#ifdef TYPE_FLOAT
+        _mm256_storeu_ps(res, acc[c]);
+#else
+        _mm256_storeu_si256((__m256i*)res, out[c]);
+#endif
+        for(k = 0; k < 8; k++)
+          {
+#if defined(TYPE_FLOAT)
+          ((float*)(dst + k * dst_advance))[c] = res[k];
+#elif defined(TYPE_UINT16)
+          ((uint16_t*)(dst + k * dst_advance))[c] = res[k];
+#else
+          dst[k * dst_advance + c] = res[k];
+#endif
+          }
+        }
+      dst += 8 * dst_advance;
+      }
+    }
+
+  /* Remaining pixels */
+  for(; i < ctx->dst_size; i++)
+    {
+    for(c = 0; c < NUM; c++)
+      tmp[c] = 0;
+
+    src = src_start + pixels[i].index * src_advance;
+    for(j = 0; j < fpp; j++)
+      {
+      for(c = 0; c < NUM; c++)
+        {
+#if defined(TYPE_FLOAT)
+        tmp[c] += pixels[i].factor_f[j] * ((const float*)src)[c];
+#elif defined(TYPE_UINT16)
+        tmp[c] += pixels[i].factor_f[j] * (float)((const uint16_t*)src)[c];
+#else
+        tmp[c] += pixels[i].factor_i[j] * src[c];
+#endif
+        }
+      src += src_advance;
+      }
+
+    for(c = 0; c < NUM; c++)
+      {
+#if defined(TYPE_FLOAT)
+#if CLIP
+      k = (NUM == 1) ? ctx->plane : c;
+      if(tmp[c] < ctx->min_values_f[k])
+        tmp[c] = ctx->min_values_f[k];
+      if(tmp[c] > ctx->max_values_f[k])
+        tmp[c] = ctx->max_values_f[k];
+#endif
+      ((float*)dst)[c] = tmp[c];
+#elif defined(TYPE_UINT16)
+      k = (int)tmp[c];
+      if(k < min_i[c])
+        k = min_i[c];
+      if(k > max_i[c])
+        k = max_i[c];
+      ((uint16_t*)dst)[c] = k;
+#else
+      tmp[c] >>= SCALE_BITS;
+      if(tmp[c] < min_i[c])
+        tmp[c] = min_i[c];
+      if(tmp[c] > max_i[c])
+        tmp[c] = max_i[c];
+      dst[c] = tmp[c];
+#endif
+      }
+    dst += dst_advance;
+    }
+  }
+
+#undef FUNC_NAME
+#undef NUM
+#undef CLIP
+#undef SAMPLE_BYTES
@@ -0,0 +1,245 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/* AVX2 Optimized scaling (x) */
+
+#include <config.h>
+#include <attributes.h>
+
+#include <gavl/gavl.h>
+#include <video.h>
+#include <scale.h>
+
+#include <immintrin.h>
+
+/*
+ *  8 bit samples use the same 16 bit coefficients as the C version,
+ *  so the results are identical. 16 bit and float samples use the
+ *  float coefficients.
+ */
+
+/* Horizontal sums of 8 vectors, result i is the sum of v[i] */
+
+static inline __m256i hsum8_epi32(const __m256i * v)
+  {
+  __m256i h0, h1;
+  h0 = _mm256_hadd_epi32(_mm256_hadd_epi32(v[0], v[1]),
+                         _mm256_hadd_epi32(v[2], v[3]));
+  h1 = _mm256_hadd_epi32(_mm256_hadd_epi32(v[4], v[5]),
+                         _mm256_hadd_epi32(v[6], v[7]));
+  return _mm256_add_epi32(_mm256_permute2x128_si256(h0, h1, 0x20),
+                          _mm256_permute2x128_si256(h0, h1, 0x31));
+  }
+
+static inline __m256 hsum8_ps(const __m256 * v)
+  {
+  __m256 h0, h1;
+  h0 = _mm256_hadd_ps(_mm256_hadd_ps(v[0], v[1]),
+                      _mm256_hadd_ps(v[2], v[3]));
+  h1 = _mm256_hadd_ps(_mm256_hadd_ps(v[4], v[5]),
+                      _mm256_hadd_ps(v[6], v[7]));
+  return _mm256_add_ps(_mm256_permute2f128_ps(h0, h1, 0x20),
+                       _mm256_permute2f128_ps(h0, h1, 0x31));
+  }
+
+/* 8 bit */
+
+#define TYPE_UINT8
+#define SCALE_BITS 16
+
+#define FUNC_NAME scale_uint8_x_1_x_generic_avx2
+#define NUM 1
+#define CLIP 1
+#include "scale_x.h"
+
+#define FUNC_NAME scale_uint8_x_2_x_generic_avx2
+#define NUM 2
+#define CLIP 1
+#include "scale_x.h"
+
+#define FUNC_NAME scale_uint8_x_3_x_generic_avx2
+#define NUM 3
+#define CLIP 1
+#include "scale_x.h"
+
+#define FUNC_NAME scale_uint8_x_4_x_generic_avx2
+#define NUM 4
+#define CLIP 1
+#include "scale_x.h"
+
+#define FUNC_NAME scale_uint8_x_1_x_generic_noclip_avx2
+#define NUM 1
+#define CLIP 0
+#include "scale_x.h"
+
+#define FUNC_NAME scale_uint8_x_2_x_generic_noclip_avx2
+#define NUM 2
+#define CLIP 0
+#include "scale_x.h"
+
+#define FUNC_NAME scale_uint8_x_3_x_generic_noclip_avx2
+#define NUM 3
+#define CLIP 0
+#include "scale_x.h"
+
+#define FUNC_NAME scale_uint8_x_4_x_generic_noclip_avx2
+#define NUM 4
+#define CLIP 0
+#include "scale_x.h"
+
+#undef TYPE_UINT8
+#undef SCALE_BITS
+
+/* 16 bit */
+
+#define TYPE_UINT16
+
+#define FUNC_NAME scale_uint16_x_1_x_generic_avx2
+#define NUM 1
+#define CLIP 1
+#include "scale_x.h"
+
+#define FUNC_NAME scale_uint16_x_2_x_generic_avx2
+#define NUM 2
+#define CLIP 1
+#include "scale_x.h"
+
+#define FUNC_NAME scale_uint16_x_3_x_generic_avx2
+#define NUM 3
+#define CLIP 1
+#include "scale_x.h"
+
+#define FUNC_NAME scale_uint16_x_4_x_generic_avx2
+#define NUM 4
+#define CLIP 1
+#include "scale_x.h"
+
+#define FUNC_NAME scale_uint16_x_1_x_generic_noclip_avx2
+#define NUM 1
+#define CLIP 0
+#include "scale_x.h"
+
+#define FUNC_NAME scale_uint16_x_2_x_generic_noclip_avx2
+#define NUM 2
+#define CLIP 0
+#include "scale_x.h"
+
+#define FUNC_NAME scale_uint16_x_3_x_generic_noclip_avx2
+#define NUM 3
+#define CLIP 0
+#include "scale_x.h"
+
+#define FUNC_NAME scale_uint16_x_4_x_generic_noclip_avx2
+#define NUM 4
+#define CLIP 0
+#include "scale_x.h"
+
+#undef TYPE_UINT16
+
+/* Float */
+
+#define TYPE_FLOAT
+
+#define FUNC_NAME scale_float_x_1_x_generic_avx2
+#define NUM 1
+#define CLIP 1
+#include "scale_x.h"
+
+#define FUNC_NAME scale_float_x_2_x_generic_avx2
+#define NUM 2
+#define CLIP 1
+#include "scale_x.h"
+
+#define FUNC_NAME scale_float_x_3_x_generic_avx2
+#define NUM 3
+#define CLIP 1
+#include "scale_x.h"
+
+#define FUNC_NAME scale_float_x_4_x_generic_avx2
+#define NUM 4
+#define CLIP 1
+#include "scale_x.h"
+
+#define FUNC_NAME scale_float_x_1_x_generic_noclip_avx2
+#define NUM 1
+#define CLIP 0
+#include "scale_x.h"
+
+#define FUNC_NAME scale_float_x_2_x_generic_noclip_avx2
+#define NUM 2
+#define CLIP 0
+#include "scale_x.h"
+
+#define FUNC_NAME scale_float_x_3_x_generic_noclip_avx2
+#define NUM 3
+#define CLIP 0
+#include "scale_x.h"
+
+#define FUNC_NAME scale_float_x_4_x_generic_noclip_avx2
+#define NUM 4
+#define CLIP 0
+#include "scale_x.h"
+
+#undef TYPE_FLOAT
+
+void gavl_init_scale_funcs_generic_x_avx2(gavl_scale_funcs_t * tab)
+  {
+  tab->funcs_x.scale_uint8_x_1_noadvance = scale_uint8_x_1_x_generic_avx2;
+  tab->funcs_x.scale_uint8_x_1_advance   = scale_uint8_x_1_x_generic_avx2;
+  tab->funcs_x.scale_uint8_x_2           = scale_uint8_x_2_x_generic_avx2;
+  tab->funcs_x.scale_uint8_x_3           = scale_uint8_x_3_x_generic_avx2;
+  tab->funcs_x.scale_uint8_x_4           = scale_uint8_x_4_x_generic_avx2;
+  tab->funcs_x.bits_uint8_noadvance      = 16;
+  tab->funcs_x.bits_uint8_advance        = 16;
+
+  tab->funcs_x.scale_uint16_x_1 = scale_uint16_x_1_x_generic_avx2;
+  tab->funcs_x.scale_uint16_x_2 = scale_uint16_x_2_x_generic_avx2;
+  tab->funcs_x.scale_uint16_x_3 = scale_uint16_x_3_x_generic_avx2;
+  tab->funcs_x.scale_uint16_x_4 = scale_uint16_x_4_x_generic_avx2;
+  tab->funcs_x.bits_uint16      = 16;
+
+  tab->funcs_x.scale_float_x_1 = scale_float_x_1_x_generic_avx2;
+  tab->funcs_x.scale_float_x_2 = scale_float_x_2_x_generic_avx2;
+  tab->funcs_x.scale_float_x_3 = scale_float_x_3_x_generic_avx2;
+  tab->funcs_x.scale_float_x_4 = scale_float_x_4_x_generic_avx2;
+  }
+
+void gavl_init_scale_funcs_generic_x_noclip_avx2(gavl_scale_funcs_t * tab)
+  {
+  tab->funcs_x.scale_uint8_x_1_noadvance = scale_uint8_x_1_x_generic_noclip_avx2;
+  tab->funcs_x.scale_uint8_x_1_advance   = scale_uint8_x_1_x_generic_noclip_avx2;
+  tab->funcs_x.scale_uint8_x_2           = scale_uint8_x_2_x_generic_noclip_avx2;
+  tab->funcs_x.scale_uint8_x_3           = scale_uint8_x_3_x_generic_noclip_avx2;
+  tab->funcs_x.scale_uint8_x_4           = scale_uint8_x_4_x_generic_noclip_avx2;
+  tab->funcs_x.bits_uint8_noadvance      = 16;
+  tab->funcs_x.bits_uint8_advance        = 16;
+
+  tab->funcs_x.scale_uint16_x_1 = scale_uint16_x_1_x_generic_noclip_avx2;
+  tab->funcs_x.scale_uint16_x_2 = scale_uint16_x_2_x_generic_noclip_avx2;
+  tab->funcs_x.scale_uint16_x_3 = scale_uint16_x_3_x_generic_noclip_avx2;
+  tab->funcs_x.scale_uint16_x_4 = scale_uint16_x_4_x_generic_noclip_avx2;
+  tab->funcs_x.bits_uint16      = 16;
+
+  tab->funcs_x.scale_float_x_1 = scale_float_x_1_x_generic_noclip_avx2;
+  tab->funcs_x.scale_float_x_2 = scale_float_x_2_x_generic_noclip_avx2;
+  tab->funcs_x.scale_float_x_3 = scale_float_x_3_x_generic_noclip_avx2;
+  tab->funcs_x.scale_float_x_4 = scale_float_x_4_x_generic_noclip_avx2;
+  }
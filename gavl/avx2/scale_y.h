@@ -0,0 +1,234 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/*
+ *  AVX2 vertical scaler for any number of taps. Needs FUNC_NAME,
+ *  NUM (components per pixel), CLIP and one of TYPE_UINT8, TYPE_UINT16
+ *  or TYPE_FLOAT. Source and destination pixels must be packed
+ *  (advance == NUM * sample size), so a line is just an array of
+ *  components.
+ *
+ *  8 bit samples are expanded to 16 bit, and 2 taps are done at once
+ *  with pmaddwd. 16 bit samples are scaled in single precision.
+ */
+
+static void (FUNC_NAME)(gavl_video_scale_context_t * ctx, int scanline,
+                        uint8_t * dest_start)
+  {
+  int i, j, fpp, phase, num_elements, src_stride;
+  const uint8_t * src_start, * src;
+  uint8_t * dst;
+#if !defined(TYPE_FLOAT) || CLIP
+  int k;
+#endif
+
+#ifdef TYPE_UINT8
+  const int32_t * factors;
+  int32_t tmp;
+  int min_i[NUM], max_i[NUM];
+  uint8_t pattern[2][16];
+  __m256i lo, hi, a, b, f;
+  __m128i res, min_v[NUM], max_v[NUM];
+#define SAMPLE_BYTES 1
+#define VEC_ELEMENTS 16
+#else
+  const float * factors;
+  float tmp;
+  __m256 acc;
+#ifdef TYPE_UINT16
+  int min_i[NUM], max_i[NUM];
+  int32_t pattern[2][8];
+  __m256i res, min_v[NUM], max_v[NUM];
+#define SAMPLE_BYTES 2
+#else
+#if CLIP
+  float min_f[NUM], max_f[NUM], pattern[2][8];
+  __m256 min_v[NUM], max_v[NUM];
+#endif
+#define SAMPLE_BYTES 4
+#endif
+#define VEC_ELEMENTS 8
+#endif
+
+  fpp = ctx->table_v.factors_per_pixel;
+  src_stride = ctx->src_stride;
+  src_start = ctx->src + ctx->table_v.pixels[scanline].index * src_stride;
+#ifdef TYPE_UINT8
+  factors = ctx->table_v.pixels[scanline].factor_i;
+#else
+  factors = ctx->table_v.pixels[scanline].factor_f;
+#endif
+  dst = dest_start;
+
+  /* Clipping values for each component and the patterns for each
+     phase of the first vector element */
+
+#if !defined(TYPE_FLOAT) || CLIP
+  for(i = 0; i < NUM; i++)
+    {
+    k = (NUM == 1) ? ctx->plane : i;
+#ifdef TYPE_FLOAT
+    min_f[i] = ctx->min_values_f[k];
+    max_f[i] = ctx->max_values_f[k];
+#elif CLIP
+    min_i[i] = ctx->min_values_v[k];
+    max_i[i] = ctx->max_values_v[k];
+#else
+    min_i[i] = 0;
+    max_i[i] = (1 << (8 * SAMPLE_BYTES)) - 1;
+#endif
+    }
+
+  for(i = 0; i < NUM; i++)
+    {
+    for(j = 0; j < VEC_ELEMENTS; j++)
+      {
+#ifdef TYPE_FLOAT
+      pattern[0][j] = min_f[(i + j) % NUM];
+      pattern[1][j] = max_f[(i + j) % NUM];
+#else
+      pattern[0][j] = min_i[(i + j) % NUM];
+      pattern[1][j] = max_i[(i + j) % NUM];
+#endif
+      }
+#if defined(TYPE_FLOAT)
+    min_v[i] = _mm256_loadu_ps(pattern[0]);
+    max_v[i] = _mm256_loadu_ps(pattern[1]);
+#elif defined(TYPE_UINT8)
+    min_v[i] = _mm_loadu_si128((const __m128i*)pattern[0]);
+    max_v[i] = _mm_loadu_si128((const __m128i*)pattern[1]);
+#else
+    min_v[i] = _mm256_loadu_si256((const __m256i*)pattern[0]);
+    max_v[i] = _mm256_loadu_si256((const __m256i*)pattern[1]);
+#endif
+    }
+#endif
+
+  num_elements = ctx->dst_size * NUM;
+  phase = 0;
+
+  for(i = 0; i + VEC_ELEMENTS <= num_elements; i += VEC_ELEMENTS)
+    {
+    src = src_start + i * SAMPLE_BYTES;
+
+#ifdef TYPE_UINT8
+    lo = _mm256_setzero_si256();
+    hi = _mm256_setzero_si256();
+    for(j = 0; j < fpp; j += 2)
+      {
+      a = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)src));
+      if(j + 1 < fpp)
+        {
+        b = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(src + src_stride)));
+        f = COEFF_PAIR(factors[j], factors[j+1]);
+        }
+      else
+        {
+        b = _mm256_setzero_si256();
+        f = COEFF_PAIR(factors[j], 0);
+        }
+      lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), f));
+      hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), f));
+      src += 2 * src_stride;
+      }
+    res = pack_16_to_8_avx2(pack_32_to_16_avx2(lo, hi, SCALE_BITS));
+    res = _mm_min_epu8(_mm_max_epu8(res, min_v[phase]), max_v[phase]);
+    _mm_storeu_si128((__m128i*)dst, res);
+#else
+    acc = _mm256_setzero_ps();
+    for(j = 0; j < fpp; j++)
+      {
+#ifdef TYPE_UINT16
+      acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(factors[j]),
+                                             _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)src)))));
+#else
+      acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(factors[j]),
+                                             _mm256_loadu_ps((const float*)src)));
+#endif
+      src += src_stride;
+      }
+#ifdef TYPE_UINT16
+    res = _mm256_cvttps_epi32(acc);
+    res = _mm256_min_epi32(_mm256_max_epi32(res, min_v[phase]), max_v[phase]);
+    res = _mm256_permute4x64_epi64(_mm256_packus_epi32(res, res), 0x08);
+    _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(res));
+#else
+#if CLIP
+    acc = _mm256_min_ps(_mm256_max_ps(acc, min_v[phase]), max_v[phase]);
+#endif
+    _mm256_storeu_ps((float*)dst, acc);
+#endif
+#endif
+    dst += VEC_ELEMENTS * SAMPLE_BYTES;
+    phase = (phase + VEC_ELEMENTS) % NUM;
+    }
+
+  /* Remaining components */
+  for(; i < num_elements; i++)
+    {
+    src = src_start + i * SAMPLE_BYTES;
+    tmp = 0;
+    for(j = 0; j < fpp; j++)
+      {
+#if defined(TYPE_FLOAT)
+      tmp += factors[j] * *((const float*)src);
+#elif defined(TYPE_UINT16)
+      tmp += factors[j] * (float)*((const uint16_t*)src);
+#else
+      tmp += factors[j] * *src;
+#endif
+      src += src_stride;
+      }
+#if defined(TYPE_FLOAT)
+#if CLIP
+    k = i % NUM;
+    if(tmp < min_f[k])
+      tmp = min_f[k];
+    if(tmp > max_f[k])
+      tmp = max_f[k];
+#endif
+    *((float*)dst) = tmp;
+#elif defined(TYPE_UINT16)
+    j = (int)tmp;
+    k = i % NUM;
+    if(j < min_i[k])
+      j = min_i[k];
+    if(j > max_i[k])
+      j = max_i[k];
+    *((uint16_t*)dst) = j;
+#else
+    k = i % NUM;
+    tmp >>= SCALE_BITS;
+    if(tmp < min_i[k])
+      tmp = min_i[k];
+    if(tmp > max_i[k])
+      tmp = max_i[k];
+    *dst = tmp;
+#endif
+    dst += SAMPLE_BYTES;
+    }
+  }
+
+#undef FUNC_NAME
+#undef NUM
+#undef CLIP
+#undef SAMPLE_BYTES
+#undef VEC_ELEMENTS
@@ -0,0 +1,233 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/* AVX2 Optimized scaling (y) */
+
+#include <config.h>
+#include <attributes.h>
+
+#include <gavl/gavl.h>
+#include <video.h>
+#include <scale.h>
+
+#include "avx2.h"
+
+/*
+ *  8 bit samples use 14 bit coefficients, so they fit into the 16 bit
+ *  operands of pmaddwd. The results can differ by one LSB from the
+ *  C version. 16 bit and float samples use the float coefficients.
+ */
+
+/* 8 bit */
+
+#define TYPE_UINT8
+#define SCALE_BITS 14
+
+#define FUNC_NAME scale_uint8_x_1_y_generic_avx2
+#define NUM 1
+#define CLIP 1
+#include "scale_y.h"
+
+#define FUNC_NAME scale_uint8_x_2_y_generic_avx2
+#define NUM 2
+#define CLIP 1
+#include "scale_y.h"
+
+#define FUNC_NAME scale_uint8_x_3_y_generic_avx2
+#define NUM 3
+#define CLIP 1
+#include "scale_y.h"
+
+#define FUNC_NAME scale_uint8_x_4_y_generic_avx2
+#define NUM 4
+#define CLIP 1
+#include "scale_y.h"
+
+#define FUNC_NAME scale_uint8_x_1_y_generic_noclip_avx2
+#define NUM 1
+#define CLIP 0
+#include "scale_y.h"
+
+#define FUNC_NAME scale_uint8_x_2_y_generic_noclip_avx2
+#define NUM 2
+#define CLIP 0
+#include "scale_y.h"
+
+#define FUNC_NAME scale_uint8_x_3_y_generic_noclip_avx2
+#define NUM 3
+#define CLIP 0
+#include "scale_y.h"
+
+#define FUNC_NAME scale_uint8_x_4_y_generic_noclip_avx2
+#define NUM 4
+#define CLIP 0
+#include "scale_y.h"
+
+#undef TYPE_UINT8
+#undef SCALE_BITS
+
+/* 16 bit */
+
+#define TYPE_UINT16
+
+#define FUNC_NAME scale_uint16_x_1_y_generic_avx2
+#define NUM 1
+#define CLIP 1
+#include "scale_y.h"
+
+#define FUNC_NAME scale_uint16_x_2_y_generic_avx2
+#define NUM 2
+#define CLIP 1
+#include "scale_y.h"
+
+#define FUNC_NAME scale_uint16_x_3_y_generic_avx2
+#define NUM 3
+#define CLIP 1
+#include "scale_y.h"
+
+#define FUNC_NAME scale_uint16_x_4_y_generic_avx2
+#define NUM 4
+#define CLIP 1
+#include "scale_y.h"
+
+#define FUNC_NAME scale_uint16_x_1_y_generic_noclip_avx2
+#define NUM 1
+#define CLIP 0
+#include "scale_y.h"
+
+#define FUNC_NAME scale_uint16_x_2_y_generic_noclip_avx2
+#define NUM 2
+#define CLIP 0
+#include "scale_y.h"
+
+#define FUNC_NAME scale_uint16_x_3_y_generic_noclip_avx2
+#define NUM 3
+#define CLIP 0
+#include "scale_y.h"
+
+#define FUNC_NAME scale_uint16_x_4_y_generic_noclip_avx2
+#define NUM 4
+#define CLIP 0
+#include "scale_y.h"
+
+#undef TYPE_UINT16
+
+/* Float */
+
+#define TYPE_FLOAT
+
+#define FUNC_NAME scale_float_x_1_y_generic_avx2
+#define NUM 1
+#define CLIP 1
+#include "scale_y.h"
+
+#define FUNC_NAME scale_float_x_2_y_generic_avx2
+#define NUM 2
+#define CLIP 1
+#include "scale_y.h"
+
+#define FUNC_NAME scale_float_x_3_y_generic_avx2
+#define NUM 3
+#define CLIP 1
+#include "scale_y.h"
+
+#define FUNC_NAME scale_float_x_4_y_generic_avx2
+#define NUM 4
+#define CLIP 1
+#include "scale_y.h"
+
+#define FUNC_NAME scale_float_x_1_y_generic_noclip_avx2
+#define NUM 1
+#define CLIP 0
+#include "scale_y.h"
+
+#define FUNC_NAME scale_float_x_2_y_generic_noclip_avx2
+#define NUM 2
+#define CLIP 0
+#include "scale_y.h"
+
+#define FUNC_NAME scale_float_x_3_y_generic_noclip_avx2
+#define NUM 3
+#define CLIP 0
+#include "scale_y.h"
+
+#define FUNC_NAME scale_float_x_4_y_generic_noclip_avx2
+#define NUM 4
+#define CLIP 0
+#include "scale_y.h"
+
+#undef TYPE_FLOAT
+
+
+#define INIT_FUNCS(suffix)                                              \
+  if((src_advance == 1) && (dst_advance == 1))                          \
+    {                                                                   \
+    tab->funcs_y.scale_uint8_x_1_noadvance = scale_uint8_x_1_y_##suffix; \
+    tab->funcs_y.bits_uint8_noadvance = 14;                             \
+    }                                                                   \
+  else if((src_advance == 2) && (dst_advance == 2))                     \
+    {                                                                   \
+    tab->funcs_y.scale_uint8_x_2 = scale_uint8_x_2_y_##suffix;          \
+    tab->funcs_y.bits_uint8_noadvance = 14;                             \
+    tab->funcs_y.scale_uint16_x_1 = scale_uint16_x_1_y_##suffix;        \
+    tab->funcs_y.bits_uint16 = 16;                                      \
+    }                                                                   \
+  else if((src_advance == 3) && (dst_advance == 3))                     \
+    {                                                                   \
+    tab->funcs_y.scale_uint8_x_3 = scale_uint8_x_3_y_##suffix;          \
+    tab->funcs_y.bits_uint8_noadvance = 14;                             \
+    }                                                                   \
+  else if((src_advance == 4) && (dst_advance == 4))                     \
+    {                                                                   \
+    tab->funcs_y.scale_uint8_x_3 = scale_uint8_x_4_y_##suffix;          \
+    tab->funcs_y.scale_uint8_x_4 = scale_uint8_x_4_y_##suffix;          \
+    tab->funcs_y.bits_uint8_noadvance = 14;                             \
+    tab->funcs_y.scale_uint16_x_2 = scale_uint16_x_2_y_##suffix;        \
+    tab->funcs_y.bits_uint16 = 16;                                      \
+    tab->funcs_y.scale_float_x_1 = scale_float_x_1_y_##suffix;          \
+    }                                                                   \
+  else if((src_advance == 6) && (dst_advance == 6))                     \
+    {                                                                   \
+    tab->funcs_y.scale_uint16_x_3 = scale_uint16_x_3_y_##suffix;        \
+    tab->funcs_y.bits_uint16 = 16;                                      \
+    }                                                                   \
+  else if((src_advance == 8) && (dst_advance == 8))                     \
+    {                                                                   \
+    tab->funcs_y.scale_uint16_x_4 = scale_uint16_x_4_y_##suffix;        \
+    tab->funcs_y.bits_uint16 = 16;                                      \
+    tab->funcs_y.scale_float_x_2 = scale_float_x_2_y_##suffix;          \
+    }                                                                   \
+  else if((src_advance == 12) && (dst_advance == 12))                   \
+    tab->funcs_y.scale_float_x_3 = scale_float_x_3_y_##suffix;          \
+  else if((src_advance == 16) && (dst_advance == 16))                   \
+    tab->funcs_y.scale_float_x_4 = scale_float_x_4_y_##suffix;
+
+void gavl_init_scale_funcs_generic_y_avx2(gavl_scale_funcs_t * tab,
+                                          int src_advance, int dst_advance)
+  {
+  INIT_FUNCS(generic_avx2);
+  }
+
+void gavl_init_scale_funcs_generic_y_noclip_avx2(gavl_scale_funcs_t * tab,
+                                                 int src_advance, int dst_advance)
+  {
+  INIT_FUNCS(generic_noclip_avx2);
+  }
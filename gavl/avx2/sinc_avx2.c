@@ -0,0 +1,38 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <config.h>
+
+#include <immintrin.h>
+
+#include <sinc.h>
+
+/* Vectorized convolution for the sinc resampler */
+
+#define FUNC_NAME gavl_sinc_kernel_f_avx2
+#define DATA_TYPE float
+#define LOAD_DATA(d, o) _mm256_cvtps_pd(_mm_i32gather_ps(d, o, 4))
+#include "sinc_kernel.h"
+
+#define FUNC_NAME gavl_sinc_kernel_d_avx2
+#define DATA_TYPE double
+#define LOAD_DATA(d, o) _mm256_i32gather_pd(d, o, 8)
+#include "sinc_kernel.h"
@@ -0,0 +1,82 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/*
+ *  AVX2 sinc kernel (see include/sinc.h). Needs FUNC_NAME, DATA_TYPE and
+ *  LOAD_DATA(data, offsets), which returns data[offsets[0..3]] as __m256d.
+ *  The coefficients are fetched with gather instructions.
+ */
+
+double FUNC_NAME(const double * coeffs, const DATA_TYPE * data,
+                 int stride, int32_t filter_index,
+                 int32_t increment, int count)
+  {
+  int k;
+  double sum[GAVL_SINC_LANES];
+  __m128i fi, fi_step, frac_mask, idx, offsets;
+  __m256d sum_v, inv, frac, c0, c1, icoeff;
+  
+  sum_v = _mm256_setzero_pd();
+  inv = _mm256_set1_pd(1.0 / (double)(1 << GAVL_SINC_SHIFT_BITS));
+  frac_mask = _mm_set1_epi32((1 << GAVL_SINC_SHIFT_BITS) - 1);
+  
+  fi = _mm_setr_epi32(filter_index, filter_index - increment,
+                      filter_index - 2 * increment, filter_index - 3 * increment);
+  fi_step = _mm_set1_epi32(GAVL_SINC_LANES * increment);
+  offsets = _mm_setr_epi32(0, stride, 2 * stride, 3 * stride);
+  
+  for(k = 0; k + GAVL_SINC_LANES <= count; k += GAVL_SINC_LANES)
+    {
+    idx = _mm_srai_epi32(fi, GAVL_SINC_SHIFT_BITS);
+    frac = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm_and_si128(fi, frac_mask)), inv);
+
+    c0 = _mm256_i32gather_pd(coeffs, idx, 8);
+    c1 = _mm256_i32gather_pd(coeffs + 1, idx, 8);
+    
+    icoeff = _mm256_add_pd(c0, _mm256_mul_pd(frac, _mm256_sub_pd(c1, c0)));
+    sum_v = _mm256_add_pd(sum_v, _mm256_mul_pd(icoeff, LOAD_DATA(data, offsets)));
+    
+    fi = _mm_sub_epi32(fi, fi_step);
+    data += GAVL_SINC_LANES * stride;
+    filter_index -= GAVL_SINC_LANES * increment;
+    }
+  
+  _mm256_storeu_pd(sum, sum_v);
+  
+  /* Remaining taps */
+  for(; k < count; k++)
+    {
+    double fraction = (filter_index & ((1 << GAVL_SINC_SHIFT_BITS) - 1)) *
+      (1.0 / (double)(1 << GAVL_SINC_SHIFT_BITS));
+    int indx = filter_index >> GAVL_SINC_SHIFT_BITS;
+    
+    sum[k % GAVL_SINC_LANES] +=
+      (coeffs[indx] + fraction * (coeffs[indx + 1] - coeffs[indx])) * data[0];
+    
+    filter_index -= increment;
+    data += stride;
+    }
+  return (sum[0] + sum[2]) + (sum[1] + sum[3]);
+  }
+
+#undef FUNC_NAME
+#undef DATA_TYPE
+#undef LOAD_DATA
@@ -0,0 +1,891 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <colorspace.h>
+
+#include "avx2.h"
+
+/*
+ *  YUV -> RGB conversions for 16 pixels at once
+ */
+
+#define INIT_YUV_RGB(jpeg)            \
+  yuv_rgb_avx2_t c;                   \
+  __m128i y8, u8, v8, r8, g8, b8;     \
+  yuv_rgb_avx2_init(&c, jpeg);
+
+/* Chroma is horizontally subsampled by 2 */
+
+#define LOAD_PLANAR_SUB \
+  y8 = _mm_loadu_si128((const __m128i*)src_y);  \
+  u8 = _mm_loadl_epi64((const __m128i*)src_u);  \
+  v8 = _mm_loadl_epi64((const __m128i*)src_v);  \
+  u8 = _mm_unpacklo_epi8(u8, u8);               \
+  v8 = _mm_unpacklo_epi8(v8, v8);
+
+#define LOAD_PLANAR_444 \
+  y8 = _mm_loadu_si128((const __m128i*)src_y);  \
+  u8 = _mm_loadu_si128((const __m128i*)src_u);  \
+  v8 = _mm_loadu_si128((const __m128i*)src_v);
+
+#define LOAD_YUY2 \
+  load_yuy2_avx2(src, &y8, &u8, &v8); \
+  u8 = _mm_unpacklo_epi8(u8, u8);     \
+  v8 = _mm_unpacklo_epi8(v8, v8);
+
+#define LOAD_UYVY \
+  load_uyvy_avx2(src, &y8, &u8, &v8); \
+  u8 = _mm_unpacklo_epi8(u8, u8);     \
+  v8 = _mm_unpacklo_epi8(v8, v8);
+
+#define CONVERT_RGB yuv_8_to_rgb_24_avx2(&c, y8, u8, v8, &r8, &g8, &b8);
+
+/* 16 bit planar */
+
+#define INIT_YUV_16_RGB               \
+  yuv_rgb_avx2_t c;                   \
+  __m256i y16, u16, v16;              \
+  __m128i r8, g8, b8;                 \
+  yuv_rgb_avx2_init(&c, 0);
+
+#define LOAD_PLANAR_16_SUB \
+  y16 = _mm256_loadu_si256((const __m256i*)src_y);                      \
+  u16 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)src_u));  \
+  v16 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)src_v));  \
+  u16 = _mm256_or_si256(u16, _mm256_slli_epi32(u16, 16));               \
+  v16 = _mm256_or_si256(v16, _mm256_slli_epi32(v16, 16));
+
+#define LOAD_PLANAR_16_444 \
+  y16 = _mm256_loadu_si256((const __m256i*)src_y);  \
+  u16 = _mm256_loadu_si256((const __m256i*)src_u);  \
+  v16 = _mm256_loadu_si256((const __m256i*)src_v);
+
+#define CONVERT_RGB_16 yuv_16_to_rgb_24_avx2(&c, y16, u16, v16, &r8, &g8, &b8);
+
+#define STORE_RGB_24  store_rgb_24_avx2(dst, r8, g8, b8);
+#define STORE_BGR_24  store_rgb_24_avx2(dst, b8, g8, r8);
+#define STORE_RGB_32  store_rgb_32_avx2(dst, r8, g8, b8, _mm_set1_epi8(-1));
+#define STORE_BGR_32  store_rgb_32_avx2(dst, b8, g8, r8, _mm_set1_epi8(-1));
+#define STORE_RGBA_32 store_rgb_32_avx2(dst, r8, g8, b8, _mm_set1_epi8(-1));
+
+/* yuy2_to_rgb_24_avx2 */
+
+#define FUNC_NAME   yuy2_to_rgb_24_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 48
+#define NUM_PIXELS  16
+#define INIT        INIT_YUV_RGB(0)
+#define CONVERT     LOAD_YUY2 CONVERT_RGB STORE_RGB_24
+
+#include "../csp_packed_packed.h"
+
+/* yuy2_to_bgr_24_avx2 */
+
+#define FUNC_NAME   yuy2_to_bgr_24_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 48
+#define NUM_PIXELS  16
+#define INIT        INIT_YUV_RGB(0)
+#define CONVERT     LOAD_YUY2 CONVERT_RGB STORE_BGR_24
+
+#include "../csp_packed_packed.h"
+
+/* yuy2_to_rgb_32_avx2 */
+
+#define FUNC_NAME   yuy2_to_rgb_32_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 64
+#define NUM_PIXELS  16
+#define INIT        INIT_YUV_RGB(0)
+#define CONVERT     LOAD_YUY2 CONVERT_RGB STORE_RGB_32
+
+#include "../csp_packed_packed.h"
+
+/* yuy2_to_bgr_32_avx2 */
+
+#define FUNC_NAME   yuy2_to_bgr_32_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 64
+#define NUM_PIXELS  16
+#define INIT        INIT_YUV_RGB(0)
+#define CONVERT     LOAD_YUY2 CONVERT_RGB STORE_BGR_32
+
+#include "../csp_packed_packed.h"
+
+/* yuy2_to_rgba_32_avx2 */
+
+#define FUNC_NAME   yuy2_to_rgba_32_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 64
+#define NUM_PIXELS  16
+#define INIT        INIT_YUV_RGB(0)
+#define CONVERT     LOAD_YUY2 CONVERT_RGB STORE_RGBA_32
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_rgb_24_avx2 */
+
+#define FUNC_NAME   uyvy_to_rgb_24_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 48
+#define NUM_PIXELS  16
+#define INIT        INIT_YUV_RGB(0)
+#define CONVERT     LOAD_UYVY CONVERT_RGB STORE_RGB_24
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_bgr_24_avx2 */
+
+#define FUNC_NAME   uyvy_to_bgr_24_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 48
+#define NUM_PIXELS  16
+#define INIT        INIT_YUV_RGB(0)
+#define CONVERT     LOAD_UYVY CONVERT_RGB STORE_BGR_24
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_rgb_32_avx2 */
+
+#define FUNC_NAME   uyvy_to_rgb_32_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 64
+#define NUM_PIXELS  16
+#define INIT        INIT_YUV_RGB(0)
+#define CONVERT     LOAD_UYVY CONVERT_RGB STORE_RGB_32
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_bgr_32_avx2 */
+
+#define FUNC_NAME   uyvy_to_bgr_32_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 64
+#define NUM_PIXELS  16
+#define INIT        INIT_YUV_RGB(0)
+#define CONVERT     LOAD_UYVY CONVERT_RGB STORE_BGR_32
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_rgba_32_avx2 */
+
+#define FUNC_NAME   uyvy_to_rgba_32_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 64
+#define NUM_PIXELS  16
+#define INIT        INIT_YUV_RGB(0)
+#define CONVERT     LOAD_UYVY CONVERT_RGB STORE_RGBA_32
+
+#include "../csp_packed_packed.h"
+
+/* yuv_420_p_to_rgb_24_avx2 */
+
+#define FUNC_NAME     yuv_420_p_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_bgr_24_avx2 */
+
+#define FUNC_NAME     yuv_420_p_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_rgb_32_avx2 */
+
+#define FUNC_NAME     yuv_420_p_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_bgr_32_avx2 */
+
+#define FUNC_NAME     yuv_420_p_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_rgba_32_avx2 */
+
+#define FUNC_NAME     yuv_420_p_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_rgb_24_avx2 */
+
+#define FUNC_NAME     yuv_422_p_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_bgr_24_avx2 */
+
+#define FUNC_NAME     yuv_422_p_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_rgb_32_avx2 */
+
+#define FUNC_NAME     yuv_422_p_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_bgr_32_avx2 */
+
+#define FUNC_NAME     yuv_422_p_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_rgba_32_avx2 */
+
+#define FUNC_NAME     yuv_422_p_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_rgb_24_avx2 */
+
+#define FUNC_NAME     yuv_444_p_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_444 CONVERT_RGB STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_bgr_24_avx2 */
+
+#define FUNC_NAME     yuv_444_p_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_444 CONVERT_RGB STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_rgb_32_avx2 */
+
+#define FUNC_NAME     yuv_444_p_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_444 CONVERT_RGB STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_bgr_32_avx2 */
+
+#define FUNC_NAME     yuv_444_p_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_444 CONVERT_RGB STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_rgba_32_avx2 */
+
+#define FUNC_NAME     yuv_444_p_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(0)
+#define CONVERT       LOAD_PLANAR_444 CONVERT_RGB STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_rgb_24_avx2 */
+
+#define FUNC_NAME     yuvj_420_p_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_bgr_24_avx2 */
+
+#define FUNC_NAME     yuvj_420_p_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_rgb_32_avx2 */
+
+#define FUNC_NAME     yuvj_420_p_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_bgr_32_avx2 */
+
+#define FUNC_NAME     yuvj_420_p_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_rgba_32_avx2 */
+
+#define FUNC_NAME     yuvj_420_p_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_rgb_24_avx2 */
+
+#define FUNC_NAME     yuvj_422_p_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_bgr_24_avx2 */
+
+#define FUNC_NAME     yuvj_422_p_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_rgb_32_avx2 */
+
+#define FUNC_NAME     yuvj_422_p_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_bgr_32_avx2 */
+
+#define FUNC_NAME     yuvj_422_p_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_rgba_32_avx2 */
+
+#define FUNC_NAME     yuvj_422_p_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_SUB CONVERT_RGB STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_rgb_24_avx2 */
+
+#define FUNC_NAME     yuvj_444_p_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_444 CONVERT_RGB STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_bgr_24_avx2 */
+
+#define FUNC_NAME     yuvj_444_p_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_444 CONVERT_RGB STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_rgb_32_avx2 */
+
+#define FUNC_NAME     yuvj_444_p_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_444 CONVERT_RGB STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_bgr_32_avx2 */
+
+#define FUNC_NAME     yuvj_444_p_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_444 CONVERT_RGB STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_rgba_32_avx2 */
+
+#define FUNC_NAME     yuvj_444_p_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_RGB(1)
+#define CONVERT       LOAD_PLANAR_444 CONVERT_RGB STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_16_to_rgb_24_avx2 */
+
+#define FUNC_NAME     yuv_422_p_16_to_rgb_24_avx2
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_16_RGB
+#define CONVERT       LOAD_PLANAR_16_SUB CONVERT_RGB_16 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_16_to_bgr_24_avx2 */
+
+#define FUNC_NAME     yuv_422_p_16_to_bgr_24_avx2
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_16_RGB
+#define CONVERT       LOAD_PLANAR_16_SUB CONVERT_RGB_16 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_16_to_rgb_32_avx2 */
+
+#define FUNC_NAME     yuv_422_p_16_to_rgb_32_avx2
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_16_RGB
+#define CONVERT       LOAD_PLANAR_16_SUB CONVERT_RGB_16 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_16_to_bgr_32_avx2 */
+
+#define FUNC_NAME     yuv_422_p_16_to_bgr_32_avx2
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_16_RGB
+#define CONVERT       LOAD_PLANAR_16_SUB CONVERT_RGB_16 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_16_to_rgba_32_avx2 */
+
+#define FUNC_NAME     yuv_422_p_16_to_rgba_32_avx2
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_16_RGB
+#define CONVERT       LOAD_PLANAR_16_SUB CONVERT_RGB_16 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_16_to_rgb_24_avx2 */
+
+#define FUNC_NAME     yuv_444_p_16_to_rgb_24_avx2
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_16_RGB
+#define CONVERT       LOAD_PLANAR_16_444 CONVERT_RGB_16 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_16_to_bgr_24_avx2 */
+
+#define FUNC_NAME     yuv_444_p_16_to_bgr_24_avx2
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_16_RGB
+#define CONVERT       LOAD_PLANAR_16_444 CONVERT_RGB_16 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_16_to_rgb_32_avx2 */
+
+#define FUNC_NAME     yuv_444_p_16_to_rgb_32_avx2
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_16_RGB
+#define CONVERT       LOAD_PLANAR_16_444 CONVERT_RGB_16 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_16_to_bgr_32_avx2 */
+
+#define FUNC_NAME     yuv_444_p_16_to_bgr_32_avx2
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_16_RGB
+#define CONVERT       LOAD_PLANAR_16_444 CONVERT_RGB_16 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_16_to_rgba_32_avx2 */
+
+#define FUNC_NAME     yuv_444_p_16_to_rgba_32_avx2
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV_16_RGB
+#define CONVERT       LOAD_PLANAR_16_444 CONVERT_RGB_16 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+void gavl_init_yuv_rgb_funcs_avx2(gavl_pixelformat_function_table_t * tab,
+                                  int width, const gavl_video_options_t * opt)
+  {
+  if(width % 16)
+    return;
+
+  /* Fixed point versions, not bitexact with the C versions */
+  if(opt->quality && (opt->quality >= 3))
+    return;
+
+  tab->yuy2_to_rgb_24 = yuy2_to_rgb_24_avx2;
+  tab->yuy2_to_bgr_24 = yuy2_to_bgr_24_avx2;
+  tab->yuy2_to_rgb_32 = yuy2_to_rgb_32_avx2;
+  tab->yuy2_to_bgr_32 = yuy2_to_bgr_32_avx2;
+  tab->yuy2_to_rgba_32 = yuy2_to_rgba_32_avx2;
+
+  tab->uyvy_to_rgb_24 = uyvy_to_rgb_24_avx2;
+  tab->uyvy_to_bgr_24 = uyvy_to_bgr_24_avx2;
+  tab->uyvy_to_rgb_32 = uyvy_to_rgb_32_avx2;
+  tab->uyvy_to_bgr_32 = uyvy_to_bgr_32_avx2;
+  tab->uyvy_to_rgba_32 = uyvy_to_rgba_32_avx2;
+
+  tab->yuv_420_p_to_rgb_24 = yuv_420_p_to_rgb_24_avx2;
+  tab->yuv_420_p_to_bgr_24 = yuv_420_p_to_bgr_24_avx2;
+  tab->yuv_420_p_to_rgb_32 = yuv_420_p_to_rgb_32_avx2;
+  tab->yuv_420_p_to_bgr_32 = yuv_420_p_to_bgr_32_avx2;
+  tab->yuv_420_p_to_rgba_32 = yuv_420_p_to_rgba_32_avx2;
+
+  tab->yuv_422_p_to_rgb_24 = yuv_422_p_to_rgb_24_avx2;
+  tab->yuv_422_p_to_bgr_24 = yuv_422_p_to_bgr_24_avx2;
+  tab->yuv_422_p_to_rgb_32 = yuv_422_p_to_rgb_32_avx2;
+  tab->yuv_422_p_to_bgr_32 = yuv_422_p_to_bgr_32_avx2;
+  tab->yuv_422_p_to_rgba_32 = yuv_422_p_to_rgba_32_avx2;
+
+  tab->yuv_444_p_to_rgb_24 = yuv_444_p_to_rgb_24_avx2;
+  tab->yuv_444_p_to_bgr_24 = yuv_444_p_to_bgr_24_avx2;
+  tab->yuv_444_p_to_rgb_32 = yuv_444_p_to_rgb_32_avx2;
+  tab->yuv_444_p_to_bgr_32 = yuv_444_p_to_bgr_32_avx2;
+  tab->yuv_444_p_to_rgba_32 = yuv_444_p_to_rgba_32_avx2;
+
+  tab->yuvj_420_p_to_rgb_24 = yuvj_420_p_to_rgb_24_avx2;
+  tab->yuvj_420_p_to_bgr_24 = yuvj_420_p_to_bgr_24_avx2;
+  tab->yuvj_420_p_to_rgb_32 = yuvj_420_p_to_rgb_32_avx2;
+  tab->yuvj_420_p_to_bgr_32 = yuvj_420_p_to_bgr_32_avx2;
+  tab->yuvj_420_p_to_rgba_32 = yuvj_420_p_to_rgba_32_avx2;
+
+  tab->yuvj_422_p_to_rgb_24 = yuvj_422_p_to_rgb_24_avx2;
+  tab->yuvj_422_p_to_bgr_24 = yuvj_422_p_to_bgr_24_avx2;
+  tab->yuvj_422_p_to_rgb_32 = yuvj_422_p_to_rgb_32_avx2;
+  tab->yuvj_422_p_to_bgr_32 = yuvj_422_p_to_bgr_32_avx2;
+  tab->yuvj_422_p_to_rgba_32 = yuvj_422_p_to_rgba_32_avx2;
+
+  tab->yuvj_444_p_to_rgb_24 = yuvj_444_p_to_rgb_24_avx2;
+  tab->yuvj_444_p_to_bgr_24 = yuvj_444_p_to_bgr_24_avx2;
+  tab->yuvj_444_p_to_rgb_32 = yuvj_444_p_to_rgb_32_avx2;
+  tab->yuvj_444_p_to_bgr_32 = yuvj_444_p_to_bgr_32_avx2;
+  tab->yuvj_444_p_to_rgba_32 = yuvj_444_p_to_rgba_32_avx2;
+
+  tab->yuv_422_p_16_to_rgb_24 = yuv_422_p_16_to_rgb_24_avx2;
+  tab->yuv_422_p_16_to_bgr_24 = yuv_422_p_16_to_bgr_24_avx2;
+  tab->yuv_422_p_16_to_rgb_32 = yuv_422_p_16_to_rgb_32_avx2;
+  tab->yuv_422_p_16_to_bgr_32 = yuv_422_p_16_to_bgr_32_avx2;
+  tab->yuv_422_p_16_to_rgba_32 = yuv_422_p_16_to_rgba_32_avx2;
+
+  tab->yuv_444_p_16_to_rgb_24 = yuv_444_p_16_to_rgb_24_avx2;
+  tab->yuv_444_p_16_to_bgr_24 = yuv_444_p_16_to_bgr_24_avx2;
+  tab->yuv_444_p_16_to_rgb_32 = yuv_444_p_16_to_rgb_32_avx2;
+  tab->yuv_444_p_16_to_bgr_32 = yuv_444_p_16_to_bgr_32_avx2;
+  tab->yuv_444_p_16_to_rgba_32 = yuv_444_p_16_to_rgba_32_avx2;
+  }
@@ -0,0 +1,322 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <colorspace.h>
+
+#include "avx2.h"
+
+/*
+ *  YUV -> YUV conversions for 16 pixels at once. These are
+ *  bitexact with the C versions.
+ */
+
+#define INIT_YUV \
+  __m128i y8, u8, v8;
+
+/* Packed -> Planar */
+
+#define CONVERT_PACKED_YUV(load) \
+  load((const uint8_t*)src, &y8, &u8, &v8);  \
+  _mm_storeu_si128((__m128i*)dst_y, y8);     \
+  _mm_storel_epi64((__m128i*)dst_u, u8);     \
+  _mm_storel_epi64((__m128i*)dst_v, v8);
+
+#define CONVERT_PACKED_Y(load) \
+  load((const uint8_t*)src, &y8, &u8, &v8);  \
+  _mm_storeu_si128((__m128i*)dst_y, y8);
+
+/* yuy2_to_yuv_420_p_avx2 */
+
+#define FUNC_NAME      yuy2_to_yuv_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     32
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_YUV
+#define CONVERT_YUV    CONVERT_PACKED_YUV(load_yuy2_avx2)
+#define CONVERT_Y      CONVERT_PACKED_Y(load_yuy2_avx2)
+
+#include "../csp_packed_planar.h"
+
+/* yuy2_to_yuv_422_p_avx2 */
+
+#define FUNC_NAME      yuy2_to_yuv_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     32
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_YUV
+#define CONVERT_YUV    CONVERT_PACKED_YUV(load_yuy2_avx2)
+
+#include "../csp_packed_planar.h"
+
+/* uyvy_to_yuv_420_p_avx2 */
+
+#define FUNC_NAME      uyvy_to_yuv_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     32
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_YUV
+#define CONVERT_YUV    CONVERT_PACKED_YUV(load_uyvy_avx2)
+#define CONVERT_Y      CONVERT_PACKED_Y(load_uyvy_avx2)
+
+#include "../csp_packed_planar.h"
+
+/* uyvy_to_yuv_422_p_avx2 */
+
+#define FUNC_NAME      uyvy_to_yuv_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     32
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_YUV
+#define CONVERT_YUV    CONVERT_PACKED_YUV(load_uyvy_avx2)
+
+#include "../csp_packed_planar.h"
+
+/* Planar -> Packed */
+
+#define CONVERT_PLANAR(store) \
+  y8 = _mm_loadu_si128((const __m128i*)src_y); \
+  u8 = _mm_loadl_epi64((const __m128i*)src_u); \
+  v8 = _mm_loadl_epi64((const __m128i*)src_v); \
+  store((uint8_t*)dst, y8, u8, v8);
+
+/* yuv_420_p_to_yuy2_avx2 */
+
+#define FUNC_NAME     yuv_420_p_to_yuy2_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_YUV
+#define CONVERT       CONVERT_PLANAR(store_yuy2_avx2)
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_yuy2_avx2 */
+
+#define FUNC_NAME     yuv_422_p_to_yuy2_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV
+#define CONVERT       CONVERT_PLANAR(store_yuy2_avx2)
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_uyvy_avx2 */
+
+#define FUNC_NAME     yuv_420_p_to_uyvy_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_YUV
+#define CONVERT       CONVERT_PLANAR(store_uyvy_avx2)
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_uyvy_avx2 */
+
+#define FUNC_NAME     yuv_422_p_to_uyvy_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_YUV
+#define CONVERT       CONVERT_PLANAR(store_uyvy_avx2)
+
+#include "../csp_planar_packed.h"
+
+/* yuy2 <-> uyvy (swap bytes) */
+
+#define FUNC_NAME   uyvy_to_yuy2_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT \
+  const __m256i mask = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, \
+                                        9, 8, 11, 10, 13, 12, 15, 14, \
+                                        1, 0, 3, 2, 5, 4, 7, 6, \
+                                        9, 8, 11, 10, 13, 12, 15, 14);
+#define CONVERT \
+  _mm256_storeu_si256((__m256i*)dst, \
+                      _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)src), mask));
+
+#include "../csp_packed_packed.h"
+
+/* 8 <-> 16 bit planar */
+
+#define Y_16_TO_8 \
+  _mm_storeu_si128((__m128i*)dst_y, \
+                   pack_16_to_8_avx2(_mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)src_y), 8)));
+
+#define UV_16_TO_8_444 \
+  _mm_storeu_si128((__m128i*)dst_u, \
+                   pack_16_to_8_avx2(_mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)src_u), 8))); \
+  _mm_storeu_si128((__m128i*)dst_v, \
+                   pack_16_to_8_avx2(_mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)src_v), 8)));
+
+#define UV_16_TO_8_422 \
+  _mm_storel_epi64((__m128i*)dst_u, \
+                   _mm_packus_epi16(_mm_srli_epi16(_mm_loadu_si128((const __m128i*)src_u), 8), \
+                                    _mm_setzero_si128()));        \
+  _mm_storel_epi64((__m128i*)dst_v, \
+                   _mm_packus_epi16(_mm_srli_epi16(_mm_loadu_si128((const __m128i*)src_v), 8), \
+                                    _mm_setzero_si128()));
+
+#define Y_8_TO_16 \
+  _mm256_storeu_si256((__m256i*)dst_y, \
+                      _mm256_slli_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)src_y)), 8));
+
+#define UV_8_TO_16_444 \
+  _mm256_storeu_si256((__m256i*)dst_u, \
+                      _mm256_slli_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)src_u)), 8)); \
+  _mm256_storeu_si256((__m256i*)dst_v, \
+                      _mm256_slli_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)src_v)), 8));
+
+#define UV_8_TO_16_422 \
+  _mm_storeu_si128((__m128i*)dst_u, \
+                   _mm_unpacklo_epi8(_mm_setzero_si128(), _mm_loadl_epi64((const __m128i*)src_u))); \
+  _mm_storeu_si128((__m128i*)dst_v, \
+                   _mm_unpacklo_epi8(_mm_setzero_si128(), _mm_loadl_epi64((const __m128i*)src_v)));
+
+/* yuv_422_p_16_to_yuv_422_p_avx2 */
+
+#define FUNC_NAME      yuv_422_p_16_to_yuv_422_p_avx2
+#define IN_TYPE        uint16_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE_Y   16
+#define IN_ADVANCE_UV  8
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB_IN  1
+#define CHROMA_SUB_OUT 1
+#define CONVERT_YUV    Y_16_TO_8 UV_16_TO_8_422
+
+#include "../csp_planar_planar.h"
+
+/* yuv_422_p_to_yuv_422_p_16_avx2 */
+
+#define FUNC_NAME      yuv_422_p_to_yuv_422_p_16_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE_Y   16
+#define IN_ADVANCE_UV  8
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB_IN  1
+#define CHROMA_SUB_OUT 1
+#define CONVERT_YUV    Y_8_TO_16 UV_8_TO_16_422
+
+#include "../csp_planar_planar.h"
+
+/* yuv_444_p_16_to_yuv_444_p_avx2 */
+
+#define FUNC_NAME      yuv_444_p_16_to_yuv_444_p_avx2
+#define IN_TYPE        uint16_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE_Y   16
+#define IN_ADVANCE_UV  16
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB_IN  1
+#define CHROMA_SUB_OUT 1
+#define CONVERT_YUV    Y_16_TO_8 UV_16_TO_8_444
+
+#include "../csp_planar_planar.h"
+
+/* yuv_444_p_to_yuv_444_p_16_avx2 */
+
+#define FUNC_NAME      yuv_444_p_to_yuv_444_p_16_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE_Y   16
+#define IN_ADVANCE_UV  16
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB_IN  1
+#define CHROMA_SUB_OUT 1
+#define CONVERT_YUV    Y_8_TO_16 UV_8_TO_16_444
+
+#include "../csp_planar_planar.h"
+
+void gavl_init_yuv_yuv_funcs_avx2(gavl_pixelformat_function_table_t * tab,
+                                  int width, const gavl_video_options_t * opt)
+  {
+  if(width % 16)
+    return;
+
+  /* These are as good as the C versions */
+  
+  tab->yuy2_to_yuv_420_p = yuy2_to_yuv_420_p_avx2;
+  tab->yuy2_to_yuv_422_p = yuy2_to_yuv_422_p_avx2;
+  tab->uyvy_to_yuv_420_p = uyvy_to_yuv_420_p_avx2;
+  tab->uyvy_to_yuv_422_p = uyvy_to_yuv_422_p_avx2;
+
+  tab->yuv_420_p_to_yuy2 = yuv_420_p_to_yuy2_avx2;
+  tab->yuv_422_p_to_yuy2 = yuv_422_p_to_yuy2_avx2;
+  tab->yuv_420_p_to_uyvy = yuv_420_p_to_uyvy_avx2;
+  tab->yuv_422_p_to_uyvy = yuv_422_p_to_uyvy_avx2;
+
+  tab->uyvy_to_yuy2 = uyvy_to_yuy2_avx2;
+
+  tab->yuv_422_p_16_to_yuv_422_p = yuv_422_p_16_to_yuv_422_p_avx2;
+  tab->yuv_444_p_16_to_yuv_444_p = yuv_444_p_16_to_yuv_444_p_avx2;
+  tab->yuv_422_p_to_yuv_422_p_16 = yuv_422_p_to_yuv_422_p_16_avx2;
+  tab->yuv_444_p_to_yuv_444_p_16 = yuv_444_p_to_yuv_444_p_16_avx2;
+  }
@@ -23,9 +23,12 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <config.h>
+
 #include <gavl/gavl.h>
 #include <video.h>
 #include <blend.h>
+#include <accel.h>
 
 gavl_overlay_blend_context_t * gavl_overlay_blend_context_create()
   {
@@ -50,6 +53,11 @@ void gavl_overlay_blend_context_destroy(gavl_overlay_blend_context_t * ctx)
 
   if(ctx->sink)
     gavl_video_sink_destroy(ctx->sink);
+
+  if(ctx->spans)
+    free(ctx->spans);
+  if(ctx->pm_buf)
+    free(ctx->pm_buf);
   
   free(ctx);
   }
@@ -60,6 +68,189 @@ gavl_overlay_blend_context_get_options(gavl_overlay_blend_context_t * ctx)
   return &ctx->opt;
   }
 
+/*
+ *  Spans of visible pixels
+ *
+ *  Blending a pixel with zero alpha doesn't change the destination,
+ *  so we blend only the parts of the overlay window, which contain
+ *  non transparent pixels. Spans consist of whole chroma subsampling
+ *  blocks. Transparent gaps shorter than SPAN_MIN_GAP pixels are
+ *  blended anyway, and identical spans of consecutive block rows are
+ *  merged into one rectangle.
+ */
+
+#define SPAN_MIN_GAP 32
+
+/* Alpha sample types */
+#define ALPHA_8     0
+#define ALPHA_16    1
+#define ALPHA_FLOAT 2
+
+static int get_alpha_offset(gavl_pixelformat_t pfmt, int * advance,
+                            int * type)
+  {
+  switch(pfmt)
+    {
+    case GAVL_GRAYA_16:
+      *advance = 2;
+      *type = ALPHA_8;
+      return 1;
+    case GAVL_GRAYA_32:
+      *advance = 4;
+      *type = ALPHA_16;
+      return 2;
+    case GAVL_GRAYA_FLOAT:
+      *advance = 8;
+      *type = ALPHA_FLOAT;
+      return 4;
+    case GAVL_RGBA_32:
+    case GAVL_YUVA_32:
+      *advance = 4;
+      *type = ALPHA_8;
+      return 3;
+    case GAVL_RGBA_64:
+    case GAVL_YUVA_64:
+      *advance = 8;
+      *type = ALPHA_16;
+      return 6;
+    case GAVL_RGBA_FLOAT:
+    case GAVL_YUVA_FLOAT:
+      *advance = 16;
+      *type = ALPHA_FLOAT;
+      return 12;
+    default:
+      break;
+    }
+  return -1;
+  }
+
+/* Check if a block of pixels has non zero alpha */
+
+static int block_visible(const gavl_video_frame_t * frame,
+                         int x, int y, int w, int h,
+                         int alpha_offset, int advance, int type)
+  {
+  int i, j;
+  const uint8_t * ptr;
+  
+  for(i = 0; i < h; i++)
+    {
+    ptr = frame->planes[0] + (y + i) * frame->strides[0] +
+      x * advance + alpha_offset;
+    
+    for(j = 0; j < w; j++)
+      {
+      switch(type)
+        {
+        case ALPHA_8:
+          if(*ptr)
+            return 1;
+          break;
+        case ALPHA_16:
+          if(*((const uint16_t*)ptr))
+            return 1;
+          break;
+        case ALPHA_FLOAT:
+          if(*((const float*)ptr) != 0.0)
+            return 1;
+          break;
+        }
+      ptr += advance;
+      }
+    }
+  return 0;
+  }
+
+static void add_span(gavl_overlay_blend_context_t * ctx,
+                     int x, int y, int w, int h)
+  {
+  if(ctx->num_spans == ctx->spans_alloc)
+    {
+    ctx->spans_alloc += 64;
+    ctx->spans = realloc(ctx->spans, ctx->spans_alloc * sizeof(*ctx->spans));
+    }
+  ctx->spans[ctx->num_spans].x = x;
+  ctx->spans[ctx->num_spans].y = y;
+  ctx->spans[ctx->num_spans].w = w;
+  ctx->spans[ctx->num_spans].h = h;
+  ctx->num_spans++;
+  }
+
+static void get_spans(gavl_overlay_blend_context_t * ctx)
+  {
+  int i, x, y, w, h;
+  int alpha_offset, advance, type;
+  int span_start, gap;
+  int last_start, last_num, cur_start;
+  
+  ctx->num_spans = 0;
+
+  w = ctx->ovl->src_rect.w;
+  h = ctx->ovl->src_rect.h;
+
+  alpha_offset = get_alpha_offset(ctx->ovl_format.pixelformat,
+                                  &advance, &type);
+  
+  if(!ctx->use_spans || (alpha_offset < 0))
+    {
+    add_span(ctx, 0, 0, w, h);
+    return;
+    }
+  
+  last_start = 0;
+  last_num = 0;
+  
+  for(y = 0; y < h; y += ctx->dst_sub_v)
+    {
+    cur_start = ctx->num_spans;
+    span_start = -1;
+    gap = 0;
+    
+    for(x = 0; x < w; x += ctx->dst_sub_h)
+      {
+      if(block_visible(ctx->ovl_win, x, y, ctx->dst_sub_h, ctx->dst_sub_v,
+                       alpha_offset, advance, type))
+        {
+        if((span_start >= 0) && (gap >= SPAN_MIN_GAP))
+          {
+          add_span(ctx, span_start, y, x - gap - span_start, ctx->dst_sub_v);
+          span_start = -1;
+          }
+        if(span_start < 0)
+          span_start = x;
+        gap = 0;
+        }
+      else
+        gap += ctx->dst_sub_h;
+      }
+    
+    if(span_start >= 0)
+      add_span(ctx, span_start, y, w - gap - span_start, ctx->dst_sub_v);
+    
+    /* Merge with the previous block row */
+    
+    if((ctx->num_spans - cur_start == last_num) && last_num &&
+       (ctx->spans[last_start].y + ctx->spans[last_start].h == y))
+      {
+      for(i = 0; i < last_num; i++)
+        {
+        if((ctx->spans[last_start + i].x != ctx->spans[cur_start + i].x) ||
+           (ctx->spans[last_start + i].w != ctx->spans[cur_start + i].w))
+          break;
+        }
+      if(i == last_num)
+        {
+        for(i = 0; i < last_num; i++)
+          ctx->spans[last_start + i].h += ctx->dst_sub_v;
+        ctx->num_spans = cur_start;
+        continue;
+        }
+      }
+    last_start = cur_start;
+    last_num = ctx->num_spans - cur_start;
+    }
+  }
+
 static gavl_sink_status_t
 put_frame(void * priv,
           gavl_overlay_t * ovl)
@@ -142,6 +333,18 @@ put_frame(void * priv,
                                 ovl,
                                 ctx->ovl_win,
                                 &ctx->ovl->src_rect);
+
+  if((ctx->ovl->src_rect.w <= 0) || (ctx->ovl->src_rect.h <= 0))
+    {
+    ctx->ovl = NULL;
+    return GAVL_SINK_OK;
+    }
+  
+  get_spans(ctx);
+
+  if(ctx->premultiply)
+    ctx->premultiply(ctx);
+  
   return GAVL_SINK_OK;
   }
 
@@ -157,13 +360,20 @@ gavl_overlay_blend_context_init(gavl_overlay_blend_context_t * ctx,
                                 const gavl_video_format_t * dst_format,
                                 gavl_video_format_t * ovl_format)
   {
+#if defined(HAVE_SSE2) || defined(HAVE_AVX2)
+  gavl_blend_func_t func;
+#endif
+  
   /* Clean up from previous initializations */
 
   if(ctx->ovl_win)
     ctx->ovl = NULL;
 
   if(ctx->sink)
+    {
     gavl_video_sink_destroy(ctx->sink);
+    ctx->sink = NULL;
+    }
   
   /* Check for non alpha capable overlay format */
 
@@ -184,6 +394,30 @@ gavl_overlay_blend_context_init(gavl_overlay_blend_context_t * ctx,
     gavl_find_blend_func_c(ctx,
                            dst_format->pixelformat,
                            &ctx->ovl_format.pixelformat);
+
+  if(!ctx->func)
+    return 0;
+
+#ifdef HAVE_SSE2
+  if(ctx->opt.accel_flags & GAVL_ACCEL_SSE2)
+    {
+    func = gavl_find_blend_func_sse2(ctx, dst_format->pixelformat);
+    if(func)
+      ctx->func = func;
+    }
+#endif
+#ifdef HAVE_AVX2
+  if(ctx->opt.accel_flags & GAVL_ACCEL_AVX2)
+    {
+    func = gavl_find_blend_func_avx2(ctx, dst_format->pixelformat);
+    if(func)
+      ctx->func = func;
+    }
+#endif
+
+  /* Skipping transparent pixels would change the color of
+     transparent destination pixels */
+  ctx->use_spans = !gavl_pixelformat_has_alpha(dst_format->pixelformat);
   
   gavl_video_format_copy(ovl_format, &ctx->ovl_format);
   
@@ -202,16 +436,36 @@ gavl_overlay_blend_context_get_sink(gavl_overlay_blend_context_t * ctx)
 void gavl_overlay_blend(gavl_overlay_blend_context_t * ctx,
                         gavl_video_frame_t * dst_frame)
   {
+  int i;
+  gavl_rectangle_i_t rect;
+  
   if(!ctx->ovl)
     return;
-  /* Get subframe from destination */
-  
-  gavl_video_frame_get_subframe(ctx->dst_format.pixelformat,
-                                dst_frame,
-                                ctx->dst_win,
-                                &ctx->dst_rect);
-  /* Fire up blender */
 
-  ctx->func(ctx, ctx->dst_win, ctx->ovl_win);
+  for(i = 0; i < ctx->num_spans; i++)
+    {
+    ctx->blend_rect = ctx->spans[i];
+
+    /* Get subframes from destination and overlay */
+  
+    rect = ctx->blend_rect;
+    rect.x += ctx->dst_rect.x;
+    rect.y += ctx->dst_rect.y;
+    gavl_video_frame_get_subframe(ctx->dst_format.pixelformat,
+                                  dst_frame,
+                                  ctx->dst_win,
+                                  &rect);
+
+    rect = ctx->blend_rect;
+    rect.x += ctx->ovl->src_rect.x;
+    rect.y += ctx->ovl->src_rect.y;
+    gavl_video_frame_get_subframe(ctx->ovl_format.pixelformat,
+                                  ctx->ovl,
+                                  ctx->ovl_win,
+                                  &rect);
+    /* Fire up blender */
+
+    ctx->func(ctx, ctx->dst_win, ctx->ovl_win);
+    }
   }
 
@@ -132,7 +132,7 @@ static void RENAME(mix_5_to_1)(gavl_mix_output_channel_t * channel,
     tmp =
       (TMP_TYPE)SRC(0,i) * (TMP_TYPE)factor1 +
       (TMP_TYPE)SRC(1,i) * (TMP_TYPE)factor2 +
-      (TMP_TYPE)SRC(1,i) * (TMP_TYPE)factor3 +
+      (TMP_TYPE)SRC(2,i) * (TMP_TYPE)factor3 +
       (TMP_TYPE)SRC(3,i) * (TMP_TYPE)factor4 +
       (TMP_TYPE)SRC(4,i) * (TMP_TYPE)factor5;
     ADJUST_TMP(tmp);
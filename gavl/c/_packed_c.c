@@ -0,0 +1,144 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/*
+ *  Conversions from and to packed 24 bit samples. Needs
+ *  GET_S24(p): Read 3 bytes as signed 32 bit number (the lowest byte is 0)
+ *  PUT_S24(p, v): Write the lower 24 bits of v
+ */
+
+static void RENAME(to_s16)(const void * src, void * dst, int num)
+  {
+  int i;
+  const uint8_t * s = src;
+  int16_t * d = dst;
+
+  for(i = 0; i < num; i++)
+    {
+    d[i] = GET_S24(s) >> 16;
+    s += 3;
+    }
+  }
+
+static void RENAME(to_s32)(const void * src, void * dst, int num)
+  {
+  int i;
+  const uint8_t * s = src;
+  int32_t * d = dst;
+
+  for(i = 0; i < num; i++)
+    {
+    d[i] = GET_S24(s);
+    s += 3;
+    }
+  }
+
+static void RENAME(to_float)(const void * src, void * dst, int num)
+  {
+  int i;
+  const uint8_t * s = src;
+  float * d = dst;
+
+  for(i = 0; i < num; i++)
+    {
+    d[i] = (float)(GET_S24(s) >> 8)/8388608.0;
+    s += 3;
+    }
+  }
+
+static void RENAME(to_double)(const void * src, void * dst, int num)
+  {
+  int i;
+  const uint8_t * s = src;
+  double * d = dst;
+
+  for(i = 0; i < num; i++)
+    {
+    d[i] = (double)(GET_S24(s) >> 8)/8388608.0;
+    s += 3;
+    }
+  }
+
+static void RENAME(from_s16)(const void * src, void * dst, int num)
+  {
+  int i;
+  int32_t tmp;
+  const int16_t * s = src;
+  uint8_t * d = dst;
+
+  for(i = 0; i < num; i++)
+    {
+    tmp = s[i] * 0x100;
+    PUT_S24(d, tmp);
+    d += 3;
+    }
+  }
+
+static void RENAME(from_s32)(const void * src, void * dst, int num)
+  {
+  int i;
+  int32_t tmp;
+  const int32_t * s = src;
+  uint8_t * d = dst;
+
+  for(i = 0; i < num; i++)
+    {
+    tmp = s[i] >> 8;
+    PUT_S24(d, tmp);
+    d += 3;
+    }
+  }
+
+static void RENAME(from_float)(const void * src, void * dst, int num)
+  {
+  int i;
+  long tmp;
+  const float * s = src;
+  uint8_t * d = dst;
+
+  for(i = 0; i < num; i++)
+    {
+    tmp = lrintf(s[i] * 8388608.0);
+    CLAMP(tmp, -8388608, 8388607);
+    PUT_S24(d, tmp);
+    d += 3;
+    }
+  }
+
+static void RENAME(from_double)(const void * src, void * dst, int num)
+  {
+  int i;
+  long tmp;
+  const double * s = src;
+  uint8_t * d = dst;
+
+  for(i = 0; i < num; i++)
+    {
+    tmp = lrint(s[i] * 8388608.0);
+    CLAMP(tmp, -8388608, 8388607);
+    PUT_S24(d, tmp);
+    d += 3;
+    }
+  }
+
+#undef GET_S24
+#undef PUT_S24
+#undef RENAME
@@ -72,12 +72,12 @@ static void blend_gray_8(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       tmp = *dst_ptr;
       BLEND_8(ovl_ptr[0], tmp, ovl_ptr[1]);
@@ -110,12 +110,12 @@ static void blend_gray_16(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = (uint16_t*)ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       tmp = *dst_ptr;
       BLEND_16(ovl_ptr[0], tmp, ovl_ptr[1]);
@@ -146,12 +146,12 @@ static void blend_gray_float(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = (float*)ovl_ptr_start;
     dst_ptr = (float*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       BLEND_FLOAT(ovl_ptr[0], *dst_ptr, ovl_ptr[1]);
       dst_ptr++;
@@ -182,12 +182,12 @@ static void blend_graya_16(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       /* Transparent frame -> Copy overlay */
       if(!dst_ptr[1])
@@ -241,12 +241,12 @@ static void blend_graya_32(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = (uint16_t*)ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       /* Transparent frame -> Copy overlay */
       if(!dst_ptr[1])
@@ -302,12 +302,12 @@ static void blend_graya_float(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = (float*)ovl_ptr_start;
     dst_ptr = (float*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       /* Transparent frame -> Copy overlay */
       if(dst_ptr[3] == 0.0)
@@ -362,12 +362,12 @@ static void blend_rgb_15(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       r_tmp = RGB15_TO_R_8(*dst_ptr);
       g_tmp = RGB15_TO_G_8(*dst_ptr);
@@ -408,12 +408,12 @@ static void blend_bgr_15(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       r_tmp = BGR15_TO_R_8(*dst_ptr);
       g_tmp = BGR15_TO_G_8(*dst_ptr);
@@ -453,12 +453,12 @@ static void blend_rgb_16(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       r_tmp = RGB16_TO_R_8(*dst_ptr);
       g_tmp = RGB16_TO_G_8(*dst_ptr);
@@ -498,12 +498,12 @@ static void blend_bgr_16(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       r_tmp = BGR16_TO_R_8(*dst_ptr);
       g_tmp = BGR16_TO_G_8(*dst_ptr);
@@ -543,12 +543,12 @@ static void blend_rgb_24(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       r_tmp = dst_ptr[0];
       g_tmp = dst_ptr[1];
@@ -590,12 +590,12 @@ static void blend_bgr_24(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       r_tmp = dst_ptr[2];
       g_tmp = dst_ptr[1];
@@ -637,12 +637,12 @@ static void blend_rgb_32(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       r_tmp = dst_ptr[0];
       g_tmp = dst_ptr[1];
@@ -684,12 +684,12 @@ static void blend_bgr_32(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       r_tmp = dst_ptr[2];
       g_tmp = dst_ptr[1];
@@ -731,12 +731,12 @@ static void blend_rgba_32(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       /* Transparent frame -> Copy overlay */
       if(!dst_ptr[3])
@@ -805,12 +805,12 @@ static void blend_rgb_48(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = (uint16_t*)ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       r_tmp = dst_ptr[0];
       g_tmp = dst_ptr[1];
@@ -852,12 +852,12 @@ static void blend_rgba_64(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = (uint16_t*)ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       /* Transparent frame -> Copy overlay */
       if(!dst_ptr[3])
@@ -925,12 +925,12 @@ static void blend_rgb_float(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = (float*)ovl_ptr_start;
     dst_ptr = (float*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       BLEND_FLOAT(ovl_ptr[0], dst_ptr[0], ovl_ptr[3]);
       BLEND_FLOAT(ovl_ptr[1], dst_ptr[1], ovl_ptr[3]);
@@ -962,12 +962,12 @@ static void blend_rgba_float(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = (float*)ovl_ptr_start;
     dst_ptr = (float*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       a_dst = dst_ptr[3] + ovl_ptr[3] - dst_ptr[3]*ovl_ptr[3];
 
@@ -1011,9 +1011,9 @@ static void blend_yuy2(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
 
-  jmax = ctx->ovl->src_rect.w / 2;
+  jmax = ctx->blend_rect.w / 2;
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
@@ -1070,9 +1070,9 @@ static void blend_uyvy(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
 
-  jmax = ctx->ovl->src_rect.w / 2;
+  jmax = ctx->blend_rect.w / 2;
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
@@ -1127,12 +1127,12 @@ static void blend_yuva_32(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       /* Transparent frame -> Copy overlay */
       if(!dst_ptr[3])
@@ -1183,687 +1183,137 @@ static void blend_yuva_32(gavl_overlay_blend_context_t * ctx,
 
   }
 
-/* ovl: GAVL_YUVA_32 */
-
-static void blend_yuv_420_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
-  {
-  int i, j, imax, jmax;
-  uint8_t * ovl_ptr;
-  uint8_t * dst_ptr_y;
-  uint8_t * dst_ptr_u;
-  uint8_t * dst_ptr_v;
-  
-  uint8_t * ovl_ptr_start;
-  uint8_t * dst_ptr_y_start;
-  uint8_t * dst_ptr_u_start;
-  uint8_t * dst_ptr_v_start;
-  
-  int tmp;
-  
-  ovl_ptr_start = overlay->planes[0];
-  dst_ptr_y_start = frame->planes[0];
-  dst_ptr_u_start = frame->planes[1];
-  dst_ptr_v_start = frame->planes[2];
-
-  imax = ctx->ovl->src_rect.h / 2;
-  jmax = ctx->ovl->src_rect.w / 2;
-  
-  for(i = 0; i < imax; i++)
-    {
-    ovl_ptr = ovl_ptr_start;
-    dst_ptr_y = dst_ptr_y_start;
-    dst_ptr_u = dst_ptr_u_start;
-    dst_ptr_v = dst_ptr_v_start;
-    
-    for(j = 0; j < jmax; j++)
-      {
-      /* Y0 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
-      *(dst_ptr_y++) = tmp;
-
-      /* U0 */
-      tmp = *dst_ptr_u;
-      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
-      *(dst_ptr_u++) = tmp;
-
-      /* V0 */
-      tmp = *dst_ptr_v;
-      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
-      *(dst_ptr_v++) = tmp;
-
-      /* Y1 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[4], tmp, ovl_ptr[7]);
-      *(dst_ptr_y++) = tmp;
-      
-      ovl_ptr+=8;
-      }
-    ovl_ptr_start += overlay->strides[0];
-    dst_ptr_y_start += frame->strides[0];
-    dst_ptr_u_start += frame->strides[1];
-    dst_ptr_v_start += frame->strides[2];
-
-
-    ovl_ptr = ovl_ptr_start;
-    dst_ptr_y = dst_ptr_y_start;
-    dst_ptr_u = dst_ptr_u_start;
-    dst_ptr_v = dst_ptr_v_start;
-    
-    for(j = 0; j < jmax; j++)
-      {
-      /* Y0 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
-      *(dst_ptr_y++) = tmp;
-      
-      /* Y1 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[4], tmp, ovl_ptr[7]);
-      *(dst_ptr_y++) = tmp;
-      
-      ovl_ptr+=8;
-      }
-    ovl_ptr_start += overlay->strides[0];
-    dst_ptr_y_start += frame->strides[0];
-    }
-  
-  }
-
-/* ovl: GAVL_YUVA_32 */
-
-static void blend_yuv_422_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
-  {
-  int i, j, jmax;
-  uint8_t * ovl_ptr;
-  uint8_t * dst_ptr_y;
-  uint8_t * dst_ptr_u;
-  uint8_t * dst_ptr_v;
-  
-  uint8_t * ovl_ptr_start;
-  uint8_t * dst_ptr_y_start;
-  uint8_t * dst_ptr_u_start;
-  uint8_t * dst_ptr_v_start;
-  
-  int tmp;
-  
-  ovl_ptr_start = overlay->planes[0];
-  dst_ptr_y_start = frame->planes[0];
-  dst_ptr_u_start = frame->planes[1];
-  dst_ptr_v_start = frame->planes[2];
-
-  jmax = ctx->ovl->src_rect.w / 2;
-  
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
-    {
-    ovl_ptr = ovl_ptr_start;
-    dst_ptr_y = dst_ptr_y_start;
-    dst_ptr_u = dst_ptr_u_start;
-    dst_ptr_v = dst_ptr_v_start;
-    
-    for(j = 0; j < jmax; j++)
-      {
-      /* Y0 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
-      *(dst_ptr_y++) = tmp;
-
-      /* U0 */
-      tmp = *dst_ptr_u;
-      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
-      *(dst_ptr_u++) = tmp;
-
-      /* V0 */
-      tmp = *dst_ptr_v;
-      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
-      *(dst_ptr_v++) = tmp;
-
-      /* Y1 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[4], tmp, ovl_ptr[7]);
-      *(dst_ptr_y++) = tmp;
-      
-      ovl_ptr+=8;
-      }
-    ovl_ptr_start += overlay->strides[0];
-
-    dst_ptr_y_start += frame->strides[0];
-    dst_ptr_u_start += frame->strides[1];
-    dst_ptr_v_start += frame->strides[2];
-    }
-  
-  }
-
-/* ovl: GAVL_YUVA_32 */
-
-static void blend_yuv_444_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
-  {
-  int i, j;
-  uint8_t * ovl_ptr;
-  uint8_t * dst_ptr_y;
-  uint8_t * dst_ptr_u;
-  uint8_t * dst_ptr_v;
-  
-  uint8_t * ovl_ptr_start;
-  uint8_t * dst_ptr_y_start;
-  uint8_t * dst_ptr_u_start;
-  uint8_t * dst_ptr_v_start;
-  
-  int tmp;
-  
-  ovl_ptr_start = overlay->planes[0];
-  dst_ptr_y_start = frame->planes[0];
-  dst_ptr_u_start = frame->planes[1];
-  dst_ptr_v_start = frame->planes[2];
-  
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
-    {
-    ovl_ptr = ovl_ptr_start;
-    dst_ptr_y = dst_ptr_y_start;
-    dst_ptr_u = dst_ptr_u_start;
-    dst_ptr_v = dst_ptr_v_start;
-    
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
-      {
-      /* Y0 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
-      *(dst_ptr_y++) = tmp;
-
-      /* U0 */
-      tmp = *dst_ptr_u;
-      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
-      *(dst_ptr_u++) = tmp;
-
-      /* V0 */
-      tmp = *dst_ptr_v;
-      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
-      *(dst_ptr_v++) = tmp;
-      
-      ovl_ptr+=4;
-      }
-    ovl_ptr_start += overlay->strides[0];
-
-    dst_ptr_y_start += frame->strides[0];
-    dst_ptr_u_start += frame->strides[1];
-    dst_ptr_v_start += frame->strides[2];
-    }
-  
-  }
-
-/* ovl: GAVL_YUVA_32 */
-
-static void blend_yuv_411_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
-  {
-  int i, j, jmax;
-  uint8_t * ovl_ptr;
-  uint8_t * dst_ptr_y;
-  uint8_t * dst_ptr_u;
-  uint8_t * dst_ptr_v;
-  
-  uint8_t * ovl_ptr_start;
-  uint8_t * dst_ptr_y_start;
-  uint8_t * dst_ptr_u_start;
-  uint8_t * dst_ptr_v_start;
-  
-  int tmp;
-  
-  ovl_ptr_start = overlay->planes[0];
-  dst_ptr_y_start = frame->planes[0];
-  dst_ptr_u_start = frame->planes[1];
-  dst_ptr_v_start = frame->planes[2];
-
-  jmax = ctx->ovl->src_rect.w / 4;
-  
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
-    {
-    ovl_ptr = ovl_ptr_start;
-    dst_ptr_y = dst_ptr_y_start;
-    dst_ptr_u = dst_ptr_u_start;
-    dst_ptr_v = dst_ptr_v_start;
-    
-    for(j = 0; j < jmax; j++)
-      {
-      /* Y0 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
-      *(dst_ptr_y++) = tmp;
-
-      /* U0 */
-      tmp = *dst_ptr_u;
-      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
-      *(dst_ptr_u++) = tmp;
-
-      /* V0 */
-      tmp = *dst_ptr_v;
-      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
-      *(dst_ptr_v++) = tmp;
-
-      /* Y1 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[4], tmp, ovl_ptr[7]);
-      *(dst_ptr_y++) = tmp;
-
-      /* Y2 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[8], tmp, ovl_ptr[11]);
-      *(dst_ptr_y++) = tmp;
-
-      /* Y3 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[12], tmp, ovl_ptr[15]);
-      *(dst_ptr_y++) = tmp;
-      
-      ovl_ptr+=16;
-      }
-    ovl_ptr_start += overlay->strides[0];
-
-    dst_ptr_y_start += frame->strides[0];
-    dst_ptr_u_start += frame->strides[1];
-    dst_ptr_v_start += frame->strides[2];
-    }
-  }
-
-/* ovl: GAVL_YUVA_32 */
-
-static void blend_yuv_410_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
-  {
-  int i, j, imax, jmax;
-  uint8_t * ovl_ptr;
-  uint8_t * dst_ptr_y;
-  uint8_t * dst_ptr_u;
-  uint8_t * dst_ptr_v;
-  
-  uint8_t * ovl_ptr_start;
-  uint8_t * dst_ptr_y_start;
-  uint8_t * dst_ptr_u_start;
-  uint8_t * dst_ptr_v_start;
-  
-  int tmp;
-  
-  ovl_ptr_start = overlay->planes[0];
-
-  dst_ptr_y_start = frame->planes[0];
-  dst_ptr_u_start = frame->planes[1];
-  dst_ptr_v_start = frame->planes[2];
-
-  imax = ctx->ovl->src_rect.h / 4;
-  jmax = ctx->ovl->src_rect.w / 4;
-  
-  for(i = 0; i < imax; i++)
-    {
-    /* Line 0 */
-
-    ovl_ptr = ovl_ptr_start;
-    dst_ptr_y = dst_ptr_y_start;
-    dst_ptr_u = dst_ptr_u_start;
-    dst_ptr_v = dst_ptr_v_start;
-    
-    for(j = 0; j < jmax; j++)
-      {
-      /* Y0 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
-      *(dst_ptr_y++) = tmp;
-
-      /* U0 */
-      tmp = *dst_ptr_u;
-      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
-      *(dst_ptr_u++) = tmp;
-
-      /* V0 */
-      tmp = *dst_ptr_v;
-      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
-      *(dst_ptr_v++) = tmp;
-      
-      /* Y1 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[4], tmp, ovl_ptr[7]);
-      *(dst_ptr_y++) = tmp;
-      
-      /* Y2 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[8], tmp, ovl_ptr[11]);
-      *(dst_ptr_y++) = tmp;
-      
-      /* Y3 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[12], tmp, ovl_ptr[15]);
-      *(dst_ptr_y++) = tmp;
-      
-      ovl_ptr+=16;
-      }
-    ovl_ptr_start += overlay->strides[0];
-    dst_ptr_y_start += frame->strides[0];
-    dst_ptr_u_start += frame->strides[1];
-    dst_ptr_v_start += frame->strides[2];
-
-    /* Line 1 */
-    
-    ovl_ptr = ovl_ptr_start;
-    dst_ptr_y = dst_ptr_y_start;
-    
-    for(j = 0; j < jmax; j++)
-      {
-      /* Y0 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
-      *(dst_ptr_y++) = tmp;
-      
-      /* Y1 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[4], tmp, ovl_ptr[7]);
-      *(dst_ptr_y++) = tmp;
-      
-      /* Y2 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[8], tmp, ovl_ptr[11]);
-      *(dst_ptr_y++) = tmp;
-
-      /* Y3 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[12], tmp, ovl_ptr[15]);
-      *(dst_ptr_y++) = tmp;
-            
-      ovl_ptr+=16;
-      }
-    ovl_ptr_start += overlay->strides[0];
-    dst_ptr_y_start += frame->strides[0];
-
-    /* Line 2 */
-    
-    ovl_ptr = ovl_ptr_start;
-    dst_ptr_y = dst_ptr_y_start;
-    
-    for(j = 0; j < jmax; j++)
-      {
-      /* Y0 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
-      *(dst_ptr_y++) = tmp;
-      
-      /* Y1 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[4], tmp, ovl_ptr[7]);
-      *(dst_ptr_y++) = tmp;
-            
-      /* Y2 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[8], tmp, ovl_ptr[11]);
-      *(dst_ptr_y++) = tmp;
-
-      /* Y3 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[12], tmp, ovl_ptr[15]);
-      *(dst_ptr_y++) = tmp;
-            
-      ovl_ptr+=16;
-      }
-    ovl_ptr_start += overlay->strides[0];
-    dst_ptr_y_start += frame->strides[0];
-
-    /* Line 3 */
-    
-    ovl_ptr = ovl_ptr_start;
-    dst_ptr_y = dst_ptr_y_start;
-    
-    for(j = 0; j < jmax; j++)
-      {
-      /* Y0 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
-      *(dst_ptr_y++) = tmp;
-      
-      /* Y1 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[4], tmp, ovl_ptr[7]);
-      *(dst_ptr_y++) = tmp;
-            
-      /* Y2 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[8], tmp, ovl_ptr[11]);
-      *(dst_ptr_y++) = tmp;
-
-      /* Y3 */
-      tmp = *dst_ptr_y;
-      BLEND_8(ovl_ptr[12], tmp, ovl_ptr[15]);
-      *(dst_ptr_y++) = tmp;
-            
-      ovl_ptr+=16;
-      }
-    ovl_ptr_start += overlay->strides[0];
-    dst_ptr_y_start += frame->strides[0];
-
-    
-    }
-
-  }
-
-/* ovl: GAVL_YUVA_32 */
+/*
+ *  Planar 8 bit YUV (ovl: GAVL_YUVA_32)
+ *
+ *  The overlay is premultiplied once per overlay and stored in the
+ *  plane layout of the destination. With sa = s * a and ia = 256 - a,
+ *  BLEND_8 becomes
+ *
+ *  d = (d * ia + sa) >> 8
+ *
+ *  which gives exactly the same results. Chroma is taken from the
+ *  top left pixel of each subsampling block.
+ */
 
-static void blend_yuvj_420_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
+static void premultiply_yuv_8(gavl_overlay_blend_context_t * ctx, int jpeg)
   {
-  int i, j, imax, jmax;
-  uint8_t * ovl_ptr;
-  uint8_t * dst_ptr_y;
-  uint8_t * dst_ptr_u;
-  uint8_t * dst_ptr_v;
-  
-  uint8_t * ovl_ptr_start;
-  uint8_t * dst_ptr_y_start;
-  uint8_t * dst_ptr_u_start;
-  uint8_t * dst_ptr_v_start;
+  int i, j, plane, w, h, size;
+  int s, a;
+  const uint8_t * ovl_ptr;
+  const uint8_t * src;
+  uint16_t * sa;
+  uint16_t * ia;
+  uint16_t * ptr;
   
-  int tmp;
+  w = ctx->ovl->src_rect.w;
+  h = ctx->ovl->src_rect.h;
+
+  ctx->pm_stride[0] = w;
+  ctx->pm_stride[1] = w / ctx->dst_sub_h;
+  ctx->pm_stride[2] = w / ctx->dst_sub_h;
 
-  imax = ctx->ovl->src_rect.h/2;
-  jmax = ctx->ovl->src_rect.w/2;
+  size = 2 * (w * h + 2 * (w / ctx->dst_sub_h) * (h / ctx->dst_sub_v));
   
-  ovl_ptr_start = overlay->planes[0];
-  dst_ptr_y_start = frame->planes[0];
-  dst_ptr_u_start = frame->planes[1];
-  dst_ptr_v_start = frame->planes[2];
+  if(ctx->pm_alloc < size)
+    {
+    ctx->pm_alloc = size;
+    ctx->pm_buf = realloc(ctx->pm_buf, ctx->pm_alloc * sizeof(*ctx->pm_buf));
+    }
+
+  ptr = ctx->pm_buf;
+  for(plane = 0; plane < 3; plane++)
+    {
+    size = ctx->pm_stride[plane] * (plane ? h / ctx->dst_sub_v : h);
+    ctx->pm_sa[plane] = ptr;
+    ptr += size;
+    ctx->pm_ia[plane] = ptr;
+    ptr += size;
+    }
   
-  for(i = 0; i < imax; i++)
+  for(i = 0; i < h; i++)
     {
-    ovl_ptr = ovl_ptr_start;
-    dst_ptr_y = dst_ptr_y_start;
-    dst_ptr_u = dst_ptr_u_start;
-    dst_ptr_v = dst_ptr_v_start;
+    ovl_ptr = ctx->ovl_win->planes[0] + i * ctx->ovl_win->strides[0];
+
+    /* Y */
+    sa = ctx->pm_sa[0] + i * ctx->pm_stride[0];
+    ia = ctx->pm_ia[0] + i * ctx->pm_stride[0];
+    src = ovl_ptr;
     
-    for(j = 0; j < jmax; j++)
+    for(j = 0; j < w; j++)
       {
-      /* Y0 */
-      tmp = *dst_ptr_y;
-      BLEND_8(Y_8_TO_YJ_8(ovl_ptr[0]), tmp, ovl_ptr[3]);
-      *(dst_ptr_y++) = tmp;
-
-      /* U0 */
-      tmp = *dst_ptr_u;
-      BLEND_8(UV_8_TO_UVJ_8(ovl_ptr[1]), tmp, ovl_ptr[3]);
-      *(dst_ptr_u++) = tmp;
-
-      /* V0 */
-      tmp = *dst_ptr_v;
-      BLEND_8(UV_8_TO_UVJ_8(ovl_ptr[2]), tmp, ovl_ptr[3]);
-      *(dst_ptr_v++) = tmp;
-
-      /* Y1 */
-      tmp = *dst_ptr_y;
-      BLEND_8(Y_8_TO_YJ_8(ovl_ptr[4]), tmp, ovl_ptr[7]);
-      *(dst_ptr_y++) = tmp;
-
-      ovl_ptr+=8;
+      a = src[3];
+      s = jpeg ? Y_8_TO_YJ_8(src[0]) : src[0];
+      sa[j] = s * a;
+      ia[j] = 256 - a;
+      src += 4;
       }
-    ovl_ptr_start += overlay->strides[0];
-
-    dst_ptr_y_start += frame->strides[0];
-    dst_ptr_u_start += frame->strides[1];
-    dst_ptr_v_start += frame->strides[2];
 
+    if(i % ctx->dst_sub_v)
+      continue;
 
-    ovl_ptr = ovl_ptr_start;
-    dst_ptr_y = dst_ptr_y_start;
-    
-    for(j = 0; j < jmax; j++)
+    /* U, V */
+    for(plane = 1; plane < 3; plane++)
       {
-      /* Y0 */
-      tmp = *dst_ptr_y;
-      BLEND_8(Y_8_TO_YJ_8(ovl_ptr[0]), tmp, ovl_ptr[3]);
-      *(dst_ptr_y++) = tmp;
-      
-      /* Y1 */
-      tmp = *dst_ptr_y;
-      BLEND_8(Y_8_TO_YJ_8(ovl_ptr[4]), tmp, ovl_ptr[7]);
-      *(dst_ptr_y++) = tmp;
+      sa = ctx->pm_sa[plane] + (i / ctx->dst_sub_v) * ctx->pm_stride[plane];
+      ia = ctx->pm_ia[plane] + (i / ctx->dst_sub_v) * ctx->pm_stride[plane];
+      src = ovl_ptr;
       
-      ovl_ptr+=8;
+      for(j = 0; j < ctx->pm_stride[plane]; j++)
+        {
+        a = src[3];
+        s = jpeg ? UV_8_TO_UVJ_8(src[plane]) : src[plane];
+        sa[j] = s * a;
+        ia[j] = 256 - a;
+        src += 4 * ctx->dst_sub_h;
+        }
       }
-    ovl_ptr_start += overlay->strides[0];
-
-    dst_ptr_y_start += frame->strides[0];
-
-
     }
-  
   }
 
-/* ovl: GAVL_YUVA_32 */
-
-static void blend_yuvj_422_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
+static void premultiply_yuv(gavl_overlay_blend_context_t * ctx)
   {
-  int i, j, jmax;
-  uint8_t * ovl_ptr;
-  uint8_t * dst_ptr_y;
-  uint8_t * dst_ptr_u;
-  uint8_t * dst_ptr_v;
-  
-  uint8_t * ovl_ptr_start;
-  uint8_t * dst_ptr_y_start;
-  uint8_t * dst_ptr_u_start;
-  uint8_t * dst_ptr_v_start;
-  
-  int tmp;
-
-  jmax = ctx->ovl->src_rect.w/2;
-  
-  ovl_ptr_start = overlay->planes[0];
-  dst_ptr_y_start = frame->planes[0];
-  dst_ptr_u_start = frame->planes[1];
-  dst_ptr_v_start = frame->planes[2];
-  
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
-    {
-    ovl_ptr = ovl_ptr_start;
-    dst_ptr_y = dst_ptr_y_start;
-    dst_ptr_u = dst_ptr_u_start;
-    dst_ptr_v = dst_ptr_v_start;
-    
-    for(j = 0; j < jmax; j++)
-      {
-      /* Y0 */
-      tmp = *dst_ptr_y;
-      BLEND_8(Y_8_TO_YJ_8(ovl_ptr[0]), tmp, ovl_ptr[3]);
-      *(dst_ptr_y++) = tmp;
-
-      /* U0 */
-      tmp = *dst_ptr_u;
-      BLEND_8(UV_8_TO_UVJ_8(ovl_ptr[1]), tmp, ovl_ptr[3]);
-      *(dst_ptr_u++) = tmp;
-
-      /* V0 */
-      tmp = *dst_ptr_v;
-      BLEND_8(UV_8_TO_UVJ_8(ovl_ptr[2]), tmp, ovl_ptr[3]);
-      *(dst_ptr_v++) = tmp;
-
-      /* Y1 */
-      tmp = *dst_ptr_y;
-      BLEND_8(Y_8_TO_YJ_8(ovl_ptr[4]), tmp, ovl_ptr[7]);
-      *(dst_ptr_y++) = tmp;
-
-      
-      ovl_ptr+=8;
-      }
-    ovl_ptr_start += overlay->strides[0];
-
-    dst_ptr_y_start += frame->strides[0];
-    dst_ptr_u_start += frame->strides[1];
-    dst_ptr_v_start += frame->strides[2];
-    }
-  
+  premultiply_yuv_8(ctx, 0);
   }
 
-/* ovl: GAVL_YUVA_32 */
+static void premultiply_yuvj(gavl_overlay_blend_context_t * ctx)
+  {
+  premultiply_yuv_8(ctx, 1);
+  }
 
-static void blend_yuvj_444_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
+static void blend_yuv_planar_8(gavl_overlay_blend_context_t * ctx,
+                               gavl_video_frame_t * frame,
+                               gavl_video_frame_t * overlay)
   {
-  int i, j;
-  uint8_t * ovl_ptr;
-  uint8_t * dst_ptr_y;
-  uint8_t * dst_ptr_u;
-  uint8_t * dst_ptr_v;
-  
-  uint8_t * ovl_ptr_start;
-  uint8_t * dst_ptr_y_start;
-  uint8_t * dst_ptr_u_start;
-  uint8_t * dst_ptr_v_start;
-  
-  int tmp;
-  
-  ovl_ptr_start = overlay->planes[0];
-  dst_ptr_y_start = frame->planes[0];
-  dst_ptr_u_start = frame->planes[1];
-  dst_ptr_v_start = frame->planes[2];
+  int i, j, plane, sub_h, sub_v, w, h, offset;
+  const uint16_t * sa;
+  const uint16_t * ia;
+  uint8_t * dst_ptr;
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(plane = 0; plane < 3; plane++)
     {
-    ovl_ptr = ovl_ptr_start;
-    dst_ptr_y = dst_ptr_y_start;
-    dst_ptr_u = dst_ptr_u_start;
-    dst_ptr_v = dst_ptr_v_start;
-    
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
-      {
-      /* Y0 */
-      tmp = *dst_ptr_y;
-      BLEND_8(Y_8_TO_YJ_8(ovl_ptr[0]), tmp, ovl_ptr[3]);
-      *(dst_ptr_y++) = tmp;
+    sub_h = plane ? ctx->dst_sub_h : 1;
+    sub_v = plane ? ctx->dst_sub_v : 1;
 
-      /* U0 */
-      tmp = *dst_ptr_u;
-      BLEND_8(UV_8_TO_UVJ_8(ovl_ptr[1]), tmp, ovl_ptr[3]);
-      *(dst_ptr_u++) = tmp;
+    w = ctx->blend_rect.w / sub_h;
+    h = ctx->blend_rect.h / sub_v;
 
-      /* V0 */
-      tmp = *dst_ptr_v;
-      BLEND_8(UV_8_TO_UVJ_8(ovl_ptr[2]), tmp, ovl_ptr[3]);
-      *(dst_ptr_v++) = tmp;
+    offset = (ctx->blend_rect.y / sub_v) * ctx->pm_stride[plane] +
+      ctx->blend_rect.x / sub_h;
+    sa = ctx->pm_sa[plane] + offset;
+    ia = ctx->pm_ia[plane] + offset;
+    dst_ptr = frame->planes[plane];
+    
+    for(i = 0; i < h; i++)
+      {
+      for(j = 0; j < w; j++)
+        dst_ptr[j] = (dst_ptr[j] * ia[j] + sa[j]) >> 8;
       
-      ovl_ptr+=4;
+      sa += ctx->pm_stride[plane];
+      ia += ctx->pm_stride[plane];
+      dst_ptr += frame->strides[plane];
       }
-    ovl_ptr_start += overlay->strides[0];
-
-    dst_ptr_y_start += frame->strides[0];
-    dst_ptr_u_start += frame->strides[1];
-    dst_ptr_v_start += frame->strides[2];
     }
-  
   }
 
 /* ovl: GAVL_YUVA_64 */
@@ -1890,9 +1340,9 @@ static void blend_yuv_422_p_16(gavl_overlay_blend_context_t * ctx,
   dst_ptr_u_start = frame->planes[1];
   dst_ptr_v_start = frame->planes[2];
 
-  jmax = ctx->ovl->src_rect.w / 2;
+  jmax = ctx->blend_rect.w / 2;
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = (uint16_t*)ovl_ptr_start;
     dst_ptr_y = (uint16_t*)dst_ptr_y_start;
@@ -1959,14 +1409,14 @@ static void blend_yuv_444_p_16(gavl_overlay_blend_context_t * ctx,
   dst_ptr_u_start = frame->planes[1];
   dst_ptr_v_start = frame->planes[2];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < ctx->blend_rect.h; i++)
     {
     ovl_ptr = (uint16_t*)ovl_ptr_start;
     dst_ptr_y = (uint16_t*)dst_ptr_y_start;
     dst_ptr_u = (uint16_t*)dst_ptr_u_start;
     dst_ptr_v = (uint16_t*)dst_ptr_v_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < ctx->blend_rect.w; j++)
       {
       alpha = ovl_ptr[3];
       /* Y0 */
@@ -2000,6 +1450,8 @@ gavl_find_blend_func_c(gavl_overlay_blend_context_t * ctx,
                        gavl_pixelformat_t frame_format,
                        gavl_pixelformat_t * overlay_format)
   {
+  ctx->premultiply = NULL;
+  
   switch(frame_format)
     {
     case GAVL_GRAY_8:
@@ -2076,35 +1528,43 @@ gavl_find_blend_func_c(gavl_overlay_blend_context_t * ctx,
       break;
     case GAVL_YUV_420_P:
       *overlay_format = GAVL_YUVA_32;
-      return blend_yuv_420_p;
+      ctx->premultiply = premultiply_yuv;
+      return blend_yuv_planar_8;
       break;
     case GAVL_YUV_422_P:
       *overlay_format = GAVL_YUVA_32;
-      return blend_yuv_422_p;
+      ctx->premultiply = premultiply_yuv;
+      return blend_yuv_planar_8;
       break;
     case GAVL_YUV_444_P:
       *overlay_format = GAVL_YUVA_32;
-      return blend_yuv_444_p;
+      ctx->premultiply = premultiply_yuv;
+      return blend_yuv_planar_8;
       break;
     case GAVL_YUV_411_P:
       *overlay_format = GAVL_YUVA_32;
-      return blend_yuv_411_p;
+      ctx->premultiply = premultiply_yuv;
+      return blend_yuv_planar_8;
       break;
     case GAVL_YUV_410_P:
       *overlay_format = GAVL_YUVA_32;
-      return blend_yuv_410_p;
+      ctx->premultiply = premultiply_yuv;
+      return blend_yuv_planar_8;
       break;
     case GAVL_YUVJ_420_P:
       *overlay_format = GAVL_YUVA_32;
-      return blend_yuvj_420_p;
+      ctx->premultiply = premultiply_yuvj;
+      return blend_yuv_planar_8;
       break;
     case GAVL_YUVJ_422_P:
       *overlay_format = GAVL_YUVA_32;
-      return blend_yuvj_422_p;
+      ctx->premultiply = premultiply_yuvj;
+      return blend_yuv_planar_8;
       break;
     case GAVL_YUVJ_444_P:
       *overlay_format = GAVL_YUVA_32;
-      return blend_yuvj_444_p;
+      ctx->premultiply = premultiply_yuvj;
+      return blend_yuv_planar_8;
       break;
     case GAVL_YUV_444_P_16:
       *overlay_format = GAVL_YUVA_64;
@@ -2142,6 +1602,12 @@ gavl_find_blend_func_c(gavl_overlay_blend_context_t * ctx,
       *overlay_format = GAVL_RGBA_FLOAT;
       return blend_rgba_float;
       break;
+    /* Not supported */
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_P010:
+    case GAVL_P016:
+    case GAVL_YUV_420_P_10:
     case GAVL_PIXELFORMAT_NONE:
       return NULL;
     }
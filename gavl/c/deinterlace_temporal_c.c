@@ -0,0 +1,105 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+#include <math.h>
+
+#include <gavl/gavl.h>
+#include <video.h>
+
+#include <deinterlace.h>
+#include <accel.h>
+
+/*
+ *  The spatial prediction (average of the lines above and below) is
+ *  clipped to the temporal prediction (the same line in the previous
+ *  field) +- the amount of motion. For static areas, this is weaving,
+ *  for moving areas it's line averaging.
+ */
+
+static void temporal_func_8_c(const uint8_t * t, const uint8_t * b,
+                              const uint8_t * p1, const uint8_t * p2t,
+                              const uint8_t * p2b, const uint8_t * p3,
+                              uint8_t * dst, int num)
+  {
+  int i;
+  for(i = 0; i < num; i++)
+    dst[i] = gavl_deinterlace_temporal_pixel(t[i], b[i], p1[i],
+                                             p2t[i], p2b[i], p3[i]);
+  }
+
+static void temporal_func_16_c(const uint8_t * t1, const uint8_t * b1,
+                               const uint8_t * p11, const uint8_t * p2t1,
+                               const uint8_t * p2b1, const uint8_t * p31,
+                               uint8_t * dst1, int num)
+  {
+  int i;
+  const uint16_t * t   = (const uint16_t*)t1;
+  const uint16_t * b   = (const uint16_t*)b1;
+  const uint16_t * p1  = (const uint16_t*)p11;
+  const uint16_t * p2t = (const uint16_t*)p2t1;
+  const uint16_t * p2b = (const uint16_t*)p2b1;
+  const uint16_t * p3  = (const uint16_t*)p31;
+  uint16_t * dst = (uint16_t*)dst1;
+
+  for(i = 0; i < num; i++)
+    dst[i] = gavl_deinterlace_temporal_pixel(t[i], b[i], p1[i],
+                                             p2t[i], p2b[i], p3[i]);
+  }
+
+static void temporal_func_float_c(const uint8_t * t1, const uint8_t * b1,
+                                  const uint8_t * p11, const uint8_t * p2t1,
+                                  const uint8_t * p2b1, const uint8_t * p31,
+                                  uint8_t * dst1, int num)
+  {
+  int i;
+  float s, diff, diff1;
+  const float * t   = (const float*)t1;
+  const float * b   = (const float*)b1;
+  const float * p1  = (const float*)p11;
+  const float * p2t = (const float*)p2t1;
+  const float * p2b = (const float*)p2b1;
+  const float * p3  = (const float*)p31;
+  float * dst = (float*)dst1;
+
+  for(i = 0; i < num; i++)
+    {
+    s = 0.5f * (t[i] + b[i]);
+    diff  = fabsf(p1[i] - p3[i]);
+    diff1 = 0.5f * (fabsf(t[i] - p2t[i]) + fabsf(b[i] - p2b[i]));
+    if(diff < diff1)
+      diff = diff1;
+
+    if(s < p1[i] - diff)
+      s = p1[i] - diff;
+    else if(s > p1[i] + diff)
+      s = p1[i] + diff;
+    dst[i] = s;
+    }
+  }
+
+void
+gavl_find_deinterlacer_temporal_funcs_c(gavl_video_deinterlace_temporal_func_table_t * tab,
+                                        const gavl_video_options_t * opt,
+                                        const gavl_video_format_t * format)
+  {
+  tab->func_8     = temporal_func_8_c;
+  tab->func_16    = temporal_func_16_c;
+  tab->func_float = temporal_func_float_c;
+  }
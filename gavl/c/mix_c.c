@@ -241,6 +241,7 @@ void gavl_setup_mix_funcs_c(gavl_mixer_table_t * t,
       t->mix_5_to_1 = mix_5_to_1_u16;
       t->mix_6_to_1 = mix_6_to_1_u16;
       t->mix_all_to_1 = mix_all_to_1_u16;
+      break;
     case GAVL_SAMPLE_S16:
       t->mix_1_to_1 = mix_1_to_1_s16;
       t->mix_2_to_1 = mix_2_to_1_s16;
@@ -277,6 +278,8 @@ void gavl_setup_mix_funcs_c(gavl_mixer_table_t * t,
       t->mix_6_to_1 = mix_6_to_1_double;
       t->mix_all_to_1 = mix_all_to_1_double;
       break;
+    case GAVL_SAMPLE_S24LE:
+    case GAVL_SAMPLE_S24BE:
     case GAVL_SAMPLE_NONE:
       break;
     }
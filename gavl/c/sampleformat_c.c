@@ -87,8 +87,110 @@ for(i = 0; i < imax; i++)\
 
 #include "_sampleformat_c.c"
 
+/* Conversion and interleaving in one pass */
+
+static void convert_s16_i_to_float_ni(gavl_audio_convert_context_t * ctx)
+  {
+  int i, j;
+  const int16_t * src = ctx->input_frame->samples.s_16;
+
+  for(i = 0; i < ctx->input_frame->valid_samples; i++)
+    {
+    for(j = 0; j < ctx->input_format.num_channels; j++)
+      ctx->output_frame->channels.f[j][i] = (float)(*(src++))/32768.0;
+    }
+  }
+
+static void convert_s16_i_to_float_ni_stereo(gavl_audio_convert_context_t * ctx)
+  {
+  int i;
+  const int16_t * src = ctx->input_frame->samples.s_16;
+  float * dst1 = ctx->output_frame->channels.f[0];
+  float * dst2 = ctx->output_frame->channels.f[1];
+
+  for(i = 0; i < ctx->input_frame->valid_samples; i++)
+    {
+    *(dst1++) = (float)(*(src++))/32768.0;
+    *(dst2++) = (float)(*(src++))/32768.0;
+    }
+  }
+
+static void convert_float_ni_to_s16_i(gavl_audio_convert_context_t * ctx)
+  {
+  int i, j;
+  long tmp;
+  int16_t * dst = ctx->output_frame->samples.s_16;
+
+  for(i = 0; i < ctx->input_frame->valid_samples; i++)
+    {
+    for(j = 0; j < ctx->input_format.num_channels; j++)
+      {
+      tmp = lrintf(ctx->input_frame->channels.f[j][i] * 32768.0);
+      CLAMP(tmp, -32768, 32767);
+      *(dst++) = tmp;
+      }
+    }
+  }
+
+static void convert_float_ni_to_s16_i_stereo(gavl_audio_convert_context_t * ctx)
+  {
+  int i;
+  long tmp;
+  const float * src1 = ctx->input_frame->channels.f[0];
+  const float * src2 = ctx->input_frame->channels.f[1];
+  int16_t * dst = ctx->output_frame->samples.s_16;
+
+  for(i = 0; i < ctx->input_frame->valid_samples; i++)
+    {
+    tmp = lrintf(*(src1++) * 32768.0);
+    CLAMP(tmp, -32768, 32767);
+    *(dst++) = tmp;
+    tmp = lrintf(*(src2++) * 32768.0);
+    CLAMP(tmp, -32768, 32767);
+    *(dst++) = tmp;
+    }
+  }
+
+/* Packed formats */
+
+#undef RENAME
+
+#define GET_S24(p) \
+  (int32_t)(((uint32_t)(p)[0] << 8) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 24))
+#define PUT_S24(p, v) \
+  (p)[0] = (v) & 0xff; (p)[1] = ((v) >> 8) & 0xff; (p)[2] = ((v) >> 16) & 0xff;
+#define RENAME(a) s24le_ ## a
+
+#include "_packed_c.c"
+
+#define GET_S24(p) \
+  (int32_t)(((uint32_t)(p)[2] << 8) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[0] << 24))
+#define PUT_S24(p, v) \
+  (p)[2] = (v) & 0xff; (p)[1] = ((v) >> 8) & 0xff; (p)[0] = ((v) >> 16) & 0xff;
+#define RENAME(a) s24be_ ## a
+
+#include "_packed_c.c"
+
+#define SET_PACKED(idx, prefix) \
+  t->unpack[idx][GAVL_UNPACKED_S16]    = prefix ## _to_s16;     \
+  t->unpack[idx][GAVL_UNPACKED_S32]    = prefix ## _to_s32;     \
+  t->unpack[idx][GAVL_UNPACKED_FLOAT]  = prefix ## _to_float;   \
+  t->unpack[idx][GAVL_UNPACKED_DOUBLE] = prefix ## _to_double;  \
+  t->pack[idx][GAVL_UNPACKED_S16]      = prefix ## _from_s16;   \
+  t->pack[idx][GAVL_UNPACKED_S32]      = prefix ## _from_s32;   \
+  t->pack[idx][GAVL_UNPACKED_FLOAT]    = prefix ## _from_float; \
+  t->pack[idx][GAVL_UNPACKED_DOUBLE]   = prefix ## _from_double;
+
 void gavl_init_sampleformat_funcs_c(gavl_sampleformat_table_t * t, gavl_interleave_mode_t interleave_mode)
   {
+  SET_PACKED(GAVL_PACKED_S24LE, s24le);
+  SET_PACKED(GAVL_PACKED_S24BE, s24be);
+  
+  t->convert_s16_i_to_float_ni        = convert_s16_i_to_float_ni;
+  t->convert_s16_i_to_float_ni_stereo = convert_s16_i_to_float_ni_stereo;
+  t->convert_float_ni_to_s16_i        = convert_float_ni_to_s16_i;
+  t->convert_float_ni_to_s16_i_stereo = convert_float_ni_to_s16_i_stereo;
+  
   if(interleave_mode == GAVL_INTERLEAVE_NONE)
     return gavl_init_sampleformat_funcs_c_ni(t);
   else if(interleave_mode == GAVL_INTERLEAVE_ALL)
@@ -101,6 +101,50 @@ static void set_volume_s32_c(gavl_volume_control_t * v, void * samples,
     }
   }
 
+/* Packed 24 bit samples */
+
+#define GET_S24LE(p) \
+  ((int32_t)(((uint32_t)(p)[0] << 8) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 24)) >> 8)
+#define PUT_S24LE(p, v) \
+  (p)[0] = (v) & 0xff; (p)[1] = ((v) >> 8) & 0xff; (p)[2] = ((v) >> 16) & 0xff;
+
+#define GET_S24BE(p) \
+  ((int32_t)(((uint32_t)(p)[2] << 8) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[0] << 24)) >> 8)
+#define PUT_S24BE(p, v) \
+  (p)[2] = (v) & 0xff; (p)[1] = ((v) >> 8) & 0xff; (p)[0] = ((v) >> 16) & 0xff;
+
+static void set_volume_s24le_c(gavl_volume_control_t * v, void * samples,
+                               int num_samples)
+  {
+  int i;
+  int64_t sample;
+  uint8_t * s = (uint8_t*)samples;
+  
+  for(i = 0; i < num_samples; i++)
+    {
+    sample = ((int64_t)GET_S24LE(s) * v->factor_i) >> 23;
+    CLAMP(sample, -8388608, 8388607);
+    PUT_S24LE(s, sample);
+    s += 3;
+    }
+  }
+
+static void set_volume_s24be_c(gavl_volume_control_t * v, void * samples,
+                               int num_samples)
+  {
+  int i;
+  int64_t sample;
+  uint8_t * s = (uint8_t*)samples;
+  
+  for(i = 0; i < num_samples; i++)
+    {
+    sample = ((int64_t)GET_S24BE(s) * v->factor_i) >> 23;
+    CLAMP(sample, -8388608, 8388607);
+    PUT_S24BE(s, sample);
+    s += 3;
+    }
+  }
+
 static void set_volume_float_c(gavl_volume_control_t * v,
                                void * samples,
                                int num_samples)
@@ -131,6 +175,9 @@ void gavl_init_volume_funcs_c(gavl_volume_funcs_t * v)
   
   v->set_volume_s32 = set_volume_s32_c;
 
+  v->set_volume_s24le = set_volume_s24le_c;
+  v->set_volume_s24be = set_volume_s24be_c;
+
   v->set_volume_float = set_volume_float_c;
   v->set_volume_double = set_volume_double_c;
   }
@@ -0,0 +1,781 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/*
+ *  Conversions for the semi planar (NV12, NV21, P010, P016) and the
+ *  10 bit planar formats.
+ *
+ *  We only have direct conversions to and from the formats closest to
+ *  them (YUV 420 Planar for NV12/NV21 and YUV 422 Planar (16 bit) for the
+ *  others) plus some shortcuts for common cases. Everything else is
+ *  done in 2 steps by the video converter (see gavl_pixelformat_get_relay()).
+ *
+ *  Semi planar frames are passed to the planar templates with a shadow
+ *  frame, where planes[1] and planes[2] point to the first Cb and Cr
+ *  samples of the interleaved chroma plane. The chroma advance
+ *  is 2 in this case. NV21 is handled by swapping the 2 pointers.
+ */
+
+#include <gavl/gavl.h>
+#include <video.h>
+#include <colorspace.h>
+
+#include "colorspace_tables.h"
+#include "colorspace_macros.h"
+
+#include <accel.h>
+
+/* 16 <-> 10 <-> 8 bit shifts */
+
+#ifdef DO_ROUND
+#define Y_16_TO_10(val) (((val)+0x20)>>6)
+#define Y_10_TO_8(val)  (((val)+0x02)>>2)
+#else
+#define Y_16_TO_10(val) ((val)>>6)
+#define Y_10_TO_8(val)  ((val)>>2)
+#endif
+
+#define Y_10_TO_16(val) ((val)<<6)
+#define Y_8_TO_10(val)  ((val)<<2)
+
+/* P010 has the 10 significant bits in the MSBs */
+#define Y_16_TO_P010(val) (Y_16_TO_10(val)<<6)
+
+static void get_shadow_frame(const gavl_video_frame_t * src,
+                             gavl_video_frame_t * dst,
+                             gavl_pixelformat_t pixelformat)
+  {
+  int bpc = gavl_pixelformat_bytes_per_component(pixelformat);
+
+  dst->planes[0]  = src->planes[0];
+  dst->strides[0] = src->strides[0];
+
+  if(pixelformat == GAVL_NV21)
+    {
+    dst->planes[1] = src->planes[1] + bpc;
+    dst->planes[2] = src->planes[1];
+    }
+  else
+    {
+    dst->planes[1] = src->planes[1];
+    dst->planes[2] = src->planes[1] + bpc;
+    }
+  dst->strides[1] = src->strides[1];
+  dst->strides[2] = src->strides[1];
+  }
+
+static void convert_semiplanar(gavl_video_convert_context_t * ctx,
+                               gavl_video_func_t func)
+  {
+  gavl_video_convert_context_t c;
+  gavl_video_frame_t in_frame;
+  gavl_video_frame_t out_frame;
+
+  c = *ctx;
+
+  if(gavl_pixelformat_is_semiplanar(ctx->input_format.pixelformat))
+    {
+    get_shadow_frame(ctx->input_frame, &in_frame,
+                     ctx->input_format.pixelformat);
+    c.input_frame = &in_frame;
+    }
+  if(gavl_pixelformat_is_semiplanar(ctx->output_format.pixelformat))
+    {
+    get_shadow_frame(ctx->output_frame, &out_frame,
+                     ctx->output_format.pixelformat);
+    c.output_frame = &out_frame;
+    }
+  func(&c);
+  }
+
+#define SEMIPLANAR_FUNC(name) \
+static void name##_c(gavl_video_convert_context_t * ctx) \
+  { \
+  convert_semiplanar(ctx, name##_sp); \
+  }
+
+/*
+ *  NV12 <-> YUV 420 Planar
+ */
+
+#define FUNC_NAME     nv12_to_yuv_420_p_sp
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  2
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0] = src_y[0]; \
+  dst_y[1] = src_y[1]; \
+  dst_u[0] = src_u[0]; \
+  dst_v[0] = src_v[0];
+
+#define CONVERT_Y    \
+  dst_y[0] = src_y[0]; \
+  dst_y[1] = src_y[1];
+
+#include "../csp_planar_planar.h"
+
+SEMIPLANAR_FUNC(nv12_to_yuv_420_p)
+
+#define FUNC_NAME     yuv_420_p_to_nv12_sp
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0] = src_y[0]; \
+  dst_y[1] = src_y[1]; \
+  dst_u[0] = src_u[0]; \
+  dst_v[0] = src_v[0];
+
+#define CONVERT_Y    \
+  dst_y[0] = src_y[0]; \
+  dst_y[1] = src_y[1];
+
+#include "../csp_planar_planar.h"
+
+SEMIPLANAR_FUNC(yuv_420_p_to_nv12)
+
+/* NV12 <-> NV21: The shadow frames do the swapping */
+
+#define FUNC_NAME     nv12_to_nv21_sp
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  2
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0] = src_y[0]; \
+  dst_y[1] = src_y[1]; \
+  dst_u[0] = src_u[0]; \
+  dst_v[0] = src_v[0];
+
+#define CONVERT_Y    \
+  dst_y[0] = src_y[0]; \
+  dst_y[1] = src_y[1];
+
+#include "../csp_planar_planar.h"
+
+SEMIPLANAR_FUNC(nv12_to_nv21)
+
+/*
+ *  NV12 -> RGB
+ */
+
+#define FUNC_NAME nv12_to_rgb_24_sp
+#define IN_TYPE uint8_t
+#define OUT_TYPE uint8_t
+#define IN_ADVANCE_Y  2
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   6
+#define NUM_PIXELS    2
+#define CHROMA_SUB    2
+#define CONVERT \
+  YUV_8_TO_RGB_24(src_y[0], src_u[0], src_v[0], dst[0], dst[1], dst[2])\
+  YUV_8_TO_RGB_24(src_y[1], src_u[0], src_v[0], dst[3], dst[4], dst[5])
+
+#define INIT   int32_t i_tmp;
+
+#include "../csp_planar_packed.h"
+
+SEMIPLANAR_FUNC(nv12_to_rgb_24)
+
+#define FUNC_NAME nv12_to_bgr_24_sp
+#define IN_TYPE uint8_t
+#define OUT_TYPE uint8_t
+#define IN_ADVANCE_Y  2
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   6
+#define NUM_PIXELS    2
+#define CHROMA_SUB    2
+#define CONVERT \
+  YUV_8_TO_RGB_24(src_y[0], src_u[0], src_v[0], dst[2], dst[1], dst[0])\
+  YUV_8_TO_RGB_24(src_y[1], src_u[0], src_v[0], dst[5], dst[4], dst[3])
+
+#define INIT   int32_t i_tmp;
+
+#include "../csp_planar_packed.h"
+
+SEMIPLANAR_FUNC(nv12_to_bgr_24)
+
+#define FUNC_NAME nv12_to_rgb_32_sp
+#define IN_TYPE uint8_t
+#define OUT_TYPE uint8_t
+#define IN_ADVANCE_Y  2
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   8
+#define NUM_PIXELS    2
+#define CHROMA_SUB    2
+#define CONVERT \
+  YUV_8_TO_RGB_24(src_y[0], src_u[0], src_v[0], dst[0], dst[1], dst[2])\
+  YUV_8_TO_RGB_24(src_y[1], src_u[0], src_v[0], dst[4], dst[5], dst[6])
+
+#define INIT   int32_t i_tmp;
+
+#include "../csp_planar_packed.h"
+
+SEMIPLANAR_FUNC(nv12_to_rgb_32)
+
+#define FUNC_NAME nv12_to_bgr_32_sp
+#define IN_TYPE uint8_t
+#define OUT_TYPE uint8_t
+#define IN_ADVANCE_Y  2
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   8
+#define NUM_PIXELS    2
+#define CHROMA_SUB    2
+#define CONVERT \
+  YUV_8_TO_RGB_24(src_y[0], src_u[0], src_v[0], dst[2], dst[1], dst[0])\
+  YUV_8_TO_RGB_24(src_y[1], src_u[0], src_v[0], dst[6], dst[5], dst[4])
+
+#define INIT   int32_t i_tmp;
+
+#include "../csp_planar_packed.h"
+
+SEMIPLANAR_FUNC(nv12_to_bgr_32)
+
+#define FUNC_NAME nv12_to_rgba_32_sp
+#define IN_TYPE uint8_t
+#define OUT_TYPE uint8_t
+#define IN_ADVANCE_Y  2
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   8
+#define NUM_PIXELS    2
+#define CHROMA_SUB    2
+#define CONVERT \
+  YUV_8_TO_RGB_24(src_y[0], src_u[0], src_v[0], dst[0], dst[1], dst[2])\
+  dst[3] = 0xff;\
+  YUV_8_TO_RGB_24(src_y[1], src_u[0], src_v[0], dst[4], dst[5], dst[6])\
+  dst[7] = 0xff;
+
+#define INIT   int32_t i_tmp;
+
+#include "../csp_planar_packed.h"
+
+SEMIPLANAR_FUNC(nv12_to_rgba_32)
+
+/*
+ *  RGB -> NV12
+ */
+
+#define FUNC_NAME      rgb_24_to_nv12_sp
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     6
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CONVERT_YUV    \
+    RGB_24_TO_YUV_8(src[0],src[1],src[2], \
+               dst_y[0],*dst_u,*dst_v) \
+    RGB_24_TO_Y_8(src[3],src[4],src[5],dst_y[1])
+
+#define CONVERT_Y      \
+    RGB_24_TO_Y_8(src[0],src[1],src[2],dst_y[0]) \
+    RGB_24_TO_Y_8(src[3],src[4],src[5],dst_y[1])
+
+#define CHROMA_SUB     2
+
+#include "../csp_packed_planar.h"
+
+SEMIPLANAR_FUNC(rgb_24_to_nv12)
+
+#define FUNC_NAME      bgr_24_to_nv12_sp
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     6
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CONVERT_YUV    \
+    RGB_24_TO_YUV_8(src[2],src[1],src[0], \
+               dst_y[0],*dst_u,*dst_v) \
+    RGB_24_TO_Y_8(src[5],src[4],src[3],dst_y[1])
+
+#define CONVERT_Y      \
+    RGB_24_TO_Y_8(src[2],src[1],src[0],dst_y[0]) \
+    RGB_24_TO_Y_8(src[5],src[4],src[3],dst_y[1])
+
+#define CHROMA_SUB     2
+
+#include "../csp_packed_planar.h"
+
+SEMIPLANAR_FUNC(bgr_24_to_nv12)
+
+#define FUNC_NAME      rgb_32_to_nv12_sp
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     8
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CONVERT_YUV    \
+    RGB_24_TO_YUV_8(src[0],src[1],src[2], \
+               dst_y[0],*dst_u,*dst_v) \
+    RGB_24_TO_Y_8(src[4],src[5],src[6],dst_y[1])
+
+#define CONVERT_Y      \
+    RGB_24_TO_Y_8(src[0],src[1],src[2],dst_y[0]) \
+    RGB_24_TO_Y_8(src[4],src[5],src[6],dst_y[1])
+
+#define CHROMA_SUB     2
+
+#include "../csp_packed_planar.h"
+
+SEMIPLANAR_FUNC(rgb_32_to_nv12)
+
+#define FUNC_NAME      bgr_32_to_nv12_sp
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     8
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CONVERT_YUV    \
+    RGB_24_TO_YUV_8(src[2],src[1],src[0], \
+               dst_y[0],*dst_u,*dst_v) \
+    RGB_24_TO_Y_8(src[6],src[5],src[4],dst_y[1])
+
+#define CONVERT_Y      \
+    RGB_24_TO_Y_8(src[2],src[1],src[0],dst_y[0]) \
+    RGB_24_TO_Y_8(src[6],src[5],src[4],dst_y[1])
+
+#define CHROMA_SUB     2
+
+#include "../csp_packed_planar.h"
+
+SEMIPLANAR_FUNC(bgr_32_to_nv12)
+
+/*
+ *  NV12 <-> P016
+ */
+
+#define FUNC_NAME     nv12_to_p016_sp
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  2
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0] = Y_8_TO_16(src_y[0]); \
+  dst_y[1] = Y_8_TO_16(src_y[1]); \
+  dst_u[0] = UV_8_TO_16(src_u[0]); \
+  dst_v[0] = UV_8_TO_16(src_v[0]);
+
+#define CONVERT_Y    \
+  dst_y[0] = Y_8_TO_16(src_y[0]); \
+  dst_y[1] = Y_8_TO_16(src_y[1]);
+
+#include "../csp_planar_planar.h"
+
+SEMIPLANAR_FUNC(nv12_to_p016)
+
+#define FUNC_NAME     p016_to_nv12_sp
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  2
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  Y_16_TO_Y_8(src_y[0], dst_y[0]);     \
+  Y_16_TO_Y_8(src_y[1], dst_y[1]);     \
+  UV_16_TO_UV_8(src_u[0], dst_u[0]);   \
+  UV_16_TO_UV_8(src_v[0], dst_v[0]);
+
+#define CONVERT_Y    \
+  Y_16_TO_Y_8(src_y[0], dst_y[0]);     \
+  Y_16_TO_Y_8(src_y[1], dst_y[1]);
+
+#include "../csp_planar_planar.h"
+
+SEMIPLANAR_FUNC(p016_to_nv12)
+
+/*
+ *  P016 <-> YUV 422 Planar (16 bit)
+ *  P010 can be read like P016
+ */
+
+#define FUNC_NAME     p016_to_yuv_422_p_16_sp
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  2
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 1
+#define CONVERT_YUV    \
+  dst_y[0] = src_y[0]; \
+  dst_y[1] = src_y[1]; \
+  dst_u[0] = src_u[0]; \
+  dst_v[0] = src_v[0];
+
+#include "../csp_planar_planar.h"
+
+SEMIPLANAR_FUNC(p016_to_yuv_422_p_16)
+
+#define FUNC_NAME     yuv_422_p_16_to_p016_sp
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  1
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0] = src_y[0]; \
+  dst_y[1] = src_y[1]; \
+  dst_u[0] = src_u[0]; \
+  dst_v[0] = src_v[0];
+
+#define CONVERT_Y    \
+  dst_y[0] = src_y[0]; \
+  dst_y[1] = src_y[1];
+
+#include "../csp_planar_planar.h"
+
+SEMIPLANAR_FUNC(yuv_422_p_16_to_p016)
+
+#define FUNC_NAME     yuv_422_p_16_to_p010_sp
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  1
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0] = Y_16_TO_P010(src_y[0]); \
+  dst_y[1] = Y_16_TO_P010(src_y[1]); \
+  dst_u[0] = Y_16_TO_P010(src_u[0]); \
+  dst_v[0] = Y_16_TO_P010(src_v[0]);
+
+#define CONVERT_Y    \
+  dst_y[0] = Y_16_TO_P010(src_y[0]); \
+  dst_y[1] = Y_16_TO_P010(src_y[1]);
+
+#include "../csp_planar_planar.h"
+
+SEMIPLANAR_FUNC(yuv_422_p_16_to_p010)
+
+/*
+ *  P016 <-> P010
+ */
+
+#define FUNC_NAME     p016_to_p010_sp
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  2
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0] = Y_16_TO_P010(src_y[0]); \
+  dst_y[1] = Y_16_TO_P010(src_y[1]); \
+  dst_u[0] = Y_16_TO_P010(src_u[0]); \
+  dst_v[0] = Y_16_TO_P010(src_v[0]);
+
+#define CONVERT_Y    \
+  dst_y[0] = Y_16_TO_P010(src_y[0]); \
+  dst_y[1] = Y_16_TO_P010(src_y[1]);
+
+#include "../csp_planar_planar.h"
+
+SEMIPLANAR_FUNC(p016_to_p010)
+
+/* P010 is valid P016 */
+
+static void p010_to_p016_c(gavl_video_convert_context_t * ctx)
+  {
+  gavl_video_frame_copy(&ctx->input_format,
+                        ctx->output_frame, ctx->input_frame);
+  }
+
+/*
+ *  P016 <-> YUV 420 Planar
+ */
+
+#define FUNC_NAME     p016_to_yuv_420_p_sp
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  2
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  Y_16_TO_Y_8(src_y[0], dst_y[0]);     \
+  Y_16_TO_Y_8(src_y[1], dst_y[1]);     \
+  UV_16_TO_UV_8(src_u[0], dst_u[0]);   \
+  UV_16_TO_UV_8(src_v[0], dst_v[0]);
+
+#define CONVERT_Y    \
+  Y_16_TO_Y_8(src_y[0], dst_y[0]);     \
+  Y_16_TO_Y_8(src_y[1], dst_y[1]);
+
+#include "../csp_planar_planar.h"
+
+SEMIPLANAR_FUNC(p016_to_yuv_420_p)
+
+/* The result is also valid P010 */
+
+#define FUNC_NAME     yuv_420_p_to_p016_sp
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0] = Y_8_TO_16(src_y[0]); \
+  dst_y[1] = Y_8_TO_16(src_y[1]); \
+  dst_u[0] = UV_8_TO_16(src_u[0]); \
+  dst_v[0] = UV_8_TO_16(src_v[0]);
+
+#define CONVERT_Y    \
+  dst_y[0] = Y_8_TO_16(src_y[0]); \
+  dst_y[1] = Y_8_TO_16(src_y[1]);
+
+#include "../csp_planar_planar.h"
+
+SEMIPLANAR_FUNC(yuv_420_p_to_p016)
+
+/*
+ *  P016 <-> YUV 420 Planar (10 bit)
+ */
+
+#define FUNC_NAME     p016_to_yuv_420_p_10_sp
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  2
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0] = Y_16_TO_10(src_y[0]); \
+  dst_y[1] = Y_16_TO_10(src_y[1]); \
+  dst_u[0] = Y_16_TO_10(src_u[0]); \
+  dst_v[0] = Y_16_TO_10(src_v[0]);
+
+#define CONVERT_Y    \
+  dst_y[0] = Y_16_TO_10(src_y[0]); \
+  dst_y[1] = Y_16_TO_10(src_y[1]);
+
+#include "../csp_planar_planar.h"
+
+SEMIPLANAR_FUNC(p016_to_yuv_420_p_10)
+
+/* The result is also valid P010 */
+
+#define FUNC_NAME     yuv_420_p_10_to_p016_sp
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0] = Y_10_TO_16(src_y[0]); \
+  dst_y[1] = Y_10_TO_16(src_y[1]); \
+  dst_u[0] = Y_10_TO_16(src_u[0]); \
+  dst_v[0] = Y_10_TO_16(src_v[0]);
+
+#define CONVERT_Y    \
+  dst_y[0] = Y_10_TO_16(src_y[0]); \
+  dst_y[1] = Y_10_TO_16(src_y[1]);
+
+#include "../csp_planar_planar.h"
+
+SEMIPLANAR_FUNC(yuv_420_p_10_to_p016)
+
+/*
+ *  YUV 420 Planar (10 bit) <-> YUV 422 Planar (16 bit)
+ */
+
+#define FUNC_NAME     yuv_420_p_10_to_yuv_422_p_16_c
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 1
+#define CONVERT_YUV    \
+  dst_y[0] = Y_10_TO_16(src_y[0]); \
+  dst_y[1] = Y_10_TO_16(src_y[1]); \
+  dst_u[0] = Y_10_TO_16(src_u[0]); \
+  dst_v[0] = Y_10_TO_16(src_v[0]);
+
+#include "../csp_planar_planar.h"
+
+#define FUNC_NAME     yuv_422_p_16_to_yuv_420_p_10_c
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  1
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0] = Y_16_TO_10(src_y[0]); \
+  dst_y[1] = Y_16_TO_10(src_y[1]); \
+  dst_u[0] = Y_16_TO_10(src_u[0]); \
+  dst_v[0] = Y_16_TO_10(src_v[0]);
+
+#define CONVERT_Y    \
+  dst_y[0] = Y_16_TO_10(src_y[0]); \
+  dst_y[1] = Y_16_TO_10(src_y[1]);
+
+#include "../csp_planar_planar.h"
+
+/*
+ *  YUV 420 Planar (10 bit) <-> YUV 420 Planar
+ */
+
+#define FUNC_NAME     yuv_420_p_10_to_yuv_420_p_c
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0] = Y_10_TO_8(src_y[0]); \
+  dst_y[1] = Y_10_TO_8(src_y[1]); \
+  dst_u[0] = Y_10_TO_8(src_u[0]); \
+  dst_v[0] = Y_10_TO_8(src_v[0]);
+
+#define CONVERT_Y    \
+  dst_y[0] = Y_10_TO_8(src_y[0]); \
+  dst_y[1] = Y_10_TO_8(src_y[1]);
+
+#include "../csp_planar_planar.h"
+
+#define FUNC_NAME     yuv_420_p_to_yuv_420_p_10_c
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0] = Y_8_TO_10(src_y[0]); \
+  dst_y[1] = Y_8_TO_10(src_y[1]); \
+  dst_u[0] = Y_8_TO_10(src_u[0]); \
+  dst_v[0] = Y_8_TO_10(src_v[0]);
+
+#define CONVERT_Y    \
+  dst_y[0] = Y_8_TO_10(src_y[0]); \
+  dst_y[1] = Y_8_TO_10(src_y[1]);
+
+#include "../csp_planar_planar.h"
+
+void gavl_init_yuv_semiplanar_funcs_c(gavl_pixelformat_function_table_t * tab,
+                                      const gavl_video_options_t * opt)
+  {
+  tab->nv12_to_yuv_420_p = nv12_to_yuv_420_p_c;
+  tab->yuv_420_p_to_nv12 = yuv_420_p_to_nv12_c;
+  tab->nv12_to_nv21      = nv12_to_nv21_c;
+
+  tab->nv12_to_rgb_24    = nv12_to_rgb_24_c;
+  tab->nv12_to_bgr_24    = nv12_to_bgr_24_c;
+  tab->nv12_to_rgb_32    = nv12_to_rgb_32_c;
+  tab->nv12_to_bgr_32    = nv12_to_bgr_32_c;
+  tab->nv12_to_rgba_32   = nv12_to_rgba_32_c;
+
+  tab->rgb_24_to_nv12    = rgb_24_to_nv12_c;
+  tab->bgr_24_to_nv12    = bgr_24_to_nv12_c;
+  tab->rgb_32_to_nv12    = rgb_32_to_nv12_c;
+  tab->bgr_32_to_nv12    = bgr_32_to_nv12_c;
+
+  tab->nv12_to_p016      = nv12_to_p016_c;
+  tab->p016_to_nv12      = p016_to_nv12_c;
+
+  tab->p016_to_yuv_422_p_16 = p016_to_yuv_422_p_16_c;
+  tab->yuv_422_p_16_to_p016 = yuv_422_p_16_to_p016_c;
+  tab->yuv_422_p_16_to_p010 = yuv_422_p_16_to_p010_c;
+
+  tab->p016_to_p010 = p016_to_p010_c;
+  tab->p010_to_p016 = p010_to_p016_c;
+
+  tab->p016_to_yuv_420_p = p016_to_yuv_420_p_c;
+  tab->yuv_420_p_to_p016 = yuv_420_p_to_p016_c;
+
+  tab->p016_to_yuv_420_p_10 = p016_to_yuv_420_p_10_c;
+  tab->yuv_420_p_10_to_p016 = yuv_420_p_10_to_p016_c;
+
+  tab->yuv_420_p_10_to_yuv_422_p_16 = yuv_420_p_10_to_yuv_422_p_16_c;
+  tab->yuv_422_p_16_to_yuv_420_p_10 = yuv_422_p_16_to_yuv_420_p_10_c;
+
+  tab->yuv_420_p_10_to_yuv_420_p = yuv_420_p_10_to_yuv_420_p_c;
+  tab->yuv_420_p_to_yuv_420_p_10 = yuv_420_p_to_yuv_420_p_10_c;
+  }
@@ -1456,6 +1456,60 @@ static int get_channel_properties(gavl_pixelformat_t src_format,
           return 0;
         }
       break;
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_P010:
+    case GAVL_P016:
+      if(src_format == GAVL_NV12 || src_format == GAVL_NV21)
+        {
+        dst_format = GAVL_GRAY_8;
+        if(ch == GAVL_CCH_Y)
+          {
+          d->extract_func = extract_8_y;
+          d->insert_func = insert_8_y;
+          }
+        else
+          {
+          d->extract_func = extract_8_uv;
+          d->insert_func = insert_8_uv;
+          }
+        }
+      else
+        {
+        dst_format = GAVL_GRAY_16;
+        if(ch == GAVL_CCH_Y)
+          {
+          d->extract_func = extract_16_y;
+          d->insert_func = insert_16_y;
+          }
+        else
+          {
+          d->extract_func = extract_16_uv;
+          d->insert_func = insert_16_uv;
+          }
+        }
+      /* Cb and Cr are interleaved in plane 1 */
+      switch(ch)
+        {
+        case GAVL_CCH_Y:
+          d->plane  = 0;
+          break;
+        case GAVL_CCH_CB:
+          d->plane  = 1;
+          d->offset = (src_format == GAVL_NV21) ? 1 : 0;
+          d->advance = 2;
+          break;
+        case GAVL_CCH_CR:
+          d->plane  = 1;
+          d->offset = (src_format == GAVL_NV21) ? 0 : 1;
+          d->advance = 2;
+          break;
+        default:
+          return 0;
+        }
+      break;
+    case GAVL_YUV_420_P_10: /* Not supported */
+      return 0;
     }
 
   /* Get chroma subsampling */
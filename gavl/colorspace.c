@@ -83,7 +83,12 @@ const pixelformat_tab_t pixelformat_tab[] =
     { GAVL_YUV_444_P_16, "YUV 444 Planar (16 bit)", "yuv444p16" },
     { GAVL_YUVJ_420_P, "YUVJ 420 Planar",           "yuvj420p8" },
     { GAVL_YUVJ_422_P, "YUVJ 422 Planar",           "yuvj422p8" },
-    { GAVL_YUVJ_444_P, "YUVJ 444 Planar",           "yuvj444p8" }
+    { GAVL_YUVJ_444_P, "YUVJ 444 Planar",           "yuvj444p8" },
+    { GAVL_YUV_420_P_10, "YUV 420 Planar (10 bit)", "yuv420p10" },
+    { GAVL_NV12, "YUV 420 Semi planar (NV12)",      "nv12"      },
+    { GAVL_NV21, "YUV 420 Semi planar (NV21)",      "nv21"      },
+    { GAVL_P010, "YUV 420 Semi planar (P010)",      "p010"      },
+    { GAVL_P016, "YUV 420 Semi planar (P016)",      "p016"      }
   };
 
 static const int num_pixelformats =
@@ -130,8 +135,15 @@ int gavl_pixelformat_num_planes(gavl_pixelformat_t csp)
     case GAVL_YUVJ_420_P:
     case GAVL_YUVJ_422_P:
     case GAVL_YUVJ_444_P:
+    case GAVL_YUV_420_P_10:
       return 3;
       break;
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_P010:
+    case GAVL_P016:
+      return 2;
+      break;
     case GAVL_PIXELFORMAT_NONE:
       return 0;
       break;
@@ -178,6 +190,11 @@ void gavl_pixelformat_chroma_sub(gavl_pixelformat_t csp, int * sub_hp,
       break;
     case GAVL_YUV_420_P:
     case GAVL_YUVJ_420_P:
+    case GAVL_YUV_420_P_10:
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_P010:
+    case GAVL_P016:
       sub_h = 2;
       sub_v = 2;
       break;
@@ -300,6 +317,7 @@ create_pixelformat_function_table(const gavl_video_options_t * opt,
     gavl_init_yuv_gray_funcs_c(csp_tab, opt);
     gavl_init_gray_yuv_funcs_c(csp_tab, opt);
     gavl_init_gray_gray_funcs_c(csp_tab, opt);
+    gavl_init_yuv_semiplanar_funcs_c(csp_tab, opt);
     }
   
 #ifdef HAVE_MMX
@@ -339,6 +357,14 @@ create_pixelformat_function_table(const gavl_video_options_t * opt,
     //    gavl_init_yuv_yuv_funcs_sse(csp_tab, opt);
     //    gavl_init_yuv_rgb_funcs_sse(csp_tab, opt);
     }
+#endif
+#ifdef HAVE_AVX2
+  if(opt->accel_flags & GAVL_ACCEL_AVX2)
+    {
+    gavl_init_rgb_yuv_funcs_avx2(csp_tab, width, opt);
+    gavl_init_yuv_rgb_funcs_avx2(csp_tab, width, opt);
+    gavl_init_yuv_yuv_funcs_avx2(csp_tab, width, opt);
+    }
 #endif
   /* High quality */
   
@@ -356,6 +382,140 @@ create_pixelformat_function_table(const gavl_video_options_t * opt,
   return csp_tab;
   }
 
+gavl_pixelformat_t gavl_pixelformat_get_relay(gavl_pixelformat_t pixelformat)
+  {
+  switch(pixelformat)
+    {
+    case GAVL_NV12:
+    case GAVL_NV21:
+      return GAVL_YUV_420_P;
+    case GAVL_P010:
+    case GAVL_P016:
+    case GAVL_YUV_420_P_10:
+      return GAVL_YUV_422_P_16;
+    default:
+      break;
+    }
+  return GAVL_PIXELFORMAT_NONE;
+  }
+
+static gavl_video_func_t
+find_semiplanar_converter(gavl_pixelformat_function_table_t * tab,
+                          gavl_pixelformat_t in, gavl_pixelformat_t out)
+  {
+  switch(in)
+    {
+    case GAVL_NV12:
+    case GAVL_NV21:
+      switch(out)
+        {
+        case GAVL_YUV_420_P:
+          return tab->nv12_to_yuv_420_p;
+        case GAVL_NV12:
+        case GAVL_NV21:
+          return tab->nv12_to_nv21;
+        case GAVL_RGB_24:
+          return tab->nv12_to_rgb_24;
+        case GAVL_BGR_24:
+          return tab->nv12_to_bgr_24;
+        case GAVL_RGB_32:
+          return tab->nv12_to_rgb_32;
+        case GAVL_BGR_32:
+          return tab->nv12_to_bgr_32;
+        case GAVL_RGBA_32:
+          return tab->nv12_to_rgba_32;
+        case GAVL_P010:
+        case GAVL_P016:
+          return tab->nv12_to_p016;
+        default:
+          break;
+        }
+      break;
+    case GAVL_P010:
+    case GAVL_P016:
+      switch(out)
+        {
+        case GAVL_YUV_422_P_16:
+          return tab->p016_to_yuv_422_p_16;
+        case GAVL_YUV_420_P:
+          return tab->p016_to_yuv_420_p;
+        case GAVL_YUV_420_P_10:
+          return tab->p016_to_yuv_420_p_10;
+        case GAVL_NV12:
+        case GAVL_NV21:
+          return tab->p016_to_nv12;
+        case GAVL_P010:
+          return tab->p016_to_p010;
+        case GAVL_P016:
+          return tab->p010_to_p016;
+        default:
+          break;
+        }
+      break;
+    case GAVL_YUV_420_P_10:
+      switch(out)
+        {
+        case GAVL_YUV_422_P_16:
+          return tab->yuv_420_p_10_to_yuv_422_p_16;
+        case GAVL_YUV_420_P:
+          return tab->yuv_420_p_10_to_yuv_420_p;
+        case GAVL_P010:
+        case GAVL_P016:
+          return tab->yuv_420_p_10_to_p016;
+        default:
+          break;
+        }
+      break;
+    case GAVL_YUV_420_P:
+      switch(out)
+        {
+        case GAVL_NV12:
+        case GAVL_NV21:
+          return tab->yuv_420_p_to_nv12;
+        case GAVL_P010:
+        case GAVL_P016:
+          return tab->yuv_420_p_to_p016;
+        case GAVL_YUV_420_P_10:
+          return tab->yuv_420_p_to_yuv_420_p_10;
+        default:
+          break;
+        }
+      break;
+    case GAVL_YUV_422_P_16:
+      switch(out)
+        {
+        case GAVL_P010:
+          return tab->yuv_422_p_16_to_p010;
+        case GAVL_P016:
+          return tab->yuv_422_p_16_to_p016;
+        case GAVL_YUV_420_P_10:
+          return tab->yuv_422_p_16_to_yuv_420_p_10;
+        default:
+          break;
+        }
+      break;
+    case GAVL_RGB_24:
+      if(out == GAVL_NV12)
+        return tab->rgb_24_to_nv12;
+      break;
+    case GAVL_BGR_24:
+      if(out == GAVL_NV12)
+        return tab->bgr_24_to_nv12;
+      break;
+    case GAVL_RGB_32:
+      if(out == GAVL_NV12)
+        return tab->rgb_32_to_nv12;
+      break;
+    case GAVL_BGR_32:
+      if(out == GAVL_NV12)
+        return tab->bgr_32_to_nv12;
+      break;
+    default:
+      break;
+    }
+  return NULL;
+  }
+
 gavl_video_func_t
 gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
                                gavl_pixelformat_t input_pixelformat,
@@ -367,6 +527,14 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
   gavl_pixelformat_function_table_t * tab =
     create_pixelformat_function_table(opt, width, height);
 
+  if((gavl_pixelformat_get_relay(input_pixelformat) != GAVL_PIXELFORMAT_NONE) ||
+     (gavl_pixelformat_get_relay(output_pixelformat) != GAVL_PIXELFORMAT_NONE))
+    {
+    ret = find_semiplanar_converter(tab, input_pixelformat, output_pixelformat);
+    free(tab);
+    return ret;
+    }
+  
   switch(input_pixelformat)
     {
     case GAVL_GRAY_8:
@@ -453,6 +621,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->gray_8_to_yj_8;
           break;
           /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_8:
           break;
@@ -542,6 +715,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->graya_16_to_yj_8;
           break;
           /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAYA_16:
           break;
@@ -633,6 +811,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->gray_16_to_yj_8;
           break;
           /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_16:
           break;
@@ -722,6 +905,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->graya_32_to_yj_8;
           break;
           /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAYA_32:
           break;
@@ -813,6 +1001,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->gray_float_to_yj_8;
           break;
           /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_FLOAT:
           break;
@@ -903,6 +1096,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->graya_float_to_yj_8;
           break;
           /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAYA_FLOAT:
           break;
@@ -1015,6 +1213,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgb_15_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_15:
           break;
@@ -1126,6 +1329,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->bgr_15_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_BGR_15:
           break;
@@ -1238,6 +1446,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgb_16_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_16:
           break;
@@ -1350,6 +1563,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->bgr_16_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_BGR_16:
           break;
@@ -1461,6 +1679,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgb_24_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_24:
           break;
@@ -1572,6 +1795,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->bgr_24_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_BGR_24:
           break;
@@ -1683,6 +1911,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgb_32_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_32:
           break;
@@ -1794,6 +2027,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->bgr_32_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_BGR_32:
           break;
@@ -1905,6 +2143,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgba_32_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGBA_32:
           break;
@@ -2017,6 +2260,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgba_64_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGBA_64:
           break;
@@ -2129,6 +2377,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgba_float_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGBA_FLOAT:
           break;
@@ -2242,6 +2495,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgb_48_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_48:
           break;
@@ -2353,6 +2611,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgb_float_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_FLOAT:
           break;
@@ -2467,6 +2730,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuy2_to_yuv_float;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUY2:
           break;
@@ -2578,6 +2846,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->uyvy_to_yuv_float;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_UYVY:
           break;
@@ -2690,6 +2963,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuva_32_to_yuv_float;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUVA_32:
           break;
@@ -2802,6 +3080,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuva_64_to_yuv_float;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUVA_64:
           break;
@@ -2914,6 +3197,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuva_float_to_yuv_float;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUVA_FLOAT:
           break;
@@ -3026,6 +3314,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_float_to_yuva_float;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_FLOAT:
           break;
@@ -3139,6 +3432,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_420_p_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_420_P:
           break;
@@ -3251,6 +3549,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_410_p_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_410_P:
           break;
@@ -3362,6 +3665,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_422_p_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_422_P:
           break;
@@ -3474,6 +3782,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_422_p_16_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_422_P_16:
           break;
@@ -3587,6 +3900,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_411_p_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_411_P:
           break;
@@ -3699,6 +4017,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_444_p_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_444_P:
           break;
@@ -3812,6 +4135,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_444_p_16_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_444_P_16:
           break;
@@ -3925,6 +4253,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_420_p_to_yuv_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUVJ_420_P:
           break;
@@ -4036,6 +4369,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_422_p_to_yuv_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUVJ_422_P:
           break;
@@ -4147,6 +4485,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuvj_444_p_to_yuv_444_p_16;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUVJ_444_P:
           break;
@@ -4155,6 +4498,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
 
       
     case GAVL_PIXELFORMAT_NONE:
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_P010:
+    case GAVL_P016:
+    case GAVL_YUV_420_P_10:
       break;
     }
   free(tab);  
@@ -4203,10 +4551,15 @@ int gavl_pixelformat_bytes_per_component(gavl_pixelformat_t csp)
     case GAVL_YUVJ_420_P:
     case GAVL_YUVJ_422_P:
     case GAVL_YUVJ_444_P:
+    case GAVL_NV12:
+    case GAVL_NV21:
       return 1;
       break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_10:
+    case GAVL_P010:
+    case GAVL_P016:
       return 2;
     }
   return 0;
@@ -4276,6 +4629,11 @@ int gavl_pixelformat_bytes_per_pixel(gavl_pixelformat_t csp)
     case GAVL_YUVJ_420_P:
     case GAVL_YUVJ_422_P:
     case GAVL_YUVJ_444_P:
+    case GAVL_YUV_420_P_10:
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_P010:
+    case GAVL_P016:
       return 0;
     }
   return 0;
@@ -4341,10 +4699,15 @@ int gavl_pixelformat_bits_per_pixel(gavl_pixelformat_t pixelformat)
     case GAVL_YUV_420_P:
     case GAVL_YUVJ_420_P:
     case GAVL_YUV_411_P:
+    case GAVL_NV12:
+    case GAVL_NV21:
       return 12;
       break;
     case GAVL_YUV_444_P:
     case GAVL_YUVJ_444_P:
+    case GAVL_YUV_420_P_10:
+    case GAVL_P010:
+    case GAVL_P016:
       return 24;
       break;
     case GAVL_YUV_422_P_16:
@@ -4394,8 +4757,14 @@ static int effective_bits_per_component(gavl_pixelformat_t fmt)
     case GAVL_YUV_444_P:
     case GAVL_YUVJ_444_P:
     case GAVL_YUV_410_P:
+    case GAVL_NV12:
+    case GAVL_NV21:
       return 8;
       break;
+    case GAVL_YUV_420_P_10:
+    case GAVL_P010:
+      return 10;
+      break;
     case GAVL_GRAY_16:
     case GAVL_GRAYA_32:
     case GAVL_RGB_48:
@@ -4403,6 +4772,7 @@ static int effective_bits_per_component(gavl_pixelformat_t fmt)
     case GAVL_YUVA_64:
     case GAVL_YUV_422_P_16:
     case GAVL_YUV_444_P_16:
+    case GAVL_P016:
       return 16;
       break;
     case GAVL_GRAY_FLOAT:
@@ -4561,6 +4931,14 @@ int gavl_pixelformat_can_scale(gavl_pixelformat_t in_csp, gavl_pixelformat_t out
     return 0;
     }
 
+  /* Formats, which need a relay format for conversions, are never
+     converted by the scaler */
+  if((gavl_pixelformat_get_relay(in_csp) != GAVL_PIXELFORMAT_NONE) ||
+     (gavl_pixelformat_get_relay(out_csp) != GAVL_PIXELFORMAT_NONE))
+    {
+    return 0;
+    }
+
 
   
   gavl_pixelformat_chroma_sub(in_csp, &sub_h_in, &sub_v_in);
@@ -4607,7 +4985,13 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
   {
   switch(in_csp)
     {
-    case GAVL_PIXELFORMAT_NONE: return GAVL_PIXELFORMAT_NONE; break;
+    case GAVL_PIXELFORMAT_NONE:
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_P010:
+    case GAVL_P016:
+    case GAVL_YUV_420_P_10:
+      return GAVL_PIXELFORMAT_NONE; break;
     case GAVL_GRAY_8:
     case GAVL_GRAY_16:
     case GAVL_GRAY_FLOAT:
@@ -4634,6 +5018,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
       /*4:4:4 -> */
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_15:
         case GAVL_BGR_15:
@@ -4681,6 +5070,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUV_422_P:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
           return GAVL_PIXELFORMAT_NONE; break;
           /* YUV422 -> RGB */
@@ -4730,6 +5124,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUV_420_P:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
           return GAVL_PIXELFORMAT_NONE; break;
           /* YUV420 -> RGB */
@@ -4779,6 +5178,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUV_444_P:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_15:
         case GAVL_BGR_15:
@@ -4827,6 +5231,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUV_410_P:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_8:
         case GAVL_GRAY_16:
@@ -4877,6 +5286,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUVJ_420_P:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_8:
         case GAVL_GRAY_16:
@@ -4926,6 +5340,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUVJ_422_P:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_8:
         case GAVL_GRAY_16:
@@ -4972,6 +5391,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUVJ_444_P:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_8:
         case GAVL_GRAY_16:
@@ -5019,6 +5443,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUV_444_P_16:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_8:
         case GAVL_GRAY_16:
@@ -5063,6 +5492,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUV_422_P_16:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_P010:
+        case GAVL_P016:
+        case GAVL_YUV_420_P_10:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_15:
         case GAVL_BGR_15:
@@ -5199,9 +5633,21 @@ void gavl_pixelformat_get_offset(gavl_pixelformat_t pixelformat,
       break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_10:
       *advance = 2;
       *offset = 0;
       break;
+      /* For the chroma plane, we return the advance of a Cb/Cr pair */
+    case GAVL_NV12:
+    case GAVL_NV21:
+      *advance = plane ? 2 : 1;
+      *offset = 0;
+      break;
+    case GAVL_P010:
+    case GAVL_P016:
+      *advance = plane ? 4 : 2;
+      *offset = 0;
+      break;
     case GAVL_RGB_48:
       *advance = 6;
       *offset = 0;
@@ -309,9 +309,42 @@ void gavl_compression_info_copy(gavl_compression_info_t * dst,
   }
 
 
+static void packet_release_external(gavl_packet_t * p)
+  {
+  p->data_unref(p->data_priv);
+  p->data_unref = NULL;
+  p->data_priv  = NULL;
+  p->data       = NULL;
+  p->data_alloc = 0;
+  }
+
+void gavl_packet_set_external(gavl_packet_t * p, uint8_t * data, int len,
+                              void (*unref)(void * priv), void * priv)
+  {
+  if(p->data_unref)
+    packet_release_external(p);
+  else if(p->data)
+    free(p->data);
+  
+  p->data       = data;
+  p->data_len   = len;
+  p->data_alloc = 0;
+  p->data_unref = unref;
+  p->data_priv  = priv;
+  }
+
 void gavl_packet_alloc(gavl_packet_t * p, int len)
   {
-  if(len + GAVL_PACKET_PADDING > p->data_alloc)
+  if(p->data_unref)
+    {
+    /* Copy external data into own memory */
+    uint8_t * data = malloc(len + GAVL_PACKET_PADDING + 1024);
+    memcpy(data, p->data, p->data_len < len ? p->data_len : len);
+    packet_release_external(p);
+    p->data = data;
+    p->data_alloc = len + GAVL_PACKET_PADDING + 1024;
+    }
+  else if(len + GAVL_PACKET_PADDING > p->data_alloc)
     {
     //    fprintf(stderr, "gavl_packet_alloc %d %d\n", len + GAVL_PACKET_PADDING, p->data_alloc);
     p->data_alloc = len + GAVL_PACKET_PADDING + 1024;
@@ -322,7 +355,9 @@ void gavl_packet_alloc(gavl_packet_t * p, int len)
 
 void gavl_packet_free(gavl_packet_t * p)
   {
-  if(p->data)
+  if(p->data_unref)
+    packet_release_external(p);
+  else if(p->data)
     free(p->data);
   }
 
@@ -331,6 +366,9 @@ void gavl_packet_reset(gavl_packet_t * p)
   int data_alloc_save;
   uint8_t * data_save;
 
+  if(p->data_unref)
+    packet_release_external(p);
+  
   data_alloc_save = p->data_alloc;
   data_save       = p->data;
   gavl_packet_init(p);
@@ -343,15 +381,25 @@ void gavl_packet_copy(gavl_packet_t * dst,
   {
   int data_alloc_save;
   uint8_t * data_save;
-
+  void (*data_unref_save)(void * data_priv);
+  void * data_priv_save;
+  
   data_alloc_save = dst->data_alloc;
   data_save       = dst->data;
-
+  data_unref_save = dst->data_unref;
+  data_priv_save  = dst->data_priv;
+  
   memcpy(dst, src, sizeof(*src));
 
   dst->data_alloc = data_alloc_save;
   dst->data       = data_save;
+  dst->data_unref = data_unref_save;
+  dst->data_priv  = data_priv_save;
 
+  /* The old data are overwritten anyway */
+  if(dst->data_unref)
+    packet_release_external(dst);
+  
   gavl_packet_alloc(dst, src->data_len);
   memcpy(dst->data, src->data, src->data_len);
   }
@@ -362,16 +410,22 @@ void gavl_packet_copy_metadata(gavl_packet_t * dst,
   int data_alloc_save;
   int data_len_save;
   uint8_t * data_save;
+  void (*data_unref_save)(void * data_priv);
+  void * data_priv_save;
   
   data_alloc_save = dst->data_alloc;
   data_len_save   = dst->data_len;
   data_save       = dst->data;
-
+  data_unref_save = dst->data_unref;
+  data_priv_save  = dst->data_priv;
+  
   memcpy(dst, src, sizeof(*src));
 
   dst->data_alloc = data_alloc_save;
   dst->data_len   = data_len_save;
   dst->data       = data_save;
+  dst->data_unref = data_unref_save;
+  dst->data_priv  = data_priv_save;
   }
 
 static const char * coding_type_strings[4] =
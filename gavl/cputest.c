@@ -42,6 +42,7 @@
 #define MM_SSSE3    GAVL_ACCEL_SSSE3
 #define MM_3DNOW    GAVL_ACCEL_3DNOW
 #define MM_3DNOWEXT GAVL_ACCEL_3DNOWEXT
+#define MM_AVX2     GAVL_ACCEL_AVX2
 
 #ifdef ARCH_X86_64
 #  define REG_b "rbx"
@@ -61,6 +62,20 @@
            "=c" (ecx), "=d" (edx)\
          : "0" (index));
 
+#define cpuid_count(index,count,eax,ebx,ecx,edx)\
+    __asm __volatile\
+        ("mov %%"REG_b", %%"REG_S"\n\t"\
+         "cpuid\n\t"\
+         "xchg %%"REG_b", %%"REG_S\
+         : "=a" (eax), "=S" (ebx),\
+           "=c" (ecx), "=d" (edx)\
+         : "0" (index), "2" (count));
+
+/* Read extended control register (checks if the OS saves the ymm registers) */
+#define xgetbv(index,eax,edx)\
+    __asm __volatile\
+        (".byte 0x0f, 0x01, 0xd0" : "=a" (eax), "=d" (edx) : "c" (index));
+
 /* Function to test if multimedia instructions are supported...  */
 
 int gavl_accel_supported()
@@ -113,6 +128,19 @@ int gavl_accel_supported()
         if (ecx & 0x00000200 )
           rval |= MM_SSSE3;
 
+        /* AVX2: Needs OSXSAVE, AVX and OS support for the ymm state */
+        if((max_std_level >= 7) &&
+           (ecx & (1<<27)) && (ecx & (1<<28)))
+          {
+          xgetbv(0, eax, edx);
+          if((eax & 0x06) == 0x06)
+            {
+            cpuid_count(7, 0, eax, ebx, ecx, edx);
+            if(ebx & (1<<5))
+              rval |= MM_AVX2;
+            }
+          }
+
     }
 
     cpuid(0x80000000, max_ext_level, ebx, ecx, edx);
@@ -48,6 +48,8 @@ void gavl_video_deinterlacer_destroy(gavl_video_deinterlacer_t * d)
 
   if(d->scaler)
     gavl_video_scaler_destroy(d->scaler);
+
+  gavl_deinterlacer_cleanup_temporal(d);
   
   free(d);
   }
@@ -93,6 +95,10 @@ int gavl_video_deinterlacer_init(gavl_video_deinterlacer_t * d,
       if(!gavl_deinterlacer_init_blend(d))
         return 0;
       break;
+    case GAVL_DEINTERLACE_TEMPORAL:
+      if(!gavl_deinterlacer_init_temporal(d))
+        return 0;
+      break;
     }
   return 1;
   }
@@ -107,9 +113,60 @@ void gavl_video_deinterlacer_deinterlace(gavl_video_deinterlacer_t * d,
        (d->opt.conversion_flags & GAVL_FORCE_DEINTERLACE))
       d->func(d, input_frame, output_frame);
     else
+      {
       gavl_video_frame_copy(&d->format, output_frame, input_frame);
+      if(d->opt.deinterlace_mode == GAVL_DEINTERLACE_TEMPORAL)
+        gavl_deinterlacer_temporal_push(d, input_frame);
+      }
     }
   else
     d->func(d, input_frame, output_frame);
   }
 
+void gavl_video_deinterlacer_deinterlace_fields(gavl_video_deinterlacer_t * d,
+                                                const gavl_video_frame_t * input_frame,
+                                                gavl_video_frame_t * output_frame_1,
+                                                gavl_video_frame_t * output_frame_2)
+  {
+  int64_t duration;
+  
+  if(d->opt.deinterlace_mode != GAVL_DEINTERLACE_TEMPORAL)
+    {
+    gavl_video_deinterlacer_deinterlace(d, input_frame, output_frame_1);
+    gavl_video_frame_copy(&d->format, output_frame_2, output_frame_1);
+    }
+  else if(d->mixed &&
+          (input_frame->interlace_mode == GAVL_INTERLACE_NONE) &&
+          !(d->opt.conversion_flags & GAVL_FORCE_DEINTERLACE))
+    {
+    gavl_video_frame_copy(&d->format, output_frame_1, input_frame);
+    gavl_video_frame_copy(&d->format, output_frame_2, input_frame);
+    gavl_deinterlacer_temporal_push(d, input_frame);
+    }
+  else
+    {
+    gavl_deinterlacer_temporal_field(d, input_frame, output_frame_1, 0);
+    gavl_deinterlacer_temporal_field(d, input_frame, output_frame_2, 1);
+    gavl_deinterlacer_temporal_push(d, input_frame);
+    }
+
+  /* Timestamps */
+  
+  duration = input_frame->duration;
+  gavl_video_frame_copy_metadata(output_frame_1, input_frame);
+  gavl_video_frame_copy_metadata(output_frame_2, input_frame);
+
+  output_frame_1->duration = duration / 2;
+  output_frame_2->timestamp += duration / 2;
+  output_frame_2->duration = duration - duration / 2;
+  
+  output_frame_1->interlace_mode = GAVL_INTERLACE_NONE;
+  output_frame_2->interlace_mode = GAVL_INTERLACE_NONE;
+  }
+
+void gavl_video_deinterlacer_reset(gavl_video_deinterlacer_t * d)
+  {
+  if(d->opt.deinterlace_mode == GAVL_DEINTERLACE_TEMPORAL)
+    gavl_deinterlacer_reset_temporal(d);
+  }
+
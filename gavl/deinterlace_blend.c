@@ -29,56 +29,53 @@
 #include <deinterlace.h>
 #include <accel.h>
 
+static void blend_rows(void * data, int start, int end)
+  {
+  int j, stride;
+  const uint8_t * t, * m, * b;
+  uint8_t * dst;
+  gavl_video_deinterlacer_t * d = data;
+
+  stride = d->cur->strides[d->plane];
+  m = d->cur->planes[d->plane] + start * stride;
+  dst = d->dst->planes[d->plane] + start * d->dst->strides[d->plane];
+  
+  for(j = start; j < end; j++)
+    {
+    /* The first and last lines are blended with their only neighbour */
+    t = j ? m - stride : m;
+    b = (j < d->plane_height - 1) ? m + stride : m;
+    
+    d->blend_func(t, m, b, dst, d->plane_width);
+
+    m += stride;
+    dst += d->dst->strides[d->plane];
+    }
+  }
+
 static void deinterlace_blend(gavl_video_deinterlacer_t * d,
                               const gavl_video_frame_t * input_frame,
                               gavl_video_frame_t * output_frame)
   {
-  int i, j;
-  int width, height;
-  uint8_t * b, *m, *t, *dst;
+  d->cur = input_frame;
+  d->dst = output_frame;
   
-  width = d->line_width;
-  height = d->format.image_height;
+  d->plane_width = d->line_width;
+  d->plane_height = d->format.image_height;
   
-  for(i = 0; i < d->num_planes; i++)
+  for(d->plane = 0; d->plane < d->num_planes; d->plane++)
     {
-    if(i == 1)
-      {
-      width  /= d->sub_h;
-      height /= d->sub_v;
-      }
-
-    /* Top line */
-    
-    t = input_frame->planes[i];
-    m = t;
-    b = m + input_frame->strides[i];
-    dst = output_frame->planes[i];
-
-    d->blend_func(t, m, b, dst, width);
-
-    /* Middle lines */
-    
-    dst += output_frame->strides[i];
-
-    m += input_frame->strides[i];
-    b += input_frame->strides[i];
-    
-    for(j = 1; j < height-1; j++)
+    if(d->plane == 1)
       {
-      d->blend_func(t, m, b, dst, width);
+      d->plane_width  /= d->sub_h;
+      d->plane_height /= d->sub_v;
 
-      t += input_frame->strides[i];
-      m += input_frame->strides[i];
-      b += input_frame->strides[i];
-      
-      dst += output_frame->strides[i];
+      /* Interleaved Cb and Cr */
+      if(gavl_pixelformat_is_semiplanar(d->format.pixelformat))
+        d->plane_width *= 2;
       }
-    /* Bottom line */
-    b -= input_frame->strides[i];
-    d->blend_func(t, m, b, dst, width);
+    gavl_video_options_run(&d->opt, blend_rows, d, d->plane_height, 1);
     }
-  
   }
 
 int gavl_deinterlacer_init_blend(gavl_video_deinterlacer_t * d)
@@ -178,6 +175,9 @@ int gavl_deinterlacer_init_blend(gavl_video_deinterlacer_t * d)
       break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_10:
+    case GAVL_P010:
+    case GAVL_P016:
       d->line_width = d->format.image_width;
       d->blend_func = tab.func_16;
       break;
@@ -189,6 +189,8 @@ int gavl_deinterlacer_init_blend(gavl_video_deinterlacer_t * d)
     case GAVL_YUV_444_P:
     case GAVL_YUVJ_422_P:
     case GAVL_YUVJ_444_P:
+    case GAVL_NV12:
+    case GAVL_NV21:
       d->line_width = d->format.image_width;
       d->blend_func = tab.func_8;
       break;
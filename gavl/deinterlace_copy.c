@@ -26,39 +26,52 @@
 #include <deinterlace.h>
 #include <accel.h>
 
+/* Line pairs [start, end) of the current plane */
+
+static void copy_rows(void * data, int start, int end)
+  {
+  int j;
+  const uint8_t * src;
+  uint8_t * dst;
+  gavl_video_deinterlacer_t * d = data;
+  int src_stride = d->cur->strides[d->plane];
+  int dst_stride = d->dst->strides[d->plane];
+  
+  src = d->cur->planes[d->plane] + (2 * start + d->field) * src_stride;
+  dst = d->dst->planes[d->plane] + 2 * start * dst_stride;
+  
+  for(j = start; j < end; j++)
+    {
+    gavl_memcpy(dst, src, d->plane_width);
+    dst += dst_stride;
+    gavl_memcpy(dst, src, d->plane_width);
+    dst += dst_stride;
+    src += src_stride * 2;
+    }
+  }
+
 static void deinterlace_copy(gavl_video_deinterlacer_t * d,
                              const gavl_video_frame_t * input_frame,
                              gavl_video_frame_t * output_frame)
   {
-  int i, j, jmax;
-  int bytes;
-  uint8_t * src;
-  uint8_t * dst;
-  int src_field =
+  d->field =
     (d->opt.deinterlace_drop_mode == GAVL_DEINTERLACE_DROP_TOP) ? 1 : 0;
+  d->cur = input_frame;
+  d->dst = output_frame;
   
-  jmax = d->format.image_height / 2;
-  bytes = d->line_width;
-
-    
-  for(i = 0; i < d->num_planes; i++)
+  d->plane_height = d->format.image_height / 2;
+  d->plane_width = d->line_width;
+  
+  for(d->plane = 0; d->plane < d->num_planes; d->plane++)
     {
-    src = input_frame->planes[i] + src_field * input_frame->strides[i];
-    dst = output_frame->planes[i];
-    
-    if(i == 1)
-      {
-      jmax /= d->sub_v;
-      bytes /= d->sub_h;
-      }
-    for(j = 0; j < jmax; j++)
+    if(d->plane == 1)
       {
-      gavl_memcpy(dst, src, bytes);
-      dst += output_frame->strides[i];
-      gavl_memcpy(dst, src, bytes);
-      dst += output_frame->strides[i];
-      src += input_frame->strides[i] * 2;
+      d->plane_height /= d->sub_v;
+      d->plane_width /= d->sub_h;
+      if(gavl_pixelformat_is_semiplanar(d->format.pixelformat))
+        d->plane_width *= 2;
       }
+    gavl_video_options_run(&d->opt, copy_rows, d, d->plane_height, 1);
     }
   }
 
@@ -0,0 +1,403 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <gavl/gavldsp.h>
+#include <video.h>
+#include <deinterlace.h>
+#include <accel.h>
+
+/*
+ *  Motion adaptive deinterlacing. The picture at the time of field k
+ *  is made from field k and the missing lines are interpolated from
+ *  fields k, k-1, k-2 and k-3. Only past fields are used, so there is no
+ *  delay.
+ *
+ *  Output rows are processed in blocks. If a block doesn't move at all,
+ *  the fields are just woven together. If it changes completely (scene cut),
+ *  the temporal prediction is useless and lines are simply averaged.
+ */
+
+#define BLOCK_ROWS 8
+
+/* Mean absolute difference (8 bit scale) above which we assume a scene cut */
+#define SCENE_CUT_THRESHOLD 48
+
+/* Sum of absolute differences (8 bit scale) of h lines */
+
+static int get_sad(gavl_video_deinterlacer_t * d,
+                   const uint8_t * src_1, const uint8_t * src_2,
+                   int stride_1, int stride_2, int w, int h)
+  {
+  int i, ret = 0;
+  gavl_dsp_funcs_t * funcs = gavl_dsp_context_get_funcs(d->dsp);
+
+  /* Line by line, so 16 bit sums don't overflow */
+  for(i = 0; i < h; i++)
+    {
+    switch(d->bytes_per_component)
+      {
+      case 1:
+        ret += funcs->sad_8(src_1, src_2, stride_1, stride_2, w, 1);
+        break;
+      case 2:
+        ret += funcs->sad_16(src_1, src_2, stride_1, stride_2, w, 1) >> 8;
+        break;
+      case 4:
+        ret += (int)(funcs->sad_f(src_1, src_2, stride_1, stride_2, w, 1) * 255.0);
+        break;
+      }
+    src_1 += stride_1;
+    src_2 += stride_2;
+    }
+  return ret;
+  }
+
+static void average(gavl_video_deinterlacer_t * d,
+                    const uint8_t * src_1, const uint8_t * src_2,
+                    uint8_t * dst, int num)
+  {
+  gavl_dsp_funcs_t * funcs = gavl_dsp_context_get_funcs(d->dsp);
+
+  switch(d->bytes_per_component)
+    {
+    case 1:
+      funcs->average_8(src_1, src_2, dst, num);
+      break;
+    case 2:
+      funcs->average_16(src_1, src_2, dst, num);
+      break;
+    case 4:
+      funcs->average_f(src_1, src_2, dst, num);
+      break;
+    }
+  }
+
+/* Process output rows [start, end) of the current plane */
+
+static void temporal_block(gavl_video_deinterlacer_t * d, int start, int end)
+  {
+  int i, t_row, b_row;
+  int bytes, lines, first_missing, sad;
+  int mode; /* 0: Interpolate, 1: Weave, 2: Average */
+
+  const uint8_t * cur  = d->cur->planes[d->plane];
+  const uint8_t * p1   = d->p1->planes[d->plane];
+  const uint8_t * p2   = d->p2->planes[d->plane];
+  const uint8_t * p3   = d->p3->planes[d->plane];
+  uint8_t * dst        = d->dst->planes[d->plane];
+
+  int cur_stride = d->cur->strides[d->plane];
+  int p1_stride  = d->p1->strides[d->plane];
+  int p2_stride  = d->p2->strides[d->plane];
+  int p3_stride  = d->p3->strides[d->plane];
+  int dst_stride = d->dst->strides[d->plane];
+
+  bytes = d->plane_width * d->bytes_per_component;
+
+  /* Missing lines of this block */
+  first_missing = start + ((start & 1) == d->field);
+  lines = (end - first_missing + 1) / 2;
+
+  mode = 0;
+
+  if(lines > 0)
+    {
+    /* Kept field against 2 fields back */
+    t_row = first_missing - 1;
+    if(t_row < 0)
+      t_row = first_missing + 1;
+    if(t_row + 2 * (lines - 1) >= d->plane_height)
+      lines--;
+
+    sad = get_sad(d, cur + t_row * cur_stride, p2 + t_row * p2_stride,
+                  2 * cur_stride, 2 * p2_stride,
+                  d->plane_width, lines);
+
+    if(sad > SCENE_CUT_THRESHOLD * d->plane_width * lines)
+      mode = 2;
+    else if(!sad &&
+            !get_sad(d, p1 + first_missing * p1_stride,
+                     p3 + first_missing * p3_stride,
+                     2 * p1_stride, 2 * p3_stride,
+                     d->plane_width, (end - first_missing + 1) / 2))
+      mode = 1;
+    }
+
+  for(i = start; i < end; i++)
+    {
+    if((i & 1) == d->field)
+      {
+      /* Kept line */
+      gavl_memcpy(dst + i * dst_stride, cur + i * cur_stride, bytes);
+      continue;
+      }
+
+    t_row = (i > 0) ? i - 1 : i + 1;
+    b_row = (i < d->plane_height - 1) ? i + 1 : i - 1;
+
+    switch(mode)
+      {
+      case 0:
+        d->temporal_func(cur + t_row * cur_stride,
+                         cur + b_row * cur_stride,
+                         p1  + i * p1_stride,
+                         p2  + t_row * p2_stride,
+                         p2  + b_row * p2_stride,
+                         p3  + i * p3_stride,
+                         dst + i * dst_stride,
+                         d->plane_width);
+        break;
+      case 1:
+        gavl_memcpy(dst + i * dst_stride, p1 + i * p1_stride, bytes);
+        break;
+      case 2:
+        average(d, cur + t_row * cur_stride, cur + b_row * cur_stride,
+                dst + i * dst_stride, d->plane_width);
+        break;
+      }
+    }
+  }
+
+static void temporal_func(void * data, int start, int end)
+  {
+  gavl_video_deinterlacer_t * d = data;
+  int i;
+
+  for(i = start; i < end; i += BLOCK_ROWS)
+    temporal_block(d, i, (i + BLOCK_ROWS < end) ? i + BLOCK_ROWS : end);
+  }
+
+static int get_first_field(gavl_video_deinterlacer_t * d,
+                           const gavl_video_frame_t * f)
+  {
+  if(d->mixed)
+    {
+    if(f->interlace_mode == GAVL_INTERLACE_BOTTOM_FIRST)
+      return 1;
+    }
+  else if(d->format.interlace_mode == GAVL_INTERLACE_BOTTOM_FIRST)
+    return 1;
+  return 0;
+  }
+
+void gavl_deinterlacer_temporal_field(gavl_video_deinterlacer_t * d,
+                                      const gavl_video_frame_t * input_frame,
+                                      gavl_video_frame_t * output_frame,
+                                      int field)
+  {
+  int first;
+  const gavl_video_frame_t * h0;
+  const gavl_video_frame_t * h1;
+
+  /* Without history, we pretend that the previous frames were
+     the same */
+  h0 = (d->history_frames > 0) ? d->history[0] : input_frame;
+  h1 = (d->history_frames > 1) ? d->history[1] : h0;
+
+  first = get_first_field(d, input_frame);
+
+  d->cur = input_frame;
+  d->p2  = h0;
+
+  if(field)
+    {
+    d->field = !first;
+    d->p1 = input_frame;
+    d->p3 = h0;
+    }
+  else
+    {
+    d->field = first;
+    d->p1 = h0;
+    d->p3 = h1;
+    }
+  d->dst = output_frame;
+
+  d->plane_width  = d->line_width;
+  d->plane_height = d->format.image_height;
+
+  for(d->plane = 0; d->plane < d->num_planes; d->plane++)
+    {
+    if(d->plane == 1)
+      {
+      d->plane_width  /= d->sub_h;
+      d->plane_height /= d->sub_v;
+
+      /* Interleaved Cb and Cr */
+      if(gavl_pixelformat_is_semiplanar(d->format.pixelformat))
+        d->plane_width *= 2;
+      }
+    gavl_video_options_run(&d->opt, temporal_func, d, d->plane_height, 2);
+    }
+  }
+
+void gavl_deinterlacer_temporal_push(gavl_video_deinterlacer_t * d,
+                                     const gavl_video_frame_t * input_frame)
+  {
+  gavl_video_frame_t * swp;
+
+  swp = d->history[1];
+  d->history[1] = d->history[0];
+  d->history[0] = swp;
+
+  gavl_video_frame_copy(&d->format, d->history[0], input_frame);
+  if(d->history_frames < 2)
+    d->history_frames++;
+  }
+
+/* Frame rate output: Picture at the time of the second field */
+
+static void deinterlace_temporal(gavl_video_deinterlacer_t * d,
+                                 const gavl_video_frame_t * input_frame,
+                                 gavl_video_frame_t * output_frame)
+  {
+  gavl_deinterlacer_temporal_field(d, input_frame, output_frame, 1);
+  gavl_deinterlacer_temporal_push(d, input_frame);
+  }
+
+/* Bytes per component, 0 if components don't fill whole bytes */
+
+static int get_bytes_per_component(gavl_pixelformat_t pixelformat)
+  {
+  switch(pixelformat)
+    {
+    case GAVL_RGB_15:
+    case GAVL_BGR_15:
+    case GAVL_RGB_16:
+    case GAVL_BGR_16:
+      return 0;
+    case GAVL_GRAY_8:
+    case GAVL_GRAYA_16:
+    case GAVL_RGB_24:
+    case GAVL_BGR_24:
+    case GAVL_RGB_32:
+    case GAVL_BGR_32:
+    case GAVL_RGBA_32:
+    case GAVL_YUVA_32:
+    case GAVL_YUY2:
+    case GAVL_UYVY:
+      return 1;
+    case GAVL_GRAY_16:
+    case GAVL_GRAYA_32:
+    case GAVL_RGB_48:
+    case GAVL_RGBA_64:
+    case GAVL_YUVA_64:
+      return 2;
+    case GAVL_GRAY_FLOAT:
+    case GAVL_GRAYA_FLOAT:
+    case GAVL_RGB_FLOAT:
+    case GAVL_RGBA_FLOAT:
+    case GAVL_YUV_FLOAT:
+    case GAVL_YUVA_FLOAT:
+      return 4;
+    default: /* Planar */
+      return gavl_pixelformat_bytes_per_component(pixelformat);
+    }
+  return 0;
+  }
+
+int gavl_deinterlacer_init_temporal(gavl_video_deinterlacer_t * d)
+  {
+  int i;
+  gavl_video_deinterlace_temporal_func_table_t tab;
+
+  memset(&tab, 0, sizeof(tab));
+  if(d->opt.quality || (d->opt.accel_flags & GAVL_ACCEL_C))
+    gavl_find_deinterlacer_temporal_funcs_c(&tab, &d->opt, &d->format);
+#ifdef HAVE_SSE2
+  if(d->opt.accel_flags & GAVL_ACCEL_SSE2)
+    gavl_find_deinterlacer_temporal_funcs_sse2(&tab, &d->opt, &d->format);
+#endif
+#ifdef HAVE_AVX2
+  if(d->opt.accel_flags & GAVL_ACCEL_AVX2)
+    gavl_find_deinterlacer_temporal_funcs_avx2(&tab, &d->opt, &d->format);
+#endif
+
+  d->bytes_per_component = get_bytes_per_component(d->format.pixelformat);
+
+  switch(d->bytes_per_component)
+    {
+    case 1:
+      d->temporal_func = tab.func_8;
+      break;
+    case 2:
+      d->temporal_func = tab.func_16;
+      break;
+    case 4:
+      d->temporal_func = tab.func_float;
+      break;
+    default:
+      d->temporal_func = NULL;
+      break;
+    }
+
+  if(!d->temporal_func)
+    return 0;
+
+  /* Components per line */
+  if(gavl_pixelformat_is_planar(d->format.pixelformat))
+    d->line_width = d->format.image_width;
+  else
+    d->line_width = d->format.image_width *
+      gavl_pixelformat_bytes_per_pixel(d->format.pixelformat) /
+      d->bytes_per_component;
+
+  if(!d->dsp)
+    d->dsp = gavl_dsp_context_create();
+  gavl_dsp_context_set_accel_flags(d->dsp, d->opt.accel_flags);
+  gavl_dsp_context_set_quality(d->dsp, d->opt.quality);
+
+  for(i = 0; i < 2; i++)
+    {
+    if(d->history[i])
+      gavl_video_frame_destroy(d->history[i]);
+    d->history[i] = gavl_video_frame_create(&d->format);
+    }
+  d->history_frames = 0;
+
+  gavl_init_memcpy();
+
+  d->func = deinterlace_temporal;
+  return 1;
+  }
+
+void gavl_deinterlacer_reset_temporal(gavl_video_deinterlacer_t * d)
+  {
+  d->history_frames = 0;
+  }
+
+void gavl_deinterlacer_cleanup_temporal(gavl_video_deinterlacer_t * d)
+  {
+  int i;
+  for(i = 0; i < 2; i++)
+    {
+    if(d->history[i])
+      gavl_video_frame_destroy(d->history[i]);
+    }
+  if(d->dsp)
+    gavl_dsp_context_destroy(d->dsp);
+  }
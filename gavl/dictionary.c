@@ -23,6 +23,7 @@
 #include <string.h>
 #include <math.h>
 #include <stdlib.h>
+#include <ctype.h>
 
 #include <gavl/gavl.h>
 #include <gavl/utils.h>
@@ -30,8 +31,147 @@
 
 #include <gavl/metatags.h>
 
+#include <dictionary.h>
+
 // #define WATCH_MEMBER GAVL_META_NUM_CHILDREN
 
+/*
+ *  Hash index
+ *
+ *  Dictionaries with more than INDEX_MIN_ENTRIES entries get a hash table
+ *  (open addressing with linear probing), which maps names to entry
+ *  indices. The entries array stays the same, so the insertion order is
+ *  preserved. The hash is calculated from the lowercase name, so the same
+ *  table serves case sensitive and case insensitive lookups.
+ *
+ *  The index is updated when entries are added and rebuilt when entries
+ *  are deleted. Lookups never modify the index, so const dictionaries can
+ *  be queried from multiple threads. If the index does not cover all
+ *  entries (e.g. if the entries were filled in directly), we fall back to
+ *  a linear search.
+ */
+
+#define INDEX_MIN_ENTRIES 16
+
+struct gavl_dict_index_s
+  {
+  int num_entries; // Number of entries covered by the index
+  int size;        // Size of the table, power of 2
+  int * slots;     // Entry index + 1, 0 means empty
+  };
+
+static uint32_t dict_hash(const char * name)
+  {
+  /* FNV-1a */
+  uint32_t ret = 2166136261U;
+  while(*name)
+    {
+    ret ^= (uint8_t)tolower(*name);
+    ret *= 16777619U;
+    name++;
+    }
+  return ret;
+  }
+
+static void index_insert(struct gavl_dict_index_s * idx,
+                         const gavl_dictionary_t * d, int i)
+  {
+  int pos = dict_hash(d->entries[i].name) & (idx->size - 1);
+
+  while(idx->slots[pos])
+    pos = (pos + 1) & (idx->size - 1);
+  
+  idx->slots[pos] = i + 1;
+  idx->num_entries++;
+  }
+
+static void index_free(gavl_dictionary_t * d)
+  {
+  if(d->index)
+    {
+    free(d->index->slots);
+    free(d->index);
+    d->index = NULL;
+    }
+  }
+
+static void index_build(gavl_dictionary_t * d)
+  {
+  int i;
+  int size;
+  
+  if(d->num_entries < INDEX_MIN_ENTRIES)
+    {
+    index_free(d);
+    return;
+    }
+
+  /* Keep the load factor below 0.5 */
+  size = 64;
+  while(size < d->num_entries * 4)
+    size *= 2;
+  
+  if(!d->index)
+    d->index = calloc(1, sizeof(*d->index));
+
+  if(d->index->size != size)
+    {
+    if(d->index->slots)
+      free(d->index->slots);
+    d->index->slots = calloc(size, sizeof(*d->index->slots));
+    d->index->size = size;
+    }
+  else
+    memset(d->index->slots, 0, size * sizeof(*d->index->slots));
+  
+  d->index->num_entries = 0;
+  for(i = 0; i < d->num_entries; i++)
+    index_insert(d->index, d, i);
+  }
+
+/* Called after an entry was appended */
+
+static void index_update(gavl_dictionary_t * d)
+  {
+  if(d->index &&
+     (d->index->num_entries == d->num_entries - 1) &&
+     (d->num_entries * 2 <= d->index->size))
+    index_insert(d->index, d, d->num_entries - 1);
+  else if(d->num_entries >= INDEX_MIN_ENTRIES)
+    index_build(d);
+  }
+
+static int index_find(const struct gavl_dict_index_s * idx,
+                      const gavl_dictionary_t * m, const char * name, int ign)
+  {
+  int pos = dict_hash(name) & (idx->size - 1);
+  int i;
+  
+  while((i = idx->slots[pos]))
+    {
+    i--;
+    if(ign)
+      {
+      if(!strcasecmp(m->entries[i].name, name))
+        return i;
+      }
+    else
+      {
+      if(!strcmp(m->entries[i].name, name))
+        return i;
+      }
+    pos = (pos + 1) & (idx->size - 1);
+    }
+  return -1;
+  }
+
+/* Called after the entries were filled in directly */
+
+void gavl_dictionary_rebuild_index(gavl_dictionary_t * d)
+  {
+  index_build(d);
+  }
+
 /* Dictionary */
 
 void gavl_dictionary_init(gavl_dictionary_t * d)
@@ -50,6 +190,9 @@ int gavl_dictionary_find(const gavl_dictionary_t * m, const char * name, int ign
   {
   int i;
 
+  if(m->index && (m->index->num_entries == m->num_entries))
+    return index_find(m->index, m, name, ign);
+  
   if(ign)
     {
     for(i = 0; i < m->num_entries; i++)
@@ -81,6 +224,7 @@ static gavl_dict_entry_t * dict_append(gavl_dictionary_t * m, const char * name)
   ret = m->entries + m->num_entries;
   ret->name = gavl_strdup(name);
   m->num_entries++;
+  index_update(m);
   return ret;
   }
 
@@ -131,6 +275,10 @@ dict_set(gavl_dictionary_t * d, const char * name, const gavl_value_t * val,
         memset(d->entries + idx, 0, sizeof(*d->entries));
       
       d->num_entries--;
+
+      /* Entry indices changed */
+      if(d->index)
+        index_build(d);
       }
     return 1;
     }
@@ -535,6 +683,7 @@ void gavl_dictionary_free(gavl_dictionary_t * d)
       dict_free_entry(d->entries + i);
     free(d->entries);
     }
+  index_free(d);
   }
 
 void gavl_dictionary_foreach(const gavl_dictionary_t * d, gavl_dictionary_foreach_func func, void * priv)
@@ -127,10 +127,15 @@ int gavl_dsp_interpolate_video_frame(gavl_dsp_context_t * ctx,
     case GAVL_YUVJ_422_P:
     case GAVL_YUVJ_444_P:
     case GAVL_YUV_422_P:
+    case GAVL_NV12:
+    case GAVL_NV21:
       interpolate = ctx->funcs.interpolate_8;
       break;
     case GAVL_YUV_422_P_16:
     case GAVL_YUV_444_P_16:
+    case GAVL_YUV_420_P_10:
+    case GAVL_P010:
+    case GAVL_P016:
       interpolate = ctx->funcs.interpolate_16;
       break;
     case GAVL_PIXELFORMAT_NONE:
@@ -157,6 +162,8 @@ int gavl_dsp_interpolate_video_frame(gavl_dsp_context_t * ctx,
     if(!i)
       {
       width /= sub_h;
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        width *= 2;
       height /= sub_v;
       }
     }
@@ -298,9 +305,15 @@ int gavl_dsp_video_frame_swap_endian(gavl_dsp_context_t * ctx,
       num_planes = 3;
       break;
     case GAVL_YUV_444_P_16:
+    case GAVL_YUV_420_P_10:
       do_swap = ctx->funcs.bswap_16;
       num_planes = 3;
       break;
+    case GAVL_P010:
+    case GAVL_P016:
+      do_swap = ctx->funcs.bswap_16;
+      num_planes = 2;
+      break;
     case GAVL_YUY2:
     case GAVL_UYVY:
     case GAVL_RGB_24:
@@ -313,6 +326,8 @@ int gavl_dsp_video_frame_swap_endian(gavl_dsp_context_t * ctx,
     case GAVL_YUVJ_420_P:
     case GAVL_YUVJ_422_P:
     case GAVL_YUVJ_444_P:
+    case GAVL_NV12:
+    case GAVL_NV21:
     case GAVL_PIXELFORMAT_NONE:
     case GAVL_GRAY_8:
     case GAVL_GRAYA_16:
@@ -333,6 +348,8 @@ int gavl_dsp_video_frame_swap_endian(gavl_dsp_context_t * ctx,
       {
       height /= sub_v;
       len /= sub_h;
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        len *= 2;
       }
     
     src = frame->planes[i];
@@ -0,0 +1,244 @@
+#include <stdlib.h>
+#include <pthread.h>
+
+#include <gavfprivate.h>
+
+/*
+ *  Background demuxer: A thread reads packets into the packet buffers
+ *  of the streams until the buffered data exceed a byte or duration
+ *  budget. The packet sources only take packets out of the buffers.
+ */
+
+struct gavf_demux_thread_s
+  {
+  pthread_t thread;
+  pthread_mutex_t mutex;
+
+  /* Signalled when packets were added or removed and on state changes */
+  pthread_cond_t cond;
+  
+  int running; // Thread was started and not joined yet
+  int stop;    // Thread should exit
+  int eof;     // Thread got EOF or an error
+  int waiting; // Number of sources waiting for packets
+
+  int64_t bytes;
+  int64_t max_bytes;
+  gavl_time_t max_time;
+  };
+
+gavf_demux_thread_t * gavf_demux_thread_create(const gavf_options_t * opt)
+  {
+  gavf_demux_thread_t * ret = calloc(1, sizeof(*ret));
+
+  pthread_mutex_init(&ret->mutex, NULL);
+  pthread_cond_init(&ret->cond, NULL);
+
+  ret->max_bytes = opt->demux_bytes;
+  ret->max_time  = opt->demux_time;
+  
+  if(!ret->max_bytes && !ret->max_time)
+    {
+    ret->max_bytes = GAVF_DEMUX_BYTES_DEFAULT;
+    ret->max_time  = GAVF_DEMUX_TIME_DEFAULT;
+    }
+  return ret;
+  }
+
+/* Interrupts blocking reads of the thread */
+
+static int check_stop(void * data)
+  {
+  gavf_demux_thread_t * dt = data;
+  return __atomic_load_n(&dt->stop, __ATOMIC_ACQUIRE);
+  }
+
+/* Called with locked mutex */
+
+static int buffer_full(gavf_t * g)
+  {
+  int i;
+  gavf_stream_t * s;
+  const gavl_packet_t * first;
+  const gavl_packet_t * last;
+  gavf_demux_thread_t * dt = g->dt;
+
+  /* Never let a source starve */
+  if(dt->waiting)
+    return 0;
+  
+  if(dt->max_bytes && (dt->bytes >= dt->max_bytes))
+    return 1;
+
+  if(!dt->max_time)
+    return 0;
+  
+  for(i = 0; i < g->num_streams; i++)
+    {
+    s = &g->streams[i];
+    
+    if(s->flags & STREAM_FLAG_DISCONTINUOUS)
+      continue;
+
+    if(!(first = gavf_packet_buffer_peek_read(s->pb)) ||
+       !(last = gavf_packet_buffer_get_last(s->pb)) ||
+       (first->pts == GAVL_TIME_UNDEFINED) ||
+       (last->pts == GAVL_TIME_UNDEFINED))
+      continue;
+    
+    if(gavl_time_unscale(s->timescale,
+                         last->pts + last->duration - first->pts) >= dt->max_time)
+      return 1;
+    }
+  return 0;
+  }
+
+static void * thread_func(void * priv)
+  {
+  gavf_t * g = priv;
+  gavf_demux_thread_t * dt = g->dt;
+  gavf_stream_t * s;
+  gavl_packet_t * p;
+  int have_header;
+
+  /* Reads from sockets and file descriptors would block
+     gavf_demux_thread_stop() until the next data arrive. Ios without
+     poll function (e.g. stdio) can't be interrupted */
+  gavf_io_set_interrupt_func(g->io, check_stop, dt);
+  
+  pthread_mutex_lock(&dt->mutex);
+
+  while(1)
+    {
+    while(!dt->stop && buffer_full(g))
+      pthread_cond_wait(&dt->cond, &dt->mutex);
+
+    if(dt->stop)
+      break;
+
+    /* g->flags are only accessed with the lock held */
+    have_header = GAVF_HAS_FLAG(g, GAVF_FLAG_HAVE_PKT_HEADER);
+    
+    pthread_mutex_unlock(&dt->mutex);
+
+    /* Do I/O without holding the lock */
+    
+    if((!have_header &&
+        !gavf_packet_read_header(g)) ||
+       !(s = gavf_find_stream_by_id(g, g->pkthdr.stream_id)))
+      {
+      pthread_mutex_lock(&dt->mutex);
+      break;
+      }
+
+    /* The slot returned by gavf_packet_buffer_get_write() isn't
+       touched by readers before gavf_packet_buffer_done_write() */
+    pthread_mutex_lock(&dt->mutex);
+    p = gavf_packet_buffer_get_write(s->pb);
+    pthread_mutex_unlock(&dt->mutex);
+    
+    if(!gavf_read_gavl_packet(g->io, s->packet_duration, s->packet_flags,
+                              s->last_sync_pts, &s->next_pts, s->pts_offset, p))
+      {
+      pthread_mutex_lock(&dt->mutex);
+      break;
+      }
+    
+    p->id = s->id;
+    
+    pthread_mutex_lock(&dt->mutex);
+    GAVF_CLEAR_FLAG(g, GAVF_FLAG_HAVE_PKT_HEADER);
+    gavf_packet_buffer_done_write(s->pb);
+    dt->bytes += p->data_len;
+    pthread_cond_broadcast(&dt->cond);
+    }
+
+  dt->eof = 1;
+  pthread_cond_broadcast(&dt->cond);
+  pthread_mutex_unlock(&dt->mutex);
+
+  gavf_io_set_interrupt_func(g->io, NULL, NULL);
+  return NULL;
+  }
+
+gavl_source_status_t
+gavf_demux_thread_read_packet(gavf_stream_t * s, gavl_packet_t ** p)
+  {
+  gavl_source_status_t st = GAVL_SOURCE_OK;
+  gavf_t * g = s->g;
+  gavf_demux_thread_t * dt = g->dt;
+  
+  pthread_mutex_lock(&dt->mutex);
+
+  /* Start the thread when the first packet is requested */
+  if(!dt->running && !dt->eof)
+    {
+    dt->stop = 0;
+    if(!pthread_create(&dt->thread, NULL, thread_func, g))
+      dt->running = 1;
+    else
+      dt->eof = 1;
+    }
+  
+  while(!(*p = gavf_packet_buffer_get_read(s->pb)))
+    {
+    if(dt->eof)
+      {
+      st = GAVL_SOURCE_EOF;
+      break;
+      }
+    else if(s->flags & STREAM_FLAG_DISCONTINUOUS)
+      {
+      st = GAVL_SOURCE_AGAIN;
+      break;
+      }
+    
+    dt->waiting++;
+    pthread_cond_broadcast(&dt->cond);
+    pthread_cond_wait(&dt->cond, &dt->mutex);
+    dt->waiting--;
+    }
+
+  if(*p)
+    {
+    dt->bytes -= (*p)->data_len;
+    pthread_cond_broadcast(&dt->cond);
+    }
+  
+  pthread_mutex_unlock(&dt->mutex);
+  
+  return st;
+  }
+
+void gavf_demux_thread_stop(gavf_demux_thread_t * dt)
+  {
+  pthread_mutex_lock(&dt->mutex);
+
+  if(dt->running)
+    {
+    /* The thread exits after the current packet or in the middle
+       of a blocking read. In the latter case, the position of the io
+       is undefined, so stopping must be followed by a seek or close */
+    __atomic_store_n(&dt->stop, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&dt->cond);
+    pthread_mutex_unlock(&dt->mutex);
+    
+    pthread_join(dt->thread, NULL);
+    
+    pthread_mutex_lock(&dt->mutex);
+    dt->running = 0;
+    }
+  
+  dt->stop = 0;
+  dt->eof = 0;
+  dt->bytes = 0;
+  pthread_mutex_unlock(&dt->mutex);
+  }
+
+void gavf_demux_thread_destroy(gavf_demux_thread_t * dt)
+  {
+  gavf_demux_thread_stop(dt);
+  pthread_mutex_destroy(&dt->mutex);
+  pthread_cond_destroy(&dt->cond);
+  free(dt);
+  }
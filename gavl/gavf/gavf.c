@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <string.h>
+#include <sys/uio.h>
 
 #include <config.h>
 
@@ -30,6 +31,9 @@ static void gavf_stream_free(gavf_stream_t * s);
 static void free_track(gavf_t * g)
   {
   int i;
+
+  if(g->dt)
+    gavf_demux_thread_stop(g->dt);
   
   if(g->streams)
     {
@@ -91,6 +95,32 @@ int gavf_extension_write(gavf_io_t * io, uint32_t key, uint32_t len,
 /*
  */
 
+/*
+ *  Flush the output after a packet or sync header. With write coalescing,
+ *  data are collected in the io buffer until the byte window is full
+ *  or the packets span more than the time window.
+ */
+
+static int write_flush(gavf_t * g, gavl_time_t time, int force)
+  {
+  if(!force && (g->opt.coalesce_bytes || g->opt.coalesce_time))
+    {
+    if(!g->opt.coalesce_time || (time == GAVL_TIME_UNDEFINED))
+      return 1;
+    
+    if(g->coalesce_start == GAVL_TIME_UNDEFINED)
+      {
+      g->coalesce_start = time;
+      return 1;
+      }
+    if(time - g->coalesce_start < g->opt.coalesce_time)
+      return 1;
+    }
+  
+  g->coalesce_start = GAVL_TIME_UNDEFINED;
+  return gavf_io_flush(g->io);
+  }
+
 static int write_sync_header(gavf_t * g, int stream, int64_t packet_pts)
   {
   int ret = 0;
@@ -197,7 +227,7 @@ static int write_sync_header(gavf_t * g, int stream, int64_t packet_pts)
     if(g->streams[i].sync_pts != GAVL_TIME_UNDEFINED)
       g->streams[i].last_sync_pts = g->streams[i].sync_pts;
     }
-  if(!gavf_io_flush(g->io))
+  if(!write_flush(g, GAVL_TIME_UNDEFINED, 0))
     goto fail;
 
 
@@ -216,10 +246,23 @@ static int write_sync_header(gavf_t * g, int stream, int64_t packet_pts)
   return ret;
   }
 
+static int write_gavl_packet(gavf_io_t * io, gavf_io_t * hdr_io,
+                             gavf_io_t * prefix_io, int packet_duration,
+                             int packet_flags, int64_t last_sync_pts,
+                             const gavl_packet_t * p);
+
+/* 'P' + stream ID + packet length */
+#define PACKET_PREFIX_SIZE 16
+
 static gavl_sink_status_t do_write_packet(gavf_t * g, int32_t stream_id, int packet_flags,
                                           int64_t last_sync_pts,
-                                          int64_t default_duration, const gavl_packet_t * p)
+                                          int64_t default_duration, gavl_time_t time,
+                                          const gavl_packet_t * p)
   {
+  uint8_t prefix_data[PACKET_PREFIX_SIZE];
+  gavl_buffer_t prefix_buf;
+  gavf_io_t prefix_io;
+
   int result;
   gavl_msg_t msg;
 
@@ -233,12 +276,17 @@ static gavl_sink_status_t do_write_packet(gavf_t * g, int32_t stream_id, int pac
   if(!result)
     return GAVL_SINK_ERROR;
   
-  if((gavf_io_write_data(g->io,
+  /* Prefix, header and payload are written with one call */
+  gavl_buffer_init_static(&prefix_buf, prefix_data, PACKET_PREFIX_SIZE);
+  gavf_io_init_buf_write(&prefix_io, &prefix_buf);
+  
+  if((gavf_io_write_data(&prefix_io,
                          (const uint8_t*)GAVF_TAG_PACKET_HEADER, 1) < 1) ||
-     (!gavf_io_write_int32v(g->io, stream_id)))
+     (!gavf_io_write_int32v(&prefix_io, stream_id)))
     return GAVL_SINK_ERROR;
 
-  if(!gavf_write_gavl_packet(g->io, g->pkt_io, default_duration, packet_flags, last_sync_pts, p))
+  if(!write_gavl_packet(g->io, g->pkt_io, &prefix_io,
+                        default_duration, packet_flags, last_sync_pts, p))
     return GAVL_SINK_ERROR;
 
   if(g->opt.flags & GAVF_OPT_FLAG_DUMP_PACKETS)
@@ -247,8 +295,8 @@ static gavl_sink_status_t do_write_packet(gavf_t * g, int32_t stream_id, int pac
     gavl_packet_dump(p);
     }
   
-
-  if(!gavf_io_flush(g->io))
+  /* Packets without time (e.g. messages) are sent immediately */
+  if(!write_flush(g, time, (time == GAVL_TIME_UNDEFINED)))
     return GAVL_SINK_ERROR;
   
   gavl_msg_init(&msg);
@@ -264,7 +312,7 @@ static gavl_sink_status_t do_write_packet(gavf_t * g, int32_t stream_id, int pac
 static gavl_sink_status_t
 write_packet(gavf_t * g, int stream, const gavl_packet_t * p)
   {
-  gavl_time_t pts;
+  gavl_time_t pts = GAVL_TIME_UNDEFINED;
   int write_sync = 0;
   gavf_stream_t * s;
 
@@ -322,7 +370,7 @@ write_packet(gavf_t * g, int stream, const gavl_packet_t * p)
     }
 
   if(do_write_packet(g, s->id, s->packet_flags, s->last_sync_pts,
-                     s->packet_duration, p) != GAVL_SINK_OK)
+                     s->packet_duration, pts, p) != GAVL_SINK_OK)
     return GAVL_SINK_ERROR;
 
 #if 0
@@ -364,22 +412,56 @@ write_packet(gavf_t * g, int stream, const gavl_packet_t * p)
   return GAVL_SINK_OK;
   }
 
-int gavf_write_gavl_packet(gavf_io_t * io, gavf_io_t * hdr_io, int packet_duration,
-                           int packet_flags, int64_t last_sync_pts,
-                           const gavl_packet_t * p)
+/* Append the packet length to prefix_io and write prefix, header and
+   payload with a single gavf_io_writev() */
+
+static int write_gavl_packet(gavf_io_t * io, gavf_io_t * hdr_io,
+                             gavf_io_t * prefix_io, int packet_duration,
+                             int packet_flags, int64_t last_sync_pts,
+                             const gavl_packet_t * p)
   {
+  struct iovec iov[3];
   gavl_buffer_t * buf;
+  gavl_buffer_t * prefix;
+  int len;
+  
   buf = gavf_io_buf_get(hdr_io);
+  prefix = gavf_io_buf_get(prefix_io);
   gavf_io_buf_reset(hdr_io);
 
   if(!gavf_write_gavl_packet_header(hdr_io, packet_duration, packet_flags, last_sync_pts, p) ||
-     !gavf_io_write_uint32v(io, buf->len + p->data_len) ||
-     (gavf_io_write_data(io, buf->buf, buf->len) < buf->len) ||
-     (gavf_io_write_data(io, p->data, p->data_len) < p->data_len))
+     !gavf_io_write_uint32v(prefix_io, buf->len + p->data_len))
+    return 0;
+
+  iov[0].iov_base = prefix->buf;
+  iov[0].iov_len  = prefix->len;
+  iov[1].iov_base = buf->buf;
+  iov[1].iov_len  = buf->len;
+  iov[2].iov_base = p->data;
+  iov[2].iov_len  = p->data_len;
+
+  len = prefix->len + buf->len + p->data_len;
+  
+  if(gavf_io_writev(io, iov, 3) < len)
     return 0;
   return 1;
   }
 
+int gavf_write_gavl_packet(gavf_io_t * io, gavf_io_t * hdr_io, int packet_duration,
+                           int packet_flags, int64_t last_sync_pts,
+                           const gavl_packet_t * p)
+  {
+  uint8_t prefix_data[PACKET_PREFIX_SIZE];
+  gavl_buffer_t prefix_buf;
+  gavf_io_t prefix_io;
+
+  gavl_buffer_init_static(&prefix_buf, prefix_data, PACKET_PREFIX_SIZE);
+  gavf_io_init_buf_write(&prefix_io, &prefix_buf);
+  
+  return write_gavl_packet(io, hdr_io, &prefix_io,
+                           packet_duration, packet_flags, last_sync_pts, p);
+  }
+
 
 /*
  *  Flush packets. s is the stream of the last packet written.
@@ -915,6 +997,10 @@ void gavf_clear_buffers(gavf_t * g)
   {
   int i;
 
+  /* Stop reading before the buffers are cleared */
+  if(g->dt)
+    gavf_demux_thread_stop(g->dt);
+  
   for(i = 0; i < g->num_streams; i++)
     {
     if(g->streams[i].pb)
@@ -994,6 +1080,9 @@ int gavf_select_track(gavf_t * g, int track)
   g->num_streams = gavl_track_get_num_streams_all(g->cur);
 
   init_streams(g);
+
+  if((g->opt.flags & GAVF_OPT_FLAG_DEMUX_THREAD) && !g->dt)
+    g->dt = gavf_demux_thread_create(&g->opt);
   
   if(GAVF_HAS_FLAG(g, GAVF_FLAG_STREAMING) &&
      !GAVF_HAS_FLAG(g, GAVF_FLAG_MULTI_HEADER))
@@ -1037,7 +1126,13 @@ int gavf_select_track(gavf_t * g, int track)
     {
     /* Read indices */
 
-    
+    if(g->sync_index_pos && (g->sync_index_pos[track] > 0))
+      {
+      gavf_io_seek(g->io, g->sync_index_pos[track], SEEK_SET);
+      
+      if(!gavf_sync_index_read_paged(g->io, &g->si))
+        goto fail;
+      }
     }
 
   ret = 1;
@@ -1137,7 +1232,6 @@ static int read_header(gavf_t * g,
 int gavf_open_read(gavf_t * g, gavf_io_t * io)
   {
   int ret = 0;
-  gavf_io_t bufio;
   gavl_buffer_t buf;
   gavf_chunk_t head;
   gavl_dictionary_t mi;
@@ -1157,7 +1251,9 @@ int gavf_open_read(gavf_t * g, gavf_io_t * io)
     {
     int num_tracks;
     int64_t footer_pos;
+    int64_t footer_end;
     int64_t header_pos;
+    int64_t sync_index_pos;
 
     int64_t total_bytes;
 
@@ -1223,17 +1319,28 @@ int gavf_open_read(gavf_t * g, gavf_io_t * io)
          strcmp(head.eightcc, GAVF_TAG_FOOTER))
         return 0;
       
-      gavl_buffer_alloc(&buf, head.len);
-
-      if((buf.len = gavf_io_read_data(g->io, buf.buf, head.len)) < head.len)
+      footer_end = gavf_io_position(g->io) + head.len;
+      
+      if(!gavl_dictionary_read(g->io, &foot))
         goto fail;
 
-      buf.pos = 0;
+      /* The sync index follows the dictionary. Remember its position,
+         the entries are loaded on demand after selecting the track */
+
+      sync_index_pos = -1;
       
-      gavf_io_init_buf_read(&bufio, &buf);
+      if((gavf_io_position(g->io) + 8 <= footer_end) &&
+         (gavf_io_read_data(g->io, (uint8_t*)head.eightcc, 8) == 8) &&
+         (!strncmp(head.eightcc, GAVF_TAG_SYNC_INDEX, 8) ||
+          !strncmp(head.eightcc, GAVF_TAG_SYNC_INDEX_FIXED, 8)))
+        sync_index_pos = gavf_io_position(g->io) - 8;
       
-      if(!gavl_dictionary_read(&bufio, &foot))
-        goto fail;
+      g->sync_index_pos = realloc(g->sync_index_pos,
+                                  (gavl_get_num_tracks(&g->mi) + 1) *
+                                  sizeof(*g->sync_index_pos));
+      memmove(g->sync_index_pos + 1, g->sync_index_pos,
+              gavl_get_num_tracks(&g->mi) * sizeof(*g->sync_index_pos));
+      g->sync_index_pos[0] = sync_index_pos;
 
       fprintf(stderr, "Got footer\n");
       gavl_dictionary_dump(&foot, 2);
@@ -1305,6 +1412,9 @@ int gavf_open_read(gavf_t * g, gavf_io_t * io)
 
 int gavf_reset(gavf_t * g)
   {
+  if(g->dt)
+    gavf_clear_buffers(g);
+  
   if(g->first_sync_pos != g->io->position)
     {
     if(g->io->seek_func)
@@ -1624,10 +1734,14 @@ int gavf_packet_read_packet(gavf_t * g, gavl_packet_t * p)
   return 1;
   }
 
+/* The pages with the first and last sync index entries are loaded
+   when opening, so we don't touch the io while the demuxer thread
+   might be running */
+
 const int64_t * gavf_first_pts(gavf_t * gavf)
   {
-  if(gavf->opt.flags & GAVF_OPT_FLAG_SYNC_INDEX)
-    return gavf->si.entries[0].pts;
+  if(gavf->si.num_entries)
+    return gavf_sync_index_get_pts(&gavf->si, 0);
   else
     return NULL;
   }
@@ -1636,8 +1750,8 @@ const int64_t * gavf_first_pts(gavf_t * gavf)
 
 const int64_t * gavf_end_pts(gavf_t * gavf)
   {
-  if(gavf->opt.flags & GAVF_OPT_FLAG_SYNC_INDEX)
-    return gavf->si.entries[gavf->si.num_entries - 1].pts;
+  if(gavf->si.num_entries)
+    return gavf_sync_index_get_pts(&gavf->si, gavf->si.num_entries - 1);
   else
     return NULL;
   }
@@ -1650,7 +1764,8 @@ static gavl_sink_status_t write_demuxer_message(gavf_t * g, const gavl_msg_t * m
   gavl_packet_init(&p);
 
   gavf_msg_to_packet(msg, &p);
-  st = do_write_packet(g, GAVL_META_STREAM_ID_MSG_DEMUXER, 0, 0, 0, &p);
+  st = do_write_packet(g, GAVL_META_STREAM_ID_MSG_DEMUXER, 0, 0, 0,
+                       GAVL_TIME_UNDEFINED, &p);
   gavl_packet_free(&p);
   return st;
   }
@@ -1691,7 +1806,7 @@ const int64_t * gavf_seek(gavf_t * g, int64_t time, int scale)
   
   gavf_clear_buffers(g);
   
-  if(!(g->opt.flags & GAVF_OPT_FLAG_SYNC_INDEX))
+  if(!g->si.num_entries)
     return NULL;
 
   GAVF_CLEAR_FLAG(g, GAVF_FLAG_EOF);
@@ -1715,17 +1830,16 @@ const int64_t * gavf_seek(gavf_t * g, int64_t time, int scale)
     
     time_scaled = gavl_time_rescale(scale, g->streams[stream].timescale, time);
     
-    /* Descrease index pointer until we are before this time */
+    /* Find the last entry before this time. Since the pts of each
+       continuous stream increase, each stream can only lower the position */
+    
+    if((index_position = gavf_sync_index_find(&g->si, stream, time_scaled,
+                                              index_position)) < 0)
+      return NULL;
+    
+    if(!index_position)
+      break;
     
-    while(g->si.entries[index_position].pts[stream] > time_scaled)
-      {
-      if(!index_position)
-        {
-        done = 1;
-        break;
-        }
-      index_position--;
-      }
     stream++;
 
     if(stream >= g->num_streams)
@@ -1736,12 +1850,12 @@ const int64_t * gavf_seek(gavf_t * g, int64_t time, int scale)
     }
   
   /* Seek to the positon */
-  gavf_io_seek(g->io, g->si.entries[index_position].pos, SEEK_SET);
+  gavf_io_seek(g->io, gavf_sync_index_get_pos(&g->si, index_position), SEEK_SET);
 
   //  fprintf(stderr, "Index position: %ld, file position: %ld\n", index_position,
-  //          g->si.entries[index_position].pos);
+  //          gavf_sync_index_get_pos(&g->si, index_position));
 
-  return g->si.entries[index_position].pts;
+  return gavf_sync_index_get_pts(&g->si, index_position);
   }
 
 
@@ -1921,6 +2035,12 @@ int gavf_start(gavf_t * g)
     return 1;
   
   g->sync_distance = g->opt.sync_distance;
+  g->coalesce_start = GAVL_TIME_UNDEFINED;
+
+  if(g->opt.coalesce_bytes > 0)
+    gavf_io_set_write_buffer(g->io, g->opt.coalesce_bytes);
+  else if(g->opt.coalesce_time > 0)
+    gavf_io_set_write_buffer(g->io, GAVF_COALESCE_BYTES_DEFAULT);
   
   init_streams(g);
   
@@ -2170,6 +2290,10 @@ void gavf_close(gavf_t * g, int discard)
       }
     else
       gavf_footer_write(g);
+
+    /* Send pending data and stop buffering */
+    if(g->opt.coalesce_bytes || g->opt.coalesce_time)
+      gavf_io_set_write_buffer(g->io, 0);
     }
   
   /* Free stuff */
@@ -2180,6 +2304,12 @@ void gavf_close(gavf_t * g, int discard)
   
   gavl_packet_free(&g->skip_pkt);
 
+  if(g->sync_index_pos)
+    free(g->sync_index_pos);
+
+  if(g->dt)
+    gavf_demux_thread_destroy(g->dt);
+  
   if(g->pkt_io)
     gavf_io_destroy(g->pkt_io);
   
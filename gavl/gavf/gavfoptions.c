@@ -8,6 +8,20 @@ gavf_options_set_sync_distance(gavf_options_t * opt, gavl_time_t sync_distance)
   opt->sync_distance = sync_distance;
   }
 
+void
+gavf_options_set_write_coalescing(gavf_options_t * opt, int bytes, gavl_time_t time)
+  {
+  opt->coalesce_bytes = bytes;
+  opt->coalesce_time = time;
+  }
+
+void
+gavf_options_set_demux_buffer(gavf_options_t * opt, int bytes, gavl_time_t time)
+  {
+  opt->demux_bytes = bytes;
+  opt->demux_time = time;
+  }
+
 void
 gavf_options_set_flags(gavf_options_t * opt, int flags)
   {
@@ -494,8 +494,7 @@ int gavf_read_gavl_packet(gavf_io_t * io,
   
   /* Payload */
   p->data_len = len - (io->position - start_pos);
-  gavl_packet_alloc(p, p->data_len);
-  if(gavf_io_read_data(io, p->data, p->data_len) < p->data_len)
+  if(gavf_io_read_packet_data(io, p) < p->data_len)
     goto fail;
 
   /* Duration */
@@ -1,8 +1,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <sys/uio.h>
 
 #include <gavfprivate.h>
+#include <dictionary.h>
 #include <gavl/utils.h>
 #include <gavl/numptr.h>
 #include <gavl/value.h>
@@ -10,6 +12,9 @@
 // #define DUMP_MSG_WRITE
 // #define DUMP_MSG_READ
 
+/* Milliseconds between checks for an interrupt */
+#define INTERRUPT_TIMEOUT 50
+
 void gavf_io_init(gavf_io_t * ret,
                   gavf_read_func  r,
                   gavf_write_func w,
@@ -31,8 +36,20 @@ void gavf_io_set_nonblock_read(gavf_io_t * io, gavf_read_func read_nonblock)
   {
   io->read_func_nonblock = read_nonblock;
   }
+
+void gavf_io_set_writev_func(gavf_io_t * io, gavf_writev_func writev)
+  {
+  io->writev_func = writev;
+  }
   
 
+void gavf_io_set_interrupt_func(gavf_io_t * io,
+                                int (*func)(void * data), void * data)
+  {
+  io->interrupt_func = func;
+  io->interrupt_data = data;
+  }
+
 void * gavf_io_get_priv(gavf_io_t * io)
   {
   return io->priv;
@@ -45,7 +62,9 @@ int gavf_io_can_seek(gavf_io_t * io)
 
 int gavf_io_can_read(gavf_io_t * io, int timeout)
   {
-  if(io->poll_func)
+  if(io->read_buf.len > io->read_buf.pos)
+    return 1;
+  else if(io->poll_func)
     return io->poll_func(io->priv, timeout);
   else
     return 1;
@@ -67,8 +86,11 @@ gavf_io_t * gavf_io_create(gavf_read_func  r,
   return ret;
   }
 
+static int flush_write_buf(gavf_io_t * io);
+
 void gavf_io_cleanup(gavf_io_t * io)
   {
+  flush_write_buf(io);
   if(io->flush_func)
     io->flush_func(io->priv);
   if(io->close_func)
@@ -77,7 +99,8 @@ void gavf_io_cleanup(gavf_io_t * io)
     free(io->filename);
   if(io->mimetype)
     free(io->mimetype);
-  gavl_buffer_free(&io->get_buf);
+  gavl_buffer_free(&io->read_buf);
+  gavl_buffer_free(&io->write_buf);
   }
 
 void gavf_io_destroy(gavf_io_t * io)
@@ -91,7 +114,7 @@ void gavf_io_set_info(gavf_io_t * io, int64_t total_bytes, const char * filename
   if(total_bytes > 0)
     io->total_bytes = total_bytes;
   io->filename = gavl_strrep(io->filename, filename);
-  io->mimetype = gavl_strrep(io->filename, mimetype);
+  io->mimetype = gavl_strrep(io->mimetype, mimetype);
   }
 
 void gavf_io_set_poll_func(gavf_io_t * io, gavf_poll_func f)
@@ -122,6 +145,9 @@ int gavf_io_flush(gavf_io_t * io)
   int ret = 1;
   if(io->got_error)
     return 0;
+
+  if(!flush_write_buf(io))
+    return 0;
   
   if(io->flush_func)
     ret = io->flush_func(io->priv);
@@ -146,45 +172,151 @@ void gavf_io_reset_position(gavf_io_t * io)
   }
 
 
+void gavf_io_set_read_buffer(gavf_io_t * io, int size)
+  {
+  io->read_buf_size = size;
+  }
+
+/* Blocking read. If an interrupt function is set, we read whatever
+   is available and poll in between, so a stalled sender can't block
+   us forever */
+
+static int do_read(gavf_io_t * io, uint8_t * buf, int len)
+  {
+  int result;
+  int ret = 0;
+  
+  if(!io->interrupt_func || !io->poll_func || !io->read_func_nonblock)
+    return io->read_func(io->priv, buf, len);
+
+  while(ret < len)
+    {
+    if(io->interrupt_func(io->interrupt_data))
+      break;
+    
+    if(!io->poll_func(io->priv, INTERRUPT_TIMEOUT))
+      continue;
+
+    /* Readable but no data means EOF or error */
+    if((result = io->read_func_nonblock(io->priv, buf + ret, len - ret)) <= 0)
+      break;
+    ret += result;
+    }
+  return ret;
+  }
+
+/* Make at least len bytes available in the read buffer.
+   Return the number of available bytes */
+
+static int fill_read_buf(gavf_io_t * io, int len, int block)
+  {
+  int avail;
+  int size;
+  int result;
+  
+  avail = io->read_buf.len - io->read_buf.pos;
+  
+  if((avail >= len) || !io->read_func)
+    return avail;
+
+  /* Move remaining data to the start */
+  if(io->read_buf.pos)
+    {
+    if(avail)
+      memmove(io->read_buf.buf, io->read_buf.buf + io->read_buf.pos, avail);
+    io->read_buf.pos = 0;
+    io->read_buf.len = avail;
+    }
+
+  size = io->read_buf_size > len ? io->read_buf_size : len;
+  gavl_buffer_alloc(&io->read_buf, size);
+  
+  if(block && !io->read_func_nonblock)
+    {
+    /* Without a nonblocking read function, we can only read whole blocks */
+    result = io->read_func(io->priv, io->read_buf.buf + avail, size - avail);
+    if(result > 0)
+      io->read_buf.len += result;
+    return io->read_buf.len;
+    }
+
+  /* Get the missing bytes */
+  if(!block && io->read_func_nonblock)
+    result = io->read_func_nonblock(io->priv, io->read_buf.buf + avail, len - avail);
+  else
+    result = do_read(io, io->read_buf.buf + avail, len - avail);
+  
+  if(result <= 0)
+    return avail;
+  
+  io->read_buf.len += result;
+
+  /* Read ahead what's available */
+  if((io->read_buf.len < size) && io->read_func_nonblock)
+    {
+    result = io->read_func_nonblock(io->priv, io->read_buf.buf + io->read_buf.len,
+                                    size - io->read_buf.len);
+    if(result > 0)
+      io->read_buf.len += result;
+    }
+  
+  return io->read_buf.len;
+  }
+
+static int get_read_buf(gavf_io_t * io, uint8_t * buf, int len)
+  {
+  int avail = io->read_buf.len - io->read_buf.pos;
+
+  if(len > avail)
+    len = avail;
+  
+  if(len > 0)
+    {
+    memcpy(buf, io->read_buf.buf + io->read_buf.pos, len);
+    io->read_buf.pos += len;
+    io->position += len;
+    }
+  return len;
+  }
+
 static int io_read_data(gavf_io_t * io, uint8_t * buf, int len, int block)
   {
   int ret = 0;
   int result;
-  int num_get = 0;
 
   if(!io->read_func)
     return 0;
 
-  if(io->get_buf.len > 0)
+  /* Take from the read buffer */
+  if(io->read_buf.len > io->read_buf.pos)
     {
-    num_get = io->get_buf.len > len ? len : io->get_buf.len;
-    memcpy(buf, io->get_buf.buf, num_get);
-
-    if(io->get_buf.len > num_get)
-      memmove(io->get_buf.buf, io->get_buf.buf + num_get, io->get_buf.len - num_get);
-    
-    io->get_buf.len -= num_get;
-    
-    buf += num_get;
-    len -= num_get;
-    io->position += num_get;
-    ret = num_get;
-    
+    ret = get_read_buf(io, buf, len);
+    buf += ret;
+    len -= ret;
     }
 
   if(len > 0)
     {
-    if(!block && io->read_func_nonblock)
-      result = io->read_func_nonblock(io->priv, buf, len);
+    if(len < io->read_buf_size)
+      {
+      /* Small read: Refill the (empty) read buffer */
+      fill_read_buf(io, len, block);
+      result = get_read_buf(io, buf, len);
+      }
     else
-      result = io->read_func(io->priv, buf, len);
+      {
+      if(!block && io->read_func_nonblock)
+        result = io->read_func_nonblock(io->priv, buf, len);
+      else
+        result = do_read(io, buf, len);
+
+      if(result > 0)
+        io->position += result;
+      }
     
     if(result > 0)
-      {
-      io->position += result;
       ret += result;
-      }
-
+    
     if(!result && block)
       io->got_error = 1;
     }
@@ -196,37 +328,181 @@ int gavf_io_read_data(gavf_io_t * io, uint8_t * buf, int len)
   return io_read_data(io, buf, len, 1);
   }
 
+int gavf_io_read_packet_data(gavf_io_t * io, gavl_packet_t * p)
+  {
+  const uint8_t * ptr;
+  
+  if(io->map_func && (io->read_buf.len == io->read_buf.pos) &&
+     (ptr = io->map_func(io->priv, p->data_len)))
+    {
+    gavl_packet_set_external(p, (uint8_t*)ptr, p->data_len,
+                             io->unmap_func, io->priv);
+    io->position += p->data_len;
+    return p->data_len;
+    }
+  
+  gavl_packet_alloc(p, p->data_len);
+  return gavf_io_read_data(io, p->data, p->data_len);
+  }
+
 int gavf_io_read_data_nonblock(gavf_io_t * io, uint8_t * buf, int len)
   {
   return io_read_data(io, buf, len, 0);
   }
 
+int gavf_io_peek_data(gavf_io_t * io, const uint8_t ** ptr, int len)
+  {
+  int ret = fill_read_buf(io, len, 1);
+  *ptr = io->read_buf.buf + io->read_buf.pos;
+  return ret;
+  }
+
+void gavf_io_consume_data(gavf_io_t * io, int len)
+  {
+  int avail = io->read_buf.len - io->read_buf.pos;
+  
+  if(len > avail)
+    len = avail;
+  
+  io->read_buf.pos += len;
+  io->position += len;
+  }
+
 int gavf_io_get_data(gavf_io_t * io, uint8_t * buf, int len)
   {
-  int ret;
+  int avail;
+  
   if(!io->read_func)
     return 0;
 
-  if(io->get_buf.len < len)
-    {
-    gavl_buffer_alloc(&io->get_buf, len);
+  if((avail = fill_read_buf(io, len, 1)) <= 0)
+    return avail;
+  
+  /* Unlikely */
+  if(len > avail)
+    len = avail;
+  
+  memcpy(buf, io->read_buf.buf + io->read_buf.pos, len);
+  return len;
+  }
 
-    ret = io->read_func(io->priv, io->get_buf.buf + io->get_buf.len, len - io->get_buf.len);
 
-    if(ret > 0)
-      io->get_buf.len += ret;
-    else
-      return ret;
+/* Scatter/gather writing */
+
+#define MAX_IOV 16
+
+static int do_writev(gavf_io_t * io, const struct iovec * iov, int iovcnt)
+  {
+  int i;
+  int result;
+  int ret = 0;
+  
+  if(io->writev_func)
+    return io->writev_func(io->priv, iov, iovcnt);
+
+  for(i = 0; i < iovcnt; i++)
+    {
+    if(!iov[i].iov_len)
+      continue;
+    result = io->write_func(io->priv, iov[i].iov_base, iov[i].iov_len);
+    if(result > 0)
+      ret += result;
+    if(result < (int)iov[i].iov_len)
+      break;
     }
+  return ret;
+  }
 
-  /* Unlikely */
-  if(len > io->get_buf.len)
-    len = io->get_buf.len;
+static int flush_write_buf(gavf_io_t * io)
+  {
+  struct iovec iov;
+  int len = io->write_buf.len;
   
-  memcpy(buf, io->get_buf.buf, len);
-  return len;
+  if(!len)
+    return 1;
+
+  iov.iov_base = io->write_buf.buf;
+  iov.iov_len  = len;
+  io->write_buf.len = 0;
+  
+  if(do_writev(io, &iov, 1) < len)
+    {
+    io->got_error = 1;
+    return 0;
+    }
+  return 1;
+  }
+
+void gavf_io_set_write_buffer(gavf_io_t * io, int size)
+  {
+  flush_write_buf(io);
+  io->write_buf_size = size;
+  if(size > 0)
+    gavl_buffer_alloc(&io->write_buf, size);
+  else
+    {
+    gavl_buffer_free(&io->write_buf);
+    gavl_buffer_init(&io->write_buf);
+    }
   }
 
+int gavf_io_writev(gavf_io_t * io, const struct iovec * iov, int iovcnt)
+  {
+  int i;
+  int ret;
+  int len = 0;
+  
+  if(io->got_error)
+    return -1;
+
+  if(!io->write_func && !io->writev_func)
+    return 0;
+  
+  for(i = 0; i < iovcnt; i++)
+    len += iov[i].iov_len;
+  
+  if(io->write_buf_size > 0)
+    {
+    if(io->write_buf.len + len <= io->write_buf_size)
+      {
+      /* Collect */
+      for(i = 0; i < iovcnt; i++)
+        {
+        memcpy(io->write_buf.buf + io->write_buf.len, iov[i].iov_base, iov[i].iov_len);
+        io->write_buf.len += iov[i].iov_len;
+        }
+      io->position += len;
+      return len;
+      }
+    else if(io->write_buf.len && (iovcnt < MAX_IOV))
+      {
+      /* Send buffered data together with the new ones */
+      struct iovec vec[MAX_IOV];
+      int buf_len = io->write_buf.len;
+      
+      vec[0].iov_base = io->write_buf.buf;
+      vec[0].iov_len  = buf_len;
+      memcpy(vec + 1, iov, iovcnt * sizeof(*iov));
+      io->write_buf.len = 0;
+      
+      ret = do_writev(io, vec, iovcnt + 1) - buf_len;
+      if(ret > 0)
+        io->position += ret;
+      if(ret < len)
+        io->got_error = 1;
+      return ret;
+      }
+    else if(!flush_write_buf(io))
+      return -1;
+    }
+  
+  ret = do_writev(io, iov, iovcnt);
+  if(ret > 0)
+    io->position += ret;
+  if(ret < len)
+    io->got_error = 1;
+  return ret;
+  }
 
 int gavf_io_write_data(gavf_io_t * io, const uint8_t * buf, int len)
   {
@@ -234,6 +510,14 @@ int gavf_io_write_data(gavf_io_t * io, const uint8_t * buf, int len)
   if(io->got_error)
     return -1;
 
+  if(io->write_buf_size > 0)
+    {
+    struct iovec iov;
+    iov.iov_base = (void*)buf;
+    iov.iov_len  = len;
+    return gavf_io_writev(io, &iov, 1);
+    }
+  
   if(!io->write_func)
     return 0;
   ret = io->write_func(io->priv, buf, len);
@@ -245,19 +529,35 @@ int gavf_io_write_data(gavf_io_t * io, const uint8_t * buf, int len)
   return ret;
   }
 
+#define SKIP_SIZE 4096
+
 void gavf_io_skip(gavf_io_t * io, int bytes)
   {
+  int len;
+  uint8_t buf[SKIP_SIZE];
+
+  /* Discard buffered data */
+  len = io->read_buf.len - io->read_buf.pos;
+  if(len > bytes)
+    len = bytes;
+  
+  gavf_io_consume_data(io, len);
+  bytes -= len;
+  
+  if(!bytes)
+    return;
+  
   if(io->seek_func)
-    io->position = io->seek_func(io->priv, bytes, SEEK_CUR);
+    gavf_io_seek(io, bytes, SEEK_CUR);
   else
     {
-    int i;
-    uint8_t c;
-    for(i = 0; i < bytes; i++)
+    while(bytes > 0)
       {
-      if(gavf_io_read_data(io, &c, 1) < 1)
+      len = bytes > SKIP_SIZE ? SKIP_SIZE : bytes;
+      
+      if(gavf_io_read_data(io, buf, len) < len)
         break;
-      io->position++;
+      bytes -= len;
       }
     }
   }
@@ -266,6 +566,19 @@ int64_t gavf_io_seek(gavf_io_t * io, int64_t pos, int whence)
   {
   if(!io->seek_func)
     return -1;
+  if(!flush_write_buf(io))
+    return -1;
+
+  /* Drop the read buffer. The underlying position is ahead
+     by the number of buffered bytes */
+  if(io->read_buf.len > io->read_buf.pos)
+    {
+    if(whence == SEEK_CUR)
+      pos -= io->read_buf.len - io->read_buf.pos;
+    }
+  io->read_buf.len = 0;
+  io->read_buf.pos = 0;
+  
   io->position = io->seek_func(io->priv, pos, whence);
   return io->position;
   }
@@ -1042,20 +1355,39 @@ int gavl_dictionary_write(gavf_io_t * io, const gavl_dictionary_t * dict)
 
 int gavl_dictionary_read(gavf_io_t * io, gavl_dictionary_t * dict)
   {
-  int i;
-  if(!gavf_io_read_int32v(io, &dict->num_entries))
+  int i, num, ret = 1;
+  gavl_dict_entry_t * e;
+  
+  if(!gavf_io_read_int32v(io, &num))
     return 0;
+
+  /* Append the entries as they are (including duplicates and undefined
+     values), so we get exactly what gavl_dictionary_write() wrote */
   
-  dict->entries_alloc = dict->num_entries;
-  dict->entries = calloc(dict->entries_alloc, sizeof(*dict->entries));
+  if(dict->num_entries + num > dict->entries_alloc)
+    {
+    dict->entries_alloc = dict->num_entries + num;
+    dict->entries = realloc(dict->entries,
+                            dict->entries_alloc * sizeof(*dict->entries));
+    }
   
-  for(i = 0; i < dict->num_entries; i++)
+  for(i = 0; i < num; i++)
     {
-    if(!gavf_io_read_string(io, &dict->entries[i].name) ||
-       !gavl_value_read(io, &dict->entries[i].v))
-      return 0;
+    e = dict->entries + dict->num_entries;
+    memset(e, 0, sizeof(*e));
+    dict->num_entries++;
+    
+    if(!gavf_io_read_string(io, &e->name) ||
+       !gavl_value_read(io, &e->v))
+      {
+      ret = 0;
+      break;
+      }
     }
-  return 1;
+
+  /* Build the hash index once for all entries */
+  gavl_dictionary_rebuild_index(dict);
+  return ret;
   }
 
 int gavl_value_write(gavf_io_t * io, const gavl_value_t * v)
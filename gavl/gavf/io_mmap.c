@@ -0,0 +1,174 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <gavfprivate.h>
+
+/*
+ *  Memory mapped file for zero copy reading.
+ *
+ *  The mapping is reference counted: The io holds one reference and each
+ *  packet, which points into the mapping, holds another one. Packets
+ *  therefore stay valid after the io is closed.
+ *
+ *  Packets are only mapped if the file already contains the zero
+ *  padding after them.
+ */
+
+typedef struct
+  {
+  uint8_t * map;
+  int64_t len;
+  int64_t pos;
+  int refcount;
+  } mmap_t;
+
+static void unref_mmap(void * priv)
+  {
+  mmap_t * m = priv;
+
+  if(__atomic_sub_fetch(&m->refcount, 1, __ATOMIC_ACQ_REL))
+    return;
+  
+  if(m->map)
+    munmap(m->map, m->len);
+  free(m);
+  }
+
+static int read_mmap(void * priv, uint8_t * data, int len)
+  {
+  mmap_t * m = priv;
+  int bytes = len;
+
+  if(m->pos + bytes > m->len)
+    bytes = m->len - m->pos;
+
+  if(bytes <= 0)
+    return 0;
+  memcpy(data, m->map + m->pos, bytes);
+  m->pos += bytes;
+  return bytes;
+  }
+
+static int64_t seek_mmap(void * priv, int64_t pos, int whence)
+  {
+  mmap_t * m = priv;
+  int64_t real_pos = 0;
+  switch(whence)
+    {
+    case SEEK_SET:
+      real_pos = pos;
+      break;
+    case SEEK_CUR:
+      real_pos = m->pos + pos;
+      break;
+    case SEEK_END:
+      real_pos = m->len + pos;
+      break;
+    }
+
+  if(real_pos < 0)
+    real_pos = 0;
+  if(real_pos > m->len)
+    real_pos = m->len;
+
+  m->pos = real_pos;
+  return m->pos;
+  }
+
+static void close_mmap(void * priv)
+  {
+  unref_mmap(priv);
+  }
+
+static const uint8_t * map_mmap(void * priv, int len)
+  {
+  int i;
+  const uint8_t * ret;
+  mmap_t * m = priv;
+
+  /* Decoders may read GAVL_PACKET_PADDING bytes beyond the end. Near the
+     end of the file we let the caller copy the data instead. */
+  if(m->pos + len + GAVL_PACKET_PADDING > m->len)
+    return NULL;
+
+  ret = m->map + m->pos;
+
+  /* The padding must be zero. We cannot clear it in the mapping because
+     it's the start of the next packet, which is read after this one
+     and again after seeking back. */
+  for(i = 0; i < GAVL_PACKET_PADDING; i++)
+    {
+    if(ret[len + i])
+      return NULL;
+    }
+  
+  m->pos += len;
+  __atomic_add_fetch(&m->refcount, 1, __ATOMIC_RELAXED);
+  return ret;
+  }
+
+GAVL_PUBLIC
+gavf_io_t * gavf_io_create_mmap_read(const char * filename)
+  {
+  int fd;
+  struct stat st;
+  mmap_t * m;
+  void * map;
+  gavf_io_t * ret;
+  
+  if((fd = open(filename, O_RDONLY)) < 0)
+    return NULL;
+  
+  if(fstat(fd, &st) || !S_ISREG(st.st_mode) || !st.st_size)
+    {
+    close(fd);
+    return NULL;
+    }
+
+  /* Writable copy-on-write mapping: Packets pointing into the file are
+     byte swapped in place for streams with the other endianess */
+  map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  
+  if(map == MAP_FAILED)
+    return NULL;
+
+  madvise(map, st.st_size, MADV_SEQUENTIAL);
+  
+  m = calloc(1, sizeof(*m));
+  m->map = map;
+  m->len = st.st_size;
+  m->refcount = 1;
+  
+  ret = gavf_io_create(read_mmap, NULL, seek_mmap, close_mmap, NULL, m);
+  ret->map_func = map_mmap;
+  ret->unmap_func = unref_mmap;
+  
+  gavf_io_set_info(ret, st.st_size, filename, NULL);
+  return ret;
+  }
@@ -121,6 +121,12 @@ static int write_socket(void * priv, const uint8_t * data, int len)
   return gavl_socket_write_data(s->fd, data, len);
   }
 
+static int writev_socket(void * priv, const struct iovec * iov, int iovcnt)
+  {
+  socket_t * s = priv;
+  return gavl_socket_writev_data(s->fd, iov, iovcnt);
+  }
+
 static void close_socket(void * priv)
   {
   socket_t * s = priv;
@@ -161,6 +167,7 @@ gavf_io_t * gavf_io_create_socket_1(int fd, int read_timeout, int flags)
 
   gavf_io_set_poll_func(ret, poll_socket);
   gavf_io_set_nonblock_read(ret, read_socket_nonblock);
+  gavf_io_set_writev_func(ret, writev_socket);
   
   return ret;
   }
@@ -1,5 +1,13 @@
+#include <stdlib.h>
+#include <errno.h>
+
 #include <gavfprivate.h>
 
+#ifndef _WIN32
+#include <unistd.h>
+#include <poll.h>
+#endif
+
 #ifdef _WIN32
 #define GAVL_FSEEK(a,b,c) fseeko64(a,b,c)
 #define GAVL_FTELL(a) ftello64(a)
@@ -78,3 +86,90 @@ gavf_io_t * gavf_io_create_file(FILE * f, int wr, int can_seek, int close)
 
   return gavf_io_create(rf, wf, sf, close ? close_file : NULL, ff, f);
   }
+
+#ifndef _WIN32
+
+/*
+ *  Unbuffered reading from a file descriptor (e.g. a pipe). Unlike stdio,
+ *  we can poll it, so blocking reads can be interrupted (see
+ *  gavf_io_set_interrupt_func()).
+ */
+
+typedef struct
+  {
+  int fd;
+  int do_close;
+  } fd_t;
+
+static int read_fd(void * priv, uint8_t * data, int len)
+  {
+  int result;
+  int ret = 0;
+  fd_t * f = priv;
+
+  while(ret < len)
+    {
+    result = read(f->fd, data + ret, len - ret);
+
+    if(result < 0)
+      {
+      if(errno == EINTR)
+        continue;
+      break;
+      }
+    else if(!result)
+      break;
+    ret += result;
+    }
+  return ret;
+  }
+
+static int poll_fd(void * priv, int timeout)
+  {
+  struct pollfd pfd;
+  fd_t * f = priv;
+  
+  pfd.fd = f->fd;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+
+  /* Errors and hangups are reported by the next read */
+  return (poll(&pfd, 1, timeout) > 0);
+  }
+
+static int read_fd_nonblock(void * priv, uint8_t * data, int len)
+  {
+  int result;
+  fd_t * f = priv;
+
+  if(!poll_fd(priv, 0))
+    return 0;
+
+  result = read(f->fd, data, len);
+  return (result > 0) ? result : 0;
+  }
+
+static void close_fd(void * priv)
+  {
+  fd_t * f = priv;
+  if(f->do_close)
+    close(f->fd);
+  free(f);
+  }
+
+GAVL_PUBLIC
+gavf_io_t * gavf_io_create_fd_read(int fd, int do_close)
+  {
+  gavf_io_t * ret;
+  fd_t * f = calloc(1, sizeof(*f));
+
+  f->fd = fd;
+  f->do_close = do_close;
+
+  ret = gavf_io_create(read_fd, NULL, NULL, close_fd, NULL, f);
+  gavf_io_set_poll_func(ret, poll_fd);
+  gavf_io_set_nonblock_read(ret, read_fd_nonblock);
+  return ret;
+  }
+
+#endif
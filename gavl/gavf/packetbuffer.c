@@ -5,17 +5,112 @@
 
 #define INCREMENT 8
 
+/* Packets are kept in a ring buffer. The packet structs are allocated
+   in blocks and recycled. The minimum pts is maintained by a second
+   ring with the packets, whose pts is smaller than the pts of all
+   later packets (in ascending order). */
+
+#define PACKET(b, i) (b)->packets[((b)->start + (i)) % (b)->packets_alloc]
+#define MIN_PTS(b, i) (b)->min[((b)->min_start + (i)) % (b)->packets_alloc]
+
+typedef struct
+  {
+  int64_t seq;
+  int64_t pts;
+  } min_pts_t;
+
 struct gavf_packet_buffer_s
   {
   gavl_packet_t ** packets;
+  int start;
   int num_packets;
   int packets_alloc;
+
+  gavl_packet_t ** blocks;
+  int num_blocks;
+  
+  min_pts_t * min;
+  int min_start;
+  int num_min;
+  int min_dirty;
+  
+  /* Sequence number of the first packet */
+  int64_t read_seq;
+  
   int timescale;
 
   gavf_packet_unref_func unref_func;
   void *                 unref_data;
   };
 
+static void push_min(gavf_packet_buffer_t * b, int64_t seq, int64_t pts)
+  {
+  /* Drop packets, which can never become the minimum again */
+  while(b->num_min && (MIN_PTS(b, b->num_min-1).pts >= pts))
+    b->num_min--;
+
+  MIN_PTS(b, b->num_min).seq = seq;
+  MIN_PTS(b, b->num_min).pts = pts;
+  b->num_min++;
+  }
+
+static void rebuild_min(gavf_packet_buffer_t * b)
+  {
+  int i;
+
+  b->num_min = 0;
+  
+  for(i = 0; i < b->num_packets; i++)
+    push_min(b, b->read_seq + i, PACKET(b, i)->pts);
+
+  b->min_dirty = 0;
+  }
+
+static void grow(gavf_packet_buffer_t * b)
+  {
+  int i;
+  int new_alloc;
+  gavl_packet_t ** packets;
+  gavl_packet_t * block;
+  min_pts_t * min;
+  
+  new_alloc = b->packets_alloc ? b->packets_alloc * 2 : INCREMENT;
+
+  /* Unwrap the rings. The new packets are inserted after the queued
+     ones, so the free slot before the start (the last packet read)
+     remains the last one to be written */
+  packets = malloc(new_alloc * sizeof(*packets));
+  min = malloc(new_alloc * sizeof(*min));
+  
+  block = calloc(new_alloc - b->packets_alloc, sizeof(*block));
+
+  for(i = 0; i < b->num_packets; i++)
+    packets[i] = PACKET(b, i);
+  
+  for(i = 0; i < new_alloc - b->packets_alloc; i++)
+    packets[b->num_packets + i] = block + i;
+
+  for(i = b->num_packets; i < b->packets_alloc; i++)
+    packets[new_alloc - b->packets_alloc + i] = PACKET(b, i);
+  
+  for(i = 0; i < b->num_min; i++)
+    min[i] = MIN_PTS(b, i);
+  
+  b->blocks = realloc(b->blocks, (b->num_blocks+1) * sizeof(*b->blocks));
+  b->blocks[b->num_blocks++] = block;
+  
+  if(b->packets)
+    free(b->packets);
+  if(b->min)
+    free(b->min);
+
+  b->packets = packets;
+  b->min = min;
+  b->start = 0;
+  b->min_start = 0;
+  b->packets_alloc = new_alloc;
+  }
+
 void gavf_packet_buffer_set_unref_func(gavf_packet_buffer_t * b,
                                        gavf_packet_unref_func unref_func,
                                        void *                 unref_data)
@@ -31,10 +126,13 @@ void gavf_packet_buffer_clear(gavf_packet_buffer_t * b)
   if(b->unref_func)
     {
     for(i = 0; i < b->num_packets; i++)
-      b->unref_func(b->packets[i], b->unref_data);
+      b->unref_func(PACKET(b, i), b->unref_data);
     }
   
+  b->read_seq += b->num_packets;
   b->num_packets = 0;
+  b->num_min = 0;
+  b->min_dirty = 0;
   }
 
 gavf_packet_buffer_t * gavf_packet_buffer_create(int timescale)
@@ -47,23 +145,21 @@ gavf_packet_buffer_t * gavf_packet_buffer_create(int timescale)
 gavl_packet_t * gavf_packet_buffer_get_write(gavf_packet_buffer_t * b)
   {
   gavl_packet_t * ret;
-  if(b->packets_alloc - b->num_packets <= 0)
-    {
-    int i;
-    b->packets =
-      realloc(b->packets, (b->packets_alloc+INCREMENT) * sizeof(*b->packets));
 
-    for(i = b->packets_alloc; i < b->packets_alloc+INCREMENT; i++)
-      b->packets[i] = calloc(1, sizeof(*b->packets[i]));
-    b->packets_alloc+=INCREMENT;
-    }
-  ret = b->packets[b->num_packets];
+  /* Never overwrite the last packet returned by
+     gavf_packet_buffer_get_read() */
+  if(b->num_packets >= b->packets_alloc - 1)
+    grow(b);
+  
+  ret = PACKET(b, b->num_packets);
   gavl_packet_reset(ret);
   return ret;
   }
 
 void gavf_packet_buffer_done_write(gavf_packet_buffer_t * b)
   {
+  if(!b->min_dirty)
+    push_min(b, b->read_seq + b->num_packets, PACKET(b, b->num_packets)->pts);
   b->num_packets++;
   }
 
@@ -72,14 +168,18 @@ gavl_packet_t * gavf_packet_buffer_get_read(gavf_packet_buffer_t * b)
   gavl_packet_t * ret;
   if(!b->num_packets)
     return NULL;
-  ret = b->packets[0];
+  ret = PACKET(b, 0);
+
+  if(!b->min_dirty && (MIN_PTS(b, 0).seq == b->read_seq))
+    {
+    b->min_start = (b->min_start + 1) % b->packets_alloc;
+    b->num_min--;
+    }
   
+  /* The packet stays valid until the next call */
+  b->start = (b->start + 1) % b->packets_alloc;
   b->num_packets--;
-  if(b->num_packets)
-    memmove(b->packets, b->packets+1, b->num_packets * sizeof(*b->packets));
-
-  /* Requeue */
-  b->packets[b->num_packets] = ret;
+  b->read_seq++;
   
   return ret;
   }
@@ -90,38 +190,35 @@ gavl_packet_t * gavf_packet_buffer_peek_read(gavf_packet_buffer_t * b)
     return NULL;
   //  if(b->packets[0]->data_len == 0)
   //    return NULL;
-  return b->packets[0];
+  return PACKET(b, 0);
   }
 
 gavl_time_t gavf_packet_buffer_get_min_pts(gavf_packet_buffer_t * b)
   {
-  int i;
-  gavl_time_t ret = GAVL_TIME_UNDEFINED;
-  
   if(!b->num_packets)
-    return ret;
+    return GAVL_TIME_UNDEFINED;
 
-  //  if(!b->packets[0]->data_len)
-  //    return ret;
+  if(b->min_dirty)
+    rebuild_min(b);
   
-  for(i = 0; i < b->num_packets; i++)
-    {
-    if(!i || (ret > b->packets[i]->pts))
-      ret = b->packets[i]->pts;
-    }
-  return gavl_time_unscale(b->timescale, ret);
+  return gavl_time_unscale(b->timescale, MIN_PTS(b, 0).pts);
   }
 
 void gavf_packet_buffer_destroy(gavf_packet_buffer_t * b)
   {
   int i;
   for(i = 0; i < b->packets_alloc; i++)
-    {
     gavl_packet_free(b->packets[i]);
-    free(b->packets[i]);
-    }
+
+  for(i = 0; i < b->num_blocks; i++)
+    free(b->blocks[i]);
+  
+  if(b->blocks)
+    free(b->blocks);
   if(b->packets)
     free(b->packets);
+  if(b->min)
+    free(b->min);
   free(b);
   }
 
@@ -130,12 +227,17 @@ const gavl_packet_t * gavf_packet_buffer_get_last(gavf_packet_buffer_t * b)
   if(!b->num_packets)
     return NULL;
   else
-    return b->packets[b->num_packets-1];
+    return PACKET(b, b->num_packets-1);
   }
 
 void gavf_packet_buffer_remove_last(gavf_packet_buffer_t * b)
   {
   if(b->num_packets)
+    {
     b->num_packets--;
+    /* Packets dropped from the minimum ring when the last one was
+       added are lost, so rebuild it when needed. This happens only for
+       out of band messages. */
+    b->min_dirty = 1;
+    }
   }
-
@@ -91,6 +91,23 @@ read_packet_func_buffer_cont(void * priv, gavl_packet_t ** p)
   return GAVL_SOURCE_OK;
   }
 
+static gavl_source_status_t
+read_packet_func_thread(void * priv, gavl_packet_t ** p)
+  {
+  gavf_stream_t * s = priv;
+  gavl_source_status_t st;
+
+  if((st = gavf_demux_thread_read_packet(s, p)) != GAVL_SOURCE_OK)
+    return st;
+  
+  if(s->g->opt.flags & GAVF_OPT_FLAG_DUMP_PACKETS)
+    {
+    fprintf(stderr, "ID: %d ", s->id);
+    gavl_packet_dump(*p);
+    }
+  return GAVL_SOURCE_OK;
+  }
+
 static gavl_source_status_t
 read_packet_func_buffer_discont(void * priv, gavl_packet_t ** p)
   {
@@ -109,7 +126,12 @@ void gavf_stream_create_packet_src(gavf_t * g, gavf_stream_t * s)
   gavl_packet_source_func_t func;
   int flags;
   
-  if(!(g->opt.flags & GAVF_OPT_FLAG_BUFFER_READ))
+  if(g->opt.flags & GAVF_OPT_FLAG_DEMUX_THREAD)
+    {
+    flags = GAVL_SOURCE_SRC_ALLOC;
+    func = read_packet_func_thread;
+    }
+  else if(!(g->opt.flags & GAVF_OPT_FLAG_BUFFER_READ))
     {
     func = read_packet_func_nobuffer;
     flags = 0;
@@ -2,6 +2,24 @@
 #include <string.h>
 
 #include <gavfprivate.h>
+#include <gavl/numptr.h>
+
+/* Index structure
+ *
+ * GAVFSIDF
+ * version (32 bit)
+ * num_entries (64 bit)
+ * num_streams (64 bit)
+ * num_entries * (pos (64 bit) + num_streams * pts (64 bit))
+ *
+ * The fixed entry size allows to load parts of the index on demand.
+ *
+ * Old indices start with GAVFSIDX followed by the number of entries
+ * and the entries, all as variable length numbers. They are converted
+ * to the in-memory index when read.
+ */
+
+#define SYNC_INDEX_VERSION 1
 
 void gavf_sync_index_init(gavf_sync_index_t * idx, int num_streams)
   {
@@ -31,15 +49,55 @@ void gavf_sync_index_add(gavf_t * g, uint64_t pos)
   idx->num_entries++;
   }
 
-int gavf_sync_index_read(gavf_io_t * io, gavf_sync_index_t * idx)
+/* Returns the version (0 for old indices) or -1 */
+
+static int read_header(gavf_io_t * io, gavf_sync_index_t * idx)
+  {
+  char tag[8];
+  uint32_t version;
+  uint64_t num_streams;
+  
+  if(gavf_io_read_data(io, (uint8_t*)tag, 8) < 8)
+    return -1;
+
+  if(!strncmp(tag, GAVF_TAG_SYNC_INDEX, 8))
+    return 0;
+  
+  if(strncmp(tag, GAVF_TAG_SYNC_INDEX_FIXED, 8) ||
+     !gavf_io_read_32_be(io, &version))
+    return -1;
+  
+  if(version != SYNC_INDEX_VERSION)
+    {
+    fprintf(stderr, "Unsupported sync index version %u\n", version);
+    return -1;
+    }
+  
+  if(!gavf_io_read_uint64f(io, &idx->num_entries) ||
+     !gavf_io_read_uint64f(io, &num_streams))
+    return -1;
+
+  if(num_streams != idx->num_streams)
+    {
+    fprintf(stderr, "Sync index has %"PRId64" streams, expected %d\n",
+            num_streams, idx->num_streams);
+    return -1;
+    }
+  idx->entry_size = (idx->num_streams + 1) * 8;
+  return version;
+  }
+
+static int read_v0(gavf_io_t * io, gavf_sync_index_t * idx)
   {
   uint64_t i;
   int j;
-  
+
   if(!gavf_io_read_uint64v(io, &idx->num_entries))
     return 0;
-  idx->entries = malloc(idx->num_entries * sizeof(*idx->entries));
 
+  idx->entries = calloc(idx->num_entries, sizeof(*idx->entries));
+  idx->entries_alloc = idx->num_entries;
+  
   for(i = 0; i < idx->num_entries; i++)
     {
     if(!gavf_io_read_uint64v(io, &idx->entries[i].pos))
@@ -55,24 +113,187 @@ int gavf_sync_index_read(gavf_io_t * io, gavf_sync_index_t * idx)
   return 1;
   }
 
+int gavf_sync_index_read(gavf_io_t * io, gavf_sync_index_t * idx)
+  {
+  uint64_t i;
+  int j;
+
+  switch(read_header(io, idx))
+    {
+    case -1:
+      return 0;
+    case 0:
+      return read_v0(io, idx);
+    }
+  
+  idx->entries = calloc(idx->num_entries, sizeof(*idx->entries));
+  idx->entries_alloc = idx->num_entries;
+  
+  for(i = 0; i < idx->num_entries; i++)
+    {
+    if(!gavf_io_read_uint64f(io, &idx->entries[i].pos))
+      return 0;
+    
+    idx->entries[i].pts = malloc(idx->pts_len);
+    for(j = 0; j < idx->num_streams; j++)
+      {
+      if(!gavf_io_read_int64f(io, &idx->entries[i].pts[j]))
+        return 0;
+      }
+    }
+  return 1;
+  }
+
+static int load_page(gavf_sync_index_t * idx, int page);
+
+int gavf_sync_index_read_paged(gavf_io_t * io, gavf_sync_index_t * idx)
+  {
+  switch(read_header(io, idx))
+    {
+    case -1:
+      return 0;
+    case 0:
+      /* Old indices have no fixed entry size and are loaded completely */
+      return read_v0(io, idx);
+    }
+
+  idx->io = io;
+  idx->entries_start = gavf_io_position(io);
+  idx->num_pages = (idx->num_entries + GAVF_SYNC_INDEX_PAGE_SIZE - 1) /
+    GAVF_SYNC_INDEX_PAGE_SIZE;
+  idx->pages = calloc(idx->num_pages, sizeof(*idx->pages));
+
+  /* Load the first and last entries now. gavf_first_pts() and
+     gavf_end_pts() can be called while the demuxer thread reads
+     from the io, so they must not load pages */
+  if(idx->num_pages && !load_page(idx, 0))
+    return 0;
+  if((idx->num_pages > 1) && !load_page(idx, idx->num_pages - 1))
+    return 0;
+  
+  return 1;
+  }
+
+static int load_page(gavf_sync_index_t * idx, int page)
+  {
+  int i, j, num;
+  int64_t first;
+  int64_t old_pos;
+  uint8_t * buf;
+  uint8_t * ptr;
+  int result = 0;
+  
+  first = (int64_t)page * GAVF_SYNC_INDEX_PAGE_SIZE;
+  num = idx->num_entries - first;
+  if(num > GAVF_SYNC_INDEX_PAGE_SIZE)
+    num = GAVF_SYNC_INDEX_PAGE_SIZE;
+
+  buf = malloc(num * idx->entry_size);
+  
+  old_pos = gavf_io_position(idx->io);
+  
+  if((gavf_io_seek(idx->io, idx->entries_start + first * idx->entry_size,
+                   SEEK_SET) < 0) ||
+     (gavf_io_read_data(idx->io, buf, num * idx->entry_size) <
+      num * idx->entry_size))
+    goto fail;
+  
+  idx->pages[page].pos = malloc(num * sizeof(*idx->pages[page].pos));
+  idx->pages[page].pts = malloc(num * idx->pts_len);
+
+  ptr = buf;
+  for(i = 0; i < num; i++)
+    {
+    idx->pages[page].pos[i] = GAVL_PTR_2_64BE(ptr);
+    ptr += 8;
+    for(j = 0; j < idx->num_streams; j++)
+      {
+      idx->pages[page].pts[i * idx->num_streams + j] = GAVL_PTR_2_64BE(ptr);
+      ptr += 8;
+      }
+    }
+  result = 1;
+  
+  fail:
+
+  gavf_io_seek(idx->io, old_pos, SEEK_SET);
+  free(buf);
+  return result;
+  }
+
+uint64_t gavf_sync_index_get_pos(gavf_sync_index_t * idx, int64_t i)
+  {
+  int page;
+  
+  if(!idx->pages)
+    return idx->entries[i].pos;
+
+  page = i / GAVF_SYNC_INDEX_PAGE_SIZE;
+  if(!idx->pages[page].pos && !load_page(idx, page))
+    return 0;
+  return idx->pages[page].pos[i % GAVF_SYNC_INDEX_PAGE_SIZE];
+  }
+
+const int64_t * gavf_sync_index_get_pts(gavf_sync_index_t * idx, int64_t i)
+  {
+  int page;
+  
+  if(!idx->pages)
+    return idx->entries[i].pts;
+
+  page = i / GAVF_SYNC_INDEX_PAGE_SIZE;
+  if(!idx->pages[page].pts && !load_page(idx, page))
+    return NULL;
+  return idx->pages[page].pts +
+    (i % GAVF_SYNC_INDEX_PAGE_SIZE) * idx->num_streams;
+  }
+
+int64_t gavf_sync_index_find(gavf_sync_index_t * idx, int stream,
+                             int64_t time, int64_t max)
+  {
+  int64_t lo = 0;
+  int64_t hi = max;
+  int64_t mid;
+  const int64_t * pts;
+
+  if(max < 0)
+    return -1;
+  
+  while(lo < hi)
+    {
+    mid = lo + (hi - lo + 1) / 2;
+    
+    if(!(pts = gavf_sync_index_get_pts(idx, mid)))
+      return -1;
+    
+    if(pts[stream] <= time)
+      lo = mid;
+    else
+      hi = mid - 1;
+    }
+  return lo;
+  }
+
 int gavf_sync_index_write(gavf_io_t * io, const gavf_sync_index_t * idx)
   {
   uint64_t i;
   int j;
 
-  if(gavf_io_write_data(io, (uint8_t*)GAVF_TAG_SYNC_INDEX, 8) < 8)
+  if(gavf_io_write_data(io, (uint8_t*)GAVF_TAG_SYNC_INDEX_FIXED, 8) < 8)
     return 0;
   
-  if(!gavf_io_write_uint64v(io, idx->num_entries))
+  if(!gavf_io_write_32_be(io, SYNC_INDEX_VERSION) ||
+     !gavf_io_write_uint64f(io, idx->num_entries) ||
+     !gavf_io_write_uint64f(io, idx->num_streams))
     return 0;
 
   for(i = 0; i < idx->num_entries; i++)
     {
-    if(!gavf_io_write_uint64v(io, idx->entries[i].pos))
+    if(!gavf_io_write_uint64f(io, idx->entries[i].pos))
       return 0;
     for(j = 0; j < idx->num_streams; j++)
       {
-      if(!gavf_io_write_int64v(io, idx->entries[i].pts[j]))
+      if(!gavf_io_write_int64f(io, idx->entries[i].pts[j]))
         return 0;
       }
     }
@@ -82,30 +303,48 @@ int gavf_sync_index_write(gavf_io_t * io, const gavf_sync_index_t * idx)
 void gavf_sync_index_free(gavf_sync_index_t * idx)
   {
   int i;
-  for(i = 0; i < idx->num_entries; i++)
-    {
-    if(idx->entries[i].pts)
-      free(idx->entries[i].pts);
-    }
-          
 
   if(idx->entries)
+    {
+    for(i = 0; i < idx->num_entries; i++)
+      {
+      if(idx->entries[i].pts)
+        free(idx->entries[i].pts);
+      }
     free(idx->entries);
+    }
+
+  if(idx->pages)
+    {
+    for(i = 0; i < idx->num_pages; i++)
+      {
+      if(idx->pages[i].pos)
+        free(idx->pages[i].pos);
+      if(idx->pages[i].pts)
+        free(idx->pages[i].pts);
+      }
+    free(idx->pages);
+    }
   }
 
-void gavf_sync_index_dump(const gavf_sync_index_t * idx)
+void gavf_sync_index_dump(gavf_sync_index_t * idx)
   {
   uint64_t i;
   int j;
+  const int64_t * pts;
   
   fprintf(stderr, "Sync index (%"PRId64" entries)\n", idx->num_entries);
 
   for(i = 0; i < idx->num_entries; i++)
     {
-    fprintf(stderr, "  Pos: %"PRId64"\n", idx->entries[i].pos);
+    fprintf(stderr, "  Pos: %"PRId64"\n", gavf_sync_index_get_pos(idx, i));
+
+    if(!(pts = gavf_sync_index_get_pts(idx, i)))
+      break;
+    
     for(j = 0; j < idx->num_streams; j++)
       {
-      fprintf(stderr, "    PTS %02d: %"PRId64"\n", j, idx->entries[i].pts[j]);
+      fprintf(stderr, "    PTS %02d: %"PRId64"\n", j, pts[j]);
       }
     }
   
@@ -921,6 +921,41 @@ static void buffer_to_video_frame(gavl_v4l2_device_t * dev, gavl_v4l2_buffer_t *
     dev->vframe->strides[1] = bytesperline / 2;
     dev->vframe->strides[2] = bytesperline / 2;
     }
+  else if(gavl_pixelformat_is_semiplanar(dev->capture_format.pixelformat))
+    {
+    int bytesperline = 0;
+    int sizeimage = 0;
+    
+    dev->vframe->planes[0] = buf->planes[0].buf;
+    
+    if(dev->planar)
+      {
+      const struct v4l2_pix_format_mplane * m = &fmt->fmt.pix_mp;
+      bytesperline = m->plane_fmt[0].bytesperline;
+      
+      if(m->num_planes == 2)
+        {
+        /* Separate buffer for the chroma plane */
+        dev->vframe->planes[1] = buf->planes[1].buf;
+        dev->vframe->strides[1] = m->plane_fmt[1].bytesperline;
+        }
+      else
+        sizeimage = m->plane_fmt[0].sizeimage;
+      }
+    else
+      {
+      bytesperline = fmt->fmt.pix.bytesperline;
+      sizeimage = fmt->fmt.pix.sizeimage;
+      }
+    
+    if(sizeimage)
+      {
+      /* Chroma plane follows the luma plane */
+      dev->vframe->planes[1] = dev->vframe->planes[0] + (sizeimage * 2) / 3;
+      dev->vframe->strides[1] = bytesperline;
+      }
+    dev->vframe->strides[0] = bytesperline;
+    }
   else if(gavl_pixelformat_is_planar(dev->capture_format.pixelformat))
     {
     /* TODO */
@@ -1629,6 +1664,8 @@ pixelformats[] =
 /* two planes -- one Y, one Cr + Cb interleaved  */
     // #define V4L2_PIX_FMT_NV12    v4l2_fourcc('N','V','1','2') /* 12  Y/CbCr 4:2:0  */
     // #define V4L2_PIX_FMT_NV21    v4l2_fourcc('N','V','2','1') /* 12  Y/CrCb 4:2:0  */
+   { V4L2_PIX_FMT_NV12, GAVL_NV12, GAVL_CODEC_ID_NONE },
+   { V4L2_PIX_FMT_NV21, GAVL_NV21, GAVL_CODEC_ID_NONE },
 
 /*  The following formats are not defined in the V4L2 specification */
     // #define V4L2_PIX_FMT_YUV410  v4l2_fourcc('Y','U','V','9') /*  9  YUV 4:1:0     */
@@ -22,6 +22,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include <config.h>
+
 #include <audio.h>
 #include <interleave.h>
 #include <accel.h>
@@ -215,6 +217,10 @@ gavl_create_interleave_table(gavl_audio_options_t * opt)
 
   if(opt->quality || (opt->accel_flags & GAVL_ACCEL_C))
     gavl_init_interleave_funcs_c(ret);
+#ifdef HAVE_SSE2
+  if(opt->accel_flags & GAVL_ACCEL_SSE2)
+    gavl_init_interleave_funcs_sse2(ret);
+#endif
   return ret;
   }
 
@@ -119,6 +119,7 @@ const char* sinc_get_name (int src_enum) ;
 const char* sinc_get_description (int src_enum) ;
 
 int gavl_sinc_set_converter (SRC_PRIVATE *psrc, int src_enum, int d) ;
+void gavl_sinc_set_accel_flags (SRC_PRIVATE *psrc, int accel_flags) ;
 
 /* In src_linear.c */
 const char* linear_get_name (int src_enum) ;
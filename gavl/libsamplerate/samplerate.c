@@ -181,6 +181,17 @@ gavl_src_set_ratio (SRC_STATE *state, double new_ratio)
 	return SRC_ERR_NO_ERROR ;
 } /* src_set_ratio */
 
+int
+gavl_src_set_accel_flags (SRC_STATE *state, int accel_flags)
+{	SRC_PRIVATE *psrc ;
+
+	if ((psrc = (SRC_PRIVATE*) state) == NULL)
+		return SRC_ERR_BAD_STATE ;
+
+	gavl_sinc_set_accel_flags (psrc, accel_flags) ;
+	return SRC_ERR_NO_ERROR ;
+} /* src_set_accel_flags */
+
 int
 gavl_src_reset (SRC_STATE *state)
 {	SRC_PRIVATE *psrc ;
@@ -29,6 +29,9 @@
 #include "config.h"
 #include "common.h"
 
+#include <gavl/gavl.h>
+#include <sinc.h>
+
 #define	SINC_MAGIC_MARKER	MAKE_MAGIC (' ', 's', 'i', 'n', 'c', ' ')
 
 /*========================================================================================
@@ -36,7 +39,7 @@
 
 #define MAKE_INCREMENT_T(x) 	((increment_t) (x))
 
-#define	SHIFT_BITS				12
+#define	SHIFT_BITS				GAVL_SINC_SHIFT_BITS
 #define	FP_ONE					((double) (((increment_t) 1) << SHIFT_BITS))
 #define	INV_FP_ONE				(1.0 / FP_ONE)
 
@@ -65,8 +68,15 @@ typedef struct
 
 	int		b_current, b_end, b_real_end, b_len ;
         int d;
-        float	buffer_f [1] ;
-	double	buffer_d [1] ;
+
+	/* Convolution kernels (see include/sinc.h) */
+	gavl_sinc_kernel_f_t	kernel_f ;
+	gavl_sinc_kernel_d_t	kernel_d ;
+	/* Point to the memory after the struct. As fixed size arrays, the
+	** compiler would be allowed to assume that only index 0 is accessed
+	*/
+	float	*buffer_f ;
+	double	*buffer_d ;
 } SINC_FILTER ;
 
 static int sinc_vari_process_d (SRC_PRIVATE *psrc, SRC_DATA *data) ;
@@ -108,6 +118,81 @@ fp_to_double (increment_t x)
 } /* fp_to_double */
 
 
+/*----------------------------------------------------------------------------------------
+**	Portable convolution kernels. They use the same partial sums as the
+**	SIMD versions, so the result doesn't depend on the CPU.
+*/
+
+static double
+sinc_kernel_f_c (const double *coeffs, const float *data, int stride,
+				increment_t filter_index, increment_t increment, int count)
+{	double	sum [GAVL_SINC_LANES] = { 0.0, 0.0, 0.0, 0.0 } ;
+	double	fraction ;
+	int		k, indx ;
+
+	for (k = 0 ; k < count ; k++)
+	{	fraction = fp_to_double (filter_index) ;
+		indx = fp_to_int (filter_index) ;
+
+		sum [k % GAVL_SINC_LANES] += (coeffs [indx] + fraction * (coeffs [indx + 1] - coeffs [indx])) * data [0] ;
+
+		filter_index -= increment ;
+		data += stride ;
+		} ;
+
+	return (sum [0] + sum [2]) + (sum [1] + sum [3]) ;
+} /* sinc_kernel_f_c */
+
+static double
+sinc_kernel_d_c (const double *coeffs, const double *data, int stride,
+				increment_t filter_index, increment_t increment, int count)
+{	double	sum [GAVL_SINC_LANES] = { 0.0, 0.0, 0.0, 0.0 } ;
+	double	fraction ;
+	int		k, indx ;
+
+	for (k = 0 ; k < count ; k++)
+	{	fraction = fp_to_double (filter_index) ;
+		indx = fp_to_int (filter_index) ;
+
+		sum [k % GAVL_SINC_LANES] += (coeffs [indx] + fraction * (coeffs [indx + 1] - coeffs [indx])) * data [0] ;
+
+		filter_index -= increment ;
+		data += stride ;
+		} ;
+
+	return (sum [0] + sum [2]) + (sum [1] + sum [3]) ;
+} /* sinc_kernel_d_c */
+
+static void
+sinc_set_kernels (SINC_FILTER *filter, int accel_flags)
+{	filter->kernel_f = sinc_kernel_f_c ;
+	filter->kernel_d = sinc_kernel_d_c ;
+
+#ifdef HAVE_SSE2
+	if (accel_flags & GAVL_ACCEL_SSE2)
+	{	filter->kernel_f = gavl_sinc_kernel_f_sse2 ;
+		filter->kernel_d = gavl_sinc_kernel_d_sse2 ;
+		} ;
+#endif
+#ifdef HAVE_AVX2
+	if (accel_flags & GAVL_ACCEL_AVX2)
+	{	filter->kernel_f = gavl_sinc_kernel_f_avx2 ;
+		filter->kernel_d = gavl_sinc_kernel_d_avx2 ;
+		} ;
+#endif
+} /* sinc_set_kernels */
+
+void
+gavl_sinc_set_accel_flags (SRC_PRIVATE *psrc, int accel_flags)
+{	SINC_FILTER *filter ;
+
+	filter = (SINC_FILTER*) psrc->private_data ;
+	if (filter == NULL || filter->sinc_magic_marker != SINC_MAGIC_MARKER)
+		return ;
+
+	sinc_set_kernels (filter, accel_flags) ;
+} /* gavl_sinc_set_accel_flags */
+
 /*----------------------------------------------------------------------------------------
 */
 
@@ -231,8 +316,13 @@ gavl_sinc_set_converter (SRC_PRIVATE *psrc, int src_enum, int d)
 	*filter = temp_filter ;
 	memset (&temp_filter, 0xEE, sizeof (temp_filter)) ;
 
+	filter->buffer_f = (float*) (filter + 1) ;
+	filter->buffer_d = (double*) (filter + 1) ;
+
 	psrc->private_data = filter ;
 
+	sinc_set_kernels (filter, gavl_accel_supported ()) ;
+
 	sinc_reset (psrc) ;
 
 	count = filter->coeff_half_len ;
@@ -608,105 +698,64 @@ prepare_data_d (SINC_FILTER *filter, SRC_DATA *data, int half_filter_chan_len)
 
 static double
 calc_output_f (SINC_FILTER *filter, increment_t increment, increment_t start_filter_index, int ch)
-{	double		fraction, left, right, icoeff ;
+{	double		left, right ;
 	increment_t	filter_index, max_filter_index ;
-	int			data_index, coeff_count, indx ;
+	int			data_index, coeff_count ;
 
 	/* Convert input parameters into fixed point. */
 	max_filter_index = int_to_fp (filter->coeff_half_len) ;
 
-	/* First apply the left half of the filter. */
+	/* First apply the left half of the filter (taps down to filter_index 0). */
 	filter_index = start_filter_index ;
 	coeff_count = (max_filter_index - filter_index) / increment ;
 	filter_index = filter_index + coeff_count * increment ;
 	data_index = filter->b_current - filter->channels * coeff_count + ch ;
 
-	left = 0.0 ;
-	do
-	{	fraction = fp_to_double (filter_index) ;
-		indx = fp_to_int (filter_index) ;
-
-		icoeff = filter->coeffs [indx] + fraction * (filter->coeffs [indx + 1] - filter->coeffs [indx]) ;
-
-		left += icoeff * filter->buffer_f [data_index] ;
+	left = filter->kernel_f (filter->coeffs, filter->buffer_f + data_index, filter->channels,
+				filter_index, increment,
+				(filter_index >= 0) ? filter_index / increment + 1 : 1) ;
 
-		filter_index -= increment ;
-		data_index = data_index + filter->channels ;
-		}
-	while (filter_index >= MAKE_INCREMENT_T (0)) ;
-
-	/* Now apply the right half of the filter. */
+	/* Now apply the right half of the filter (taps down to filter_index 1). */
 	filter_index = increment - start_filter_index ;
 	coeff_count = (max_filter_index - filter_index) / increment ;
 	filter_index = filter_index + coeff_count * increment ;
 	data_index = filter->b_current + filter->channels * (1 + coeff_count) + ch ;
 
-	right = 0.0 ;
-	do
-	{	fraction = fp_to_double (filter_index) ;
-		indx = fp_to_int (filter_index) ;
-
-		icoeff = filter->coeffs [indx] + fraction * (filter->coeffs [indx + 1] - filter->coeffs [indx]) ;
-
-		right += icoeff * filter->buffer_f [data_index] ;
-
-		filter_index -= increment ;
-		data_index = data_index - filter->channels ;
-		}
-	while (filter_index > MAKE_INCREMENT_T (0)) ;
+	right = filter->kernel_f (filter->coeffs, filter->buffer_f + data_index, -filter->channels,
+				filter_index, increment,
+				(filter_index > 0) ? (filter_index - 1) / increment + 1 : 1) ;
 
 	return (left + right) ;
 } /* calc_output_f */
 
 static double
 calc_output_d (SINC_FILTER *filter, increment_t increment, increment_t start_filter_index, int ch)
-{	double		fraction, left, right, icoeff ;
+{	double		left, right ;
 	increment_t	filter_index, max_filter_index ;
-	int			data_index, coeff_count, indx ;
+	int			data_index, coeff_count ;
 
 	/* Convert input parameters into fixed point. */
 	max_filter_index = int_to_fp (filter->coeff_half_len) ;
 
-	/* First apply the left half of the filter. */
+	/* First apply the left half of the filter (taps down to filter_index 0). */
 	filter_index = start_filter_index ;
 	coeff_count = (max_filter_index - filter_index) / increment ;
 	filter_index = filter_index + coeff_count * increment ;
 	data_index = filter->b_current - filter->channels * coeff_count + ch ;
 
-	left = 0.0 ;
-	do
-	{	fraction = fp_to_double (filter_index) ;
-		indx = fp_to_int (filter_index) ;
-
-		icoeff = filter->coeffs [indx] + fraction * (filter->coeffs [indx + 1] - filter->coeffs [indx]) ;
-
-		left += icoeff * filter->buffer_d [data_index] ;
-
-		filter_index -= increment ;
-		data_index = data_index + filter->channels ;
-		}
-	while (filter_index >= MAKE_INCREMENT_T (0)) ;
+	left = filter->kernel_d (filter->coeffs, filter->buffer_d + data_index, filter->channels,
+				filter_index, increment,
+				(filter_index >= 0) ? filter_index / increment + 1 : 1) ;
 
-	/* Now apply the right half of the filter. */
+	/* Now apply the right half of the filter (taps down to filter_index 1). */
 	filter_index = increment - start_filter_index ;
 	coeff_count = (max_filter_index - filter_index) / increment ;
 	filter_index = filter_index + coeff_count * increment ;
 	data_index = filter->b_current + filter->channels * (1 + coeff_count) + ch ;
 
-	right = 0.0 ;
-	do
-	{	fraction = fp_to_double (filter_index) ;
-		indx = fp_to_int (filter_index) ;
-
-		icoeff = filter->coeffs [indx] + fraction * (filter->coeffs [indx + 1] - filter->coeffs [indx]) ;
-
-		right += icoeff * filter->buffer_d [data_index] ;
-
-		filter_index -= increment ;
-		data_index = data_index - filter->channels ;
-		}
-	while (filter_index > MAKE_INCREMENT_T (0)) ;
+	right = filter->kernel_d (filter->coeffs, filter->buffer_d + data_index, -filter->channels,
+				filter_index, increment,
+				(filter_index > 0) ? (filter_index - 1) / increment + 1 : 1) ;
 
 	return (left + right) ;
 } /* calc_output_d */
-
@@ -24,8 +24,11 @@
 #include <string.h>
 #include <math.h>
 
+#include <config.h>
+
 #include <audio.h>
 #include <mix.h>
+#include <accel.h>
 
 // #define DUMP_MATRIX
 
@@ -50,6 +53,13 @@
 
 #define CLAMP(x,a,b) if(x<a)x=a;if(x>b)x=b;
 
+/*
+ *  Mix output channels in groups if we have at least this many input
+ *  channels. Each group needs just one pass over the input samples.
+ */
+
+#define GROUP_MIN_INPUTS 7
+
 #ifdef DUMP_MATRIX
 
 static void input_channel_dump(gavl_mix_input_channel_t * c)
@@ -74,9 +84,17 @@ static void output_channel_dump(gavl_mix_output_channel_t * c)
 void gavl_mix_audio(gavl_audio_convert_context_t * ctx)
   {
   int i;
+
+  for(i = 0; i < ctx->mix_matrix->num_groups; i++)
+    ctx->mix_matrix->group_func(&ctx->mix_matrix->groups[i],
+                                ctx->input_frame,
+                                ctx->output_frame);
+  
   for(i = 0; i < ctx->output_format.num_channels; i++)
     {
-    if(ctx->mix_matrix->output_channels[i].func)
+    if(ctx->mix_matrix->output_channels[i].grouped)
+      continue;
+    else if(ctx->mix_matrix->output_channels[i].func)
       ctx->mix_matrix->output_channels[i].func(&ctx->mix_matrix->output_channels[i],
                                                 ctx->input_frame,
                                                 ctx->output_frame);
@@ -761,12 +779,134 @@ static void set_factor(gavl_mix_input_channel_t * ret,
     case GAVL_SAMPLE_DOUBLE:
       ret->factor.f_float = fac;
       break;
+    case GAVL_SAMPLE_S24LE:
+    case GAVL_SAMPLE_S24BE:
     case GAVL_SAMPLE_NONE:
       break;
     }
   }
 
+static gavl_mix_func_t get_mix_func(const gavl_mixer_table_t * tab,
+                                    int num_inputs)
+  {
+  switch(num_inputs)
+    {
+    case 0:
+      return NULL;
+    case 1:
+      return tab->mix_1_to_1;
+    case 2:
+      return tab->mix_2_to_1;
+    case 3:
+      return tab->mix_3_to_1;
+    case 4:
+      return tab->mix_4_to_1;
+    case 5:
+      return tab->mix_5_to_1;
+    case 6:
+      return tab->mix_6_to_1;
+    default:
+      return tab->mix_all_to_1;
+    }
+  }
+
+/*
+ *  The SIMD versions multiply 16 bit samples with 16 bit factors.
+ *  Larger factors (from user defined matrices) are mixed in C.
+ */
+
+static int factors_fit_16(const gavl_mix_output_channel_t * c)
+  {
+  int i;
+  for(i = 0; i < c->num_inputs; i++)
+    {
+    if((c->inputs[i].factor.f_int > INT16_MAX) ||
+       (c->inputs[i].factor.f_int < INT16_MIN))
+      return 0;
+    }
+  return 1;
+  }
+
+static void add_group_channel(gavl_mix_group_t * g,
+                              gavl_mix_output_channel_t * c,
+                              gavl_sample_format_t format)
+  {
+  int i, j;
+  
+  for(i = 0; i < c->num_inputs; i++)
+    {
+    for(j = 0; j < g->num_inputs; j++)
+      {
+      if(g->inputs[j] == c->inputs[i].index)
+        break;
+      }
+    if(j == g->num_inputs)
+      g->inputs[g->num_inputs++] = c->inputs[i].index;
+
+    if(format == GAVL_SAMPLE_FLOAT)
+      g->factors.f_float[j][g->num_outputs] = c->inputs[i].factor.f_float;
+    else
+      g->factors.f_int[j][g->num_outputs] = c->inputs[i].factor.f_int;
+    }
+  g->outputs[g->num_outputs++] = c->index;
+  c->grouped = 1;
+  }
+
+static void init_groups(gavl_mix_matrix_t * ctx,
+                        const gavl_mixer_table_t * tab,
+                        gavl_audio_format_t * in_format,
+                        gavl_audio_format_t * out_format)
+  {
+  int i, num;
+  gavl_mix_output_channel_t * c;
+  gavl_mix_group_t * g = NULL;
+  
+  if(!tab->mix_group || (in_format->num_channels < GROUP_MIN_INPUTS))
+    return;
+
+  /* Channels, which are mixed by the table functions */
+  num = 0;
+  for(i = 0; i < out_format->num_channels; i++)
+    {
+    c = &ctx->output_channels[i];
+    if(c->func && (c->func != tab->copy_func) &&
+       (c->func == get_mix_func(tab, c->num_inputs)))
+      num++;
+    }
+  if(num < 2)
+    return;
+
+  ctx->groups = calloc((num + GAVL_MIX_GROUP_SIZE - 1) / GAVL_MIX_GROUP_SIZE,
+                       sizeof(*ctx->groups));
+  ctx->group_func = tab->mix_group;
+
+  for(i = 0; i < out_format->num_channels; i++)
+    {
+    c = &ctx->output_channels[i];
+    if(!c->func || (c->func == tab->copy_func) ||
+       (c->func != get_mix_func(tab, c->num_inputs)))
+      continue;
+
+    if(!g || (g->num_outputs == GAVL_MIX_GROUP_SIZE))
+      g = &ctx->groups[ctx->num_groups++];
+    
+    add_group_channel(g, c, in_format->sample_format);
+    }
+
+  /* Pad to an even number of inputs with zero factors */
+  for(i = 0; i < ctx->num_groups; i++)
+    {
+    g = &ctx->groups[i];
+    if(g->num_inputs & 1)
+      {
+      g->inputs[g->num_inputs] = g->inputs[0];
+      g->num_inputs++;
+      }
+    }
+  }
+
 static void init_context(gavl_mix_matrix_t * ctx,
+                         gavl_audio_options_t * opt,
                          double matrix[GAVL_MAX_CHANNELS][GAVL_MAX_CHANNELS],
                          gavl_audio_format_t * in_format,
                          gavl_audio_format_t * out_format)
@@ -774,10 +914,21 @@ static void init_context(gavl_mix_matrix_t * ctx,
   int i, j;
   int num_inputs;
   gavl_mixer_table_t tab;
+  gavl_mixer_table_t tab_c;
   //  fprintf(stderr, "init_context...");
-  memset(&tab, 0, sizeof(tab));
+  memset(&tab_c, 0, sizeof(tab_c));
 
-  gavl_setup_mix_funcs_c(&tab, in_format);
+  gavl_setup_mix_funcs_c(&tab_c, in_format);
+  tab = tab_c;
+
+#ifdef HAVE_SSE2
+  if(opt->accel_flags & GAVL_ACCEL_SSE2)
+    gavl_setup_mix_funcs_sse2(&tab, in_format);
+#endif
+#ifdef HAVE_AVX2
+  if(opt->accel_flags & GAVL_ACCEL_AVX2)
+    gavl_setup_mix_funcs_avx2(&tab, in_format);
+#endif
   
   for(i = 0; i < out_format->num_channels; i++)
     {
@@ -814,39 +965,18 @@ static void init_context(gavl_mix_matrix_t * ctx,
               gavl_channel_id_to_string(out_format->channel_locations[i]));
 #endif
       }
+    else if(tab.factors_16 && !factors_fit_16(&ctx->output_channels[i]))
+      ctx->output_channels[i].func =
+        get_mix_func(&tab_c, ctx->output_channels[i].num_inputs);
     else
-      {
-      switch(ctx->output_channels[i].num_inputs)
-        {
-        case 0:
-          break;
-        case 1:
-          ctx->output_channels[i].func = tab.mix_1_to_1;
-          break;
-        case 2:
-          ctx->output_channels[i].func = tab.mix_2_to_1;
-          break;
-        case 3:
-          ctx->output_channels[i].func = tab.mix_3_to_1;
-          break;
-        case 4:
-          ctx->output_channels[i].func = tab.mix_4_to_1;
-          break;
-        case 5:
-          ctx->output_channels[i].func = tab.mix_5_to_1;
-          break;
-        case 6:
-          ctx->output_channels[i].func = tab.mix_6_to_1;
-          break;
-        default:
-          ctx->output_channels[i].func = tab.mix_all_to_1;
-          break;
-        }
-      }
+      ctx->output_channels[i].func =
+        get_mix_func(&tab, ctx->output_channels[i].num_inputs);
 #ifdef DUMP_MATRIX
     output_channel_dump(&ctx->output_channels[i]);
 #endif
     }
+
+  init_groups(ctx, &tab, in_format, out_format);
   
   //  fprintf(stderr, "done\n");
   }
@@ -870,7 +1000,7 @@ gavl_create_mix_matrix(gavl_audio_options_t * opt,
   //  fprintf(stderr, "done\n");
   
   //  fprintf(stderr, "Init mix context\n");
-  init_context(ret, mix_matrix, in, out);
+  init_context(ret, opt, mix_matrix, in, out);
   //  fprintf(stderr, "done\n");
                  
   return ret;
@@ -878,6 +1008,8 @@ gavl_create_mix_matrix(gavl_audio_options_t * opt,
 
 void gavl_destroy_mix_matrix(gavl_mix_matrix_t * ctx)
   {
+  if(ctx->groups)
+    free(ctx->groups);
   free(ctx);
   }
 
@@ -0,0 +1,362 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/* Scale one source frame to several outputs */
+
+#include <stdlib.h>
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <video.h>
+#include <scale.h>
+
+/* Approximate number of rows of the largest output processed at once */
+#define BAND_ROWS 16
+
+typedef struct
+  {
+  gavl_video_scaler_t * scaler;
+  int parent; /* -1: Source frame */
+  int wave;   /* Outputs of wave n are scaled from outputs of wave n-1 */
+  } output_t;
+
+/* Rows of one plane of one output */
+
+typedef struct
+  {
+  gavl_video_scale_context_t * ctx;
+  int num;
+  } segment_t;
+
+struct gavl_video_multiscaler_s
+  {
+  gavl_video_options_t opt;
+  float cascade_ratio;
+
+  output_t * outputs;
+  int num_outputs;
+  int outputs_alloc;
+
+  int num_waves;
+
+  /* All outputs can be scaled row wise */
+  int scale_rows;
+
+  /* Current step */
+  segment_t * segments;
+  int num_segments;
+  int segments_alloc;
+  int num_bands;
+  };
+
+gavl_video_multiscaler_t * gavl_video_multiscaler_create()
+  {
+  gavl_video_multiscaler_t * ret;
+  ret = calloc(1, sizeof(*ret));
+  gavl_video_options_set_defaults(&ret->opt);
+  return ret;
+  }
+
+void gavl_video_multiscaler_destroy(gavl_video_multiscaler_t * s)
+  {
+  int i;
+  for(i = 0; i < s->outputs_alloc; i++)
+    gavl_video_scaler_destroy(s->outputs[i].scaler);
+  if(s->outputs)
+    free(s->outputs);
+  if(s->segments)
+    free(s->segments);
+  free(s);
+  }
+
+gavl_video_options_t *
+gavl_video_multiscaler_get_options(gavl_video_multiscaler_t * s)
+  {
+  return &s->opt;
+  }
+
+void gavl_video_multiscaler_set_cascade_ratio(gavl_video_multiscaler_t * s,
+                                              float ratio)
+  {
+  s->cascade_ratio = ratio;
+  }
+
+int gavl_video_multiscaler_get_parent(gavl_video_multiscaler_t * s,
+                                      int output)
+  {
+  return s->outputs[output].parent;
+  }
+
+/* Find the smallest output, which is at least ratio times larger than
+   output i */
+
+static int find_parent(const gavl_video_format_t * dst_formats,
+                       int num_outputs, int i, float ratio)
+  {
+  int j, ret = -1;
+  const gavl_video_format_t * f = &dst_formats[i];
+  const gavl_video_format_t * p;
+
+  for(j = 0; j < num_outputs; j++)
+    {
+    p = &dst_formats[j];
+
+    if((j == i) ||
+       (p->image_width < ratio * f->image_width) ||
+       (p->image_height < ratio * f->image_height) ||
+       ((p->image_width == f->image_width) &&
+        (p->image_height == f->image_height)))
+      continue;
+
+    if((ret < 0) ||
+       (p->image_width * p->image_height <
+        dst_formats[ret].image_width * dst_formats[ret].image_height))
+      ret = j;
+    }
+  return ret;
+  }
+
+int gavl_video_multiscaler_init(gavl_video_multiscaler_t * s,
+                                const gavl_video_format_t * src_format,
+                                const gavl_video_format_t * dst_formats,
+                                int num_outputs)
+  {
+  int i, j;
+  int cascade;
+  gavl_video_options_t * opt;
+  gavl_rectangle_i_t dst_rect;
+  output_t * o;
+
+  if(num_outputs > s->outputs_alloc)
+    {
+    s->outputs = realloc(s->outputs, num_outputs * sizeof(*s->outputs));
+    for(i = s->outputs_alloc; i < num_outputs; i++)
+      s->outputs[i].scaler = gavl_video_scaler_create();
+    s->outputs_alloc = num_outputs;
+    }
+  s->num_outputs = num_outputs;
+
+  /* Cascading is only done for progressive frames */
+
+  cascade = (s->cascade_ratio >= 1.0) &&
+    (src_format->interlace_mode == GAVL_INTERLACE_NONE);
+
+  for(i = 0; i < num_outputs; i++)
+    {
+    if(dst_formats[i].pixelformat != src_format->pixelformat)
+      return 0;
+    if(dst_formats[i].interlace_mode != GAVL_INTERLACE_NONE)
+      cascade = 0;
+    }
+
+  /* Set up the graph */
+
+  for(i = 0; i < num_outputs; i++)
+    {
+    if(cascade)
+      s->outputs[i].parent = find_parent(dst_formats, num_outputs, i,
+                                         s->cascade_ratio);
+    else
+      s->outputs[i].parent = -1;
+    }
+
+  /* Parents are always larger, so there are no loops */
+
+  s->num_waves = 0;
+  for(i = 0; i < num_outputs; i++)
+    {
+    s->outputs[i].wave = 0;
+    j = s->outputs[i].parent;
+    while(j >= 0)
+      {
+      s->outputs[i].wave++;
+      j = s->outputs[j].parent;
+      }
+    if(s->num_waves < s->outputs[i].wave + 1)
+      s->num_waves = s->outputs[i].wave + 1;
+    }
+
+  /* Initialize scalers */
+
+  s->scale_rows = 1;
+
+  for(i = 0; i < num_outputs; i++)
+    {
+    o = &s->outputs[i];
+    opt = gavl_video_scaler_get_options(o->scaler);
+    gavl_video_options_copy(opt, &s->opt);
+
+    if((o->parent < 0) && s->opt.have_rectangles)
+      {
+      gavl_rectangle_i_set_all(&dst_rect, &dst_formats[i]);
+      gavl_video_options_set_rectangles(opt, &s->opt.src_rect, &dst_rect);
+      }
+    else
+      gavl_video_options_set_rectangles(opt, NULL, NULL);
+
+    if(!gavl_video_scaler_init(o->scaler,
+                               (o->parent < 0) ? src_format : &dst_formats[o->parent],
+                               &dst_formats[i]))
+      return 0;
+
+    if(!gavl_video_scaler_can_scale_rows(o->scaler))
+      s->scale_rows = 0;
+    }
+  return 1;
+  }
+
+/* Sweep through all segments band by band */
+
+static void add_segment(gavl_video_multiscaler_t * s,
+                        gavl_video_scale_context_t * ctx, int num)
+  {
+  if(!num)
+    return;
+
+  if(s->num_segments == s->segments_alloc)
+    {
+    s->segments_alloc += 16;
+    s->segments = realloc(s->segments,
+                          s->segments_alloc * sizeof(*s->segments));
+    }
+  s->segments[s->num_segments].ctx = ctx;
+  s->segments[s->num_segments].num = num;
+  s->num_segments++;
+  }
+
+/*
+ *  Work unit i is band (i / num_segments) of segment (i % num_segments).
+ *  Consecutive units process the same part of the picture for all
+ *  outputs, so they read the same source rows.
+ */
+
+#define GET_ROWS                                                \
+  seg = &s->segments[i % s->num_segments];                      \
+  band = i / s->num_segments;                                   \
+  row_start = (seg->num * band) / s->num_bands;                 \
+  row_end = (seg->num * (band + 1)) / s->num_bands;
+
+static void first_func(void * p, int start, int end)
+  {
+  int i, band, row_start, row_end;
+  segment_t * seg;
+  gavl_video_multiscaler_t * s = p;
+
+  for(i = start; i < end; i++)
+    {
+    GET_ROWS
+    if(row_end > row_start)
+      gavl_video_scale_context_first_rows(seg->ctx, row_start, row_end);
+    }
+  }
+
+static void final_func(void * p, int start, int end)
+  {
+  int i, band, row_start, row_end;
+  segment_t * seg;
+  gavl_video_multiscaler_t * s = p;
+
+  for(i = start; i < end; i++)
+    {
+    GET_ROWS
+    if(row_end > row_start)
+      gavl_video_scale_context_final_rows(seg->ctx, row_start, row_end);
+    }
+  }
+
+static void run_segments(gavl_video_multiscaler_t * s,
+                         gavl_video_process_func func)
+  {
+  int i, max_rows = 0;
+
+  if(!s->num_segments)
+    return;
+
+  for(i = 0; i < s->num_segments; i++)
+    {
+    if(max_rows < s->segments[i].num)
+      max_rows = s->segments[i].num;
+    }
+  s->num_bands = (max_rows + BAND_ROWS - 1) / BAND_ROWS;
+  gavl_video_options_run(&s->opt, func, s,
+                         s->num_bands * s->num_segments, 1);
+  }
+
+void gavl_video_multiscaler_scale(gavl_video_multiscaler_t * s,
+                                  const gavl_video_frame_t * src,
+                                  gavl_video_frame_t ** dst)
+  {
+  int i, plane, wave;
+  output_t * o;
+  gavl_video_scale_context_t * ctx;
+
+  for(wave = 0; wave < s->num_waves; wave++)
+    {
+    if(!s->scale_rows)
+      {
+      for(i = 0; i < s->num_outputs; i++)
+        {
+        o = &s->outputs[i];
+        if(o->wave == wave)
+          gavl_video_scaler_scale(o->scaler,
+                                  (o->parent < 0) ? src : dst[o->parent],
+                                  dst[i]);
+        }
+      continue;
+      }
+
+    /* First step of all outputs */
+
+    s->num_segments = 0;
+    for(i = 0; i < s->num_outputs; i++)
+      {
+      o = &s->outputs[i];
+      if(o->wave != wave)
+        continue;
+      for(plane = 0; plane < o->scaler->num_planes; plane++)
+        {
+        ctx = &o->scaler->contexts[0][plane];
+        add_segment(s, ctx,
+                    gavl_video_scale_context_first_begin(ctx,
+                                                         (o->parent < 0) ? src : dst[o->parent]));
+        }
+      }
+    run_segments(s, first_func);
+
+    /* Final step of all outputs */
+
+    s->num_segments = 0;
+    for(i = 0; i < s->num_outputs; i++)
+      {
+      o = &s->outputs[i];
+      if(o->wave != wave)
+        continue;
+      for(plane = 0; plane < o->scaler->num_planes; plane++)
+        {
+        ctx = &o->scaler->contexts[0][plane];
+        gavl_video_scale_context_final_begin(ctx, dst[i]);
+        add_segment(s, ctx, ctx->dst_rect.h);
+        }
+      }
+    run_segments(s, final_func);
+    }
+  }
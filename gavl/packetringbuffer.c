@@ -0,0 +1,218 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <stdlib.h>
+
+#include <gavl/connectors.h>
+
+/*
+ *  Same scheme as the audio ringbuffer, but the positions count packets.
+ *  The packets in the slots keep their memory, so after the first round
+ *  no allocations are done anymore.
+ */
+
+#define CACHE_LINE 64
+
+struct gavl_packet_ringbuffer_s
+  {
+  int capacity;
+  gavl_packet_t * slots;
+
+  gavl_packet_sink_t * sink;
+  gavl_packet_source_t * source;
+
+  /* Producer side */
+  uint8_t pad_1[CACHE_LINE];
+  int64_t write_pos;
+  int64_t overruns;
+  int eof;
+
+  /* Consumer side */
+  uint8_t pad_2[CACHE_LINE];
+  int64_t read_pos;
+  int read_pending;
+  int64_t underruns;
+  uint8_t pad_3[CACHE_LINE];
+  };
+
+gavl_packet_t *
+gavl_packet_ringbuffer_write_begin(gavl_packet_ringbuffer_t * rb)
+  {
+  gavl_packet_t * ret;
+  int64_t read_pos = __atomic_load_n(&rb->read_pos, __ATOMIC_ACQUIRE);
+
+  if(rb->write_pos - read_pos >= rb->capacity)
+    return NULL;
+
+  ret = &rb->slots[rb->write_pos % rb->capacity];
+  gavl_packet_reset(ret);
+  return ret;
+  }
+
+void gavl_packet_ringbuffer_write_end(gavl_packet_ringbuffer_t * rb)
+  {
+  __atomic_store_n(&rb->write_pos, rb->write_pos + 1, __ATOMIC_RELEASE);
+  }
+
+gavl_packet_t *
+gavl_packet_ringbuffer_read_begin(gavl_packet_ringbuffer_t * rb)
+  {
+  int64_t write_pos = __atomic_load_n(&rb->write_pos, __ATOMIC_ACQUIRE);
+
+  if(write_pos == rb->read_pos)
+    {
+    if(!gavl_packet_ringbuffer_get_eof(rb))
+      __atomic_add_fetch(&rb->underruns, 1, __ATOMIC_RELAXED);
+    return NULL;
+    }
+  return &rb->slots[rb->read_pos % rb->capacity];
+  }
+
+void gavl_packet_ringbuffer_read_end(gavl_packet_ringbuffer_t * rb)
+  {
+  __atomic_store_n(&rb->read_pos, rb->read_pos + 1, __ATOMIC_RELEASE);
+  }
+
+/* Sink */
+
+static gavl_packet_t * get_packet_func(void * priv)
+  {
+  return gavl_packet_ringbuffer_write_begin(priv);
+  }
+
+static gavl_sink_status_t put_packet_func(void * priv, gavl_packet_t * p)
+  {
+  gavl_packet_t * dst;
+  gavl_packet_ringbuffer_t * rb = priv;
+
+  if(p != &rb->slots[rb->write_pos % rb->capacity])
+    {
+    if(!(dst = gavl_packet_ringbuffer_write_begin(rb)))
+      {
+      __atomic_add_fetch(&rb->overruns, 1, __ATOMIC_RELAXED);
+      return GAVL_SINK_OK;
+      }
+    gavl_packet_copy(dst, p);
+    }
+  gavl_packet_ringbuffer_write_end(rb);
+  return GAVL_SINK_OK;
+  }
+
+/* Source */
+
+gavl_source_status_t
+gavl_packet_ringbuffer_read_packet(void * priv, gavl_packet_t ** p)
+  {
+  gavl_packet_t * src;
+  gavl_packet_ringbuffer_t * rb = priv;
+
+  /* The previous packet is released not before the next read call */
+  if(rb->read_pending)
+    {
+    gavl_packet_ringbuffer_read_end(rb);
+    rb->read_pending = 0;
+    }
+
+  if(!(src = gavl_packet_ringbuffer_read_begin(rb)))
+    return gavl_packet_ringbuffer_get_eof(rb) ? GAVL_SOURCE_EOF : GAVL_SOURCE_AGAIN;
+
+  if(*p)
+    {
+    gavl_packet_copy(*p, src);
+    gavl_packet_ringbuffer_read_end(rb);
+    }
+  else
+    {
+    *p = src;
+    rb->read_pending = 1;
+    }
+  return GAVL_SOURCE_OK;
+  }
+
+gavl_packet_ringbuffer_t * gavl_packet_ringbuffer_create(int capacity)
+  {
+  int i;
+  gavl_packet_ringbuffer_t * ret = calloc(1, sizeof(*ret));
+
+  ret->capacity = capacity;
+  ret->slots = calloc(capacity, sizeof(*ret->slots));
+  for(i = 0; i < capacity; i++)
+    gavl_packet_init(&ret->slots[i]);
+
+  ret->sink = gavl_packet_sink_create(get_packet_func, put_packet_func, ret);
+  ret->source = gavl_packet_source_create(gavl_packet_ringbuffer_read_packet,
+                                          ret, GAVL_SOURCE_SRC_ALLOC);
+  return ret;
+  }
+
+void gavl_packet_ringbuffer_destroy(gavl_packet_ringbuffer_t * rb)
+  {
+  int i;
+
+  gavl_packet_sink_destroy(rb->sink);
+  gavl_packet_source_destroy(rb->source);
+
+  for(i = 0; i < rb->capacity; i++)
+    gavl_packet_free(&rb->slots[i]);
+  free(rb->slots);
+  free(rb);
+  }
+
+gavl_packet_sink_t *
+gavl_packet_ringbuffer_get_sink(gavl_packet_ringbuffer_t * rb)
+  {
+  return rb->sink;
+  }
+
+gavl_packet_source_t *
+gavl_packet_ringbuffer_get_source(gavl_packet_ringbuffer_t * rb)
+  {
+  return rb->source;
+  }
+
+void gavl_packet_ringbuffer_set_eof(gavl_packet_ringbuffer_t * rb)
+  {
+  __atomic_store_n(&rb->eof, 1, __ATOMIC_RELEASE);
+  }
+
+int gavl_packet_ringbuffer_get_eof(gavl_packet_ringbuffer_t * rb)
+  {
+  if(!__atomic_load_n(&rb->eof, __ATOMIC_ACQUIRE))
+    return 0;
+  return (__atomic_load_n(&rb->write_pos, __ATOMIC_ACQUIRE) ==
+          __atomic_load_n(&rb->read_pos, __ATOMIC_ACQUIRE));
+  }
+
+int gavl_packet_ringbuffer_get_fill(gavl_packet_ringbuffer_t * rb)
+  {
+  int64_t read_pos = __atomic_load_n(&rb->read_pos, __ATOMIC_ACQUIRE);
+  return (int)(__atomic_load_n(&rb->write_pos, __ATOMIC_ACQUIRE) - read_pos);
+  }
+
+void gavl_packet_ringbuffer_get_stats(gavl_packet_ringbuffer_t * rb,
+                                      int64_t * overruns,
+                                      int64_t * underruns)
+  {
+  if(overruns)
+    *overruns = __atomic_load_n(&rb->overruns, __ATOMIC_RELAXED);
+  if(underruns)
+    *underruns = __atomic_load_n(&rb->underruns, __ATOMIC_RELAXED);
+  }
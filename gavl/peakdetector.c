@@ -169,6 +169,51 @@ static void update_channel_s32(gavl_peak_detector_t * pd, void * _samples,
   pd->max_d[channel] = (double)((int)pd->max_i[channel]) / 2147483647.0;
   }
 
+/* Packed 24 bit samples, sign extended to int32 */
+
+#define GET_S24LE(p) \
+  ((int32_t)(((uint32_t)(p)[0] << 8) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 24)) >> 8)
+#define GET_S24BE(p) \
+  ((int32_t)(((uint32_t)(p)[2] << 8) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[0] << 24)) >> 8)
+
+static void update_channel_s24le(gavl_peak_detector_t * pd, void * _samples,
+                                 int num, int offset,
+                                 int advance, int channel)
+  {
+  int i;
+  int32_t sample;
+  uint8_t * samples = (uint8_t *)_samples;
+  samples += 3 * offset;
+  for(i = 0; i < num; i++)
+    {
+    sample = GET_S24LE(samples);
+    if(sample > pd->max_i[channel]) pd->max_i[channel] = sample;
+    if(sample < pd->min_i[channel]) pd->min_i[channel] = sample;
+    samples += 3 * advance;
+    }
+  pd->min_d[channel] = (double)((int)pd->min_i[channel]) / 8388608.0;
+  pd->max_d[channel] = (double)((int)pd->max_i[channel]) / 8388607.0;
+  }
+
+static void update_channel_s24be(gavl_peak_detector_t * pd, void * _samples,
+                                 int num, int offset,
+                                 int advance, int channel)
+  {
+  int i;
+  int32_t sample;
+  uint8_t * samples = (uint8_t *)_samples;
+  samples += 3 * offset;
+  for(i = 0; i < num; i++)
+    {
+    sample = GET_S24BE(samples);
+    if(sample > pd->max_i[channel]) pd->max_i[channel] = sample;
+    if(sample < pd->min_i[channel]) pd->min_i[channel] = sample;
+    samples += 3 * advance;
+    }
+  pd->min_d[channel] = (double)((int)pd->min_i[channel]) / 8388608.0;
+  pd->max_d[channel] = (double)((int)pd->max_i[channel]) / 8388607.0;
+  }
+
 static void update_channel_float(gavl_peak_detector_t * pd, void * _samples,
                                  int num, int offset,
                                  int advance, int channel)
@@ -219,6 +264,10 @@ static gavl_sink_status_t put_frame_func(void * priv,
   {
   int i;
   gavl_peak_detector_t *pd = priv;
+
+  if(!pd->update_channel)
+    return GAVL_SINK_OK;
+  
   pd->update(pd, frame);
 
   for(i = 0; i < pd->format.num_channels; i++)
@@ -286,7 +335,14 @@ void gavl_peak_detector_set_format(gavl_peak_detector_t *pd,
     case GAVL_SAMPLE_DOUBLE:
       pd->update_channel = update_channel_double;
       break;
+    case GAVL_SAMPLE_S24LE:
+      pd->update_channel = update_channel_s24le;
+      break;
+    case GAVL_SAMPLE_S24BE:
+      pd->update_channel = update_channel_s24be;
+      break;
     case GAVL_SAMPLE_NONE:
+      pd->update_channel = NULL;
       break;
     }
   gavl_peak_detector_reset(pd);
@@ -365,6 +421,8 @@ void gavl_peak_detector_reset(gavl_peak_detector_t * pd)
     case GAVL_SAMPLE_S8:
     case GAVL_SAMPLE_S16:
     case GAVL_SAMPLE_S32:
+    case GAVL_SAMPLE_S24LE:
+    case GAVL_SAMPLE_S24BE:
       for(i = 0; i < pd->format.num_channels; i++)
         {
         pd->min_i[i] = 0x0;
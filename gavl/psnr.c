@@ -564,6 +564,37 @@ void gavl_video_frame_psnr(double * psnr,
                           src2->planes[2], src2->strides[2],
                           format->image_width/sub_h, format->image_height/sub_v, 1);
       break;
+    case GAVL_NV12:
+    case GAVL_NV21:
+      psnr[0] = psnr_y_8(src1->planes[0], src1->strides[0],
+                        src2->planes[0], src2->strides[0],
+                        format->image_width, format->image_height, 1);
+      psnr[1] = psnr_uv_8(src1->planes[1], src1->strides[1],
+                         src2->planes[1], src2->strides[1],
+                         format->image_width/2, format->image_height/2, 2);
+      psnr[2] = psnr_uv_8(src1->planes[1]+1, src1->strides[1],
+                         src2->planes[1]+1, src2->strides[1],
+                         format->image_width/2, format->image_height/2, 2);
+      if(format->pixelformat == GAVL_NV21)
+        {
+        double swp = psnr[1];
+        psnr[1] = psnr[2];
+        psnr[2] = swp;
+        }
+      break;
+    case GAVL_P010:
+    case GAVL_P016:
+      psnr[0] = psnr_y_16(src1->planes[0], src1->strides[0],
+                         src2->planes[0], src2->strides[0],
+                         format->image_width, format->image_height, 1);
+      psnr[1] = psnr_uv_16(src1->planes[1], src1->strides[1],
+                          src2->planes[1], src2->strides[1],
+                          format->image_width/2, format->image_height/2, 2);
+      psnr[2] = psnr_uv_16(src1->planes[1]+2, src1->strides[1],
+                          src2->planes[1]+2, src2->strides[1],
+                          format->image_width/2, format->image_height/2, 2);
+      break;
+    case GAVL_YUV_420_P_10: /* Not supported */
     case GAVL_PIXELFORMAT_NONE:
       break;
     }
@@ -57,6 +57,8 @@ void gavl_packet_pts_cache_push(gavl_packet_pts_cache_t *c, const gavl_packet_t
   c->packets[c->num_packets].data = NULL;
   c->packets[c->num_packets].data_len   = 0;
   c->packets[c->num_packets].data_alloc = 0;
+  c->packets[c->num_packets].data_unref = NULL;
+  c->packets[c->num_packets].data_priv  = NULL;
   
   c->num_packets++;
   
@@ -22,6 +22,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include <config.h>
+
 #include <audio.h>
 #include <sampleformat.h>
 #include <libgdither/gdither.h>
@@ -198,6 +200,14 @@ gavl_sampleformat_table_t * gavl_create_sampleformat_table(gavl_audio_options_t
 
   if(opt->quality || (opt->accel_flags & GAVL_ACCEL_C))
     gavl_init_sampleformat_funcs_c(ret, interleave_mode);
+#ifdef HAVE_SSE2
+  if(opt->accel_flags & GAVL_ACCEL_SSE2)
+    gavl_init_sampleformat_funcs_sse2(ret, interleave_mode);
+#endif
+#ifdef HAVE_AVX2
+  if(opt->accel_flags & GAVL_ACCEL_AVX2)
+    gavl_init_sampleformat_funcs_avx2(ret, interleave_mode);
+#endif
   return ret;
   }
 
@@ -239,6 +249,114 @@ static GDitherType get_dither_type(gavl_audio_options_t * opt)
   return GDitherNone;
   }
 
+/* Packed formats */
+
+static int get_packed_index(gavl_sample_format_t format)
+  {
+  switch(format)
+    {
+    case GAVL_SAMPLE_S24LE:
+      return GAVL_PACKED_S24LE;
+    case GAVL_SAMPLE_S24BE:
+      return GAVL_PACKED_S24BE;
+    default:
+      break;
+    }
+  return -1;
+  }
+
+static int get_unpacked_index(gavl_sample_format_t format)
+  {
+  switch(format)
+    {
+    case GAVL_SAMPLE_S16:
+      return GAVL_UNPACKED_S16;
+    case GAVL_SAMPLE_S32:
+      return GAVL_UNPACKED_S32;
+    case GAVL_SAMPLE_FLOAT:
+      return GAVL_UNPACKED_FLOAT;
+    case GAVL_SAMPLE_DOUBLE:
+      return GAVL_UNPACKED_DOUBLE;
+    default:
+      break;
+    }
+  return -1;
+  }
+
+int gavl_sample_format_is_packed(gavl_sample_format_t format)
+  {
+  return (get_packed_index(format) >= 0);
+  }
+
+int gavl_sample_format_can_pack(gavl_sample_format_t format)
+  {
+  return (get_unpacked_index(format) >= 0);
+  }
+
+/* The packed functions work on arrays, so we call them for each
+   channel, each channel pair or once for all samples */
+
+static void convert_packed(gavl_audio_convert_context_t * ctx)
+  {
+  int i, step = 1;
+  int num_channels = ctx->input_format.num_channels;
+  int num = ctx->input_frame->valid_samples;
+
+  switch(ctx->input_format.interleave_mode)
+    {
+    case GAVL_INTERLEAVE_ALL:
+      ctx->packed_func(ctx->input_frame->samples.u_8,
+                       ctx->output_frame->samples.u_8,
+                       num_channels * num);
+      return;
+    case GAVL_INTERLEAVE_2:
+      step = 2;
+      break;
+    case GAVL_INTERLEAVE_NONE:
+      break;
+    }
+
+  for(i = 0; i < num_channels; i += step)
+    {
+    ctx->packed_func(ctx->input_frame->channels.u_8[i],
+                     ctx->output_frame->channels.u_8[i],
+                     (i + step <= num_channels) ? step * num : num);
+    }
+  }
+
+static gavl_audio_convert_context_t *
+packed_context_create(gavl_audio_options_t * opt,
+                      gavl_audio_format_t * in_format,
+                      gavl_audio_format_t * out_format)
+  {
+  int in_index, out_index;
+  gavl_audio_convert_context_t * ret;
+  gavl_sampleformat_table_t * table;
+  
+  ret = gavl_audio_convert_context_create(in_format, out_format);
+  ret->output_format.sample_format = out_format->sample_format;
+
+  /* The packed functions are the same for all interleave modes */
+  table = gavl_create_sampleformat_table(opt, GAVL_INTERLEAVE_NONE);
+
+  if((in_index = get_packed_index(in_format->sample_format)) >= 0)
+    {
+    if((out_index = get_unpacked_index(out_format->sample_format)) >= 0)
+      ret->packed_func = table->unpack[in_index][out_index];
+    }
+  else if((out_index = get_packed_index(out_format->sample_format)) >= 0)
+    {
+    if((in_index = get_unpacked_index(in_format->sample_format)) >= 0)
+      ret->packed_func = table->pack[out_index][in_index];
+    }
+  
+  gavl_destroy_sampleformat_table(table);
+
+  if(ret->packed_func)
+    ret->func = convert_packed;
+  return ret;
+  }
+
 /* Create sampleformat converter. Samples are interleaved or non interleaved */
 
 gavl_audio_convert_context_t *
@@ -260,6 +378,11 @@ gavl_sampleformat_context_create(gavl_audio_options_t * opt,
           gavl_sample_format_to_string(in_format->sample_format),
           gavl_sample_format_to_string(out_format->sample_format));
 #endif  
+
+  if(gavl_sample_format_is_packed(in_format->sample_format) ||
+     gavl_sample_format_is_packed(out_format->sample_format))
+    return packed_context_create(opt, in_format, out_format);
+  
   ret = gavl_audio_convert_context_create(in_format, out_format);
   ret->output_format.sample_format = out_format->sample_format;
 
@@ -387,6 +510,62 @@ gavl_sampleformat_context_create(gavl_audio_options_t * opt,
   }
 
 
+/* Sampleformat conversion and interleaving in one pass. Returns NULL
+   if there is no converter for the formats */
+
+gavl_audio_convert_context_t *
+gavl_sampleformat_interleave_context_create(gavl_audio_options_t * opt,
+                                            gavl_audio_format_t * in_format,
+                                            gavl_audio_format_t * out_format)
+  {
+  gavl_audio_convert_context_t * ret;
+  gavl_sampleformat_table_t * table;
+  gavl_audio_func_t func = NULL;
+  
+  /* Dithering is done by libgdither */
+  if((get_dither_type(opt) != GDitherNone) &&
+     (gavl_bytes_per_sample(out_format->sample_format) <= 2) &&
+     (in_format->sample_format >= GAVL_SAMPLE_FLOAT))
+    return NULL;
+
+  if(in_format->interleave_mode == GAVL_INTERLEAVE_2)
+    return NULL;
+
+  table = gavl_create_sampleformat_table(opt, in_format->interleave_mode);
+
+  if((in_format->sample_format == GAVL_SAMPLE_S16) &&
+     (in_format->interleave_mode == GAVL_INTERLEAVE_ALL) &&
+     (out_format->sample_format == GAVL_SAMPLE_FLOAT) &&
+     (out_format->interleave_mode == GAVL_INTERLEAVE_NONE))
+    {
+    if(in_format->num_channels == 2)
+      func = table->convert_s16_i_to_float_ni_stereo;
+    else
+      func = table->convert_s16_i_to_float_ni;
+    }
+  else if((in_format->sample_format == GAVL_SAMPLE_FLOAT) &&
+          (in_format->interleave_mode == GAVL_INTERLEAVE_NONE) &&
+          (out_format->sample_format == GAVL_SAMPLE_S16) &&
+          (out_format->interleave_mode == GAVL_INTERLEAVE_ALL))
+    {
+    if(in_format->num_channels == 2)
+      func = table->convert_float_ni_to_s16_i_stereo;
+    else
+      func = table->convert_float_ni_to_s16_i;
+    }
+  
+  gavl_destroy_sampleformat_table(table);
+
+  if(!func)
+    return NULL;
+  
+  ret = gavl_audio_convert_context_create(in_format, out_format);
+  ret->output_format.sample_format = out_format->sample_format;
+  ret->output_format.interleave_mode = out_format->interleave_mode;
+  ret->func = func;
+  return ret;
+  }
+
 gavl_audio_func_t gavl_find_sampleformat_converter(gavl_sampleformat_table_t * t,
                                                    gavl_audio_format_t * in,
                                                    gavl_audio_format_t * out)
@@ -417,6 +596,8 @@ gavl_audio_func_t gavl_find_sampleformat_converter(gavl_sampleformat_table_t * t
         case GAVL_SAMPLE_DOUBLE:
           return t->convert_u8_to_double;
           break;
+        case GAVL_SAMPLE_S24LE:
+        case GAVL_SAMPLE_S24BE:
         case GAVL_SAMPLE_NONE:
           break;
         }
@@ -445,6 +626,8 @@ gavl_audio_func_t gavl_find_sampleformat_converter(gavl_sampleformat_table_t * t
         case GAVL_SAMPLE_DOUBLE:
           return t->convert_s8_to_double;
           break;
+        case GAVL_SAMPLE_S24LE:
+        case GAVL_SAMPLE_S24BE:
         case GAVL_SAMPLE_NONE:
           break;
         }
@@ -474,6 +657,8 @@ gavl_audio_func_t gavl_find_sampleformat_converter(gavl_sampleformat_table_t * t
           return t->convert_u16_to_double;
           break;
           
+        case GAVL_SAMPLE_S24LE:
+        case GAVL_SAMPLE_S24BE:
         case GAVL_SAMPLE_NONE:
           break;
         }
@@ -502,6 +687,8 @@ gavl_audio_func_t gavl_find_sampleformat_converter(gavl_sampleformat_table_t * t
         case GAVL_SAMPLE_DOUBLE:
           return t->convert_s16_to_double;
           break;
+        case GAVL_SAMPLE_S24LE:
+        case GAVL_SAMPLE_S24BE:
         case GAVL_SAMPLE_NONE:
           break;
         }
@@ -531,6 +718,8 @@ gavl_audio_func_t gavl_find_sampleformat_converter(gavl_sampleformat_table_t * t
           return t->convert_s32_to_double;
           break;
 
+        case GAVL_SAMPLE_S24LE:
+        case GAVL_SAMPLE_S24BE:
         case GAVL_SAMPLE_NONE:
           break;
         }
@@ -559,6 +748,8 @@ gavl_audio_func_t gavl_find_sampleformat_converter(gavl_sampleformat_table_t * t
         case GAVL_SAMPLE_DOUBLE:
           return t->convert_float_to_double;
           break;
+        case GAVL_SAMPLE_S24LE:
+        case GAVL_SAMPLE_S24BE:
         case GAVL_SAMPLE_NONE:
           break;
         }
@@ -587,10 +778,14 @@ gavl_audio_func_t gavl_find_sampleformat_converter(gavl_sampleformat_table_t * t
         case GAVL_SAMPLE_DOUBLE:
           // Nothing
           break;
+        case GAVL_SAMPLE_S24LE:
+        case GAVL_SAMPLE_S24BE:
         case GAVL_SAMPLE_NONE:
           break;
         }
       break;
+    case GAVL_SAMPLE_S24LE:
+    case GAVL_SAMPLE_S24BE:
     case GAVL_SAMPLE_NONE:
       break;
     }
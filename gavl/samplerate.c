@@ -77,54 +77,73 @@ static int get_filter_type(gavl_audio_options_t * opt)
 
 #define GET_OUTPUT_SAMPLES(ni, r) (int)((double)(ni)*(r)+10.5)
 
-static void resample_interleave_none_f(gavl_audio_convert_context_t * ctx)
+/*
+ *  Resamplers for single channels or channel pairs are independent
+ *  of each other. Each one gets its own copy of the SRC_DATA so they
+ *  can run in parallel.
+ */
+
+static void resample_func(void * priv, int start, int end)
   {
   int i, result;
-  for(i = 0; i < ctx->samplerate_converter->num_resamplers; i++)
+  gavl_samplerate_converter_t * s = priv;
+  
+  for(i = start; i < end; i++)
     {
-    ctx->samplerate_converter->data.input_frames  = ctx->input_frame->valid_samples;
-    ctx->samplerate_converter->data.output_frames =
-      GET_OUTPUT_SAMPLES(ctx->input_frame->valid_samples,
-                         ctx->samplerate_converter->ratio);
-    ctx->samplerate_converter->data.data_in_f  = ctx->input_frame->channels.f[i];
-    ctx->samplerate_converter->data.data_out_f = ctx->output_frame->channels.f[i];
-    result = gavl_src_process(ctx->samplerate_converter->resamplers[i],
-                              &ctx->samplerate_converter->data);
+    result = gavl_src_process(s->resamplers[i], &s->thread_data[i]);
     if(result)
+      fprintf(stderr, "gavl_src_process returned %s\n",
+              gavl_src_strerror(result));
+    }
+  }
+
+static void resample_channels(gavl_audio_convert_context_t * ctx,
+                              int channels_per_resampler, int d)
+  {
+  int i;
+  gavl_samplerate_converter_t * s = ctx->samplerate_converter;
+  
+  for(i = 0; i < s->num_resamplers; i++)
+    {
+    s->thread_data[i] = s->data;
+    s->thread_data[i].input_frames  = ctx->input_frame->valid_samples;
+    s->thread_data[i].output_frames =
+      GET_OUTPUT_SAMPLES(ctx->input_frame->valid_samples, s->ratio);
+    if(d)
       {
-      fprintf(stderr, "gavl_src_process returned %s (%p)\n",
-              gavl_src_strerror(result), ctx->output_frame->samples.f);
-      break;
+      s->thread_data[i].data_in_d  =
+        ctx->input_frame->channels.d[i * channels_per_resampler];
+      s->thread_data[i].data_out_d =
+        ctx->output_frame->channels.d[i * channels_per_resampler];
+      }
+    else
+      {
+      s->thread_data[i].data_in_f  =
+        ctx->input_frame->channels.f[i * channels_per_resampler];
+      s->thread_data[i].data_out_f =
+        ctx->output_frame->channels.f[i * channels_per_resampler];
       }
     }
-  ctx->output_frame->valid_samples =
-    ctx->samplerate_converter->data.output_frames_gen;
+
+  gavl_audio_options_run(s->opt, resample_func, s, s->num_resamplers);
+  
+  s->data.output_frames_gen = s->thread_data[0].output_frames_gen;
+  ctx->output_frame->valid_samples = s->data.output_frames_gen;
 #if 0
   fprintf(stderr, "Resampled %d -> %ld\n",
           ctx->input_frame->valid_samples,
-          ctx->samplerate_converter->data.output_frames_gen);
+          s->data.output_frames_gen);
 #endif
   }
 
+static void resample_interleave_none_f(gavl_audio_convert_context_t * ctx)
+  {
+  resample_channels(ctx, 1, 0);
+  }
+
 static void resample_interleave_2_f(gavl_audio_convert_context_t * ctx)
   {
-  int i;
-  ctx->samplerate_converter->data.input_frames  =
-    ctx->input_frame->valid_samples; 
-  ctx->samplerate_converter->data.output_frames =
-    GET_OUTPUT_SAMPLES(ctx->input_frame->valid_samples,
-                       ctx->samplerate_converter->ratio);
-  for(i = 0; i < ctx->samplerate_converter->num_resamplers; i++)
-    {
-    ctx->samplerate_converter->data.data_in_f  =
-      ctx->input_frame->channels.f[2*i];
-    ctx->samplerate_converter->data.data_out_f =
-      ctx->output_frame->channels.f[2*i];
-    gavl_src_process(ctx->samplerate_converter->resamplers[i],
-                &ctx->samplerate_converter->data);
-    }
-  ctx->output_frame->valid_samples =
-    ctx->samplerate_converter->data.output_frames_gen;
+  resample_channels(ctx, 2, 0);
   }
   
 static void resample_interleave_all_f(gavl_audio_convert_context_t * ctx)
@@ -145,47 +164,12 @@ static void resample_interleave_all_f(gavl_audio_convert_context_t * ctx)
 
 static void resample_interleave_none_d(gavl_audio_convert_context_t * ctx)
   {
-  int i, result;
-  for(i = 0; i < ctx->samplerate_converter->num_resamplers; i++)
-    {
-    ctx->samplerate_converter->data.input_frames  = ctx->input_frame->valid_samples;
-    ctx->samplerate_converter->data.output_frames =
-      GET_OUTPUT_SAMPLES(ctx->input_frame->valid_samples,
-                         ctx->samplerate_converter->ratio);
-    ctx->samplerate_converter->data.data_in_d  = ctx->input_frame->channels.d[i];
-    ctx->samplerate_converter->data.data_out_d = ctx->output_frame->channels.d[i];
-    result = gavl_src_process(ctx->samplerate_converter->resamplers[i],
-                         &ctx->samplerate_converter->data);
-    if(result)
-      {
-      fprintf(stderr, "gavl_src_process returned %s (%p)\n", gavl_src_strerror(result), ctx->output_frame->samples.f);
-      break;
-      }
-    }
-  ctx->output_frame->valid_samples =
-    ctx->samplerate_converter->data.output_frames_gen;
-
+  resample_channels(ctx, 1, 1);
   }
 
 static void resample_interleave_2_d(gavl_audio_convert_context_t * ctx)
   {
-  int i;
-  ctx->samplerate_converter->data.input_frames  =
-    ctx->input_frame->valid_samples; 
-  ctx->samplerate_converter->data.output_frames =
-    GET_OUTPUT_SAMPLES(ctx->input_frame->valid_samples,
-                       ctx->samplerate_converter->ratio);
-  for(i = 0; i < ctx->samplerate_converter->num_resamplers; i++)
-    {
-    ctx->samplerate_converter->data.data_in_d  =
-      ctx->input_frame->channels.d[2*i];
-    ctx->samplerate_converter->data.data_out_d =
-      ctx->output_frame->channels.d[2*i];
-    gavl_src_process(ctx->samplerate_converter->resamplers[i],
-                &ctx->samplerate_converter->data);
-    }
-  ctx->output_frame->valid_samples =
-    ctx->samplerate_converter->data.output_frames_gen;
+  resample_channels(ctx, 2, 1);
   }
   
 static void resample_interleave_all_d(gavl_audio_convert_context_t * ctx)
@@ -221,11 +205,16 @@ static void init_interleave_none(gavl_audio_convert_context_t * ctx,
   ctx->samplerate_converter->resamplers =
     calloc(ctx->samplerate_converter->num_resamplers,
            sizeof(*(ctx->samplerate_converter->resamplers)));
+  ctx->samplerate_converter->thread_data =
+    calloc(ctx->samplerate_converter->num_resamplers,
+           sizeof(*(ctx->samplerate_converter->thread_data)));
   
   for(i = 0; i < ctx->samplerate_converter->num_resamplers; i++)
     {
     ctx->samplerate_converter->resamplers[i] =
       gavl_src_new(filter_type, 1, &error, d);
+    gavl_src_set_accel_flags(ctx->samplerate_converter->resamplers[i],
+                             opt->accel_flags);
     }
   if(d)
     ctx->func = resample_interleave_none_d;
@@ -249,6 +238,9 @@ static void init_interleave_2(gavl_audio_convert_context_t * ctx,
   ctx->samplerate_converter->resamplers =
     calloc(ctx->samplerate_converter->num_resamplers,
            sizeof(*(ctx->samplerate_converter->resamplers)));
+  ctx->samplerate_converter->thread_data =
+    calloc(ctx->samplerate_converter->num_resamplers,
+           sizeof(*(ctx->samplerate_converter->thread_data)));
 
   for(i = 0; i < ctx->samplerate_converter->num_resamplers; i++)
     {
@@ -257,6 +249,8 @@ static void init_interleave_2(gavl_audio_convert_context_t * ctx,
     
     ctx->samplerate_converter->resamplers[i] =
       gavl_src_new(filter_type, num_channels, &error, d);
+    gavl_src_set_accel_flags(ctx->samplerate_converter->resamplers[i],
+                             opt->accel_flags);
     }
   if(d)
     ctx->func = resample_interleave_2_d;
@@ -279,6 +273,8 @@ static void init_interleave_all(gavl_audio_convert_context_t * ctx,
   ctx->samplerate_converter->resamplers[0] =
     gavl_src_new(get_filter_type(opt),
                  input_format->num_channels, &error, d);
+  gavl_src_set_accel_flags(ctx->samplerate_converter->resamplers[0],
+                           opt->accel_flags);
 
 
   if(d)
@@ -301,6 +297,7 @@ gavl_samplerate_context_create(gavl_audio_options_t * opt,
   ret = gavl_audio_convert_context_create(input_format, output_format);
 
   ret->samplerate_converter = calloc(1, sizeof(*(ret->samplerate_converter)));
+  ret->samplerate_converter->opt = opt;
 
   d = (input_format->sample_format == GAVL_SAMPLE_DOUBLE) ? 1 : 0;
   
@@ -349,5 +346,7 @@ void gavl_samplerate_converter_destroy(gavl_samplerate_converter_t * s)
     gavl_src_delete(s->resamplers[i]);
     }
   free(s->resamplers);
+  if(s->thread_data)
+    free(s->thread_data);
   free(s);
   }
@@ -146,6 +146,21 @@ void gavl_init_scale_funcs(gavl_scale_funcs_t * tab,
         gavl_init_scale_funcs_bilinear_y_sse2(tab, src_advance, dst_advance);
         //        gavl_init_scale_funcs_bilinear_x_sse2(tab, src_advance, dst_advance);
         }
+#endif
+#ifdef HAVE_AVX2
+      if((opt->quality < 3) && (opt->accel_flags & GAVL_ACCEL_AVX2))
+        {
+        if(scale_table->do_clip)
+          {
+          gavl_init_scale_funcs_generic_y_avx2(tab, src_advance, dst_advance);
+          gavl_init_scale_funcs_generic_x_avx2(tab);
+          }
+        else
+          {
+          gavl_init_scale_funcs_generic_y_noclip_avx2(tab, src_advance, dst_advance);
+          gavl_init_scale_funcs_generic_x_noclip_avx2(tab);
+          }
+        }
 #endif
       break;
     case 3:
@@ -181,6 +196,21 @@ void gavl_init_scale_funcs(gavl_scale_funcs_t * tab,
         gavl_init_scale_funcs_quadratic_y_sse2(tab, src_advance, dst_advance);
         //        gavl_init_scale_funcs_quadratic_x_sse2(tab, src_advance, dst_advance);
         }
+#endif
+#ifdef HAVE_AVX2
+      if((opt->quality < 3) && (opt->accel_flags & GAVL_ACCEL_AVX2))
+        {
+        if(scale_table->do_clip)
+          {
+          gavl_init_scale_funcs_generic_y_avx2(tab, src_advance, dst_advance);
+          gavl_init_scale_funcs_generic_x_avx2(tab);
+          }
+        else
+          {
+          gavl_init_scale_funcs_generic_y_noclip_avx2(tab, src_advance, dst_advance);
+          gavl_init_scale_funcs_generic_x_noclip_avx2(tab);
+          }
+        }
 #endif
       break;
     case 4:
@@ -219,6 +249,13 @@ void gavl_init_scale_funcs(gavl_scale_funcs_t * tab,
           {
           gavl_init_scale_funcs_bicubic_x_noclip_sse3(tab);
           }
+#endif
+#ifdef HAVE_AVX2
+        if((opt->quality < 3) && (opt->accel_flags & GAVL_ACCEL_AVX2))
+          {
+          gavl_init_scale_funcs_generic_y_noclip_avx2(tab, src_advance, dst_advance);
+          gavl_init_scale_funcs_generic_x_noclip_avx2(tab);
+          }
 #endif
         }
       else
@@ -256,6 +293,13 @@ void gavl_init_scale_funcs(gavl_scale_funcs_t * tab,
           {
           gavl_init_scale_funcs_bicubic_x_sse3(tab);
           }
+#endif
+#ifdef HAVE_AVX2
+        if((opt->quality < 3) && (opt->accel_flags & GAVL_ACCEL_AVX2))
+          {
+          gavl_init_scale_funcs_generic_y_avx2(tab, src_advance, dst_advance);
+          gavl_init_scale_funcs_generic_x_avx2(tab);
+          }
 #endif
         }
       break;
@@ -293,6 +337,21 @@ void gavl_init_scale_funcs(gavl_scale_funcs_t * tab,
         {
         gavl_init_scale_funcs_generic_x_sse3(tab);
         }
+#endif
+#ifdef HAVE_AVX2
+      if((opt->quality < 3) && (opt->accel_flags & GAVL_ACCEL_AVX2))
+        {
+        if(scale_table->do_clip)
+          {
+          gavl_init_scale_funcs_generic_y_avx2(tab, src_advance, dst_advance);
+          gavl_init_scale_funcs_generic_x_avx2(tab);
+          }
+        else
+          {
+          gavl_init_scale_funcs_generic_y_noclip_avx2(tab, src_advance, dst_advance);
+          gavl_init_scale_funcs_generic_x_noclip_avx2(tab);
+          }
+        }
 #endif
       break;
     }
@@ -656,3 +715,48 @@ void gavl_video_scaler_scale(gavl_video_scaler_t * s,
       }
     }
   }
+
+int gavl_video_scaler_can_scale_rows(gavl_video_scaler_t * s)
+  {
+  if((s->src_fields != 1) || (s->dst_fields != 1) ||
+     (s->src_format.interlace_mode == GAVL_INTERLACE_MIXED))
+    return 0;
+
+  if(s->dst_rect.x || s->dst_rect.y ||
+     (s->dst_rect.w != s->dst_format.image_width) ||
+     (s->dst_rect.h != s->dst_format.image_height))
+    return 0;
+  
+  return 1;
+  }
+
+void gavl_video_scaler_scale_begin(gavl_video_scaler_t * s,
+                                   const gavl_video_frame_t * src)
+  {
+  int i;
+  for(i = 0; i < s->num_planes; i++)
+    gavl_video_scale_context_scale_begin(&s->contexts[0][i], src);
+  }
+
+void gavl_video_scaler_scale_rows(gavl_video_scaler_t * s,
+                                  gavl_video_frame_t * dst,
+                                  int start, int end)
+  {
+  int i;
+  int sub_h, sub_v;
+  gavl_video_scale_context_t * ctx;
+  
+  gavl_pixelformat_chroma_sub(s->dst_format.pixelformat, &sub_h, &sub_v);
+
+  gavl_video_scale_context_scale_rows(&s->contexts[0][0], dst, start, end);
+  
+  for(i = 1; i < s->num_planes; i++)
+    {
+    ctx = &s->contexts[0][i];
+
+    /* The last chroma row might be a partial one */
+    gavl_video_scale_context_scale_rows(ctx, dst, start / sub_v,
+                                        (end == s->dst_rect.h) ?
+                                        ctx->dst_rect.h : end / sub_v);
+    }
+  }
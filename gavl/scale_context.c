@@ -79,6 +79,7 @@ static void dump_offset(gavl_video_scale_offsets_t*off)
 
 static gavl_video_scale_scanline_func get_func(gavl_scale_func_tab_t * tab,
                                                gavl_pixelformat_t pixelformat,
+                                               int plane,
                                                int * bits)
   {
   switch(pixelformat)
@@ -144,9 +145,28 @@ static gavl_video_scale_scanline_func get_func(gavl_scale_func_tab_t * tab,
       break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_10:
       *bits = tab->bits_uint16;
       return tab->scale_uint16_x_1;
       break;
+      /* The chroma plane of semi planar formats is scaled like
+         gray + alpha */
+    case GAVL_NV12:
+    case GAVL_NV21:
+      *bits = tab->bits_uint8_noadvance;
+      if(plane)
+        return tab->scale_uint8_x_2;
+      else
+        return tab->scale_uint8_x_1_noadvance;
+      break;
+    case GAVL_P010:
+    case GAVL_P016:
+      *bits = tab->bits_uint16;
+      if(plane)
+        return tab->scale_uint16_x_2;
+      else
+        return tab->scale_uint16_x_1;
+      break;
     case GAVL_RGB_48:
       *bits = tab->bits_uint16;
       return tab->scale_uint16_x_3;
@@ -178,7 +198,7 @@ static gavl_video_scale_scanline_func get_func(gavl_scale_func_tab_t * tab,
   return NULL;
   }
 
-static void get_minmax(gavl_pixelformat_t pixelformat,
+static void get_minmax(gavl_pixelformat_t pixelformat, int plane,
                        int * min, int * max, float * min_f, float * max_f)
   {
   int i;
@@ -266,6 +286,30 @@ static void get_minmax(gavl_pixelformat_t pixelformat,
       max[2] = 240<<8;
       max[3] = (1<<16)-1;
       break;
+    case GAVL_YUV_420_P_10:
+      min[0] = 16<<2;
+      min[1] = 16<<2;
+      min[2] = 16<<2;
+      max[0] = 235<<2;
+      max[1] = 240<<2;
+      max[2] = 240<<2;
+      break;
+      /* Semi planar formats: Both chroma components are in the
+         second plane */
+    case GAVL_NV12:
+    case GAVL_NV21:
+      min[0] = 16;
+      max[0] = plane ? 240 : 235;
+      min[1] = 16;
+      max[1] = 240;
+      break;
+    case GAVL_P010:
+    case GAVL_P016:
+      min[0] = 16<<8;
+      max[0] = plane ? 240<<8 : 235<<8;
+      min[1] = 16<<8;
+      max[1] = 240<<8;
+      break;
     case GAVL_GRAY_16:
     case GAVL_GRAYA_32:
     case GAVL_RGB_48:
@@ -305,6 +349,9 @@ static void alloc_temp(gavl_video_scale_context_t * ctx, gavl_pixelformat_t pixe
   int size;
   if((pixelformat == GAVL_YUY2) || (pixelformat == GAVL_UYVY))
     ctx->buffer_stride = ctx->buffer_width;
+  else if(gavl_pixelformat_is_semiplanar(pixelformat) && ctx->plane)
+    ctx->buffer_stride = ctx->buffer_width * 2 *
+      gavl_pixelformat_bytes_per_component(pixelformat);
   else if(gavl_pixelformat_is_planar(pixelformat))
     ctx->buffer_stride = ctx->buffer_width *
       gavl_pixelformat_bytes_per_component(pixelformat);
@@ -572,6 +619,9 @@ int gavl_video_scale_context_init(gavl_video_scale_context_t*ctx,
   ctx->bytes_per_line = gavl_pixelformat_is_planar(src_format->pixelformat) ?
     ctx->dst_rect.w * gavl_pixelformat_bytes_per_component(src_format->pixelformat) :
     ctx->dst_rect.w * gavl_pixelformat_bytes_per_pixel(src_format->pixelformat);
+
+  if(plane && gavl_pixelformat_is_semiplanar(src_format->pixelformat))
+    ctx->bytes_per_line *= 2;
   
   /* Set source and destination offsets */
   
@@ -656,7 +706,7 @@ int gavl_video_scale_context_init(gavl_video_scale_context_t*ctx,
       gavl_init_scale_funcs(&funcs, &tmp_opt, ctx->offset1.src_advance,
                             ctx->offset2.dst_advance, &ctx->table_h,
                             &ctx->table_v);
-      ctx->func1 = get_func(&funcs.funcs_xy, src_format->pixelformat, &bits_h);
+      ctx->func1 = get_func(&funcs.funcs_xy, src_format->pixelformat, plane, &bits_h);
       //      fprintf(stderr, "X AND Y %d\n");
       }
     
@@ -708,7 +758,7 @@ int gavl_video_scale_context_init(gavl_video_scale_context_t*ctx,
                               ctx->offset1.src_advance,
                               ctx->offset1.dst_advance,
                               &ctx->table_h, NULL);
-        ctx->func1 = get_func(&funcs.funcs_x, src_format->pixelformat, &bits_h);
+        ctx->func1 = get_func(&funcs.funcs_x, src_format->pixelformat, plane, &bits_h);
         if(bits_h)
           gavl_video_scale_table_init_int(&ctx->table_h, bits_h);
         
@@ -717,7 +767,7 @@ int gavl_video_scale_context_init(gavl_video_scale_context_t*ctx,
                               ctx->offset2.dst_advance,
                               NULL, &ctx->table_v);
         ctx->func2 = get_func(&funcs.funcs_y,
-                              src_format->pixelformat, &bits_v);
+                              src_format->pixelformat, plane, &bits_v);
 
         if(bits_v)
           gavl_video_scale_table_init_int(&ctx->table_v, bits_v);
@@ -738,7 +788,7 @@ int gavl_video_scale_context_init(gavl_video_scale_context_t*ctx,
                               ctx->offset1.src_advance,
                               ctx->offset1.dst_advance,
                               NULL, &ctx->table_v);
-        ctx->func1 = get_func(&funcs.funcs_y, src_format->pixelformat, &bits_v);
+        ctx->func1 = get_func(&funcs.funcs_y, src_format->pixelformat, plane, &bits_v);
 
         if(bits_v)
           gavl_video_scale_table_init_int(&ctx->table_v, bits_v);
@@ -748,7 +798,7 @@ int gavl_video_scale_context_init(gavl_video_scale_context_t*ctx,
                               ctx->offset2.dst_advance,
                               &ctx->table_h, NULL);
         ctx->func2 = get_func(&funcs.funcs_x,
-                              src_format->pixelformat, &bits_h);
+                              src_format->pixelformat, plane, &bits_h);
         if(bits_h)
           gavl_video_scale_table_init_int(&ctx->table_h, bits_h);
         }
@@ -769,7 +819,7 @@ int gavl_video_scale_context_init(gavl_video_scale_context_t*ctx,
                           ctx->offset1.src_advance,
                           ctx->offset1.dst_advance,
                           &ctx->table_h, NULL);
-    ctx->func1 = get_func(&funcs.funcs_x, src_format->pixelformat, &bits_h);
+    ctx->func1 = get_func(&funcs.funcs_x, src_format->pixelformat, plane, &bits_h);
 
     if(bits_h)
       gavl_video_scale_table_init_int(&ctx->table_h, bits_h);
@@ -786,7 +836,7 @@ int gavl_video_scale_context_init(gavl_video_scale_context_t*ctx,
                           ctx->offset1.src_advance,
                           ctx->offset1.dst_advance,
                           NULL, &ctx->table_v);
-    ctx->func1 = get_func(&funcs.funcs_y, src_format->pixelformat, &bits_v);
+    ctx->func1 = get_func(&funcs.funcs_y, src_format->pixelformat, plane, &bits_v);
     
     if(bits_v)
       gavl_video_scale_table_init_int(&ctx->table_v, bits_v);
@@ -807,10 +857,10 @@ int gavl_video_scale_context_init(gavl_video_scale_context_t*ctx,
   gavl_video_scale_table_dump(&ctx->table_v);
 #endif
   
-  get_minmax(src_format->pixelformat, ctx->min_values_h,
+  get_minmax(src_format->pixelformat, plane, ctx->min_values_h,
              ctx->max_values_h, ctx->min_values_f, ctx->max_values_f);
   
-  get_minmax(src_format->pixelformat, ctx->min_values_v,
+  get_minmax(src_format->pixelformat, plane, ctx->min_values_v,
              ctx->max_values_v, ctx->min_values_f, ctx->max_values_f);
   
 #if 0
@@ -1043,6 +1093,9 @@ gavl_video_scale_context_init_convolve(gavl_video_scale_context_t* ctx,
     gavl_pixelformat_is_planar(format->pixelformat) ?
     ctx->dst_rect.w * gavl_pixelformat_bytes_per_component(format->pixelformat) :
     ctx->dst_rect.w * gavl_pixelformat_bytes_per_pixel(format->pixelformat);
+
+  if(plane && gavl_pixelformat_is_semiplanar(format->pixelformat))
+    ctx->bytes_per_line *= 2;
   
   /* Set source and destination offsets */
 
@@ -1134,7 +1187,7 @@ gavl_video_scale_context_init_convolve(gavl_video_scale_context_t* ctx,
                             ctx->offset1.src_advance,
                             ctx->offset2.dst_advance,
                             &ctx->table_h, &ctx->table_v);
-      ctx->func1 = get_func(&funcs.funcs_xy, format->pixelformat, &bits_h);
+      ctx->func1 = get_func(&funcs.funcs_xy, format->pixelformat, plane, &bits_h);
       //      fprintf(stderr, "X AND Y\n");
       }
     
@@ -1167,7 +1220,7 @@ gavl_video_scale_context_init_convolve(gavl_video_scale_context_t* ctx,
                             ctx->offset1.src_advance,
                             ctx->offset1.dst_advance,
                             &ctx->table_h, NULL);
-      ctx->func1 = get_func(&funcs.funcs_x, format->pixelformat, &bits_h);
+      ctx->func1 = get_func(&funcs.funcs_x, format->pixelformat, plane, &bits_h);
 
       gavl_video_scale_table_init_int(&ctx->table_h, bits_h);
 
@@ -1175,7 +1228,7 @@ gavl_video_scale_context_init_convolve(gavl_video_scale_context_t* ctx,
                             ctx->offset2.src_advance,
                             ctx->offset2.dst_advance,
                             NULL, &ctx->table_v);
-      ctx->func2 = get_func(&funcs.funcs_y, format->pixelformat, &bits_v);
+      ctx->func2 = get_func(&funcs.funcs_y, format->pixelformat, plane, &bits_v);
 
 
       gavl_video_scale_table_init_int(&ctx->table_v, bits_v);
@@ -1199,7 +1252,7 @@ gavl_video_scale_context_init_convolve(gavl_video_scale_context_t* ctx,
                           ctx->offset1.src_advance,
                           ctx->offset1.dst_advance,
                           &ctx->table_h, NULL);
-    ctx->func1 = get_func(&funcs.funcs_x, format->pixelformat, &bits_h);
+    ctx->func1 = get_func(&funcs.funcs_x, format->pixelformat, plane, &bits_h);
     
     gavl_video_scale_table_init_int(&ctx->table_h, bits_h);
     }
@@ -1218,7 +1271,7 @@ gavl_video_scale_context_init_convolve(gavl_video_scale_context_t* ctx,
                           ctx->offset1.src_advance,
                           ctx->offset1.dst_advance,
                           NULL, &ctx->table_v);
-    ctx->func1 = get_func(&funcs.funcs_y, format->pixelformat, &bits_v);
+    ctx->func1 = get_func(&funcs.funcs_y, format->pixelformat, plane, &bits_v);
     
     gavl_video_scale_table_init_int(&ctx->table_v, bits_v);
     }
@@ -1232,8 +1285,8 @@ gavl_video_scale_context_init_convolve(gavl_video_scale_context_t* ctx,
 #endif
 
   
-  get_minmax(format->pixelformat, ctx->min_values_h, ctx->max_values_h, ctx->min_values_f, ctx->max_values_f);
-  get_minmax(format->pixelformat, ctx->min_values_v, ctx->max_values_v, ctx->min_values_f, ctx->max_values_f);
+  get_minmax(format->pixelformat, plane, ctx->min_values_h, ctx->max_values_h, ctx->min_values_f, ctx->max_values_f);
+  get_minmax(format->pixelformat, plane, ctx->min_values_v, ctx->max_values_v, ctx->min_values_f, ctx->max_values_f);
 
   if(h_c) free(h_c);
   if(v_c) free(v_c);
@@ -1312,10 +1365,6 @@ static void scale_context_scale_mt(gavl_video_scale_context_t * ctx,
                                    const gavl_video_frame_t * src,
                                    gavl_video_frame_t * dst)
   {
-  int delta;
-  int scanline;
-  int nt;
-  int i;
   switch(ctx->num_directions)
     {
     case 1:
@@ -1324,23 +1373,7 @@ static void scale_context_scale_mt(gavl_video_scale_context_t * ctx,
       ctx->src_stride = src->strides[ctx->src_frame_plane];
       ctx->dst_frame = dst;
       
-      nt = ctx->opt->num_threads;
-      if(nt > ctx->dst_rect.h)
-        nt = ctx->dst_rect.h;
-      
-      delta = ctx->dst_rect.h / nt;
-      scanline = 0;
-      for(i = 0; i < nt - 1; i++)
-        {
-        ctx->opt->run_func(func_1, ctx, scanline, scanline+delta, ctx->opt->run_data, i);
-        
-        //        fprintf(stderr, "scanline: %d (%d)\n", ctx->scanline, ctx->dst_rect.h);
-        scanline += delta;
-        }
-      ctx->opt->run_func(func_1, ctx, scanline, ctx->dst_rect.h, ctx->opt->run_data, nt - 1);
-      
-      for(i = 0; i < nt; i++)
-        ctx->opt->stop_func(ctx->opt->stop_data, i);
+      gavl_video_options_run(ctx->opt, func_1, ctx, ctx->dst_rect.h, 1);
       break;
     case 2:
       /* First step */
@@ -1358,27 +1391,8 @@ static void scale_context_scale_mt(gavl_video_scale_context_t * ctx,
       dump_offset(ctx->offset);
 #endif
 
-      nt = ctx->opt->num_threads;
-      if(nt > ctx->buffer_height)
-        nt = ctx->buffer_height;
-
-      delta = ctx->buffer_height / nt;
-      scanline = 0;
-      for(i = 0; i < nt - 1; i++)
-        {
-        ctx->opt->run_func(func_1_of_2, ctx, scanline, scanline+delta, ctx->opt->run_data, i);
-        
-        //        fprintf(stderr, "scanline: %d (%d)\n", ctx->scanline, ctx->dst_rect.h);
-        scanline += delta;
-        }
-      ctx->opt->run_func(func_1_of_2, ctx, scanline, ctx->buffer_height,
-                         ctx->opt->run_data, nt - 1);
+      gavl_video_options_run(ctx->opt, func_1_of_2, ctx, ctx->buffer_height, 1);
       
-      for(i = 0; i < nt; i++)
-        ctx->opt->stop_func(ctx->opt->stop_data, i);
-      
-      //      fprintf(stderr, "done\n");
-
       /* Second step */
       ctx->offset = &ctx->offset2;
 #if 0
@@ -1390,26 +1404,7 @@ static void scale_context_scale_mt(gavl_video_scale_context_t * ctx,
       ctx->dst_size = ctx->dst_rect.w;
       ctx->dst_frame = dst;
       
-      nt = ctx->opt->num_threads;
-      if(nt > ctx->dst_rect.h)
-        nt = ctx->dst_rect.h;
-      
-      delta = ctx->dst_rect.h / nt;
-
-      scanline = 0;
-      for(i = 0; i < nt - 1; i++)
-        {
-        ctx->opt->run_func(func_2_of_2, ctx, scanline, scanline+delta, ctx->opt->run_data, i);
-        
-        //        fprintf(stderr, "scanline: %d (%d)\n", ctx->scanline, ctx->dst_rect.h);
-        scanline += delta;
-        }
-      ctx->opt->run_func(func_2_of_2, ctx, scanline, ctx->dst_rect.h,
-                         ctx->opt->run_data, nt - 1);
-      
-      for(i = 0; i < nt; i++)
-        ctx->opt->stop_func(ctx->opt->stop_data, i);
-      //      fprintf(stderr, "done\n");
+      gavl_video_options_run(ctx->opt, func_2_of_2, ctx, ctx->dst_rect.h, 1);
       break;
     }
   }
@@ -1426,6 +1421,97 @@ static void scale_context_scale_mt(gavl_video_scale_context_t * ctx,
 #endif
 
 
+/*
+ *  Row wise scaling: Run the first step (if any) and prepare the context
+ *  so the final step can be done for arbitrary ranges of output rows.
+ */
+
+void gavl_video_scale_context_scale_begin(gavl_video_scale_context_t * ctx,
+                                          const gavl_video_frame_t * src)
+  {
+  int num;
+
+  num = gavl_video_scale_context_first_begin(ctx, src);
+  if(num)
+    gavl_video_options_run(ctx->opt, func_1_of_2, ctx, num, 1);
+  gavl_video_scale_context_final_begin(ctx, NULL);
+  }
+
+int gavl_video_scale_context_first_begin(gavl_video_scale_context_t * ctx,
+                                         const gavl_video_frame_t * src)
+  {
+  switch(ctx->num_directions)
+    {
+    case 1:
+      ctx->src = src->planes[ctx->src_frame_plane] + ctx->offset->src_offset;
+      ctx->src_stride = src->strides[ctx->src_frame_plane];
+      break;
+    case 2:
+      ctx->offset = &ctx->offset1;
+      
+      ctx->src = src->planes[ctx->src_frame_plane] +
+        ctx->offset->src_offset +
+        src->strides[ctx->src_frame_plane] * ctx->first_scanline;
+      
+      ctx->src_stride = src->strides[ctx->src_frame_plane];
+      ctx->dst_size = ctx->buffer_width;
+      return ctx->buffer_height;
+    }
+  return 0;
+  }
+
+void gavl_video_scale_context_first_rows(gavl_video_scale_context_t * ctx,
+                                         int start, int end)
+  {
+  func_1_of_2(ctx, start, end);
+  }
+
+void gavl_video_scale_context_final_begin(gavl_video_scale_context_t * ctx,
+                                          gavl_video_frame_t * dst)
+  {
+  if(ctx->num_directions == 2)
+    {
+    ctx->offset = &ctx->offset2;
+    ctx->src = ctx->buffer;
+    ctx->src_stride = ctx->buffer_stride;
+    ctx->dst_size = ctx->dst_rect.w;
+    }
+  ctx->dst_frame = dst;
+  }
+
+void gavl_video_scale_context_final_rows(gavl_video_scale_context_t * ctx,
+                                         int start, int end)
+  {
+  if(ctx->num_directions == 2)
+    func_2_of_2(ctx, start, end);
+  else
+    func_1(ctx, start, end);
+  }
+
+/* Output rows [start, end) go to the first rows of dst */
+
+void gavl_video_scale_context_scale_rows(gavl_video_scale_context_t * ctx,
+                                         gavl_video_frame_t * dst,
+                                         int start, int end)
+  {
+  int i;
+  uint8_t * dst_save;
+  gavl_video_scale_scanline_func func;
+
+  func = (ctx->num_directions == 2) ? ctx->func2 : ctx->func1;
+  
+  dst_save = dst->planes[ctx->dst_frame_plane] + ctx->offset->dst_offset;
+  
+  for(i = start; i < end; i++)
+    {
+    func(ctx, i, dst_save);
+    dst_save += dst->strides[ctx->dst_frame_plane];
+    }
+#ifdef HAVE_MMX
+  __asm__ __volatile__ ("emms");
+#endif
+  }
+
 void gavl_video_scale_context_scale(gavl_video_scale_context_t * ctx,
                                     const gavl_video_frame_t * src,
                                     gavl_video_frame_t * dst)
@@ -34,6 +34,7 @@
 #include <fcntl.h>
 //#include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 
 #include <netinet/in.h>
@@ -748,6 +749,73 @@ int gavl_socket_write_data(int fd, const void * data, int len)
   return result;
   }
 
+#define MAX_IOV 64
+
+int gavl_socket_writev_data(int fd, const struct iovec * iov, int iovcnt)
+  {
+  struct iovec vec[MAX_IOV];
+  struct msghdr msg;
+  ssize_t result;
+  int i;
+  int ret = 0;
+  
+  if(iovcnt > MAX_IOV)
+    {
+    /* Send in portions */
+    for(i = 0; i < iovcnt; i += MAX_IOV)
+      {
+      int num = iovcnt - i;
+      int len = 0;
+      int j;
+      if(num > MAX_IOV)
+        num = MAX_IOV;
+      for(j = 0; j < num; j++)
+        len += iov[i+j].iov_len;
+
+      result = gavl_socket_writev_data(fd, iov + i, num);
+      if(result > 0)
+        ret += result;
+      if(result < len)
+        break;
+      }
+    return ret;
+    }
+  
+  memcpy(vec, iov, iovcnt * sizeof(*iov));
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = vec;
+  msg.msg_iovlen = iovcnt;
+  
+  while(msg.msg_iovlen)
+    {
+    result = sendmsg(fd, &msg, MSG_NOSIGNAL);
+
+    if(result < 0)
+      {
+      if(errno == EINTR)
+        continue;
+      gavl_log(GAVL_LOG_ERROR, LOG_DOMAIN, "Sending data failed: %s", 
+               strerror(errno));    
+      break;
+      }
+    ret += result;
+    
+    /* Skip the data which were sent */
+    while(msg.msg_iovlen && ((size_t)result >= msg.msg_iov->iov_len))
+      {
+      result -= msg.msg_iov->iov_len;
+      msg.msg_iov++;
+      msg.msg_iovlen--;
+      }
+    if(result > 0)
+      {
+      msg.msg_iov->iov_base = (uint8_t*)msg.msg_iov->iov_base + result;
+      msg.msg_iov->iov_len -= result;
+      }
+    }
+  return ret;
+  }
+
 /*
  *  Read a single line from a filedescriptor
  *
@@ -0,0 +1,225 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <video.h>
+#include <blend.h>
+
+#include <emmintrin.h>
+
+/*
+ *  SSE2 blenders, identical to the C ones. The C version of BLEND_8
+ *  can be written as
+ *
+ *  d = (d * (256 - a) + s * a) >> 8
+ *
+ *  where the sum never exceeds 16 bits.
+ */
+
+#define BLEND_8(s, d, a) \
+  d = (((s - d) * a)>>8) + d;
+
+static inline __m128i blend_16(__m128i d, __m128i s, __m128i a)
+  {
+  return
+    _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(d, _mm_sub_epi16(_mm_set1_epi16(256), a)),
+                                 _mm_mullo_epi16(s, a)), 8);
+  }
+
+/* 4 pixels of RGBA_32 over RGB_32 or BGR_32. The 4th destination byte
+   is left unchanged */
+
+static inline __m128i blend_rgbx_32(__m128i d, __m128i o, int bgr)
+  {
+  __m128i zero, mask, d_16, o_16, a_16, ret[2];
+  int i;
+
+  zero = _mm_setzero_si128();
+  mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+
+  for(i = 0; i < 2; i++)
+    {
+    if(!i)
+      {
+      d_16 = _mm_unpacklo_epi8(d, zero);
+      o_16 = _mm_unpacklo_epi8(o, zero);
+      }
+    else
+      {
+      d_16 = _mm_unpackhi_epi8(d, zero);
+      o_16 = _mm_unpackhi_epi8(o, zero);
+      }
+    
+    a_16 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(o_16, _MM_SHUFFLE(3, 3, 3, 3)),
+                               _MM_SHUFFLE(3, 3, 3, 3));
+    a_16 = _mm_and_si128(a_16, mask);
+
+    if(bgr)
+      o_16 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(o_16, _MM_SHUFFLE(3, 0, 1, 2)),
+                                 _MM_SHUFFLE(3, 0, 1, 2));
+    
+    ret[i] = blend_16(d_16, o_16, a_16);
+    }
+  return _mm_packus_epi16(ret[0], ret[1]);
+  }
+
+static void blend_rgbx_32_sse2(gavl_overlay_blend_context_t * ctx,
+                               gavl_video_frame_t * frame,
+                               gavl_video_frame_t * overlay, int bgr)
+  {
+  int i, j, tmp;
+  uint8_t * ovl_ptr;
+  uint8_t * dst_ptr;
+  
+  for(i = 0; i < ctx->blend_rect.h; i++)
+    {
+    ovl_ptr = overlay->planes[0] + i * overlay->strides[0];
+    dst_ptr = frame->planes[0] + i * frame->strides[0];
+    
+    for(j = 0; j + 4 <= ctx->blend_rect.w; j += 4)
+      {
+      _mm_storeu_si128((__m128i*)dst_ptr,
+                       blend_rgbx_32(_mm_loadu_si128((const __m128i*)dst_ptr),
+                                     _mm_loadu_si128((const __m128i*)ovl_ptr), bgr));
+      ovl_ptr += 16;
+      dst_ptr += 16;
+      }
+
+    for(; j < ctx->blend_rect.w; j++)
+      {
+      tmp = dst_ptr[bgr ? 2 : 0];
+      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
+      dst_ptr[bgr ? 2 : 0] = tmp;
+
+      tmp = dst_ptr[1];
+      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
+      dst_ptr[1] = tmp;
+
+      tmp = dst_ptr[bgr ? 0 : 2];
+      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
+      dst_ptr[bgr ? 0 : 2] = tmp;
+      
+      ovl_ptr += 4;
+      dst_ptr += 4;
+      }
+    }
+  }
+
+/* ovl: GAVL_RGBA_32 */
+
+static void blend_rgb_32_sse2(gavl_overlay_blend_context_t * ctx,
+                              gavl_video_frame_t * frame,
+                              gavl_video_frame_t * overlay)
+  {
+  blend_rgbx_32_sse2(ctx, frame, overlay, 0);
+  }
+
+/* ovl: GAVL_RGBA_32 */
+
+static void blend_bgr_32_sse2(gavl_overlay_blend_context_t * ctx,
+                              gavl_video_frame_t * frame,
+                              gavl_video_frame_t * overlay)
+  {
+  blend_rgbx_32_sse2(ctx, frame, overlay, 1);
+  }
+
+/* Planar 8 bit YUV with the premultiplied overlay (see blend_c.c) */
+
+static void blend_yuv_planar_8_sse2(gavl_overlay_blend_context_t * ctx,
+                                    gavl_video_frame_t * frame,
+                                    gavl_video_frame_t * overlay)
+  {
+  int i, j, plane, sub_h, sub_v, w, h, offset;
+  const uint16_t * sa;
+  const uint16_t * ia;
+  uint8_t * dst_ptr;
+  __m128i zero, d, lo, hi;
+
+  zero = _mm_setzero_si128();
+  
+  for(plane = 0; plane < 3; plane++)
+    {
+    sub_h = plane ? ctx->dst_sub_h : 1;
+    sub_v = plane ? ctx->dst_sub_v : 1;
+
+    w = ctx->blend_rect.w / sub_h;
+    h = ctx->blend_rect.h / sub_v;
+
+    offset = (ctx->blend_rect.y / sub_v) * ctx->pm_stride[plane] +
+      ctx->blend_rect.x / sub_h;
+    sa = ctx->pm_sa[plane] + offset;
+    ia = ctx->pm_ia[plane] + offset;
+    dst_ptr = frame->planes[plane];
+    
+    for(i = 0; i < h; i++)
+      {
+      for(j = 0; j + 16 <= w; j += 16)
+        {
+        d = _mm_loadu_si128((const __m128i*)(dst_ptr + j));
+
+        lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero),
+                                           _mm_loadu_si128((const __m128i*)(ia + j))),
+                           _mm_loadu_si128((const __m128i*)(sa + j)));
+        hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero),
+                                           _mm_loadu_si128((const __m128i*)(ia + j + 8))),
+                           _mm_loadu_si128((const __m128i*)(sa + j + 8)));
+        
+        _mm_storeu_si128((__m128i*)(dst_ptr + j),
+                         _mm_packus_epi16(_mm_srli_epi16(lo, 8),
+                                          _mm_srli_epi16(hi, 8)));
+        }
+
+      for(; j < w; j++)
+        dst_ptr[j] = (dst_ptr[j] * ia[j] + sa[j]) >> 8;
+      
+      sa += ctx->pm_stride[plane];
+      ia += ctx->pm_stride[plane];
+      dst_ptr += frame->strides[plane];
+      }
+    }
+  }
+
+gavl_blend_func_t
+gavl_find_blend_func_sse2(gavl_overlay_blend_context_t * ctx,
+                          gavl_pixelformat_t frame_format)
+  {
+  switch(frame_format)
+    {
+    case GAVL_RGB_32:
+      return blend_rgb_32_sse2;
+    case GAVL_BGR_32:
+      return blend_bgr_32_sse2;
+    case GAVL_YUV_420_P:
+    case GAVL_YUV_422_P:
+    case GAVL_YUV_444_P:
+    case GAVL_YUV_411_P:
+    case GAVL_YUV_410_P:
+    case GAVL_YUVJ_420_P:
+    case GAVL_YUVJ_422_P:
+    case GAVL_YUVJ_444_P:
+      return blend_yuv_planar_8_sse2;
+    default:
+      break;
+    }
+  return NULL;
+  }
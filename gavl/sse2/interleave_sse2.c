@@ -0,0 +1,442 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <audio.h>
+#include <interleave.h>
+
+#include <emmintrin.h>
+
+/*
+ *  SSE2 interleaving for stereo, 5.1 and 7.1. Other channel numbers
+ *  are handled like in the C versions.
+ */
+
+/* Transposing a 8x8 matrix of 16 bit elements is its own inverse */
+
+static inline void transpose_8x8_16(__m128i * r)
+  {
+  __m128i a0, a1, a2, a3, a4, a5, a6, a7;
+  __m128i b0, b1, b2, b3, b4, b5, b6, b7;
+
+  a0 = _mm_unpacklo_epi16(r[0], r[1]);
+  a1 = _mm_unpackhi_epi16(r[0], r[1]);
+  a2 = _mm_unpacklo_epi16(r[2], r[3]);
+  a3 = _mm_unpackhi_epi16(r[2], r[3]);
+  a4 = _mm_unpacklo_epi16(r[4], r[5]);
+  a5 = _mm_unpackhi_epi16(r[4], r[5]);
+  a6 = _mm_unpacklo_epi16(r[6], r[7]);
+  a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+  b0 = _mm_unpacklo_epi32(a0, a2);
+  b1 = _mm_unpackhi_epi32(a0, a2);
+  b2 = _mm_unpacklo_epi32(a1, a3);
+  b3 = _mm_unpackhi_epi32(a1, a3);
+  b4 = _mm_unpacklo_epi32(a4, a6);
+  b5 = _mm_unpackhi_epi32(a4, a6);
+  b6 = _mm_unpacklo_epi32(a5, a7);
+  b7 = _mm_unpackhi_epi32(a5, a7);
+
+  r[0] = _mm_unpacklo_epi64(b0, b4);
+  r[1] = _mm_unpackhi_epi64(b0, b4);
+  r[2] = _mm_unpacklo_epi64(b1, b5);
+  r[3] = _mm_unpackhi_epi64(b1, b5);
+  r[4] = _mm_unpacklo_epi64(b2, b6);
+  r[5] = _mm_unpackhi_epi64(b2, b6);
+  r[6] = _mm_unpacklo_epi64(b3, b7);
+  r[7] = _mm_unpackhi_epi64(b3, b7);
+  }
+
+/* 16 bit */
+
+static void interleave_none_to_all_stereo_16(gavl_audio_convert_context_t * ctx)
+  {
+  int i;
+  __m128i l, r;
+  const uint16_t * src1 = ctx->input_frame->channels.u_16[0];
+  const uint16_t * src2 = ctx->input_frame->channels.u_16[1];
+  uint16_t * dst = ctx->output_frame->samples.u_16;
+  int num = ctx->input_frame->valid_samples;
+
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    l = _mm_loadu_si128((const __m128i*)(src1 + i));
+    r = _mm_loadu_si128((const __m128i*)(src2 + i));
+    _mm_storeu_si128((__m128i*)(dst + 2 * i), _mm_unpacklo_epi16(l, r));
+    _mm_storeu_si128((__m128i*)(dst + 2 * i + 8), _mm_unpackhi_epi16(l, r));
+    }
+  for(; i < num; i++)
+    {
+    dst[2*i]   = src1[i];
+    dst[2*i+1] = src2[i];
+    }
+  }
+
+static void interleave_all_to_none_stereo_16(gavl_audio_convert_context_t * ctx)
+  {
+  int i;
+  __m128i v1, v2;
+  const uint16_t * src = ctx->input_frame->samples.u_16;
+  uint16_t * dst1 = ctx->output_frame->channels.u_16[0];
+  uint16_t * dst2 = ctx->output_frame->channels.u_16[1];
+  int num = ctx->input_frame->valid_samples;
+
+  /* Sign extended 16 bit values survive the saturation of packssdw */
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    v1 = _mm_loadu_si128((const __m128i*)(src + 2 * i));
+    v2 = _mm_loadu_si128((const __m128i*)(src + 2 * i + 8));
+    _mm_storeu_si128((__m128i*)(dst1 + i),
+                     _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(v1, 16), 16),
+                                     _mm_srai_epi32(_mm_slli_epi32(v2, 16), 16)));
+    _mm_storeu_si128((__m128i*)(dst2 + i),
+                     _mm_packs_epi32(_mm_srai_epi32(v1, 16),
+                                     _mm_srai_epi32(v2, 16)));
+    }
+  for(; i < num; i++)
+    {
+    dst1[i] = src[2*i];
+    dst2[i] = src[2*i+1];
+    }
+  }
+
+/*
+ *  5.1 and 7.1 are done in blocks of 8 samples as 8x8 transposes. For
+ *  5.1, the rows have 2 extra elements. They are read from and written
+ *  to the next sample, so we need at least one sample after the block.
+ */
+
+static void interleave_none_to_all_16(gavl_audio_convert_context_t * ctx)
+  {
+  int i, j;
+  __m128i r[8];
+  const uint16_t * src[8];
+  uint16_t * dst = ctx->output_frame->samples.u_16;
+  int num = ctx->input_frame->valid_samples;
+  int num_channels = ctx->input_format.num_channels;
+
+  i = 0;
+
+  if((num_channels == 6) || (num_channels == 8))
+    {
+    for(j = 0; j < num_channels; j++)
+      src[j] = ctx->input_frame->channels.u_16[j];
+    r[6] = r[7] = _mm_setzero_si128();
+
+    for(i = 0; i + 8 < num; i += 8)
+      {
+      for(j = 0; j < num_channels; j++)
+        r[j] = _mm_loadu_si128((const __m128i*)(src[j] + i));
+      transpose_8x8_16(r);
+      for(j = 0; j < 8; j++)
+        _mm_storeu_si128((__m128i*)(dst + num_channels * (i + j)), r[j]);
+      }
+    }
+
+  for(; i < num; i++)
+    {
+    for(j = 0; j < num_channels; j++)
+      dst[num_channels * i + j] = ctx->input_frame->channels.u_16[j][i];
+    }
+  }
+
+static void interleave_all_to_none_16(gavl_audio_convert_context_t * ctx)
+  {
+  int i, j;
+  __m128i r[8];
+  uint16_t * dst[8];
+  const uint16_t * src = ctx->input_frame->samples.u_16;
+  int num = ctx->input_frame->valid_samples;
+  int num_channels = ctx->input_format.num_channels;
+
+  i = 0;
+
+  if((num_channels == 6) || (num_channels == 8))
+    {
+    for(j = 0; j < num_channels; j++)
+      dst[j] = ctx->output_frame->channels.u_16[j];
+
+    for(i = 0; i + 8 < num; i += 8)
+      {
+      for(j = 0; j < 8; j++)
+        r[j] = _mm_loadu_si128((const __m128i*)(src + num_channels * (i + j)));
+      transpose_8x8_16(r);
+      for(j = 0; j < num_channels; j++)
+        _mm_storeu_si128((__m128i*)(dst[j] + i), r[j]);
+      }
+    }
+
+  for(; i < num; i++)
+    {
+    for(j = 0; j < num_channels; j++)
+      ctx->output_frame->channels.u_16[j][i] = src[num_channels * i + j];
+    }
+  }
+
+/* 32 bit. The samples are moved through float registers */
+
+static void interleave_none_to_all_stereo_32(gavl_audio_convert_context_t * ctx)
+  {
+  int i;
+  __m128 l, r;
+  const float * src1 = ctx->input_frame->channels.f[0];
+  const float * src2 = ctx->input_frame->channels.f[1];
+  float * dst = ctx->output_frame->samples.f;
+  int num = ctx->input_frame->valid_samples;
+
+  for(i = 0; i + 4 <= num; i += 4)
+    {
+    l = _mm_loadu_ps(src1 + i);
+    r = _mm_loadu_ps(src2 + i);
+    _mm_storeu_ps(dst + 2 * i, _mm_unpacklo_ps(l, r));
+    _mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+  for(; i < num; i++)
+    {
+    dst[2*i]   = src1[i];
+    dst[2*i+1] = src2[i];
+    }
+  }
+
+static void interleave_all_to_none_stereo_32(gavl_audio_convert_context_t * ctx)
+  {
+  int i;
+  __m128 v1, v2;
+  const float * src = ctx->input_frame->samples.f;
+  float * dst1 = ctx->output_frame->channels.f[0];
+  float * dst2 = ctx->output_frame->channels.f[1];
+  int num = ctx->input_frame->valid_samples;
+
+  for(i = 0; i + 4 <= num; i += 4)
+    {
+    v1 = _mm_loadu_ps(src + 2 * i);
+    v2 = _mm_loadu_ps(src + 2 * i + 4);
+    _mm_storeu_ps(dst1 + i, _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(dst2 + i, _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+  for(; i < num; i++)
+    {
+    dst1[i] = src[2*i];
+    dst2[i] = src[2*i+1];
+    }
+  }
+
+/* 5.1 and 7.1 in blocks of 4 samples */
+
+static void interleave_none_to_all_32(gavl_audio_convert_context_t * ctx)
+  {
+  int i, j;
+  __m128 r0, r1, r2, r3, r4, r5, r6, r7;
+  const float * const * src = (const float * const *)ctx->input_frame->channels.f;
+  float * dst = ctx->output_frame->samples.f;
+  int num = ctx->input_frame->valid_samples;
+  int num_channels = ctx->input_format.num_channels;
+
+  i = 0;
+
+  if(num_channels == 8)
+    {
+    for(; i + 4 <= num; i += 4)
+      {
+      r0 = _mm_loadu_ps(src[0] + i);
+      r1 = _mm_loadu_ps(src[1] + i);
+      r2 = _mm_loadu_ps(src[2] + i);
+      r3 = _mm_loadu_ps(src[3] + i);
+      r4 = _mm_loadu_ps(src[4] + i);
+      r5 = _mm_loadu_ps(src[5] + i);
+      r6 = _mm_loadu_ps(src[6] + i);
+      r7 = _mm_loadu_ps(src[7] + i);
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+      _MM_TRANSPOSE4_PS(r4, r5, r6, r7);
+      _mm_storeu_ps(dst + 8 * i,      r0);
+      _mm_storeu_ps(dst + 8 * i + 4,  r4);
+      _mm_storeu_ps(dst + 8 * i + 8,  r1);
+      _mm_storeu_ps(dst + 8 * i + 12, r5);
+      _mm_storeu_ps(dst + 8 * i + 16, r2);
+      _mm_storeu_ps(dst + 8 * i + 20, r6);
+      _mm_storeu_ps(dst + 8 * i + 24, r3);
+      _mm_storeu_ps(dst + 8 * i + 28, r7);
+      }
+    }
+  else if(num_channels == 6)
+    {
+    for(; i + 4 <= num; i += 4)
+      {
+      r0 = _mm_loadu_ps(src[0] + i);
+      r1 = _mm_loadu_ps(src[1] + i);
+      r2 = _mm_loadu_ps(src[2] + i);
+      r3 = _mm_loadu_ps(src[3] + i);
+      r4 = _mm_loadu_ps(src[4] + i);
+      r5 = _mm_loadu_ps(src[5] + i);
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+      r6 = _mm_unpacklo_ps(r4, r5);
+      r7 = _mm_unpackhi_ps(r4, r5);
+      _mm_storeu_ps(dst + 6 * i,      r0);
+      _mm_storel_pi((__m64*)(dst + 6 * i + 4),  r6);
+      _mm_storeu_ps(dst + 6 * i + 6,  r1);
+      _mm_storeh_pi((__m64*)(dst + 6 * i + 10), r6);
+      _mm_storeu_ps(dst + 6 * i + 12, r2);
+      _mm_storel_pi((__m64*)(dst + 6 * i + 16), r7);
+      _mm_storeu_ps(dst + 6 * i + 18, r3);
+      _mm_storeh_pi((__m64*)(dst + 6 * i + 22), r7);
+      }
+    }
+
+  for(; i < num; i++)
+    {
+    for(j = 0; j < num_channels; j++)
+      ctx->output_frame->samples.u_32[num_channels * i + j] =
+        ctx->input_frame->channels.u_32[j][i];
+    }
+  }
+
+static void interleave_all_to_none_32(gavl_audio_convert_context_t * ctx)
+  {
+  int i, j;
+  __m128 r0, r1, r2, r3, r4, r5, r6, r7;
+  const float * src = ctx->input_frame->samples.f;
+  float * const * dst = ctx->output_frame->channels.f;
+  int num = ctx->input_frame->valid_samples;
+  int num_channels = ctx->input_format.num_channels;
+
+  i = 0;
+
+  if(num_channels == 8)
+    {
+    for(; i + 4 <= num; i += 4)
+      {
+      r0 = _mm_loadu_ps(src + 8 * i);
+      r4 = _mm_loadu_ps(src + 8 * i + 4);
+      r1 = _mm_loadu_ps(src + 8 * i + 8);
+      r5 = _mm_loadu_ps(src + 8 * i + 12);
+      r2 = _mm_loadu_ps(src + 8 * i + 16);
+      r6 = _mm_loadu_ps(src + 8 * i + 20);
+      r3 = _mm_loadu_ps(src + 8 * i + 24);
+      r7 = _mm_loadu_ps(src + 8 * i + 28);
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+      _MM_TRANSPOSE4_PS(r4, r5, r6, r7);
+      _mm_storeu_ps(dst[0] + i, r0);
+      _mm_storeu_ps(dst[1] + i, r1);
+      _mm_storeu_ps(dst[2] + i, r2);
+      _mm_storeu_ps(dst[3] + i, r3);
+      _mm_storeu_ps(dst[4] + i, r4);
+      _mm_storeu_ps(dst[5] + i, r5);
+      _mm_storeu_ps(dst[6] + i, r6);
+      _mm_storeu_ps(dst[7] + i, r7);
+      }
+    }
+  else if(num_channels == 6)
+    {
+    for(; i + 4 <= num; i += 4)
+      {
+      r0 = _mm_loadu_ps(src + 6 * i);
+      r1 = _mm_loadu_ps(src + 6 * i + 6);
+      r2 = _mm_loadu_ps(src + 6 * i + 12);
+      r3 = _mm_loadu_ps(src + 6 * i + 18);
+      r6 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(src + 6 * i + 4)),
+                        (const __m64*)(src + 6 * i + 10));
+      r7 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(src + 6 * i + 16)),
+                        (const __m64*)(src + 6 * i + 22));
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+      r4 = _mm_shuffle_ps(r6, r7, _MM_SHUFFLE(2, 0, 2, 0));
+      r5 = _mm_shuffle_ps(r6, r7, _MM_SHUFFLE(3, 1, 3, 1));
+      _mm_storeu_ps(dst[0] + i, r0);
+      _mm_storeu_ps(dst[1] + i, r1);
+      _mm_storeu_ps(dst[2] + i, r2);
+      _mm_storeu_ps(dst[3] + i, r3);
+      _mm_storeu_ps(dst[4] + i, r4);
+      _mm_storeu_ps(dst[5] + i, r5);
+      }
+    }
+
+  for(; i < num; i++)
+    {
+    for(j = 0; j < num_channels; j++)
+      ctx->output_frame->channels.u_32[j][i] =
+        ctx->input_frame->samples.u_32[num_channels * i + j];
+    }
+  }
+
+/* 64 bit */
+
+static void interleave_none_to_all_stereo_64(gavl_audio_convert_context_t * ctx)
+  {
+  int i;
+  __m128d l, r;
+  const double * src1 = ctx->input_frame->channels.d[0];
+  const double * src2 = ctx->input_frame->channels.d[1];
+  double * dst = ctx->output_frame->samples.d;
+  int num = ctx->input_frame->valid_samples;
+
+  for(i = 0; i + 2 <= num; i += 2)
+    {
+    l = _mm_loadu_pd(src1 + i);
+    r = _mm_loadu_pd(src2 + i);
+    _mm_storeu_pd(dst + 2 * i, _mm_unpacklo_pd(l, r));
+    _mm_storeu_pd(dst + 2 * i + 2, _mm_unpackhi_pd(l, r));
+    }
+  for(; i < num; i++)
+    {
+    dst[2*i]   = src1[i];
+    dst[2*i+1] = src2[i];
+    }
+  }
+
+static void interleave_all_to_none_stereo_64(gavl_audio_convert_context_t * ctx)
+  {
+  int i;
+  __m128d v1, v2;
+  const double * src = ctx->input_frame->samples.d;
+  double * dst1 = ctx->output_frame->channels.d[0];
+  double * dst2 = ctx->output_frame->channels.d[1];
+  int num = ctx->input_frame->valid_samples;
+
+  for(i = 0; i + 2 <= num; i += 2)
+    {
+    v1 = _mm_loadu_pd(src + 2 * i);
+    v2 = _mm_loadu_pd(src + 2 * i + 2);
+    _mm_storeu_pd(dst1 + i, _mm_unpacklo_pd(v1, v2));
+    _mm_storeu_pd(dst2 + i, _mm_unpackhi_pd(v1, v2));
+    }
+  for(; i < num; i++)
+    {
+    dst1[i] = src[2*i];
+    dst2[i] = src[2*i+1];
+    }
+  }
+
+void gavl_init_interleave_funcs_sse2(gavl_interleave_table_t * t)
+  {
+  t->interleave_none_to_all_16        = interleave_none_to_all_16;
+  t->interleave_none_to_all_stereo_16 = interleave_none_to_all_stereo_16;
+  t->interleave_all_to_none_16        = interleave_all_to_none_16;
+  t->interleave_all_to_none_stereo_16 = interleave_all_to_none_stereo_16;
+
+  t->interleave_none_to_all_32        = interleave_none_to_all_32;
+  t->interleave_none_to_all_stereo_32 = interleave_none_to_all_stereo_32;
+  t->interleave_all_to_none_32        = interleave_all_to_none_32;
+  t->interleave_all_to_none_stereo_32 = interleave_all_to_none_stereo_32;
+
+  t->interleave_none_to_all_stereo_64 = interleave_none_to_all_stereo_64;
+  t->interleave_all_to_none_stereo_64 = interleave_all_to_none_stereo_64;
+  }
@@ -0,0 +1,344 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <audio.h>
+#include <mix.h>
+
+#include <emmintrin.h>
+
+/*
+ *  SSE2 mixers. The integer versions are identical to the C ones,
+ *  float results can differ in the last bits because of the summation
+ *  order. 16 bit samples of 2 inputs are interleaved and multiplied
+ *  at once with pmaddwd.
+ */
+
+#define CLAMP(x,a,b) if(x<a)x=a;if(x>b)x=b;
+
+/* Divide by 0x10000 rounding towards zero like the C version */
+
+static inline __m128i div_16(__m128i x)
+  {
+  return _mm_srai_epi32(_mm_add_epi32(x, _mm_srli_epi32(_mm_srai_epi32(x, 31), 16)), 16);
+  }
+
+static inline __m128i factor_pair(int f1, int f2)
+  {
+  return _mm_set1_epi32((int)(((uint32_t)f2 << 16) | (uint16_t)f1));
+  }
+
+static inline void store_float(float * dst, __m128 acc)
+  {
+  _mm_storeu_ps(dst, _mm_min_ps(_mm_max_ps(acc, _mm_set1_ps(-1.0f)),
+                                _mm_set1_ps(1.0f)));
+  }
+
+/* Single output channel */
+
+static void mix_float_sse2(gavl_mix_output_channel_t * channel,
+                           const gavl_audio_frame_t * input_frame,
+                           gavl_audio_frame_t * output_frame)
+  {
+  int i, j;
+  float tmp;
+  const float * src[GAVL_MAX_CHANNELS];
+  float fac[GAVL_MAX_CHANNELS];
+  __m128 acc0, acc1, f;
+  int num = input_frame->valid_samples;
+  float * dst = output_frame->channels.f[channel->index];
+
+  for(j = 0; j < channel->num_inputs; j++)
+    {
+    src[j] = input_frame->channels.f[channel->inputs[j].index];
+    fac[j] = channel->inputs[j].factor.f_float;
+    }
+
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    f = _mm_set1_ps(fac[0]);
+    acc0 = _mm_mul_ps(_mm_loadu_ps(src[0] + i), f);
+    acc1 = _mm_mul_ps(_mm_loadu_ps(src[0] + i + 4), f);
+
+    for(j = 1; j < channel->num_inputs; j++)
+      {
+      f = _mm_set1_ps(fac[j]);
+      acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(src[j] + i), f));
+      acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(src[j] + i + 4), f));
+      }
+    store_float(dst + i, acc0);
+    store_float(dst + i + 4, acc1);
+    }
+
+  for(; i < num; i++)
+    {
+    tmp = src[0][i] * fac[0];
+    for(j = 1; j < channel->num_inputs; j++)
+      tmp += src[j][i] * fac[j];
+    CLAMP(tmp, -1.0f, 1.0f);
+    dst[i] = tmp;
+    }
+  }
+
+static void mix_s16_sse2(gavl_mix_output_channel_t * channel,
+                         const gavl_audio_frame_t * input_frame,
+                         gavl_audio_frame_t * output_frame)
+  {
+  int i, j, tmp, num_pairs;
+  const int16_t * src[GAVL_MAX_CHANNELS+1];
+  int fac[GAVL_MAX_CHANNELS+1];
+  __m128i f[GAVL_MAX_CHANNELS/2+1];
+  __m128i a, b, lo, hi;
+  int num = input_frame->valid_samples;
+  int16_t * dst = output_frame->channels.s_16[channel->index];
+
+  for(j = 0; j < channel->num_inputs; j++)
+    {
+    src[j] = input_frame->channels.s_16[channel->inputs[j].index];
+    fac[j] = channel->inputs[j].factor.f_int;
+    }
+
+  /* Odd number of inputs: Pad with a zero factor */
+  src[j] = src[0];
+  fac[j] = 0;
+
+  num_pairs = (channel->num_inputs + 1) / 2;
+
+  for(j = 0; j < num_pairs; j++)
+    f[j] = factor_pair(fac[2*j], fac[2*j+1]);
+
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    lo = _mm_setzero_si128();
+    hi = _mm_setzero_si128();
+
+    for(j = 0; j < num_pairs; j++)
+      {
+      a = _mm_loadu_si128((const __m128i*)(src[2*j] + i));
+      b = _mm_loadu_si128((const __m128i*)(src[2*j+1] + i));
+      lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), f[j]));
+      hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), f[j]));
+      }
+    _mm_storeu_si128((__m128i*)(dst + i),
+                     _mm_packs_epi32(div_16(lo), div_16(hi)));
+    }
+
+  for(; i < num; i++)
+    {
+    tmp = 0;
+    for(j = 0; j < channel->num_inputs; j++)
+      tmp += src[j][i] * fac[j];
+    tmp /= 0x10000;
+    CLAMP(tmp, INT16_MIN, INT16_MAX);
+    dst[i] = tmp;
+    }
+  }
+
+/* Several output channels */
+
+static void mix_group_float_sse2(const gavl_mix_group_t * g,
+                                 const gavl_audio_frame_t * input_frame,
+                                 gavl_audio_frame_t * output_frame)
+  {
+  int i, j, o;
+  float tmp;
+  const float * src[GAVL_MAX_CHANNELS+1];
+  float * dst[GAVL_MIX_GROUP_SIZE];
+  __m128 a0, a1, a2, a3, b0, b1, b2, b3;
+  __m128 f0, f1, f2, f3, v;
+  int num = input_frame->valid_samples;
+
+  for(j = 0; j < g->num_inputs; j++)
+    src[j] = input_frame->channels.f[g->inputs[j]];
+  for(o = 0; o < g->num_outputs; o++)
+    dst[o] = output_frame->channels.f[g->outputs[o]];
+
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    a0 = a1 = a2 = a3 = _mm_setzero_ps();
+    b0 = b1 = b2 = b3 = _mm_setzero_ps();
+
+    for(j = 0; j < g->num_inputs; j++)
+      {
+      f0 = _mm_load1_ps(&g->factors.f_float[j][0]);
+      f1 = _mm_load1_ps(&g->factors.f_float[j][1]);
+      f2 = _mm_load1_ps(&g->factors.f_float[j][2]);
+      f3 = _mm_load1_ps(&g->factors.f_float[j][3]);
+
+      v = _mm_loadu_ps(src[j] + i);
+      a0 = _mm_add_ps(a0, _mm_mul_ps(v, f0));
+      a1 = _mm_add_ps(a1, _mm_mul_ps(v, f1));
+      a2 = _mm_add_ps(a2, _mm_mul_ps(v, f2));
+      a3 = _mm_add_ps(a3, _mm_mul_ps(v, f3));
+
+      v = _mm_loadu_ps(src[j] + i + 4);
+      b0 = _mm_add_ps(b0, _mm_mul_ps(v, f0));
+      b1 = _mm_add_ps(b1, _mm_mul_ps(v, f1));
+      b2 = _mm_add_ps(b2, _mm_mul_ps(v, f2));
+      b3 = _mm_add_ps(b3, _mm_mul_ps(v, f3));
+      }
+
+    switch(g->num_outputs)
+      {
+      case 4:
+        store_float(dst[3] + i, a3);
+        store_float(dst[3] + i + 4, b3);
+        /* Fall through */
+      case 3:
+        store_float(dst[2] + i, a2);
+        store_float(dst[2] + i + 4, b2);
+        /* Fall through */
+      case 2:
+        store_float(dst[1] + i, a1);
+        store_float(dst[1] + i + 4, b1);
+        /* Fall through */
+      case 1:
+        store_float(dst[0] + i, a0);
+        store_float(dst[0] + i + 4, b0);
+      }
+    }
+
+  for(; i < num; i++)
+    {
+    for(o = 0; o < g->num_outputs; o++)
+      {
+      tmp = 0.0;
+      for(j = 0; j < g->num_inputs; j++)
+        tmp += src[j][i] * g->factors.f_float[j][o];
+      CLAMP(tmp, -1.0f, 1.0f);
+      dst[o][i] = tmp;
+      }
+    }
+  }
+
+static void mix_group_s16_sse2(const gavl_mix_group_t * g,
+                               const gavl_audio_frame_t * input_frame,
+                               gavl_audio_frame_t * output_frame)
+  {
+  int i, j, o, tmp;
+  const int16_t * src[GAVL_MAX_CHANNELS+1];
+  int16_t * dst[GAVL_MIX_GROUP_SIZE];
+  __m128i f[GAVL_MAX_CHANNELS/2+1][GAVL_MIX_GROUP_SIZE];
+  __m128i lo0, lo1, lo2, lo3, hi0, hi1, hi2, hi3;
+  __m128i a, b, ab;
+  int num = input_frame->valid_samples;
+
+  for(j = 0; j < g->num_inputs; j++)
+    src[j] = input_frame->channels.s_16[g->inputs[j]];
+
+  for(j = 0; j < g->num_inputs / 2; j++)
+    {
+    for(o = 0; o < GAVL_MIX_GROUP_SIZE; o++)
+      f[j][o] = factor_pair(g->factors.f_int[2*j][o],
+                            g->factors.f_int[2*j+1][o]);
+    }
+  for(o = 0; o < g->num_outputs; o++)
+    dst[o] = output_frame->channels.s_16[g->outputs[o]];
+
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    lo0 = lo1 = lo2 = lo3 = _mm_setzero_si128();
+    hi0 = hi1 = hi2 = hi3 = _mm_setzero_si128();
+
+    for(j = 0; j < g->num_inputs / 2; j++)
+      {
+      a = _mm_loadu_si128((const __m128i*)(src[2*j] + i));
+      b = _mm_loadu_si128((const __m128i*)(src[2*j+1] + i));
+
+      ab = _mm_unpacklo_epi16(a, b);
+      lo0 = _mm_add_epi32(lo0, _mm_madd_epi16(ab, f[j][0]));
+      lo1 = _mm_add_epi32(lo1, _mm_madd_epi16(ab, f[j][1]));
+      lo2 = _mm_add_epi32(lo2, _mm_madd_epi16(ab, f[j][2]));
+      lo3 = _mm_add_epi32(lo3, _mm_madd_epi16(ab, f[j][3]));
+
+      ab = _mm_unpackhi_epi16(a, b);
+      hi0 = _mm_add_epi32(hi0, _mm_madd_epi16(ab, f[j][0]));
+      hi1 = _mm_add_epi32(hi1, _mm_madd_epi16(ab, f[j][1]));
+      hi2 = _mm_add_epi32(hi2, _mm_madd_epi16(ab, f[j][2]));
+      hi3 = _mm_add_epi32(hi3, _mm_madd_epi16(ab, f[j][3]));
+      }
+
+    switch(g->num_outputs)
+      {
+      case 4:
+        _mm_storeu_si128((__m128i*)(dst[3] + i),
+                         _mm_packs_epi32(div_16(lo3), div_16(hi3)));
+        /* Fall through */
+      case 3:
+        _mm_storeu_si128((__m128i*)(dst[2] + i),
+                         _mm_packs_epi32(div_16(lo2), div_16(hi2)));
+        /* Fall through */
+      case 2:
+        _mm_storeu_si128((__m128i*)(dst[1] + i),
+                         _mm_packs_epi32(div_16(lo1), div_16(hi1)));
+        /* Fall through */
+      case 1:
+        _mm_storeu_si128((__m128i*)(dst[0] + i),
+                         _mm_packs_epi32(div_16(lo0), div_16(hi0)));
+      }
+    }
+
+  for(; i < num; i++)
+    {
+    for(o = 0; o < g->num_outputs; o++)
+      {
+      tmp = 0;
+      for(j = 0; j < g->num_inputs; j++)
+        tmp += src[j][i] * g->factors.f_int[j][o];
+      tmp /= 0x10000;
+      CLAMP(tmp, INT16_MIN, INT16_MAX);
+      dst[o][i] = tmp;
+      }
+    }
+  }
+
+void gavl_setup_mix_funcs_sse2(gavl_mixer_table_t * t,
+                               gavl_audio_format_t * f)
+  {
+  switch(f->sample_format)
+    {
+    case GAVL_SAMPLE_S16:
+      t->mix_1_to_1 = mix_s16_sse2;
+      t->mix_2_to_1 = mix_s16_sse2;
+      t->mix_3_to_1 = mix_s16_sse2;
+      t->mix_4_to_1 = mix_s16_sse2;
+      t->mix_5_to_1 = mix_s16_sse2;
+      t->mix_6_to_1 = mix_s16_sse2;
+      t->mix_all_to_1 = mix_s16_sse2;
+      t->mix_group = mix_group_s16_sse2;
+      t->factors_16 = 1;
+      break;
+    case GAVL_SAMPLE_FLOAT:
+      t->mix_1_to_1 = mix_float_sse2;
+      t->mix_2_to_1 = mix_float_sse2;
+      t->mix_3_to_1 = mix_float_sse2;
+      t->mix_4_to_1 = mix_float_sse2;
+      t->mix_5_to_1 = mix_float_sse2;
+      t->mix_6_to_1 = mix_float_sse2;
+      t->mix_all_to_1 = mix_float_sse2;
+      t->mix_group = mix_group_float_sse2;
+      break;
+    default:
+      break;
+    }
+  }
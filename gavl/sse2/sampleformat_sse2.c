@@ -0,0 +1,270 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <math.h>
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <audio.h>
+#include <sampleformat.h>
+
+#include <emmintrin.h>
+
+/*
+ *  SSE2 sampleformat converters. The results are identical to the C
+ *  versions: Scaling is by powers of 2 and the float -> int conversions
+ *  round to nearest even like lrintf().
+ */
+
+#define CLAMP(i, min, max) if(i<min)i=min;if(i>max)i=max;
+
+/* Conversions of arrays */
+
+static void s16_to_float(const int16_t * src, float * dst, int num)
+  {
+  int i;
+  __m128i v, sign;
+  const __m128 fac = _mm_set1_ps(1.0 / 32768.0);
+
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    v = _mm_loadu_si128((const __m128i*)(src + i));
+    sign = _mm_srai_epi16(v, 15);
+    _mm_storeu_ps(dst + i,
+                  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, sign)), fac));
+    _mm_storeu_ps(dst + i + 4,
+                  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, sign)), fac));
+    }
+  for(; i < num; i++)
+    dst[i] = (float)src[i] / 32768.0;
+  }
+
+/* Clip in float, the rounding of the limits doesn't change them */
+
+static inline __m128i float_to_s16_4(__m128 x)
+  {
+  x = _mm_mul_ps(x, _mm_set1_ps(32768.0));
+  x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-32768.0)), _mm_set1_ps(32767.0));
+  return _mm_cvtps_epi32(x);
+  }
+
+static void float_to_s16(const float * src, int16_t * dst, int num)
+  {
+  int i;
+  long tmp;
+
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    _mm_storeu_si128((__m128i*)(dst + i),
+                     _mm_packs_epi32(float_to_s16_4(_mm_loadu_ps(src + i)),
+                                     float_to_s16_4(_mm_loadu_ps(src + i + 4))));
+    }
+  for(; i < num; i++)
+    {
+    tmp = lrintf(src[i] * 32768.0);
+    CLAMP(tmp, -32768, 32767);
+    dst[i] = tmp;
+    }
+  }
+
+static void s32_to_float(const int32_t * src, float * dst, int num)
+  {
+  int i;
+  const __m128 fac = _mm_set1_ps(1.0 / 2147483648.0);
+
+  for(i = 0; i + 4 <= num; i += 4)
+    _mm_storeu_ps(dst + i,
+                  _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(src + i))), fac));
+  for(; i < num; i++)
+    dst[i] = (float)src[i] / 2147483648.0;
+  }
+
+/*
+ *  cvtps2dq returns 0x80000000 for values out of range. This is correct
+ *  for negative overflows, positive overflows are flipped to 0x7fffffff.
+ */
+
+static void float_to_s32(const float * src, int32_t * dst, int num)
+  {
+  int i;
+  int64_t tmp;
+  __m128 x;
+  const __m128 fac = _mm_set1_ps(2147483648.0);
+  
+  for(i = 0; i + 4 <= num; i += 4)
+    {
+    x = _mm_mul_ps(_mm_loadu_ps(src + i), fac);
+    _mm_storeu_si128((__m128i*)(dst + i),
+                     _mm_xor_si128(_mm_cvtps_epi32(x),
+                                   _mm_castps_si128(_mm_cmpge_ps(x, fac))));
+    }
+  for(; i < num; i++)
+    {
+    tmp = llrintf(src[i] * 2147483648.0);
+    CLAMP(tmp, -2147483648LL, 2147483647LL);
+    dst[i] = tmp;
+    }
+  }
+
+static void float_to_double(const float * src, double * dst, int num)
+  {
+  int i;
+  __m128 x;
+
+  for(i = 0; i + 4 <= num; i += 4)
+    {
+    x = _mm_loadu_ps(src + i);
+    _mm_storeu_pd(dst + i, _mm_cvtps_pd(x));
+    _mm_storeu_pd(dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(x, x)));
+    }
+  for(; i < num; i++)
+    dst[i] = src[i];
+  }
+
+static void double_to_float(const double * src, float * dst, int num)
+  {
+  int i;
+
+  for(i = 0; i + 4 <= num; i += 4)
+    {
+    _mm_storeu_ps(dst + i,
+                  _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(src + i)),
+                                _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2))));
+    }
+  for(; i < num; i++)
+    dst[i] = src[i];
+  }
+
+/* Conversion functions for non interleaved and interleaved frames */
+
+#define CONVERT_FUNCS(name, src_type, dst_type)                        \
+static void name##_ni(gavl_audio_convert_context_t * ctx)              \
+  {                                                                     \
+  int i;                                                                \
+  for(i = 0; i < ctx->input_format.num_channels; i++)                   \
+    name(ctx->input_frame->channels.src_type[i],                        \
+         ctx->output_frame->channels.dst_type[i],                       \
+         ctx->input_frame->valid_samples);                              \
+  }                                                                     \
+                                                                        \
+static void name##_i(gavl_audio_convert_context_t * ctx)               \
+  {                                                                     \
+  name(ctx->input_frame->samples.src_type,                              \
+       ctx->output_frame->samples.dst_type,                             \
+       ctx->input_format.num_channels * ctx->input_frame->valid_samples); \
+  }
+
+CONVERT_FUNCS(s16_to_float, s_16, f)
+CONVERT_FUNCS(float_to_s16, f, s_16)
+CONVERT_FUNCS(s32_to_float, s_32, f)
+CONVERT_FUNCS(float_to_s32, f, s_32)
+CONVERT_FUNCS(float_to_double, f, d)
+CONVERT_FUNCS(double_to_float, d, f)
+
+/* Conversion and interleaving in one pass */
+
+static void convert_s16_i_to_float_ni_stereo(gavl_audio_convert_context_t * ctx)
+  {
+  int i;
+  __m128i v;
+  const __m128 fac = _mm_set1_ps(1.0 / 32768.0);
+  const int16_t * src = ctx->input_frame->samples.s_16;
+  float * dst1 = ctx->output_frame->channels.f[0];
+  float * dst2 = ctx->output_frame->channels.f[1];
+  int num = ctx->input_frame->valid_samples;
+
+  /* Each 32 bit element is one stereo sample */
+  for(i = 0; i + 4 <= num; i += 4)
+    {
+    v = _mm_loadu_si128((const __m128i*)(src + 2 * i));
+    _mm_storeu_ps(dst1 + i,
+                  _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(v, 16), 16)), fac));
+    _mm_storeu_ps(dst2 + i,
+                  _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(v, 16)), fac));
+    }
+  for(; i < num; i++)
+    {
+    dst1[i] = (float)src[2*i] / 32768.0;
+    dst2[i] = (float)src[2*i+1] / 32768.0;
+    }
+  }
+
+static void convert_float_ni_to_s16_i_stereo(gavl_audio_convert_context_t * ctx)
+  {
+  int i;
+  long tmp;
+  __m128i l, r;
+  const float * src1 = ctx->input_frame->channels.f[0];
+  const float * src2 = ctx->input_frame->channels.f[1];
+  int16_t * dst = ctx->output_frame->samples.s_16;
+  int num = ctx->input_frame->valid_samples;
+
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    l = _mm_packs_epi32(float_to_s16_4(_mm_loadu_ps(src1 + i)),
+                        float_to_s16_4(_mm_loadu_ps(src1 + i + 4)));
+    r = _mm_packs_epi32(float_to_s16_4(_mm_loadu_ps(src2 + i)),
+                        float_to_s16_4(_mm_loadu_ps(src2 + i + 4)));
+    _mm_storeu_si128((__m128i*)(dst + 2 * i), _mm_unpacklo_epi16(l, r));
+    _mm_storeu_si128((__m128i*)(dst + 2 * i + 8), _mm_unpackhi_epi16(l, r));
+    }
+  for(; i < num; i++)
+    {
+    tmp = lrintf(src1[i] * 32768.0);
+    CLAMP(tmp, -32768, 32767);
+    dst[2*i] = tmp;
+    tmp = lrintf(src2[i] * 32768.0);
+    CLAMP(tmp, -32768, 32767);
+    dst[2*i+1] = tmp;
+    }
+  }
+
+void gavl_init_sampleformat_funcs_sse2(gavl_sampleformat_table_t * t,
+                                       gavl_interleave_mode_t interleave_mode)
+  {
+  if(interleave_mode == GAVL_INTERLEAVE_NONE)
+    {
+    t->convert_s16_to_float    = s16_to_float_ni;
+    t->convert_float_to_s16    = float_to_s16_ni;
+    t->convert_s32_to_float    = s32_to_float_ni;
+    t->convert_float_to_s32    = float_to_s32_ni;
+    t->convert_float_to_double = float_to_double_ni;
+    t->convert_double_to_float = double_to_float_ni;
+    }
+  else if(interleave_mode == GAVL_INTERLEAVE_ALL)
+    {
+    t->convert_s16_to_float    = s16_to_float_i;
+    t->convert_float_to_s16    = float_to_s16_i;
+    t->convert_s32_to_float    = s32_to_float_i;
+    t->convert_float_to_s32    = float_to_s32_i;
+    t->convert_float_to_double = float_to_double_i;
+    t->convert_double_to_float = double_to_float_i;
+    }
+  
+  t->convert_s16_i_to_float_ni_stereo = convert_s16_i_to_float_ni_stereo;
+  t->convert_float_ni_to_s16_i_stereo = convert_float_ni_to_s16_i_stereo;
+
+  /* For other channel numbers, separate SIMD conversion and
+     interleaving passes are faster than the fused C versions */
+  t->convert_s16_i_to_float_ni = NULL;
+  t->convert_float_ni_to_s16_i = NULL;
+  }
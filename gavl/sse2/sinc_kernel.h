@@ -0,0 +1,95 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/*
+ *  SSE2 sinc kernel (see include/sinc.h). Needs FUNC_NAME, DATA_TYPE and
+ *  LOAD_DATA(data, stride), which returns data[0] and data[stride] as __m128d
+ */
+
+double FUNC_NAME(const double * coeffs, const DATA_TYPE * data,
+                 int stride, int32_t filter_index,
+                 int32_t increment, int count)
+  {
+  int k;
+  int32_t idx[4];
+  double sum[GAVL_SINC_LANES];
+  __m128i fi, fi_step, frac_mask;
+  __m128d sum_01, sum_23, inv, frac_01, frac_23, p0, p1, c0, c1, icoeff;
+  
+  sum_01 = _mm_setzero_pd();
+  sum_23 = _mm_setzero_pd();
+  inv = _mm_set1_pd(1.0 / (double)(1 << GAVL_SINC_SHIFT_BITS));
+  frac_mask = _mm_set1_epi32((1 << GAVL_SINC_SHIFT_BITS) - 1);
+  
+  fi = _mm_setr_epi32(filter_index, filter_index - increment,
+                      filter_index - 2 * increment, filter_index - 3 * increment);
+  fi_step = _mm_set1_epi32(GAVL_SINC_LANES * increment);
+  
+  for(k = 0; k + GAVL_SINC_LANES <= count; k += GAVL_SINC_LANES)
+    {
+    _mm_storeu_si128((__m128i*)idx, _mm_srai_epi32(fi, GAVL_SINC_SHIFT_BITS));
+
+    frac_01 = _mm_mul_pd(_mm_cvtepi32_pd(_mm_and_si128(fi, frac_mask)), inv);
+    frac_23 = _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(_mm_and_si128(fi, frac_mask), 8)), inv);
+
+    /* Taps 0 and 1 */
+    p0 = _mm_loadu_pd(coeffs + idx[0]);
+    p1 = _mm_loadu_pd(coeffs + idx[1]);
+    c0 = _mm_unpacklo_pd(p0, p1);
+    c1 = _mm_unpackhi_pd(p0, p1);
+    icoeff = _mm_add_pd(c0, _mm_mul_pd(frac_01, _mm_sub_pd(c1, c0)));
+    sum_01 = _mm_add_pd(sum_01, _mm_mul_pd(icoeff, LOAD_DATA(data, stride)));
+    
+    /* Taps 2 and 3 */
+    p0 = _mm_loadu_pd(coeffs + idx[2]);
+    p1 = _mm_loadu_pd(coeffs + idx[3]);
+    c0 = _mm_unpacklo_pd(p0, p1);
+    c1 = _mm_unpackhi_pd(p0, p1);
+    icoeff = _mm_add_pd(c0, _mm_mul_pd(frac_23, _mm_sub_pd(c1, c0)));
+    sum_23 = _mm_add_pd(sum_23, _mm_mul_pd(icoeff, LOAD_DATA(data + 2 * stride, stride)));
+
+    fi = _mm_sub_epi32(fi, fi_step);
+    data += GAVL_SINC_LANES * stride;
+    filter_index -= GAVL_SINC_LANES * increment;
+    }
+
+  _mm_storeu_pd(sum, sum_01);
+  _mm_storeu_pd(sum + 2, sum_23);
+
+  /* Remaining taps */
+  for(; k < count; k++)
+    {
+    double fraction = (filter_index & ((1 << GAVL_SINC_SHIFT_BITS) - 1)) *
+      (1.0 / (double)(1 << GAVL_SINC_SHIFT_BITS));
+    int indx = filter_index >> GAVL_SINC_SHIFT_BITS;
+    
+    sum[k % GAVL_SINC_LANES] +=
+      (coeffs[indx] + fraction * (coeffs[indx + 1] - coeffs[indx])) * data[0];
+    
+    filter_index -= increment;
+    data += stride;
+    }
+  return (sum[0] + sum[2]) + (sum[1] + sum[3]);
+  }
+
+#undef FUNC_NAME
+#undef DATA_TYPE
+#undef LOAD_DATA
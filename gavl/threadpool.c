@@ -0,0 +1,397 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <stdlib.h>
+#include <pthread.h>
+
+#include <gavl.h>
+#include <threadpool.h>
+
+/* Tiles per thread: More tiles mean better load balancing but more
+   locking overhead */
+
+#define TILES_PER_THREAD 8
+
+/* Tile queue of one thread. The owner takes tiles from the head,
+   other threads steal them from the tail */
+
+typedef struct
+  {
+  pthread_mutex_t mutex;
+  int head;
+  int tail;
+  } tile_queue_t;
+
+typedef struct
+  {
+  pthread_t thread;
+  int index;
+  int job_id;        /* Last job seen by this thread */
+  struct pool_s * p;
+  } worker_t;
+
+typedef struct pool_s
+  {
+  pthread_mutex_t mutex;
+  pthread_cond_t start_cond;
+  pthread_cond_t done_cond;
+
+  /* Held while a job is running */
+  pthread_mutex_t job_mutex;
+
+  worker_t * workers;
+  int num_workers;
+  int workers_alloc;
+
+  tile_queue_t * queues;
+
+  /* Current job */
+  int job_id;
+  int job_threads;   /* Including the calling thread */
+  int job_running;   /* Number of workers still busy */
+
+  gavl_video_process_func func;
+  void * data;
+  int num;
+  int align;
+  int num_units;     /* num / align rounded up */
+  int num_tiles;
+
+  int quit;
+  } pool_t;
+
+static pool_t * pool = NULL;
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void run_tile(pool_t * p, int tile)
+  {
+  int start, end;
+
+  start = (int)(((int64_t)tile * p->num_units) / p->num_tiles) * p->align;
+  end = (int)(((int64_t)(tile+1) * p->num_units) / p->num_tiles) * p->align;
+
+  if(end > p->num)
+    end = p->num;
+
+  if(end > start)
+    p->func(p->data, start, end);
+  }
+
+static int get_tile(pool_t * p, int index)
+  {
+  int ret = -1;
+  int i, idx;
+  tile_queue_t * q;
+
+  /* Own queue */
+  q = &p->queues[index];
+  pthread_mutex_lock(&q->mutex);
+  if(q->head < q->tail)
+    ret = q->head++;
+  pthread_mutex_unlock(&q->mutex);
+
+  if(ret >= 0)
+    return ret;
+
+  /* Steal */
+  for(i = 1; i < p->job_threads; i++)
+    {
+    idx = (index + i) % p->job_threads;
+    q = &p->queues[idx];
+
+    pthread_mutex_lock(&q->mutex);
+    if(q->head < q->tail)
+      ret = --q->tail;
+    pthread_mutex_unlock(&q->mutex);
+
+    if(ret >= 0)
+      return ret;
+    }
+  return -1;
+  }
+
+static void do_work(pool_t * p, int index)
+  {
+  int tile;
+  while((tile = get_tile(p, index)) >= 0)
+    run_tile(p, tile);
+  }
+
+static void * worker_func(void * data)
+  {
+  worker_t * w = data;
+  pool_t * p = w->p;
+  int job_id = w->job_id;
+
+  pthread_mutex_lock(&p->mutex);
+
+  while(1)
+    {
+    while(!p->quit && (p->job_id == job_id))
+      pthread_cond_wait(&p->start_cond, &p->mutex);
+
+    if(p->quit)
+      break;
+
+    job_id = p->job_id;
+
+    /* Not needed for this job */
+    if(w->index >= p->job_threads)
+      continue;
+
+    pthread_mutex_unlock(&p->mutex);
+    do_work(p, w->index);
+    pthread_mutex_lock(&p->mutex);
+
+    p->job_running--;
+    if(!p->job_running)
+      pthread_cond_signal(&p->done_cond);
+    }
+  pthread_mutex_unlock(&p->mutex);
+  return NULL;
+  }
+
+static pool_t * pool_create()
+  {
+  pool_t * ret = calloc(1, sizeof(*ret));
+  pthread_mutex_init(&ret->mutex, NULL);
+  pthread_mutex_init(&ret->job_mutex, NULL);
+  pthread_cond_init(&ret->start_cond, NULL);
+  pthread_cond_init(&ret->done_cond, NULL);
+  return ret;
+  }
+
+/* Called with job_mutex held, i.e. the workers are idle */
+
+static void pool_grow(pool_t * p, int num_threads)
+  {
+  int i;
+
+  if(num_threads <= p->workers_alloc)
+    return;
+
+  /* Worker threads keep a pointer to their worker_t, so we need
+     to stop them before the array is moved */
+
+  pthread_mutex_lock(&p->mutex);
+  p->quit = 1;
+  pthread_cond_broadcast(&p->start_cond);
+  pthread_mutex_unlock(&p->mutex);
+
+  for(i = 0; i < p->num_workers; i++)
+    pthread_join(p->workers[i].thread, NULL);
+
+  for(i = 0; i < p->workers_alloc; i++)
+    pthread_mutex_destroy(&p->queues[i].mutex);
+
+  p->quit = 0;
+  p->workers_alloc = num_threads;
+
+  p->workers = realloc(p->workers, p->workers_alloc * sizeof(*p->workers));
+  p->queues = realloc(p->queues, p->workers_alloc * sizeof(*p->queues));
+
+  for(i = 0; i < p->workers_alloc; i++)
+    pthread_mutex_init(&p->queues[i].mutex, NULL);
+
+  /* Thread 0 is the calling thread */
+  p->num_workers = num_threads - 1;
+
+  for(i = 0; i < p->num_workers; i++)
+    {
+    p->workers[i].index = i + 1;
+    p->workers[i].job_id = p->job_id;
+    p->workers[i].p = p;
+    pthread_create(&p->workers[i].thread, NULL, worker_func, &p->workers[i]);
+    }
+  }
+
+static void pool_destroy(pool_t * p)
+  {
+  int i;
+  pthread_mutex_lock(&p->mutex);
+  p->quit = 1;
+  pthread_cond_broadcast(&p->start_cond);
+  pthread_mutex_unlock(&p->mutex);
+
+  for(i = 0; i < p->num_workers; i++)
+    pthread_join(p->workers[i].thread, NULL);
+
+  for(i = 0; i < p->workers_alloc; i++)
+    pthread_mutex_destroy(&p->queues[i].mutex);
+
+  if(p->workers)
+    free(p->workers);
+  if(p->queues)
+    free(p->queues);
+
+  pthread_mutex_destroy(&p->mutex);
+  pthread_mutex_destroy(&p->job_mutex);
+  pthread_cond_destroy(&p->start_cond);
+  pthread_cond_destroy(&p->done_cond);
+  free(p);
+  }
+
+static void __attribute__ ((destructor)) pool_cleanup(void)
+  {
+  if(pool)
+    {
+    pool_destroy(pool);
+    pool = NULL;
+    }
+  }
+
+void gavl_thread_pool_run(int num_threads,
+                          gavl_video_process_func func,
+                          void * data, int num, int align)
+  {
+  int i;
+  pool_t * p;
+
+  if(align < 1)
+    align = 1;
+
+  if(num_threads > num / align)
+    num_threads = num / align;
+
+  if(num_threads < 2)
+    {
+    func(data, 0, num);
+    return;
+    }
+
+  pthread_mutex_lock(&pool_mutex);
+  if(!pool)
+    pool = pool_create();
+  p = pool;
+  pthread_mutex_unlock(&pool_mutex);
+
+  /* Pool busy: Do it ourselves */
+  if(pthread_mutex_trylock(&p->job_mutex))
+    {
+    func(data, 0, num);
+    return;
+    }
+
+  pool_grow(p, num_threads);
+
+  p->func = func;
+  p->data = data;
+  p->num = num;
+  p->align = align;
+  p->num_units = (num + align - 1) / align;
+  p->num_tiles = num_threads * TILES_PER_THREAD;
+  if(p->num_tiles > p->num_units)
+    p->num_tiles = p->num_units;
+
+  /* Distribute tiles */
+  for(i = 0; i < num_threads; i++)
+    {
+    p->queues[i].head = (i * p->num_tiles) / num_threads;
+    p->queues[i].tail = ((i+1) * p->num_tiles) / num_threads;
+    }
+
+  /* Start */
+  pthread_mutex_lock(&p->mutex);
+  p->job_threads = num_threads;
+  p->job_running = num_threads - 1;
+  p->job_id++;
+  pthread_cond_broadcast(&p->start_cond);
+  pthread_mutex_unlock(&p->mutex);
+
+  do_work(p, 0);
+
+  /* Wait */
+  pthread_mutex_lock(&p->mutex);
+  while(p->job_running)
+    pthread_cond_wait(&p->done_cond, &p->mutex);
+  pthread_mutex_unlock(&p->mutex);
+
+  pthread_mutex_unlock(&p->job_mutex);
+  }
+
+/* Defaults for the run- and stop functions. They are returned to
+   applications, which call them directly, so they must work standalone */
+
+void gavl_run_func_default(gavl_video_process_func func,
+                           void * gavl_data,
+                           int start, int end,
+                           void * client_data, int thread)
+  {
+  func(gavl_data, start, end);
+  }
+
+void gavl_stop_func_default(void * client_data, int thread)
+  {
+  }
+
+void gavl_threads_run(int num_threads,
+                      gavl_video_run_func run_func, void * run_data,
+                      gavl_video_stop_func stop_func, void * stop_data,
+                      gavl_video_process_func func,
+                      void * data, int num, int align)
+  {
+  int i, nt, start, end;
+  int num_units;
+  
+  if(num_threads < 2)
+    {
+    func(data, 0, num);
+    return;
+    }
+
+  /* Builtin thread pool */
+  if(!run_func || (run_func == gavl_run_func_default))
+    {
+    gavl_thread_pool_run(num_threads, func, data, num, align);
+    return;
+    }
+
+  /* Application supplied threads: One slice per thread */
+
+  if(align < 1)
+    align = 1;
+  
+  num_units = (num + align - 1) / align;
+  
+  nt = num_threads;
+  if(nt > num_units)
+    nt = num_units;
+  if(nt < 1)
+    nt = 1;
+  
+  for(i = 0; i < nt; i++)
+    {
+    start = ((i * num_units) / nt) * align;
+
+    if(i == nt - 1)
+      end = num;
+    else
+      end = (((i+1) * num_units) / nt) * align;
+    
+    run_func(func, data, start, end, run_data, i);
+    }
+  
+  for(i = 0; i < nt; i++)
+    {
+    if(stop_func)
+      stop_func(stop_data, i);
+    }
+  }
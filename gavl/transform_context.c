@@ -28,6 +28,7 @@
 
 static gavl_transform_scanline_func get_func(gavl_transform_funcs_t * tab,
                                              gavl_pixelformat_t pixelformat,
+                                             int plane,
                                              int * bits)
   {
   switch(pixelformat)
@@ -93,9 +94,31 @@ static gavl_transform_scanline_func get_func(gavl_transform_funcs_t * tab,
       break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_10:
       *bits = tab->bits_uint16_x_1;
       return tab->transform_uint16_x_1;
       break;
+    case GAVL_NV12:
+    case GAVL_NV21:
+      *bits = tab->bits_uint8_noadvance;
+      if(plane)
+        return tab->transform_uint8_x_2;
+      else
+        return tab->transform_uint8_x_1_noadvance;
+      break;
+    case GAVL_P010:
+    case GAVL_P016:
+      if(plane)
+        {
+        *bits = tab->bits_uint16_x_2;
+        return tab->transform_uint16_x_2;
+        }
+      else
+        {
+        *bits = tab->bits_uint16_x_1;
+        return tab->transform_uint16_x_1;
+        }
+      break;
     case GAVL_RGB_48:
       *bits = tab->bits_uint16_x_3;
       return tab->transform_uint16_x_3;
@@ -277,6 +300,7 @@ gavl_transform_context_init(gavl_image_transform_t * t,
 
   ctx->func = get_func(&func_tab,
                        t->format.pixelformat,
+                       ctx->plane,
                        &bits);
 
   if(!ctx->func)
@@ -337,28 +361,8 @@ void gavl_transform_context_transform(gavl_transform_context_t * ctx,
   
   if(ctx->opt->num_threads > 1)
     {
-    int delta;
-    int scanline;
-    int nt;
-    
     ctx->dst_frame = dst;
-    nt = ctx->opt->num_threads;
-    if(nt > ctx->dst_height)
-      nt = ctx->dst_height;
-    
-    delta = ctx->dst_height / nt;
-    scanline = 0;
-    for(i = 0; i < nt - 1; i++)
-      {
-      ctx->opt->run_func(func_1, ctx, scanline,
-                         scanline+delta, ctx->opt->run_data, i);
-      scanline += delta;
-      }
-    ctx->opt->run_func(func_1, ctx, scanline, ctx->dst_height,
-                       ctx->opt->run_data, nt - 1);
-    
-    for(i = 0; i < nt; i++)
-      ctx->opt->stop_func(ctx->opt->stop_data, i);
+    gavl_video_options_run(ctx->opt, func_1, ctx, ctx->dst_height, 1);
     }
   else
     {
@@ -287,9 +287,6 @@ void gavl_transform_table_init(gavl_transform_table_t * tab,
                                float off_x, float off_y, float scale_x,
                                float scale_y, int width, int height)
   {
-  int delta;
-  int scanline;
-  int nt;
   int i;
   
   slice_data_t sd;
@@ -326,27 +323,7 @@ void gavl_transform_table_init(gavl_transform_table_t * tab,
   for(i = 1; i < height; i++)
     tab->pixels[i] = tab->pixels[0] + i * width;
 
-  nt = opt->num_threads;
-  if(nt > height)
-    nt = height;
-  if(nt < 1)
-    nt = 1;
-  
-  delta = height / nt;
-  scanline = 0;
-
-  for(i = 0; i < nt - 1; i++)
-    {
-    opt->run_func(init_slice, &sd, scanline, scanline+delta,
-                  opt->run_data, i);
-        
-    scanline += delta;
-    }
-  opt->run_func(init_slice, &sd, scanline, height,
-                opt->run_data, nt - 1);
-  
-  for(i = 0; i < nt; i++)
-    opt->stop_func(opt->stop_data, i);
+  gavl_video_options_run(opt, init_slice, &sd, height, 1);
   }
 
 void gavl_transform_table_init_int(gavl_transform_table_t * tab,
@@ -29,9 +29,184 @@
 #include <stdio.h>  
 //#endif
 
+#include <pthread.h>
+
 #include "gavl.h"
 #include "config.h"
 #include "video.h"
+#include "scale.h"
+
+/*
+ *  Fused scaling and pixelformat conversion
+ *
+ *  If a scaling step is directly followed by a pixelformat conversion,
+ *  we don't need a full sized intermediate frame. Instead, the scaler
+ *  output is produced in bands of FUSE_BAND_HEIGHT rows, which are
+ *  converted while they are still in the cache. Each thread works with
+ *  its own band buffer.
+ */
+
+#define FUSE_BAND_HEIGHT 16
+
+struct gavl_video_fuse_s
+  {
+  /* The pixelformat conversion step, which was merged into the scaler */
+  gavl_video_convert_context_t csp;
+  
+  gavl_video_format_t band_format;
+  
+  gavl_video_frame_t ** bands;
+  int * bands_used;
+  int num_bands;
+  pthread_mutex_t mutex;
+  
+  int out_sub_v;
+  int out_planes;
+  };
+
+static void fuse_destroy(struct gavl_video_fuse_s * f)
+  {
+  int i;
+  for(i = 0; i < f->num_bands; i++)
+    gavl_video_frame_destroy(f->bands[i]);
+  if(f->bands)
+    free(f->bands);
+  if(f->bands_used)
+    free(f->bands_used);
+  pthread_mutex_destroy(&f->mutex);
+  free(f);
+  }
+
+static int fuse_get_band(struct gavl_video_fuse_s * f)
+  {
+  int i;
+  pthread_mutex_lock(&f->mutex);
+
+  for(i = 0; i < f->num_bands; i++)
+    {
+    if(!f->bands_used[i])
+      break;
+    }
+  
+  if(i == f->num_bands)
+    {
+    f->num_bands++;
+    f->bands = realloc(f->bands, f->num_bands * sizeof(*f->bands));
+    f->bands_used = realloc(f->bands_used, f->num_bands * sizeof(*f->bands_used));
+    f->bands[i] = gavl_video_frame_create(&f->band_format);
+    }
+  f->bands_used[i] = 1;
+  pthread_mutex_unlock(&f->mutex);
+  return i;
+  }
+
+static void fuse_release_band(struct gavl_video_fuse_s * f, int idx)
+  {
+  pthread_mutex_lock(&f->mutex);
+  f->bands_used[idx] = 0;
+  pthread_mutex_unlock(&f->mutex);
+  }
+
+static void fuse_func_bands(void * data, int start, int end)
+  {
+  int i, j, y, h, idx;
+  gavl_video_convert_context_t * ctx = data;
+  struct gavl_video_fuse_s * f = ctx->fuse;
+  gavl_video_convert_context_t csp;
+  gavl_video_frame_t out_band;
+
+  idx = fuse_get_band(f);
+
+  memset(&out_band, 0, sizeof(out_band));
+  memcpy(&csp, &f->csp, sizeof(csp));
+  csp.input_frame = f->bands[idx];
+  csp.output_frame = &out_band;
+  
+  for(i = start; i < end; i++)
+    {
+    y = i * FUSE_BAND_HEIGHT;
+    h = ctx->output_format.image_height - y;
+    if(h > FUSE_BAND_HEIGHT)
+      h = FUSE_BAND_HEIGHT;
+    
+    gavl_video_scaler_scale_rows(ctx->scaler, f->bands[idx], y, y + h);
+
+    for(j = 0; j < f->out_planes; j++)
+      {
+      out_band.planes[j] = ctx->output_frame->planes[j] +
+        (j ? y / f->out_sub_v : y) * ctx->output_frame->strides[j];
+      out_band.strides[j] = ctx->output_frame->strides[j];
+      }
+    csp.input_format.image_height = h;
+    csp.output_format.image_height = h;
+    csp.func(&csp);
+    }
+  fuse_release_band(f, idx);
+  }
+
+static void fuse_func(gavl_video_convert_context_t * ctx)
+  {
+  gavl_video_scaler_scale_begin(ctx->scaler, ctx->input_frame);
+  
+  gavl_video_options_run(ctx->options, fuse_func_bands, ctx,
+                         (ctx->output_format.image_height + FUSE_BAND_HEIGHT - 1) /
+                         FUSE_BAND_HEIGHT, 1);
+  }
+
+/*
+ *  Sliced pixelformat conversion
+ *
+ *  Pixelformat conversions, which are not fused with a scaler, are
+ *  done in bands of scanlines by several threads. Band boundaries are
+ *  multiples of the vertical chroma subsampling of the input and
+ *  output formats, so each band starts at a chroma line.
+ */
+
+static void get_band(const gavl_video_frame_t * frame,
+                     gavl_video_frame_t * band,
+                     gavl_pixelformat_t pixelformat, int y)
+  {
+  int i, num_planes, sub_h, sub_v;
+
+  num_planes = gavl_pixelformat_num_planes(pixelformat);
+  gavl_pixelformat_chroma_sub(pixelformat, &sub_h, &sub_v);
+  
+  for(i = 0; i < num_planes; i++)
+    {
+    band->planes[i] = frame->planes[i] +
+      (i ? y / sub_v : y) * frame->strides[i];
+    band->strides[i] = frame->strides[i];
+    }
+  }
+
+static void csp_func_bands(void * data, int start, int end)
+  {
+  gavl_video_convert_context_t * ctx = data;
+  gavl_video_convert_context_t band;
+  gavl_video_frame_t in_band;
+  gavl_video_frame_t out_band;
+
+  memset(&in_band, 0, sizeof(in_band));
+  memset(&out_band, 0, sizeof(out_band));
+  memcpy(&band, ctx, sizeof(band));
+
+  get_band(ctx->input_frame, &in_band, ctx->input_format.pixelformat,
+           start);
+  get_band(ctx->output_frame, &out_band, ctx->output_format.pixelformat,
+           start);
+  
+  band.input_frame = &in_band;
+  band.output_frame = &out_band;
+  band.input_format.image_height = end - start;
+  band.output_format.image_height = end - start;
+  ctx->band_func(&band);
+  }
+
+static void csp_func_mt(gavl_video_convert_context_t * ctx)
+  {
+  gavl_video_options_run(ctx->options, csp_func_bands, ctx,
+                         ctx->output_format.image_height, ctx->band_align);
+  }
 
 /***************************************************
  * Create and destroy video converters
@@ -53,6 +228,8 @@ static void video_converter_cleanup(gavl_video_converter_t* cnv)
     
     if(cnv->first_context->scaler)
       gavl_video_scaler_destroy(cnv->first_context->scaler);
+    if(cnv->first_context->fuse)
+      fuse_destroy(cnv->first_context->fuse);
     if(cnv->first_context->output_frame && cnv->first_context->next)
       gavl_video_frame_destroy(cnv->first_context->output_frame);
     free(cnv->first_context);
@@ -103,15 +280,38 @@ static int add_context_csp(gavl_video_converter_t * cnv,
                      const gavl_video_format_t * output_format)
   {
   gavl_video_convert_context_t * ctx;
-  ctx = add_context(cnv, input_format, output_format);
-
-  ctx->func = gavl_find_pixelformat_converter(&cnv->options,
-                                             input_format->pixelformat,
-                                             output_format->pixelformat,
-                                             input_format->frame_width,
-                                             input_format->frame_height);
-
-  if(!ctx->func)
+  gavl_video_func_t func;
+  gavl_pixelformat_t relay;
+  gavl_video_format_t relay_format;
+  
+  func = gavl_find_pixelformat_converter(&cnv->options,
+                                         input_format->pixelformat,
+                                         output_format->pixelformat,
+                                         input_format->frame_width,
+                                         input_format->frame_height);
+
+  /* Formats with incomplete conversion tables are converted in 2 steps */
+  if(!func)
+    {
+    relay = gavl_pixelformat_get_relay(input_format->pixelformat);
+    
+    if((relay == GAVL_PIXELFORMAT_NONE) ||
+       (relay == output_format->pixelformat))
+      relay = gavl_pixelformat_get_relay(output_format->pixelformat);
+    
+    if((relay != GAVL_PIXELFORMAT_NONE) &&
+       (relay != input_format->pixelformat) &&
+       (relay != output_format->pixelformat))
+      {
+      gavl_video_format_copy(&relay_format, output_format);
+      relay_format.pixelformat = relay;
+      
+      return add_context_csp(cnv, input_format, &relay_format) &&
+        add_context_csp(cnv, &relay_format, output_format);
+      }
+    }
+  
+  if(!func)
     {
 #if 0
     fprintf(stderr, "Found no conversion from %s to %s\n",
@@ -120,6 +320,9 @@ static int add_context_csp(gavl_video_converter_t * cnv,
 #endif
     return 0;
     }
+
+  ctx = add_context(cnv, input_format, output_format);
+  ctx->func = func;
 #if 0
   fprintf(stderr, "Doing pixelformat conversion from %s to %s\n",
           gavl_pixelformat_to_string(input_format->pixelformat),
@@ -204,6 +407,98 @@ static int add_context_deinterlace(gavl_video_converter_t * cnv,
   return 1;
   }
 
+/* Merge scaling steps with following pixelformat conversions */
+
+static void fuse_contexts(gavl_video_converter_t * cnv)
+  {
+  int sub_h;
+  struct gavl_video_fuse_s * f;
+  gavl_video_convert_context_t * ctx;
+  gavl_video_convert_context_t * next;
+
+  if(cnv->options.conversion_flags & GAVL_NO_FUSE)
+    return;
+  
+  ctx = cnv->first_context;
+  
+  while(ctx && ctx->next)
+    {
+    next = ctx->next;
+    
+    if(ctx->scaler && !next->scaler && !next->deinterlacer &&
+       gavl_video_scaler_can_scale_rows(ctx->scaler))
+      {
+      f = calloc(1, sizeof(*f));
+      pthread_mutex_init(&f->mutex, NULL);
+
+      memcpy(&f->csp, next, sizeof(*next));
+      f->csp.next = NULL;
+      
+      gavl_video_format_copy(&f->band_format, &next->input_format);
+      f->band_format.image_height = FUSE_BAND_HEIGHT;
+      f->band_format.frame_height = FUSE_BAND_HEIGHT;
+      
+      gavl_pixelformat_chroma_sub(next->output_format.pixelformat,
+                                  &sub_h, &f->out_sub_v);
+      f->out_planes = gavl_pixelformat_num_planes(next->output_format.pixelformat);
+      
+      ctx->fuse = f;
+      ctx->func = fuse_func;
+      gavl_video_format_copy(&ctx->output_format, &next->output_format);
+      
+      /* Remove the pixelformat conversion step */
+      ctx->next = next->next;
+      if(cnv->last_context == next)
+        cnv->last_context = ctx;
+      free(next);
+      cnv->num_contexts--;
+      }
+    ctx = ctx->next;
+    }
+  }
+
+/* Let the remaining pixelformat conversion steps run in slices */
+
+static void slice_contexts(gavl_video_converter_t * cnv)
+  {
+  int sub_h, in_sub_v, out_sub_v;
+  gavl_video_convert_context_t * ctx;
+
+  if(cnv->options.num_threads < 2)
+    return;
+  
+  ctx = cnv->first_context;
+  
+  while(ctx)
+    {
+    if(!ctx->scaler && !ctx->deinterlacer && !ctx->fuse)
+      {
+      gavl_pixelformat_chroma_sub(ctx->input_format.pixelformat,
+                                  &sub_h, &in_sub_v);
+      gavl_pixelformat_chroma_sub(ctx->output_format.pixelformat,
+                                  &sub_h, &out_sub_v);
+
+      /* Subsampling factors are powers of 2 */
+      ctx->band_align = (in_sub_v > out_sub_v) ? in_sub_v : out_sub_v;
+      ctx->band_func = ctx->func;
+      ctx->func = csp_func_mt;
+      }
+    ctx = ctx->next;
+    }
+  }
+
+int gavl_video_converter_is_fused(gavl_video_converter_t * cnv)
+  {
+  gavl_video_convert_context_t * ctx = cnv->first_context;
+  while(ctx)
+    {
+    if(ctx->fuse)
+      return 1;
+    ctx = ctx->next;
+    }
+  return 0;
+  }
+
 int gavl_video_converter_reinit(gavl_video_converter_t * cnv)
   {
   int csp_then_scale = 0;
@@ -457,6 +752,9 @@ int gavl_video_converter_reinit(gavl_video_converter_t * cnv)
       return -1;
     }
 
+  fuse_contexts(cnv);
+  slice_contexts(cnv);
+  
   /* Now, create temporary frames for the contexts */
 
   cnv->have_frames = 0;
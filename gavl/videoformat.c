@@ -408,6 +408,8 @@ int gavl_video_format_get_image_size(const gavl_video_format_t * format)
     if(!i)
       {
       bytes_per_line /= sub_h;
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        bytes_per_line *= 2;
       height /= sub_v;
       }
     }
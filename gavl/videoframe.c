@@ -65,7 +65,15 @@ static void video_frame_alloc(gavl_video_frame_t * ret,
       {
       ret->strides[0] = bpc * format->frame_width;
       ret->strides[1] = bpc * ((format->frame_width + sub_h - 1) / sub_h);
-      ret->strides[2] = ret->strides[1];
+
+      /* Semi planar: One chroma plane with both components */
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        {
+        ret->strides[1] *= 2;
+        ret->strides[2] = 0;
+        }
+      else
+        ret->strides[2] = ret->strides[1];
       
       if(align)
         {
@@ -80,7 +88,8 @@ static void video_frame_alloc(gavl_video_frame_t * ret,
                               ret->strides[1]*((format->frame_height+sub_v-1)/sub_v)+
                               ret->strides[2]*((format->frame_height+sub_v-1)/sub_v));
     ret->planes[1] = ret->planes[0] + ret->strides[0]*format->frame_height;
-    ret->planes[2] = ret->planes[1] + ret->strides[1]*((format->frame_height+sub_v-1)/sub_v);
+    if(ret->strides[2])
+      ret->planes[2] = ret->planes[1] + ret->strides[1]*((format->frame_height+sub_v-1)/sub_v);
     }
   else // Packed
     {
@@ -139,6 +148,59 @@ void gavl_video_frame_null(gavl_video_frame_t* frame)
   frame->planes[0] = NULL;
   }
 
+/* Clear the interleaved chroma plane of a semi planar frame */
+
+static void clear_semiplanar_chroma(gavl_video_frame_t * frame,
+                                    const gavl_video_format_t * format,
+                                    int mask)
+  {
+  int i, j;
+  int u_index, v_index;
+  uint8_t * ptr;
+  uint16_t * ptr_16;
+  int width  = format->frame_width / 2;
+  int height = format->frame_height / 2;
+  
+  if(format->pixelformat == GAVL_NV21)
+    {
+    u_index = 1;
+    v_index = 0;
+    }
+  else
+    {
+    u_index = 0;
+    v_index = 1;
+    }
+  
+  for(i = 0; i < height; i++)
+    {
+    if(gavl_pixelformat_bytes_per_component(format->pixelformat) == 1)
+      {
+      ptr = frame->planes[1] + i * frame->strides[1];
+      for(j = 0; j < width; j++)
+        {
+        if(mask & CLEAR_MASK_PLANE_1)
+          ptr[u_index] = 0x80;
+        if(mask & CLEAR_MASK_PLANE_2)
+          ptr[v_index] = 0x80;
+        ptr += 2;
+        }
+      }
+    else
+      {
+      ptr_16 = (uint16_t*)(frame->planes[1] + i * frame->strides[1]);
+      for(j = 0; j < width; j++)
+        {
+        if(mask & CLEAR_MASK_PLANE_1)
+          ptr_16[u_index] = 0x8000;
+        if(mask & CLEAR_MASK_PLANE_2)
+          ptr_16[v_index] = 0x8000;
+        ptr_16 += 2;
+        }
+      }
+    }
+  }
+
 void gavl_video_frame_clear_mask(gavl_video_frame_t * frame,
                                  const gavl_video_format_t * format, int mask)
   {
@@ -510,6 +572,65 @@ void gavl_video_frame_clear_mask(gavl_video_frame_t * frame,
           memset(frame->planes[2] + i * frame->strides[2], 0x80, bytes);
         }
       break;
+    case GAVL_NV12:
+    case GAVL_NV21:
+      if(mask & CLEAR_MASK_PLANE_0)
+        {
+        bytes = format->frame_width;
+        for(i = 0; i < format->frame_height; i++)
+          memset(frame->planes[0] + i * frame->strides[0], 0x00, bytes);
+        }
+      if(mask & (CLEAR_MASK_PLANE_1 | CLEAR_MASK_PLANE_2))
+        clear_semiplanar_chroma(frame, format, mask);
+      break;
+    case GAVL_P010:
+    case GAVL_P016:
+      if(mask & CLEAR_MASK_PLANE_0)
+        {
+        bytes = format->frame_width * 2;
+        for(i = 0; i < format->frame_height; i++)
+          memset(frame->planes[0] + i * frame->strides[0], 0x00, bytes);
+        }
+      if(mask & (CLEAR_MASK_PLANE_1 | CLEAR_MASK_PLANE_2))
+        clear_semiplanar_chroma(frame, format, mask);
+      break;
+    case GAVL_YUV_420_P_10:
+      if(mask & CLEAR_MASK_PLANE_0)
+        {
+        bytes = format->frame_width * 2;
+        for(i = 0; i < format->frame_height; i++)
+          memset(frame->planes[0] + i * frame->strides[0], 0x00, bytes);
+        }
+      
+      if(!(mask & (CLEAR_MASK_PLANE_1 | CLEAR_MASK_PLANE_2)))
+        break;
+      
+      line_start_u = frame->planes[1];
+      line_start_v = frame->planes[2];
+      for(i = 0; i < format->frame_height / 2; i++)
+        {
+        ptr_16_u = (uint16_t*)line_start_u;
+        ptr_16_v = (uint16_t*)line_start_v;
+
+        if(mask & CLEAR_MASK_PLANE_1)
+          {
+          for(j = 0; j < format->frame_width/2; j++)
+            {
+            *(ptr_16_u++) = 0x200;
+            }
+          }
+        if(mask & CLEAR_MASK_PLANE_2)
+          {
+          for(j = 0; j < format->frame_width/2; j++)
+            {
+            *(ptr_16_v++) = 0x200;
+            }
+          }
+        
+        line_start_u += frame->strides[1];
+        line_start_v += frame->strides[2];
+        }
+      break;
     case GAVL_PIXELFORMAT_NONE:
       break;
     }
@@ -583,6 +704,8 @@ void gavl_video_frame_copy_plane(const gavl_video_format_t * format,
     {
     gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
     bytes_per_line /= sub_h;
+    if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+      bytes_per_line *= 2;
     height /= sub_v;
     }
   copy_plane(dst, src, plane, bytes_per_line, height);
@@ -634,6 +757,8 @@ void gavl_video_frame_copy(const gavl_video_format_t * format,
       {
       gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
       bytes_per_line /= sub_h;
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        bytes_per_line *= 2;
       height /= sub_v;
       }
     copy_plane(dst, src, i, bytes_per_line, height);
@@ -829,6 +954,9 @@ static flip_scanline_func find_flip_scanline_func(gavl_pixelformat_t csp)
     case GAVL_BGR_16:
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_10:
+    case GAVL_P010:
+    case GAVL_P016:
     case GAVL_GRAYA_16:
     case GAVL_GRAY_16:
       return flip_scanline_2;
@@ -869,6 +997,8 @@ static flip_scanline_func find_flip_scanline_func(gavl_pixelformat_t csp)
     case GAVL_YUVJ_420_P:
     case GAVL_YUVJ_422_P:
     case GAVL_YUVJ_444_P:
+    case GAVL_NV12:
+    case GAVL_NV21:
     case GAVL_GRAY_8:
       return flip_scanline_1;
       break;
@@ -884,6 +1014,17 @@ static flip_scanline_func find_flip_scanline_func(gavl_pixelformat_t csp)
   return NULL;
   }
 
+/* Flip function for the chroma plane of semi planar formats */
+
+static flip_scanline_func
+find_flip_scanline_func_semiplanar(gavl_pixelformat_t csp)
+  {
+  if(gavl_pixelformat_bytes_per_component(csp) == 1)
+    return flip_scanline_2;
+  else
+    return flip_scanline_4;
+  }
+
 void gavl_video_frame_copy_flip_x(const gavl_video_format_t * format,
                                   gavl_video_frame_t * dst,
                                   const gavl_video_frame_t * src)
@@ -923,6 +1064,8 @@ void gavl_video_frame_copy_flip_x(const gavl_video_format_t * format,
       {
       jmax /= sub_v;
       width /= sub_h;
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        func = find_flip_scanline_func_semiplanar(format->pixelformat);
       }
     }
   
@@ -991,7 +1134,11 @@ void gavl_video_frame_copy_flip_xy(const gavl_video_format_t * format,
   for(i = 0; i < planes; i++)
     {
     if(i)
+      {
       gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        func = find_flip_scanline_func_semiplanar(format->pixelformat);
+      }
 
     src_ptr = src->planes[i] +
       ((format->image_height / sub_v) - 1) * src->strides[i];
@@ -1020,6 +1167,7 @@ void gavl_video_frame_dump(gavl_video_frame_t * frame,
   int sub_h, sub_v;
   int planes;
   int i, j;
+  int bytes;
   
   FILE * output;
 
@@ -1046,9 +1194,13 @@ void gavl_video_frame_dump(gavl_video_frame_t * frame,
       gavl_pixelformat_chroma_sub(format->pixelformat,
                           &sub_h, &sub_v);
     
+    bytes = format->image_width / sub_h;
+    if(i && gavl_pixelformat_is_semiplanar(format->pixelformat))
+      bytes *= 2;
+    
     for(j = 0; j < format->image_height / sub_v; j++)
       {
-      fwrite(frame->planes[i] + j*frame->strides[i], 1,  format->image_width / sub_h,
+      fwrite(frame->planes[i] + j*frame->strides[i], 1, bytes,
              output);
       }
     fclose(output);
@@ -1079,7 +1231,8 @@ void gavl_video_frame_get_subframe(gavl_pixelformat_t pixelformat,
     for(i = 1; i < num_planes; i++)
       {
       dst->planes[i] = src->planes[i] +
-        (src_rect->y/uv_sub_v) * src->strides[i] + (src_rect->x/uv_sub_h) * bytes;
+        (src_rect->y/uv_sub_v) * src->strides[i] + (src_rect->x/uv_sub_h) * bytes *
+        (gavl_pixelformat_is_semiplanar(pixelformat) ? 2 : 1);
       dst->strides[i] = src->strides[i];
       }
     }
@@ -1347,6 +1500,67 @@ static void fill_planar_16(gavl_video_frame_t * frame,
   
   }
 
+/* Semi planar: color[1] and color[2] are stored in memory order */
+
+static void fill_semiplanar_8(gavl_video_frame_t * frame,
+                              const gavl_video_format_t * format,
+                              uint8_t * color)
+  {
+  int i, j, imax, jmax;
+  uint8_t * dst;
+  
+  /* Luminance */
+  dst = frame->planes[0];
+  for(i = 0; i < format->image_height; i++)
+    {
+    memset(dst, color[0], format->image_width);
+    dst += frame->strides[0];
+    }
+  /* Chrominance */
+  imax = format->image_height / 2;
+  jmax = format->image_width  / 2;
+  
+  for(i = 0; i < imax; i++)
+    {
+    dst = frame->planes[1] + i * frame->strides[1];
+    for(j = 0; j < jmax; j++)
+      {
+      dst[0] = color[1];
+      dst[1] = color[2];
+      dst += 2;
+      }
+    }
+  }
+
+static void fill_semiplanar_16(gavl_video_frame_t * frame,
+                               const gavl_video_format_t * format,
+                               uint16_t * color)
+  {
+  int i, j, imax, jmax;
+  uint16_t * dst;
+  
+  /* Luminance */
+  for(i = 0; i < format->image_height; i++)
+    {
+    dst = (uint16_t*)(frame->planes[0] + i * frame->strides[0]);
+    for(j = 0; j < format->image_width; j++)
+      *(dst++) = color[0];
+    }
+  /* Chrominance */
+  imax = format->image_height / 2;
+  jmax = format->image_width  / 2;
+  
+  for(i = 0; i < imax; i++)
+    {
+    dst = (uint16_t*)(frame->planes[1] + i * frame->strides[1]);
+    for(j = 0; j < jmax; j++)
+      {
+      dst[0] = color[1];
+      dst[1] = color[2];
+      dst += 2;
+      }
+    }
+  }
 
 void gavl_video_frame_fill(gavl_video_frame_t * frame,
                            const gavl_video_format_t * format,
@@ -1547,6 +1761,36 @@ void gavl_video_frame_fill(gavl_video_frame_t * frame,
                           packed_64[1], packed_64[2]);
       fill_planar_16(frame, format, packed_64);
       break;
+    case GAVL_YUV_420_P_10:
+      RGB_FLOAT_TO_YUV_16(color[0], color[1], color[2], packed_64[0],
+                          packed_64[1], packed_64[2]);
+      packed_64[0] >>= 6;
+      packed_64[1] >>= 6;
+      packed_64[2] >>= 6;
+      fill_planar_16(frame, format, packed_64);
+      break;
+    case GAVL_NV12:
+      RGB_FLOAT_TO_YUV_8(color[0], color[1], color[2], packed_32[0],
+                         packed_32[1], packed_32[2]);
+      fill_semiplanar_8(frame, format, packed_32);
+      break;
+    case GAVL_NV21:
+      RGB_FLOAT_TO_YUV_8(color[0], color[1], color[2], packed_32[0],
+                         packed_32[2], packed_32[1]);
+      fill_semiplanar_8(frame, format, packed_32);
+      break;
+    case GAVL_P010:
+    case GAVL_P016:
+      RGB_FLOAT_TO_YUV_16(color[0], color[1], color[2], packed_64[0],
+                          packed_64[1], packed_64[2]);
+      if(format->pixelformat == GAVL_P010)
+        {
+        packed_64[0] &= 0xffc0;
+        packed_64[1] &= 0xffc0;
+        packed_64[2] &= 0xffc0;
+        }
+      fill_semiplanar_16(frame, format, packed_64);
+      break;
     case GAVL_PIXELFORMAT_NONE:
       fprintf(stderr, "Pixelformat not specified for video frame\n");
       return;
@@ -1582,7 +1826,11 @@ void gavl_video_frame_set_strides(gavl_video_frame_t * frame,
     {
     frame->strides[i] = bytes_per_line;
     if(i)
+      {
       frame->strides[i] /= sub_h;
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        frame->strides[i] *= 2;
+      }
     }
   }
   
@@ -1640,6 +1888,8 @@ int gavl_video_frames_equal(const gavl_video_format_t * format,
       {
       gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
       bytes_per_line /= sub_h;
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        bytes_per_line *= 2;
       height /= sub_v;
       }
 
@@ -1685,6 +1935,8 @@ int gavl_video_frame_continuous(const gavl_video_format_t * format,
     if(i == 1)
       {
       bytes_per_line /= sub_h;
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        bytes_per_line *= 2;
       bytes_per_plane = bytes_per_line * (format->frame_height / sub_v);
       }
 
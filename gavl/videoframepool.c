@@ -18,20 +18,152 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  * *****************************************************************/
-
 #include <stdlib.h>
+#include <pthread.h>
 
 #include <gavl/gavl.h>
 
+/*
+ *  Frames are stored in slots, which are allocated in chunks. Chunks are
+ *  never moved or freed before the pool is destroyed, so the slots can be
+ *  accessed without locking.
+ *
+ *  Unused frames are kept in a lock-free LIFO (Treiber stack) of slot
+ *  indices. The head contains a generation counter in the upper 32 bits
+ *  to avoid the ABA problem. Indices are stored with an offset of 1 so
+ *  that 0 terminates the list.
+ *
+ *  The mutex is only taken for allocating new frames, for blocking and for
+ *  the legacy API (gavl_video_frame_pool_get()).
+ */
+
+#define SLOTS_PER_CHUNK 64
+#define MAX_CHUNKS      256
+
+#define INDEX_MASK 0xffffffffULL
+
+typedef struct
+  {
+  gavl_video_frame_t * frame;
+  uint32_t next;
+  } slot_t;
+
 struct gavl_video_frame_pool_s
   {
+  slot_t * chunks[MAX_CHUNKS];
+  int num_slots;
+
+  /* Slots, whose frames were removed by gavl_video_frame_pool_trim() */
+  int * empty_slots;
+  int num_empty_slots;
+  int empty_slots_alloc;
+  
+  uint64_t free_head;
+  int num_free;
+  
   int num_frames;
-  int frames_alloc;
-  gavl_video_frame_t ** frames;
+  int max_frames;
+  
+  /* Statistics */
+  int64_t hits;
+  int64_t misses;
+  int peak;
+
+  int waiters;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  
   gavl_video_frame_t * (*create_frame)(void * priv);
   void * priv;
   };
 
+#define SLOT(p, idx) (&(p)->chunks[(idx) / SLOTS_PER_CHUNK][(idx) % SLOTS_PER_CHUNK])
+
+static void push_free(gavl_video_frame_pool_t * p, int idx)
+  {
+  uint64_t head, new_head;
+  slot_t * s = SLOT(p, idx);
+  
+  head = __atomic_load_n(&p->free_head, __ATOMIC_RELAXED);
+  do{
+    __atomic_store_n(&s->next, (uint32_t)(head & INDEX_MASK), __ATOMIC_RELAXED);
+    new_head = (((head >> 32) + 1) << 32) | (uint64_t)(idx + 1);
+    } while(!__atomic_compare_exchange_n(&p->free_head, &head, new_head, 1,
+                                         __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+  __atomic_add_fetch(&p->num_free, 1, __ATOMIC_RELAXED);
+  }
+
+static int pop_free(gavl_video_frame_pool_t * p)
+  {
+  uint64_t head, new_head;
+  uint32_t idx;
+  
+  head = __atomic_load_n(&p->free_head, __ATOMIC_ACQUIRE);
+  do{
+    idx = head & INDEX_MASK;
+    if(!idx)
+      return -1;
+    new_head = (((head >> 32) + 1) << 32) |
+      __atomic_load_n(&SLOT(p, idx - 1)->next, __ATOMIC_RELAXED);
+    } while(!__atomic_compare_exchange_n(&p->free_head, &head, new_head, 1,
+                                         __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE));
+  __atomic_sub_fetch(&p->num_free, 1, __ATOMIC_RELAXED);
+  return idx - 1;
+  }
+
+/* Find the slot of a frame. The index is stored in the frame itself,
+   we just check if the frame really belongs to the pool */
+
+static int find_slot(gavl_video_frame_pool_t * p, const gavl_video_frame_t * f)
+  {
+  int idx = f->pool_slot - 1;
+  
+  if((idx < 0) || (idx >= __atomic_load_n(&p->num_slots, __ATOMIC_ACQUIRE)) ||
+     (SLOT(p, idx)->frame != f))
+    return -1;
+  return idx;
+  }
+
+/* Create a new frame. Must be called with the mutex locked */
+
+static int create_frame(gavl_video_frame_pool_t * p)
+  {
+  int idx;
+  gavl_video_frame_t * f;
+  
+  if(p->num_empty_slots)
+    idx = p->empty_slots[--p->num_empty_slots];
+  else
+    {
+    if(p->num_slots == MAX_CHUNKS * SLOTS_PER_CHUNK)
+      return -1;
+    idx = p->num_slots;
+    if(!p->chunks[idx / SLOTS_PER_CHUNK])
+      p->chunks[idx / SLOTS_PER_CHUNK] =
+        calloc(SLOTS_PER_CHUNK, sizeof(*p->chunks[0]));
+    }
+  
+  if(p->create_frame)
+    f = p->create_frame(p->priv);
+  else
+    {
+    f = gavl_video_frame_create(p->priv);
+    gavl_video_frame_clear(f, p->priv);
+    }
+  
+  f->pool_slot = idx + 1;
+  SLOT(p, idx)->frame = f;
+
+  if(idx == p->num_slots)
+    __atomic_store_n(&p->num_slots, idx + 1, __ATOMIC_RELEASE);
+  
+  p->num_frames++;
+  if(p->num_frames > p->peak)
+    p->peak = p->num_frames;
+  p->misses++;
+  return idx;
+  }
+
 gavl_video_frame_pool_t *
 gavl_video_frame_pool_create(gavl_video_frame_t * (create_frame)(void * priv),
                              void * priv)
@@ -40,48 +172,214 @@ gavl_video_frame_pool_create(gavl_video_frame_t * (create_frame)(void * priv),
   ret = calloc(1, sizeof(*ret));
   ret->create_frame = create_frame;
   ret->priv = priv;
+  pthread_mutex_init(&ret->mutex, NULL);
+  pthread_cond_init(&ret->cond, NULL);
   return ret;
   }
-  
+
+void gavl_video_frame_pool_set_max_frames(gavl_video_frame_pool_t *p,
+                                          int max_frames)
+  {
+  pthread_mutex_lock(&p->mutex);
+  p->max_frames = max_frames;
+  pthread_cond_broadcast(&p->cond);
+  pthread_mutex_unlock(&p->mutex);
+  }
+
 gavl_video_frame_t * gavl_video_frame_pool_get(gavl_video_frame_pool_t *p)
   {
   int i;
-  for(i = 0; i < p->num_frames; i++)
+  gavl_video_frame_t * ret = NULL;
+  
+  pthread_mutex_lock(&p->mutex);
+
+  /* Frames on the free list (e.g. after gavl_video_frame_pool_reset())
+     must be taken from there. Otherwise they could be destroyed by
+     gavl_video_frame_pool_trim() or handed out twice by
+     gavl_video_frame_pool_acquire() */
+  
+  if((i = pop_free(p)) >= 0)
     {
-    if(!p->frames[i]->refcount)
-      return p->frames[i];
+    ret = SLOT(p, i)->frame;
+    __atomic_add_fetch(&p->hits, 1, __ATOMIC_RELAXED);
     }
+  else
+    {
+    /* Frames, which were released by resetting the refcount */
+    for(i = 0; i < p->num_slots; i++)
+      {
+      if(SLOT(p, i)->frame && !SLOT(p, i)->frame->refcount)
+        {
+        ret = SLOT(p, i)->frame;
+        __atomic_add_fetch(&p->hits, 1, __ATOMIC_RELAXED);
+        break;
+        }
+      }
+    }
+  
   /* Allocate a new frame */
-  if(p->num_frames == p->frames_alloc)
+  if(!ret && ((i = create_frame(p)) >= 0))
+    ret = SLOT(p, i)->frame;
+  
+  pthread_mutex_unlock(&p->mutex);
+  return ret;
+  }
+
+gavl_video_frame_t *
+gavl_video_frame_pool_acquire(gavl_video_frame_pool_t *p, int block)
+  {
+  int idx;
+  gavl_video_frame_t * ret;
+
+  /* Fast path */
+  if((idx = pop_free(p)) >= 0)
     {
-    p->frames_alloc += 16;
-    p->frames = realloc(p->frames, p->frames_alloc * sizeof(*p->frames));
+    __atomic_add_fetch(&p->hits, 1, __ATOMIC_RELAXED);
+    ret = SLOT(p, idx)->frame;
+    __atomic_store_n(&ret->refcount, 1, __ATOMIC_RELAXED);
+    return ret;
     }
+  
+  pthread_mutex_lock(&p->mutex);
 
-  if(p->create_frame)
-    p->frames[p->num_frames] = p->create_frame(p->priv);
-  else
+  /* Announce ourselves before checking the free list again so we
+     won't miss the wakeup from gavl_video_frame_pool_release() */
+  __atomic_add_fetch(&p->waiters, 1, __ATOMIC_SEQ_CST);
+  
+  while(1)
     {
-    p->frames[p->num_frames] = gavl_video_frame_create(p->priv);
-    gavl_video_frame_clear(p->frames[p->num_frames], p->priv);
+    if((idx = pop_free(p)) >= 0)
+      {
+      __atomic_add_fetch(&p->hits, 1, __ATOMIC_RELAXED);
+      break;
+      }
+    if(!p->max_frames || (p->num_frames < p->max_frames))
+      {
+      idx = create_frame(p);
+      break;
+      }
+    if(!block)
+      break;
+    pthread_cond_wait(&p->cond, &p->mutex);
     }
-  p->num_frames++;
-  return p->frames[p->num_frames-1];
+  
+  __atomic_sub_fetch(&p->waiters, 1, __ATOMIC_SEQ_CST);
+  pthread_mutex_unlock(&p->mutex);
+
+  if(idx < 0)
+    return NULL;
+  
+  ret = SLOT(p, idx)->frame;
+  __atomic_store_n(&ret->refcount, 1, __ATOMIC_RELAXED);
+  return ret;
+  }
+
+void gavl_video_frame_pool_ref(gavl_video_frame_t * f)
+  {
+  __atomic_add_fetch(&f->refcount, 1, __ATOMIC_RELAXED);
+  }
+
+void gavl_video_frame_pool_release(gavl_video_frame_pool_t *p,
+                                   gavl_video_frame_t * f)
+  {
+  int idx;
+  
+  if(__atomic_sub_fetch(&f->refcount, 1, __ATOMIC_ACQ_REL) > 0)
+    return;
+
+  if((idx = find_slot(p, f)) < 0)
+    return;
+  
+  push_free(p, idx);
+  
+  if(__atomic_load_n(&p->waiters, __ATOMIC_SEQ_CST))
+    {
+    pthread_mutex_lock(&p->mutex);
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->mutex);
+    }
+  }
+
+void gavl_video_frame_pool_trim(gavl_video_frame_pool_t *p, int max_free)
+  {
+  int idx;
+  slot_t * s;
+  
+  pthread_mutex_lock(&p->mutex);
+
+  while(__atomic_load_n(&p->num_free, __ATOMIC_RELAXED) > max_free)
+    {
+    if((idx = pop_free(p)) < 0)
+      break;
+
+    s = SLOT(p, idx);
+    gavl_video_frame_destroy(s->frame);
+    s->frame = NULL;
+    p->num_frames--;
+    
+    if(p->num_empty_slots == p->empty_slots_alloc)
+      {
+      p->empty_slots_alloc += 16;
+      p->empty_slots = realloc(p->empty_slots,
+                               p->empty_slots_alloc * sizeof(*p->empty_slots));
+      }
+    p->empty_slots[p->num_empty_slots++] = idx;
+    }
+  
+  pthread_mutex_unlock(&p->mutex);
+  }
+
+void gavl_video_frame_pool_get_stats(gavl_video_frame_pool_t *p,
+                                     int64_t * hits, int64_t * misses,
+                                     int * peak)
+  {
+  pthread_mutex_lock(&p->mutex);
+  if(hits)
+    *hits = __atomic_load_n(&p->hits, __ATOMIC_RELAXED);
+  if(misses)
+    *misses = p->misses;
+  if(peak)
+    *peak = p->peak;
+  pthread_mutex_unlock(&p->mutex);
   }
 
 void gavl_video_frame_pool_destroy(gavl_video_frame_pool_t *p)
   {
   int i;
-  for(i = 0; i < p->num_frames; i++)
-    gavl_video_frame_destroy(p->frames[i]);
-  if(p->frames)
-    free(p->frames);
+  for(i = 0; i < p->num_slots; i++)
+    {
+    if(SLOT(p, i)->frame)
+      gavl_video_frame_destroy(SLOT(p, i)->frame);
+    }
+  for(i = 0; i < MAX_CHUNKS; i++)
+    {
+    if(p->chunks[i])
+      free(p->chunks[i]);
+    }
+  if(p->empty_slots)
+    free(p->empty_slots);
+  pthread_mutex_destroy(&p->mutex);
+  pthread_cond_destroy(&p->cond);
   free(p);
   }
 
 void gavl_video_frame_pool_reset(gavl_video_frame_pool_t *p)
   {
   int i;
-  for(i = 0; i < p->num_frames; i++)
-    p->frames[i]->refcount = 0;
+
+  pthread_mutex_lock(&p->mutex);
+
+  p->free_head = 0;
+  p->num_free = 0;
+  
+  for(i = p->num_slots - 1; i >= 0; i--)
+    {
+    if(SLOT(p, i)->frame)
+      {
+      SLOT(p, i)->frame->refcount = 0;
+      push_free(p, i);
+      }
+    }
+  pthread_cond_broadcast(&p->cond);
+  pthread_mutex_unlock(&p->mutex);
   }
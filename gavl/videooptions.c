@@ -30,23 +30,12 @@
 #include <config.h>
 #include <video.h>
 #include <accel.h>
+#include <threadpool.h>
 
 /***************************************************
  * Default Options
  ***************************************************/
 
-static void run_func_default(void (*func)(void*, int, int),
-                             void * gavl_data,
-                             int start, int len,
-                             void * client_data, int thread)
-  {
-  func(gavl_data, start, len);
-  }
-
-static void stop_func_default(void * client_data, int thread)
-  {
-  }
-
 void gavl_video_options_set_defaults(gavl_video_options_t * opt)
   {
   memset(opt, 0, sizeof(*opt));
@@ -57,8 +46,8 @@ void gavl_video_options_set_defaults(gavl_video_options_t * opt)
   opt->downscale_filter = GAVL_DOWNSCALE_FILTER_WIDE;
 
   opt->num_threads = 1;
-  opt->run_func = run_func_default;
-  opt->stop_func = stop_func_default;
+  opt->run_func = gavl_run_func_default;
+  opt->stop_func = gavl_stop_func_default;
   
   gavl_init_memcpy();
   }
@@ -80,7 +69,7 @@ void gavl_video_options_set_run_func(gavl_video_options_t * opt,
                                                  void * client_data, int thread), 
                                      void * client_data)
   {
-  opt->run_func = run;
+  opt->run_func = run ? run : gavl_run_func_default;
   opt->run_data = client_data;
   }
 
@@ -97,7 +86,7 @@ void gavl_video_options_set_stop_func(gavl_video_options_t * opt,
                                       void (*stop)(void * client_data, int thread), 
                                       void * client_data)
   {
-  opt->stop_func = stop;
+  opt->stop_func = stop ? stop : gavl_stop_func_default;
   opt->stop_data = client_data;
   }
 
@@ -109,6 +98,16 @@ gavl_video_options_get_stop_func(const gavl_video_options_t * opt,
   return opt->stop_func;
   }
 
+void gavl_video_options_run(const gavl_video_options_t * opt,
+                            gavl_video_process_func func,
+                            void * data, int num, int align)
+  {
+  gavl_threads_run(opt->num_threads,
+                   opt->run_func, opt->run_data,
+                   opt->stop_func, opt->stop_data,
+                   func, data, num, align);
+  }
+
 void gavl_video_options_set_rectangles(gavl_video_options_t * opt,
                                        const gavl_rectangle_f_t * src_rect,
                                        const gavl_rectangle_i_t * dst_rect)
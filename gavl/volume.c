@@ -41,6 +41,10 @@ static void set_factor_i(gavl_volume_control_t * v)
     case GAVL_SAMPLE_S32:
       v->factor_i = (int64_t)(v->factor_f * 0x80000000LL+0.5);
       break;
+    case GAVL_SAMPLE_S24LE:
+    case GAVL_SAMPLE_S24BE:
+      v->factor_i = (int64_t)(v->factor_f * 0x800000+0.5);
+      break;
     case GAVL_SAMPLE_NONE:
     case GAVL_SAMPLE_FLOAT:
     case GAVL_SAMPLE_DOUBLE:
@@ -144,7 +148,15 @@ void gavl_volume_control_set_format(gavl_volume_control_t * v,
       v->set_volume_channel = funcs->set_volume_double;
       break;
 
+    case GAVL_SAMPLE_S24LE:
+      v->set_volume_channel = funcs->set_volume_s24le;
+      break;
+    case GAVL_SAMPLE_S24BE:
+      v->set_volume_channel = funcs->set_volume_s24be;
+      break;
+
     case GAVL_SAMPLE_NONE:
+      v->set_volume_channel = NULL;
       break;
     }
 
@@ -170,7 +182,8 @@ void gavl_volume_control_set_format(gavl_volume_control_t * v,
 void gavl_volume_control_apply(gavl_volume_control_t * v,
                                gavl_audio_frame_t * frame)
   {
-  v->set_volume(v, frame);
+  if(v->set_volume_channel)
+    v->set_volume(v, frame);
   }
 
 
@@ -47,13 +47,30 @@ struct gavl_audio_options_s
   gavl_resample_mode_t resample_mode;
   
   const double ** mix_matrix;
+
+  /* Multithreading (see videooptions.c) */
+  int num_threads;
+  gavl_video_run_func run_func;
+  void * run_data;
+  gavl_video_stop_func stop_func;
+  void * stop_data;
   };
 
+/* Run func for the range [0, num) using the threading setup in opt */
+
+void gavl_audio_options_run(const gavl_audio_options_t * opt,
+                            gavl_video_process_func func,
+                            void * data, int num);
+
 typedef struct gavl_audio_convert_context_s gavl_audio_convert_context_t;
 typedef struct gavl_mix_matrix_s gavl_mix_matrix_t;
 
 typedef void (*gavl_audio_func_t)(struct gavl_audio_convert_context_s * ctx);
 
+/* Converts num samples from or to a packed format (see sampleformat.c) */
+
+typedef void (*gavl_packed_func_t)(const void * src, void * dst, int num);
+
 typedef struct gavl_samplerate_converter_s gavl_samplerate_converter_t;
 
 typedef struct gavl_audio_dither_context_s gavl_audio_dither_context_t;
@@ -64,6 +81,10 @@ struct gavl_samplerate_converter_s
   SRC_STATE ** resamplers;
   SRC_DATA data;
   double ratio;
+
+  /* Per resampler copies of data for processing them in parallel */
+  SRC_DATA * thread_data;
+  const gavl_audio_options_t * opt;
   };
 
 struct gavl_audio_convert_context_s
@@ -83,6 +104,7 @@ struct gavl_audio_convert_context_s
   gavl_mix_matrix_t * mix_matrix;
   gavl_samplerate_converter_t * samplerate_converter;
   gavl_audio_dither_context_t * dither_context;
+  gavl_packed_func_t packed_func;
     
   /* For chaining */
   
@@ -108,6 +130,21 @@ gavl_sampleformat_context_create(gavl_audio_options_t * opt,
                                  gavl_audio_format_t  * input_format,
                                  gavl_audio_format_t  * output_format);
 
+/*
+ *  Packed 24 bit formats are unpacked at the beginning and
+ *  packed at the end of a conversion chain. This can be done in one pass
+ *  from and to the formats, for which gavl_sample_format_can_pack()
+ *  returns 1.
+ */
+
+int gavl_sample_format_is_packed(gavl_sample_format_t format);
+int gavl_sample_format_can_pack(gavl_sample_format_t format);
+
+gavl_audio_convert_context_t *
+gavl_sampleformat_interleave_context_create(gavl_audio_options_t * opt,
+                                            gavl_audio_format_t  * input_format,
+                                            gavl_audio_format_t  * output_format);
+
 gavl_audio_convert_context_t *
 gavl_samplerate_context_create(gavl_audio_options_t * opt,
                                gavl_audio_format_t  * input_format,
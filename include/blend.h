@@ -44,6 +44,26 @@ struct gavl_overlay_blend_context_s
   int dst_sub_h, dst_sub_v;
   
   gavl_video_sink_t * sink;
+
+  /* Rectangles of the overlay window containing non transparent
+     pixels. Calculated once per overlay in put_frame() */
+  gavl_rectangle_i_t * spans;
+  int num_spans;
+  int spans_alloc;
+  int use_spans;
+  
+  /* Part of the overlay window passed to func */
+  gavl_rectangle_i_t blend_rect;
+
+  /* Premultiplied overlay in the plane layout of the destination
+     format: For each sample, s * a and 256 - a. Calculated once per
+     overlay by premultiply(), if the blend function needs it */
+  void (*premultiply)(gavl_overlay_blend_context_t * ctx);
+  uint16_t * pm_buf;
+  int pm_alloc;
+  uint16_t * pm_sa[3];
+  uint16_t * pm_ia[3];
+  int pm_stride[3];
   };
 
 gavl_blend_func_t
@@ -51,4 +71,22 @@ gavl_find_blend_func_c(gavl_overlay_blend_context_t * ctx,
                        gavl_pixelformat_t frame_format,
                        gavl_pixelformat_t * overlay_format);
 
+/*
+ *  Optimized versions: Called after gavl_find_blend_func_c() for the same
+ *  overlay format, so they can use the premultiplied overlay set up there.
+ *  They return NULL if the format isn't supported.
+ */
+
+#ifdef HAVE_SSE2
+gavl_blend_func_t
+gavl_find_blend_func_sse2(gavl_overlay_blend_context_t * ctx,
+                          gavl_pixelformat_t frame_format);
+#endif
+
+#ifdef HAVE_AVX2
+gavl_blend_func_t
+gavl_find_blend_func_avx2(gavl_overlay_blend_context_t * ctx,
+                          gavl_pixelformat_t frame_format);
+#endif
+
                        
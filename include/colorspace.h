@@ -1214,6 +1214,48 @@ typedef struct
   gavl_video_func_t graya_float_to_gray_float;
   gavl_video_func_t gray_float_to_graya_float;
   
+  /* Semi planar and 10 bit formats. Conversions, which are not
+     here, go through GAVL_YUV_420_P or GAVL_YUV_422_P_16
+     (see gavl_pixelformat_get_relay()). NV21 and P010 (as input)
+     are handled by the NV12 and P016 functions. */
+
+  gavl_video_func_t nv12_to_yuv_420_p;
+  gavl_video_func_t yuv_420_p_to_nv12;
+  gavl_video_func_t nv12_to_nv21;
+
+  gavl_video_func_t nv12_to_rgb_24;
+  gavl_video_func_t nv12_to_bgr_24;
+  gavl_video_func_t nv12_to_rgb_32;
+  gavl_video_func_t nv12_to_bgr_32;
+  gavl_video_func_t nv12_to_rgba_32;
+
+  gavl_video_func_t rgb_24_to_nv12;
+  gavl_video_func_t bgr_24_to_nv12;
+  gavl_video_func_t rgb_32_to_nv12;
+  gavl_video_func_t bgr_32_to_nv12;
+
+  gavl_video_func_t nv12_to_p016;
+  gavl_video_func_t p016_to_nv12;
+
+  gavl_video_func_t p016_to_yuv_422_p_16;
+  gavl_video_func_t yuv_422_p_16_to_p016;
+  gavl_video_func_t yuv_422_p_16_to_p010;
+
+  gavl_video_func_t p016_to_p010;
+  gavl_video_func_t p010_to_p016;
+
+  gavl_video_func_t p016_to_yuv_420_p;
+  gavl_video_func_t yuv_420_p_to_p016;
+
+  gavl_video_func_t p016_to_yuv_420_p_10;
+  gavl_video_func_t yuv_420_p_10_to_p016;
+
+  gavl_video_func_t yuv_420_p_10_to_yuv_422_p_16;
+  gavl_video_func_t yuv_422_p_16_to_yuv_420_p_10;
+
+  gavl_video_func_t yuv_420_p_10_to_yuv_420_p;
+  gavl_video_func_t yuv_420_p_to_yuv_420_p_10;
+
   } gavl_pixelformat_function_table_t;
 
 void gavl_init_rgb_rgb_funcs_c(gavl_pixelformat_function_table_t *, const gavl_video_options_t * opt);
@@ -1226,6 +1268,7 @@ void gavl_init_gray_rgb_funcs_c(gavl_pixelformat_function_table_t *, const gavl_
 void gavl_init_yuv_gray_funcs_c(gavl_pixelformat_function_table_t *, const gavl_video_options_t * opt);
 void gavl_init_gray_yuv_funcs_c(gavl_pixelformat_function_table_t *, const gavl_video_options_t * opt);
 void gavl_init_gray_gray_funcs_c(gavl_pixelformat_function_table_t *, const gavl_video_options_t * opt);
+void gavl_init_yuv_semiplanar_funcs_c(gavl_pixelformat_function_table_t *, const gavl_video_options_t * opt);
 
 
 void gavl_init_rgb_rgb_funcs_hq(gavl_pixelformat_function_table_t *, const gavl_video_options_t * opt);
@@ -1274,3 +1317,14 @@ gavl_init_yuv_rgb_funcs_mmxext(gavl_pixelformat_function_table_t *,
 void gavl_init_rgb_yuv_funcs_sse3(gavl_pixelformat_function_table_t *,
                                   const gavl_video_options_t * opt);
 #endif
+
+#ifdef HAVE_AVX2
+void gavl_init_rgb_yuv_funcs_avx2(gavl_pixelformat_function_table_t *,
+                                  int width, const gavl_video_options_t * opt);
+
+void gavl_init_yuv_rgb_funcs_avx2(gavl_pixelformat_function_table_t *,
+                                  int width, const gavl_video_options_t * opt);
+
+void gavl_init_yuv_yuv_funcs_avx2(gavl_pixelformat_function_table_t *,
+                                  int width, const gavl_video_options_t * opt);
+#endif
@@ -25,6 +25,8 @@
 /* Private structures for the deinterlacer */
 
 #include "config.h"
+#include <stdlib.h>
+#include <gavl/gavldsp.h>
 
 typedef void (*gavl_video_deinterlace_func)(gavl_video_deinterlacer_t*,
                                             const gavl_video_frame_t*in,
@@ -36,6 +38,50 @@ typedef void (*gavl_video_deinterlace_blend_func)(const uint8_t * t,
                                                   uint8_t * dst,
                                                   int num);
 
+/*
+ *  Motion adaptive interpolation of a missing line.
+ *  t, b:     Lines above and below in the current field
+ *  p1:       Same line in the previous field
+ *  p2t, p2b: Lines above and below in the field before (same parity as t and b)
+ *  p3:       Same line 3 fields back
+ */
+
+typedef void (*gavl_video_deinterlace_temporal_func)(const uint8_t * t,
+                                                     const uint8_t * b,
+                                                     const uint8_t * p1,
+                                                     const uint8_t * p2t,
+                                                     const uint8_t * p2b,
+                                                     const uint8_t * p3,
+                                                     uint8_t * dst,
+                                                     int num);
+
+/* One integer pixel, rounding like pavgb/pavgw */
+
+static inline int gavl_deinterlace_temporal_pixel(int t, int b, int p1,
+                                                  int p2t, int p2b, int p3)
+  {
+  int s, diff, diff1;
+
+  s = (t + b + 1) >> 1;
+  diff = abs(p1 - p3);
+  diff1 = (abs(t - p2t) + abs(b - p2b) + 1) >> 1;
+  if(diff < diff1)
+    diff = diff1;
+
+  if(s < p1 - diff)
+    s = (p1 > diff) ? p1 - diff : 0;
+  else if(s > p1 + diff)
+    s = p1 + diff;
+  return s;
+  }
+
+typedef struct
+  {
+  gavl_video_deinterlace_temporal_func func_8;
+  gavl_video_deinterlace_temporal_func func_16;
+  gavl_video_deinterlace_temporal_func func_float;
+  } gavl_video_deinterlace_temporal_func_table_t;
+
 typedef struct
   {
   gavl_video_deinterlace_blend_func func_packed_15;
@@ -70,6 +116,28 @@ struct gavl_video_deinterlacer_s
   int sub_v;
   
   int mixed;
+
+  /* Temporal deinterlacing */
+  gavl_video_deinterlace_temporal_func temporal_func;
+  gavl_dsp_context_t * dsp;
+  int bytes_per_component;
+
+  /* Previous input frames, history[0] is the last one */
+  gavl_video_frame_t * history[2];
+  int history_frames;
+
+  /* Current job, processed in slices. For temporal deinterlacing, the
+     kept lines come from cur, the missing lines are interpolated from
+     cur, p1, p2 and p3 (see above) */
+  const gavl_video_frame_t * cur;
+  const gavl_video_frame_t * p1;
+  const gavl_video_frame_t * p2;
+  const gavl_video_frame_t * p3;
+  gavl_video_frame_t * dst;
+  int field;
+  int plane;
+  int plane_width;
+  int plane_height;
   };
 
 /* Find conversion function */
@@ -81,6 +149,25 @@ int gavl_deinterlacer_init_blend(gavl_video_deinterlacer_t * d);
 
 int gavl_deinterlacer_init_copy(gavl_video_deinterlacer_t * d);
 
+int gavl_deinterlacer_init_temporal(gavl_video_deinterlacer_t * d);
+
+void gavl_deinterlacer_cleanup_temporal(gavl_video_deinterlacer_t * d);
+
+void gavl_deinterlacer_reset_temporal(gavl_video_deinterlacer_t * d);
+
+/* Interpolate the picture at the time of the first (field == 0) or
+   second (field == 1) field of the frame */
+
+void gavl_deinterlacer_temporal_field(gavl_video_deinterlacer_t * d,
+                                      const gavl_video_frame_t * input_frame,
+                                      gavl_video_frame_t * output_frame,
+                                      int field);
+
+/* Remember the input frame for the next call */
+
+void gavl_deinterlacer_temporal_push(gavl_video_deinterlacer_t * d,
+                                     const gavl_video_frame_t * input_frame);
+
 void
 gavl_find_deinterlacer_blend_funcs_c(gavl_video_deinterlace_blend_func_table_t * tab,
                                      const gavl_video_options_t * opt,
@@ -98,6 +185,25 @@ gavl_find_deinterlacer_blend_funcs_mmxext(gavl_video_deinterlace_blend_func_tabl
                                           const gavl_video_format_t * format);
 #endif
 
+void
+gavl_find_deinterlacer_temporal_funcs_c(gavl_video_deinterlace_temporal_func_table_t * tab,
+                                        const gavl_video_options_t * opt,
+                                        const gavl_video_format_t * format);
+
+#ifdef HAVE_SSE2
+void
+gavl_find_deinterlacer_temporal_funcs_sse2(gavl_video_deinterlace_temporal_func_table_t * tab,
+                                           const gavl_video_options_t * opt,
+                                           const gavl_video_format_t * format);
+#endif
+
+#ifdef HAVE_AVX2
+void
+gavl_find_deinterlacer_temporal_funcs_avx2(gavl_video_deinterlace_temporal_func_table_t * tab,
+                                           const gavl_video_options_t * opt,
+                                           const gavl_video_format_t * format);
+#endif
+
 #ifdef HAVE_3DNOW
 void
 gavl_find_deinterlacer_blend_funcs_3dnow(gavl_video_deinterlace_blend_func_table_t * tab,
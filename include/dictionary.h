@@ -0,0 +1,32 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+#ifndef _GAVL_DICTIONARY_PRIVATE_H_
+#define _GAVL_DICTIONARY_PRIVATE_H_
+
+#include <gavl/value.h>
+
+/* Update the hash index after the entries were filled in directly */
+
+void gavl_dictionary_rebuild_index(gavl_dictionary_t * d);
+
+#endif // _GAVL_DICTIONARY_PRIVATE_H_
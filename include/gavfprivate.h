@@ -28,7 +28,32 @@ struct gavl_io_s
   gavl_handle_msg_func msg_callback;
   void * msg_data;
   
-  gavl_buffer_t get_buf;
+  /* Read buffer: Data between read_buf.pos and read_buf.len were read
+     from the underlying io but not consumed yet. Up to read_buf_size bytes
+     are read ahead */
+  gavl_buffer_t read_buf;
+  int read_buf_size;
+
+  /* Zero copy reading (memory mapped files). map_func returns a pointer to
+     len bytes at the current position, advances the position and adds a
+     reference, which is released with unmap_func(priv) */
+  const uint8_t * (*map_func)(void * priv, int len);
+  void (*unmap_func)(void * priv);
+
+  /* Scatter/gather writing. Must write everything and return the total
+     number of bytes or less on error */
+  gavf_writev_func writev_func;
+
+  /* Write coalescing: Small writes are collected until write_buf_size
+     bytes are reached or gavf_io_flush() is called */
+  gavl_buffer_t write_buf;
+  int write_buf_size;
+
+  /* Interruptible reading: If set and the io can poll and read
+     nonblocking, blocking reads wait in small steps and give up
+     as soon as interrupt_func returns nonzero */
+  int (*interrupt_func)(void * data);
+  void * interrupt_data;
   };
 
 void gavf_io_init(gavf_io_t * ret,
@@ -43,10 +68,17 @@ void gavf_io_init(gavf_io_t * ret,
 
 void gavf_io_skip(gavf_io_t * io, int bytes);
 
+/* Read p->data_len bytes of packet payload. Points p->data into the
+   mapped file if possible */
+int gavf_io_read_packet_data(gavf_io_t * io, gavl_packet_t * p);
+
 void gavf_io_init_buf_read(gavf_io_t * io, gavl_buffer_t * buf);
 void gavf_io_init_buf_write(gavf_io_t * io, gavl_buffer_t * buf);
 
 void gavf_io_set_nonblock_read(gavf_io_t * io, gavf_read_func read_nonblock);
+void gavf_io_set_writev_func(gavf_io_t * io, gavf_writev_func writev);
+void gavf_io_set_interrupt_func(gavf_io_t * io,
+                                int (*func)(void * data), void * data);
 
 /* Packetbuffer */
 
@@ -172,8 +204,37 @@ struct gavf_options_s
   {
   uint32_t flags;
   gavl_time_t sync_distance;
+
+  /* Write coalescing window */
+  int coalesce_bytes;
+  gavl_time_t coalesce_time;
+
+  /* Read ahead budget of the demuxer thread */
+  int demux_bytes;
+  gavl_time_t demux_time;
   };
 
+/* Buffer size if only the coalescing time is given */
+#define GAVF_COALESCE_BYTES_DEFAULT 65536
+
+/* Demuxer thread budget if none is given */
+#define GAVF_DEMUX_BYTES_DEFAULT (8*1024*1024)
+#define GAVF_DEMUX_TIME_DEFAULT  (2*GAVL_TIME_SCALE)
+
+/* Demuxer thread */
+
+typedef struct gavf_demux_thread_s gavf_demux_thread_t;
+
+gavf_demux_thread_t * gavf_demux_thread_create(const gavf_options_t * opt);
+
+/* Stop the thread (if running) and reset the EOF state. The
+   thread is restarted by the next read */
+void gavf_demux_thread_stop(gavf_demux_thread_t * dt);
+void gavf_demux_thread_destroy(gavf_demux_thread_t * dt);
+
+gavl_source_status_t
+gavf_demux_thread_read_packet(gavf_stream_t * s, gavl_packet_t ** p);
+
 /* Extension header */
 
 typedef struct
@@ -268,17 +329,48 @@ typedef struct
   /* Secondary variables (not in the file) */
   int num_streams;
   int pts_len;
+
+  /* Paged index (read mode): Entries have a fixed size in the file
+     and are loaded in pages of GAVF_SYNC_INDEX_PAGE_SIZE on demand */
+  
+  gavf_io_t * io;
+  int64_t entries_start; // File position of the first entry
+  int entry_size;
+  
+  struct
+    {
+    uint64_t * pos;
+    int64_t * pts; // num_streams per entry
+    } * pages;
+
+  int num_pages;
   
   } gavf_sync_index_t;
 
+#define GAVF_SYNC_INDEX_PAGE_SIZE 512
+
 void gavf_sync_index_init(gavf_sync_index_t * idx, int num_streams);
 
 void gavf_sync_index_add(gavf_t * g, uint64_t pos);
 
+/* The read functions start at the tag, which tells the layout */
+
 int gavf_sync_index_read(gavf_io_t * io, gavf_sync_index_t * idx);
+
+/* Read only the index header and load the entries on demand */
+int gavf_sync_index_read_paged(gavf_io_t * io, gavf_sync_index_t * idx);
+
+uint64_t gavf_sync_index_get_pos(gavf_sync_index_t * idx, int64_t i);
+const int64_t * gavf_sync_index_get_pts(gavf_sync_index_t * idx, int64_t i);
+
+/* Return the last entry <= max where the pts of stream is <= time
+   (0 if there is none) or -1 on error */
+int64_t gavf_sync_index_find(gavf_sync_index_t * idx, int stream,
+                             int64_t time, int64_t max);
+
 int gavf_sync_index_write(gavf_io_t * io, const gavf_sync_index_t * idx);
 void gavf_sync_index_free(gavf_sync_index_t * idx);
-void gavf_sync_index_dump(const gavf_sync_index_t * idx);
+void gavf_sync_index_dump(gavf_sync_index_t * idx);
 
 /* Global gavf structure */
 
@@ -310,6 +402,12 @@ struct gavf_s
   gavf_sync_index_t     si;
   gavf_packet_index_t   pi;
 
+  /* File positions of the sync indices of all tracks (read mode) */
+  int64_t * sync_index_pos;
+
+  /* Background demuxer (GAVF_OPT_FLAG_DEMUX_THREAD) */
+  gavf_demux_thread_t * dt;
+
   gavf_packet_header_t  pkthdr;
   
   gavf_stream_t * streams;
@@ -337,6 +435,9 @@ struct gavf_s
   gavl_time_t last_sync_time;
   gavl_time_t sync_distance;
 
+  /* Time of the first packet since the last flush (write coalescing) */
+  gavl_time_t coalesce_start;
+
   encoding_mode_t encoding_mode;
   encoding_mode_t final_encoding_mode;
 
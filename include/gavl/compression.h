@@ -361,6 +361,9 @@ typedef struct
   int32_t dst_y;             //!< Y-coordinate in the destination frame (for overlays)
 
   uint32_t id;    //!< ID of the gavf stream where this packet belongs
+
+  void (*data_unref)(void * data_priv); //!< If non-NULL, data is not owned by the packet and released with this (since 2.0.0)
+  void * data_priv; //!< Argument for data_unref (since 2.0.0)
   
   } gavl_packet_t;
 
@@ -391,6 +394,28 @@ void gavl_packet_alloc(gavl_packet_t * p, int len);
 GAVL_PUBLIC
 void gavl_packet_free(gavl_packet_t * p);
 
+/** \brief Let a packet point to external data
+ *  \param p A packet
+ *  \param data Payload
+ *  \param len Length of the payload
+ *  \param unref Function to call when the packet releases the data
+ *  \param priv Argument for unref
+ *
+ *  This is used for zero copy reading, e.g. from memory mapped files.
+ *  The caller passes one reference of the data to the packet,
+ *  which is released by \ref gavl_packet_free, \ref gavl_packet_reset
+ *  or when the packet gets its own memory by \ref gavl_packet_alloc
+ *  (the data are copied then). Like for other packets, the
+ *  \ref GAVL_PACKET_PADDING bytes after the payload must be readable
+ *  and zero.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+void gavl_packet_set_external(gavl_packet_t * p, uint8_t * data, int len,
+                              void (*unref)(void * priv), void * priv);
+
 /** \brief Copy a packet
  *  \param dst Destination
  *  \param src Source
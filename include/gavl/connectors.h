@@ -147,6 +147,18 @@ typedef gavl_source_status_t
 
 #define GAVL_SOURCE_SRC_DISCONTINUOUS       (1<<3)
 
+/** \brief Destination accepts frames pointing into the buffers of the source.
+ *
+ *  If an audio frame is read with *frame == NULL and the requested
+ *  samples are completely inside the buffered frame, the source
+ *  returns a subframe of it instead of copying the samples.
+ *  The frame is valid until the next read call.
+ *
+ *  Since 2.0.0
+ */
+
+#define GAVL_SOURCE_DST_SUBFRAMES           (1<<0)
+
 
 /* Called by the source */
 
@@ -425,7 +437,8 @@ gavl_audio_source_get_dst_flags(gavl_audio_source_t * s);
  *  the frames will converted. For this, we have a
  *  \ref gavl_audio_converter_t. In addition, if the
  *  samples_per_frame members are different, the frames will
- *  be repackaged.
+ *  be repackaged. Pass \ref GAVL_SOURCE_DST_SUBFRAMES in dst_flags
+ *  to avoid copying for the repackaging where possible.
  */
 
 GAVL_PUBLIC
@@ -483,6 +496,21 @@ GAVL_PUBLIC
 int gavl_audio_source_read_samples(void*s, gavl_audio_frame_t * frame,
                                    int num_samples);
 
+/** \brief Get copy statistics of an audio source
+ *  \param s An audio source
+ *  \param bytes_copied Returns the number of bytes copied for repackaging (or NULL)
+ *  \param bytes_passed Returns the number of bytes passed without copying (or NULL)
+ *
+ *  Samples, which are only converted, are not counted.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+void gavl_audio_source_get_copy_stats(gavl_audio_source_t * s,
+                                      int64_t * bytes_copied,
+                                      int64_t * bytes_passed);
+
 /** \brief Get coversion options of an audio source
  *  \param s An audio source
  *  \returns Conversion options
@@ -1312,6 +1340,341 @@ gavl_packet_connector_get_source_status(gavl_packet_connector_t * c);
  * @}
  */
   
+/*! \defgroup ringbuffers Ring buffers
+ *  \ingroup pipelines
+ *
+ *  Ring buffers pass audio samples or packets from one thread to
+ *  another without locking. There must be exactly one producer thread
+ *  and one consumer thread. The producer writes into a sink, the
+ *  consumer reads from a source. Alternatively, both sides can access
+ *  the buffer memory directly with the begin/end functions. Don't mix
+ *  the direct functions with the sink (or source) on the same side.
+ *
+ *  If the buffer is full, new data are dropped and the overrun
+ *  counter is incremented. If it's empty, the source returns
+ *  \ref GAVL_SOURCE_AGAIN and the underrun counter is incremented.
+ *
+ *  Since 2.0.0
+ *
+ * @{
+ */
+
+/*! \brief Opaque structure for the audio ring buffer
+ *
+ * You don't want to know what's inside.
+ */
+
+typedef struct gavl_audio_ringbuffer_s gavl_audio_ringbuffer_t;
+
+/*! \brief Opaque structure for the packet ring buffer
+ *
+ * You don't want to know what's inside.
+ */
+
+typedef struct gavl_packet_ringbuffer_s gavl_packet_ringbuffer_t;
+
+/*! \brief Create an audio ring buffer
+ *  \param format Audio format
+ *  \param capacity Maximum number of samples in the buffer
+ *  \returns A newly created ring buffer
+ *
+ *  The samples_per_frame member of the format is the maximum size
+ *  of the frames read from the source.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC gavl_audio_ringbuffer_t *
+gavl_audio_ringbuffer_create(const gavl_audio_format_t * format,
+                             int capacity);
+
+/*! \brief Destroy an audio ring buffer
+ *  \param rb An audio ring buffer
+ *
+ *  This also destroys the sink and the source.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC void
+gavl_audio_ringbuffer_destroy(gavl_audio_ringbuffer_t * rb);
+
+/*! \brief Get the producer side of an audio ring buffer
+ *  \param rb An audio ring buffer
+ *  \returns An audio sink
+ *
+ *  If \ref gavl_audio_sink_get_frame returns non-NULL, the samples
+ *  are written directly into the buffer.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC gavl_audio_sink_t *
+gavl_audio_ringbuffer_get_sink(gavl_audio_ringbuffer_t * rb);
+
+/*! \brief Get the consumer side of an audio ring buffer
+ *  \param rb An audio ring buffer
+ *  \returns An audio source
+ *
+ *  The source returns \ref GAVL_SOURCE_EOF after
+ *  \ref gavl_audio_ringbuffer_set_eof was called and all samples
+ *  were read.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC gavl_audio_source_t *
+gavl_audio_ringbuffer_get_source(gavl_audio_ringbuffer_t * rb);
+
+/*! \brief Start writing into an audio ring buffer
+ *  \param rb An audio ring buffer
+ *  \param frame Returns a frame pointing into the buffer
+ *  \returns Number of samples, which can be written into frame
+ *
+ *  Call \ref gavl_audio_ringbuffer_write_end after writing the
+ *  samples. The returned frame never wraps around the end of the
+ *  buffer, so it can be smaller than the free space.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC int
+gavl_audio_ringbuffer_write_begin(gavl_audio_ringbuffer_t * rb,
+                                  gavl_audio_frame_t ** frame);
+
+/*! \brief Finish writing into an audio ring buffer
+ *  \param rb An audio ring buffer
+ *  \param num Number of samples written
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC void
+gavl_audio_ringbuffer_write_end(gavl_audio_ringbuffer_t * rb, int num);
+
+/*! \brief Start reading from an audio ring buffer
+ *  \param rb An audio ring buffer
+ *  \param frame Returns a frame pointing into the buffer
+ *  \returns Number of samples, which can be read from frame
+ *
+ *  If samples are available, call \ref gavl_audio_ringbuffer_read_end
+ *  after reading them. The returned frame never wraps around the end
+ *  of the buffer.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC int
+gavl_audio_ringbuffer_read_begin(gavl_audio_ringbuffer_t * rb,
+                                 gavl_audio_frame_t ** frame);
+
+/*! \brief Finish reading from an audio ring buffer
+ *  \param rb An audio ring buffer
+ *  \param num Number of samples read
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC void
+gavl_audio_ringbuffer_read_end(gavl_audio_ringbuffer_t * rb, int num);
+
+/*! \brief Signal the end of the stream
+ *  \param rb An audio ring buffer
+ *
+ *  Call this from the producer after the last samples were written.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC void
+gavl_audio_ringbuffer_set_eof(gavl_audio_ringbuffer_t * rb);
+
+/*! \brief Check for the end of the stream
+ *  \param rb An audio ring buffer
+ *  \returns 1 if EOF was signalled and all samples were read, 0 else
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC int
+gavl_audio_ringbuffer_get_eof(gavl_audio_ringbuffer_t * rb);
+
+/*! \brief Get the number of buffered samples
+ *  \param rb An audio ring buffer
+ *  \returns Number of samples, which were written but not yet read
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC int
+gavl_audio_ringbuffer_get_fill(gavl_audio_ringbuffer_t * rb);
+
+/*! \brief Get statistics of an audio ring buffer
+ *  \param rb An audio ring buffer
+ *  \param overruns Returns the number of frames, which didn't fit completely (or NULL)
+ *  \param underruns Returns the number of reads from the empty buffer (or NULL)
+ *
+ *  This can be called from any thread.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC void
+gavl_audio_ringbuffer_get_stats(gavl_audio_ringbuffer_t * rb,
+                                int64_t * overruns,
+                                int64_t * underruns);
+
+/*! \brief Create a packet ring buffer
+ *  \param capacity Maximum number of packets in the buffer
+ *  \returns A newly created ring buffer
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC gavl_packet_ringbuffer_t *
+gavl_packet_ringbuffer_create(int capacity);
+
+/*! \brief Destroy a packet ring buffer
+ *  \param rb A packet ring buffer
+ *
+ *  This also destroys the sink and the source.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC void
+gavl_packet_ringbuffer_destroy(gavl_packet_ringbuffer_t * rb);
+
+/*! \brief Get the producer side of a packet ring buffer
+ *  \param rb A packet ring buffer
+ *  \returns A packet sink
+ *
+ *  If \ref gavl_packet_sink_get_packet returns non-NULL, the packet
+ *  is stored directly in the buffer.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC gavl_packet_sink_t *
+gavl_packet_ringbuffer_get_sink(gavl_packet_ringbuffer_t * rb);
+
+/*! \brief Get the consumer side of a packet ring buffer
+ *  \param rb A packet ring buffer
+ *  \returns A packet source
+ *
+ *  The source has no format information. To create a source with
+ *  formats, pass \ref gavl_packet_ringbuffer_read_packet with the
+ *  flag \ref GAVL_SOURCE_SRC_ALLOC to
+ *  \ref gavl_packet_source_create_audio or
+ *  \ref gavl_packet_source_create_video.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC gavl_packet_source_t *
+gavl_packet_ringbuffer_get_source(gavl_packet_ringbuffer_t * rb);
+
+/*! \brief Read a packet from a packet ring buffer
+ *  \param rb A packet ring buffer
+ *  \param p Where to store the packet
+ *  \returns Source status
+ *
+ *  This has the prototype of \ref gavl_packet_source_func_t. If *p is NULL,
+ *  it's set to a packet inside the buffer, which stays valid until
+ *  the next call.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC gavl_source_status_t
+gavl_packet_ringbuffer_read_packet(void * rb, gavl_packet_t ** p);
+
+/*! \brief Start writing into a packet ring buffer
+ *  \param rb A packet ring buffer
+ *  \returns A packet inside the buffer or NULL if the buffer is full
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC gavl_packet_t *
+gavl_packet_ringbuffer_write_begin(gavl_packet_ringbuffer_t * rb);
+
+/*! \brief Finish writing into a packet ring buffer
+ *  \param rb A packet ring buffer
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC void
+gavl_packet_ringbuffer_write_end(gavl_packet_ringbuffer_t * rb);
+
+/*! \brief Start reading from a packet ring buffer
+ *  \param rb A packet ring buffer
+ *  \returns A packet inside the buffer or NULL if the buffer is empty
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC gavl_packet_t *
+gavl_packet_ringbuffer_read_begin(gavl_packet_ringbuffer_t * rb);
+
+/*! \brief Finish reading from a packet ring buffer
+ *  \param rb A packet ring buffer
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC void
+gavl_packet_ringbuffer_read_end(gavl_packet_ringbuffer_t * rb);
+
+/*! \brief Signal the end of the stream
+ *  \param rb A packet ring buffer
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC void
+gavl_packet_ringbuffer_set_eof(gavl_packet_ringbuffer_t * rb);
+
+/*! \brief Check for the end of the stream
+ *  \param rb A packet ring buffer
+ *  \returns 1 if EOF was signalled and all packets were read, 0 else
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC int
+gavl_packet_ringbuffer_get_eof(gavl_packet_ringbuffer_t * rb);
+
+/*! \brief Get the number of buffered packets
+ *  \param rb A packet ring buffer
+ *  \returns Number of packets, which were written but not yet read
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC int
+gavl_packet_ringbuffer_get_fill(gavl_packet_ringbuffer_t * rb);
+
+/*! \brief Get statistics of a packet ring buffer
+ *  \param rb A packet ring buffer
+ *  \param overruns Returns the number of dropped packets (or NULL)
+ *  \param underruns Returns the number of reads from the empty buffer (or NULL)
+ *
+ *  This can be called from any thread.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC void
+gavl_packet_ringbuffer_get_stats(gavl_packet_ringbuffer_t * rb,
+                                 int64_t * overruns,
+                                 int64_t * underruns);
+
+/**
+ * @}
+ */
+
 #ifdef __cplusplus
 }
 #endif
@@ -84,7 +84,7 @@
       }
    
   Optional:
-  CHUNK("GAVFSIDX") 8 bytes
+  CHUNK("GAVFSIDF") 8 bytes (CHUNK("GAVFSIDX") in older files)
   len:      8 bytes, bytes to follow, 0 if unknown
   len bytes sync index
   
@@ -108,6 +108,7 @@
 
 #define GAVF_TAG_SYNC_HEADER    "GAVFSYNC"
 #define GAVF_TAG_SYNC_INDEX     "GAVFSIDX"
+#define GAVF_TAG_SYNC_INDEX_FIXED "GAVFSIDF"
 #define GAVF_TAG_PACKET_INDEX   "GAVFPIDX"
 #define GAVF_TAG_FOOTER         "GAVFFOOT"
 #define GAVF_TAG_TAIL           "GAVFTAIL"
@@ -143,6 +144,9 @@ typedef void (*gavf_close_func)(void * priv);
 typedef int (*gavf_flush_func)(void * priv);
 typedef int (*gavf_poll_func)(void * priv, int timeout);
 
+struct iovec;
+typedef int (*gavf_writev_func)(void * priv, const struct iovec * iov, int iovcnt);
+
 
 
 // typedef int (*gavf_io_cb_func)(void * priv, int type, const void * data);
@@ -206,6 +210,13 @@ int gavf_io_flush(gavf_io_t *);
 GAVL_PUBLIC
 gavf_io_t * gavf_io_create_file(FILE * f, int wr, int can_seek, int do_close);
 
+/* Read from a file descriptor (e.g. a pipe) without stdio buffering.
+   Blocking reads of the demuxer thread (GAVF_OPT_FLAG_DEMUX_THREAD)
+   can be interrupted for such ios and for sockets, while reads from
+   stdio streams block until data arrive. */
+GAVL_PUBLIC
+gavf_io_t * gavf_io_create_fd_read(int fd, int do_close);
+
 #define GAVF_IO_SOCKET_DO_CLOSE     (1<<0)
 
 #define GAVF_IO_SOCKET_BUFFER_READ  (1<<1)
@@ -234,6 +245,13 @@ gavf_io_t * gavf_io_create_mem_read(const uint8_t * ptr, int len);
 GAVL_PUBLIC
 gavf_io_t * gavf_io_create_mem_write();
 
+/* Read a local file through a memory mapping. Packets, which are
+   followed by GAVL_PACKET_PADDING zero bytes in the file, point directly
+   into the mapped file and keep it mapped until they are freed or
+   reset. All other packets are copied. */
+GAVL_PUBLIC
+gavf_io_t * gavf_io_create_mmap_read(const char * filename);
+
 GAVL_PUBLIC
 gavf_io_t * gavf_io_create_tls_client(int fd, const char * server_name, int flags);
 
@@ -259,9 +277,35 @@ int gavf_io_read_data_nonblock(gavf_io_t * io, uint8_t * buf, int len);
 GAVL_PUBLIC
 int gavf_io_get_data(gavf_io_t * io, uint8_t * buf, int len);
 
+/* Make at least len bytes available in the read buffer without removing
+   them from the input. Returns the number of available bytes (less than len
+   on EOF) and stores a pointer to them in ptr. The data stay valid until the
+   next read or seek operation */
+GAVL_PUBLIC
+int gavf_io_peek_data(gavf_io_t * io, const uint8_t ** ptr, int len);
+
+/* Remove len bytes returned by gavf_io_peek_data() from the input */
+GAVL_PUBLIC
+void gavf_io_consume_data(gavf_io_t * io, int len);
+
+/* Read ahead up to size bytes so small reads don't reach the underlying read
+   function. If the io has a nonblocking read function, only the requested bytes
+   are read blocking. 0 disables read ahead */
+GAVL_PUBLIC
+void gavf_io_set_read_buffer(gavf_io_t * io, int size);
+
 GAVL_PUBLIC
 int gavf_io_write_data(gavf_io_t * io, const uint8_t * buf, int len);
 
+/* Write several buffers at once (like writev(2)). Returns the total number of bytes */
+GAVL_PUBLIC
+int gavf_io_writev(gavf_io_t * io, const struct iovec * iov, int iovcnt);
+
+/* Collect up to size bytes of small writes before passing them to the
+   underlying write function. They are sent by gavf_io_flush(). 0 disables buffering */
+GAVL_PUBLIC
+void gavf_io_set_write_buffer(gavf_io_t * io, int size);
+
 GAVL_PUBLIC
 int gavf_io_read_line(gavf_io_t * io, char ** ret, int * ret_alloc, int max_len);
 
@@ -481,6 +525,11 @@ typedef void (*gavf_packet_unref_func)(gavl_packet_t * p, void * priv);
 
 #define GAVF_OPT_FLAG_ORIG_PTS     (1<<8)
 
+/* Read packets in a background thread. Packet sources take them from
+   per stream queues and never wait for I/O unless the queue is empty.
+   Message callbacks are called from the demuxer thread then */
+#define GAVF_OPT_FLAG_DEMUX_THREAD (1<<9)
+
 
 GAVL_PUBLIC
 void gavf_options_set_flags(gavf_options_t *, int flags);
@@ -492,6 +541,24 @@ GAVL_PUBLIC
 void gavf_options_set_sync_distance(gavf_options_t *,
                                     gavl_time_t sync_distance);
 
+/* Collect packets before sending them to the output. Data are sent if
+   more than bytes are buffered or the packets span more than time
+   (in GAVL_TIME_SCALE units). Messages are always sent immediately.
+   0 for both (default) flushes the output after each packet */
+
+GAVL_PUBLIC
+void gavf_options_set_write_coalescing(gavf_options_t *,
+                                       int bytes, gavl_time_t time);
+
+/* Budget of the demuxer thread: It pauses if more than bytes are
+   buffered or the queue of a continuous stream spans more than time
+   (in GAVL_TIME_SCALE units). 0 disables a limit. If both are 0 (default),
+   8 MB and 2 seconds are used */
+
+GAVL_PUBLIC
+void gavf_options_set_demux_buffer(gavf_options_t *,
+                                   int bytes, gavl_time_t time);
+
 GAVL_PUBLIC
 gavf_options_t * gavf_options_create();
 
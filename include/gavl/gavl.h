@@ -113,6 +113,16 @@ typedef struct gavl_video_frame_s gavl_video_frame_t;
  *  which can transfer the tasks to worker threads. Multithreading is configured with
  *  \ref gavl_video_options_set_num_threads, \ref gavl_video_options_set_run_func and
  *  \ref gavl_video_options_set_stop_func
+ *
+ *  The audio converter uses the same mechanism for resampling, where
+ *  the pieces are groups of channels. It's configured with
+ *  \ref gavl_audio_options_set_num_threads, \ref gavl_audio_options_set_run_func and
+ *  \ref gavl_audio_options_set_stop_func
+ *
+ *  If the number of threads is larger than one and the default run function
+ *  is used, gavl uses a builtin pool of persistent worker threads.
+ *  It splits the work into many small tiles of scanlines, which are
+ *  balanced between the threads by work stealing.
  *  
  *  @{
  */
@@ -224,6 +234,7 @@ typedef void (*gavl_video_stop_func)(void * client_data, int thread);
 #define GAVL_ACCEL_3DNOW    (1<<5) //!< AMD 3Dnow
 #define GAVL_ACCEL_3DNOWEXT (1<<6) //!< AMD 3Dnow ext
 #define GAVL_ACCEL_SSSE3    (1<<7) //!< Intel SSSE3
+#define GAVL_ACCEL_AVX2     (1<<8) //!< Intel AVX2
 
 /** \brief Get the supported acceleration flags
  *  \returns A combination of GAVL_ACCEL_* flags.
@@ -258,7 +269,13 @@ GAVL_PUBLIC int gavl_accel_supported();
 /** \ingroup audio_format
  *  \brief Format of one audio sample
  * 
- * For multibyte numbers, the byte order is always machine native endian
+ * For multibyte numbers, the byte order is always machine native endian,
+ * except for the packed 24 bit formats, which have an explicit byte order.
+ *
+ * The packed 24 bit formats can be converted, copied and transported
+ * and are supported by the volume control and the peak detector.
+ * For mixing and resampling, the audio converter unpacks them to one of
+ * the other formats.
  */
   
 typedef enum
@@ -270,7 +287,9 @@ typedef enum
     GAVL_SAMPLE_S16    = 4, /*!< Signed 16 bit */
     GAVL_SAMPLE_S32    = 5, /*!< Signed 32 bit */
     GAVL_SAMPLE_FLOAT  = 6,  /*!< Floating point (-1.0 .. 1.0) */
-    GAVL_SAMPLE_DOUBLE = 7  /*!< Double (-1.0 .. 1.0) */
+    GAVL_SAMPLE_DOUBLE = 7,  /*!< Double (-1.0 .. 1.0) */
+    GAVL_SAMPLE_S24LE  = 8,  /*!< Signed 24 bit, 3 bytes little endian, accessed as u_8 (Since 2.0.0) */
+    GAVL_SAMPLE_S24BE  = 9   /*!< Signed 24 bit, 3 bytes big endian, accessed as u_8 (Since 2.0.0) */
   } gavl_sample_format_t;
 
 /** \ingroup audio_format
@@ -1132,6 +1151,92 @@ void gavl_audio_options_set_mix_matrix(gavl_audio_options_t * opt,
 GAVL_PUBLIC
 const double **
 gavl_audio_options_get_mix_matrix(const gavl_audio_options_t * opt);
+
+/*! \ingroup audio_options
+ *  \brief Set number of threads
+ *  \param opt Audio options
+ *  \param n Number of threads
+ *
+ *  Channels (or channel pairs) are resampled in parallel. The result
+ *  is identical to the single threaded one. If the default run function
+ *  is set, the threads are taken from the builtin thread pool.
+ *
+ *  Since 2.0.0
+ */
+  
+GAVL_PUBLIC
+void gavl_audio_options_set_num_threads(gavl_audio_options_t * opt, int n);
+
+/*! \ingroup audio_options
+ *  \brief Get number of threads
+ *  \param opt Audio options
+ *  \returns Number of threads
+ *
+ *  Since 2.0.0
+ */
+  
+GAVL_PUBLIC
+int gavl_audio_options_get_num_threads(const gavl_audio_options_t * opt);
+
+/*! \ingroup audio_options
+ *  \brief Set function to be passed to each thread
+ *  \param opt Audio options
+ *  \param func Function to be passed to each thread
+ *  \param client_data Client data to be passed to the run function
+ *
+ *  The default function calls func in the calling thread. As long as it is
+ *  set, gavl uses a builtin thread pool instead of calling it. Passing NULL
+ *  restores the default.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+void gavl_audio_options_set_run_func(gavl_audio_options_t * opt,
+                                     gavl_video_run_func func,
+                                     void * client_data);
+
+/*! \ingroup audio_options
+ *  \brief Get function to be passed to each thread
+ *  \param opt Audio options
+ *  \param client_data Returns client data
+ *  \return The function
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+gavl_video_run_func
+gavl_audio_options_get_run_func(const gavl_audio_options_t * opt,
+                                void ** client_data);
+
+/*! \ingroup audio_options
+ *  \brief Set function to wait for a thread
+ *  \param opt Audio options
+ *  \param func Function to wait for a thread
+ *  \param client_data Client data to be passed to the stop function
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+void gavl_audio_options_set_stop_func(gavl_audio_options_t * opt,
+                                      gavl_video_stop_func func, 
+                                      void * client_data);
+
+/*! \ingroup audio_options
+ *  \brief Get function to wait for a thread
+ *  \param opt Audio options
+ *  \param client_data Returns client data
+ *  \return The function
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+gavl_video_stop_func
+gavl_audio_options_get_stop_func(const gavl_audio_options_t * opt,
+                                 void ** client_data);
   
 /*! \ingroup audio_options
  *  \brief Create an options container
@@ -1799,6 +1904,12 @@ void gavl_rectangle_f_dump(const gavl_rectangle_f_t * r);
  * Flag for grayscale pixelformats
  */
 #define GAVL_PIXFMT_GRAY   (1<<13)
+
+/** \ingroup video_format
+ * Flag for semi planar pixelformats (luma plane followed by one plane
+ * with interleaved chroma)
+ */
+#define GAVL_PIXFMT_SEMIPLANAR (1<<14)
   
 /*! \ingroup video_format
  * \brief Pixelformat definition
@@ -1933,6 +2044,22 @@ enum gavl_pixelformat_e
     /*! 16 bit Planar YCbCr 4:2:2. Each component is an uint16_t in native byte order.
      */
     GAVL_YUV_422_P_16 = 10 | GAVL_PIXFMT_PLANAR | GAVL_PIXFMT_YUV,
+
+    /*! Semi planar YCbCr 4:2:0. Luma plane followed by a plane with interleaved Cb and Cr. Each component is an uint8_t
+     */
+    GAVL_NV12 = 11 | GAVL_PIXFMT_PLANAR | GAVL_PIXFMT_YUV | GAVL_PIXFMT_SEMIPLANAR,
+    /*! Semi planar YCbCr 4:2:0. Like \ref GAVL_NV12 but with Cr before Cb
+     */
+    GAVL_NV21 = 12 | GAVL_PIXFMT_PLANAR | GAVL_PIXFMT_YUV | GAVL_PIXFMT_SEMIPLANAR,
+    /*! Semi planar YCbCr 4:2:0. Like \ref GAVL_NV12 but each component is an uint16_t in native byte order with 10 significant bits in the upper bits
+     */
+    GAVL_P010 = 13 | GAVL_PIXFMT_PLANAR | GAVL_PIXFMT_YUV | GAVL_PIXFMT_SEMIPLANAR,
+    /*! Semi planar YCbCr 4:2:0. Like \ref GAVL_NV12 but each component is an uint16_t in native byte order
+     */
+    GAVL_P016 = 14 | GAVL_PIXFMT_PLANAR | GAVL_PIXFMT_YUV | GAVL_PIXFMT_SEMIPLANAR,
+    /*! 10 bit Planar YCbCr 4:2:0. Each component is an uint16_t in native byte order with values in the lower 10 bits.
+     */
+    GAVL_YUV_420_P_10 = 15 | GAVL_PIXFMT_PLANAR | GAVL_PIXFMT_YUV,
     
   };
 
@@ -2052,6 +2179,17 @@ typedef enum
 
 #define  gavl_pixelformat_is_planar(fmt) ((fmt) & GAVL_PIXFMT_PLANAR)
 
+/*! \ingroup video_format
+ * \brief Check if a pixelformat is semi planar
+ * \param fmt A pixelformat
+ * \returns 1 if the pixelformat is semi planar, 0 else
+ *
+ * Semi planar formats are also planar. They have 2 planes, the second one
+ * contains both chroma components interleaved.
+ */
+
+#define  gavl_pixelformat_is_semiplanar(fmt) ((fmt) & GAVL_PIXFMT_SEMIPLANAR)
+
 
 /*! \ingroup video_format
  * \brief Get the number of channels
@@ -2600,7 +2738,8 @@ struct gavl_video_frame_s
   int32_t dst_y;                     //!< y offset in the destination frame. (since 1.5.0) */
 
   gavl_hw_context_t * hwctx;         //!< Handle for accessing the frame
-  
+
+  int pool_slot;                     //!< Private: Slot in the \ref gavl_video_frame_pool_t plus one (since 2.0.0)
   };
 
 
@@ -3077,6 +3216,18 @@ int gavl_video_frames_equal(const gavl_video_format_t * format,
  */
 
 #define GAVL_RESAMPLE_CHROMA    (1<<3)
+
+/** \ingroup video_conversion_flags
+ * \brief Don't fuse scaling and pixelformat conversion
+ *
+ *  By default, the video converter feeds the output of a scaling step
+ *  directly into a following pixelformat conversion in small bands of
+ *  scanlines instead of going through a full sized temporary frame.
+ *  This flag switches that off.
+ *  See also \ref gavl_video_converter_is_fused
+ */
+
+#define GAVL_NO_FUSE            (1<<4)
   
 /** \ingroup video_options
  * Alpha handling mode
@@ -3102,7 +3253,8 @@ typedef enum
     GAVL_DEINTERLACE_NONE      = 0, /*!< Don't care about interlacing                */
     GAVL_DEINTERLACE_COPY      = 1, /*!< Take one field and copy it to the other     */
     GAVL_DEINTERLACE_SCALE     = 2, /*!< Take one field and scale it vertically by 2 */
-    GAVL_DEINTERLACE_BLEND     = 3  /*!< Linear blend fields together */
+    GAVL_DEINTERLACE_BLEND     = 3, /*!< Linear blend fields together */
+    GAVL_DEINTERLACE_TEMPORAL  = 4, /*!< Motion adaptive, uses the previous fields. Since 2.0.0 */
   } gavl_deinterlace_mode_t;
 
 /** \ingroup video_options
@@ -3448,6 +3600,9 @@ float gavl_video_options_get_downscale_blur(const gavl_video_options_t * opt);
  *   \param opt Video options
  *   \param n Number of threads
  *
+ *  If the default run function is set, the threads are taken from a
+ *  builtin thread pool.
+ *
  *  Since 1.1.1
  */
   
@@ -3472,6 +3627,10 @@ int gavl_video_options_get_num_threads(const gavl_video_options_t * opt);
  *   \param func Function to be passed to each thread
  *   \param client_data Client data to be passed to the run function
  *
+ *  The default function calls func in the calling thread. As long as it is
+ *  set, gavl uses a builtin thread pool instead of calling it. Passing NULL
+ *  restores the default.
+ *
  *  Since 1.1.1
  */
 
@@ -3626,6 +3785,19 @@ int gavl_video_converter_init(gavl_video_converter_t* cnv,
   
 GAVL_PUBLIC
 int gavl_video_converter_reinit(gavl_video_converter_t* cnv);
+
+/*! \ingroup video_converter
+ *  \brief Check if scaling and pixelformat conversion are fused
+ *  \param cnv An initialized video converter
+ *  \returns 1 if the converter scales and converts the pixelformat in one
+ *           pass without a full sized temporary frame, 0 else.
+ *
+ *  Fusing is done for progressive formats if the scaled image covers the
+ *  whole output frame, unless \ref GAVL_NO_FUSE is set.
+ */
+
+GAVL_PUBLIC
+int gavl_video_converter_is_fused(gavl_video_converter_t* cnv);
  
   
 /***************************************************
@@ -3760,6 +3932,123 @@ void gavl_video_scaler_scale(gavl_video_scaler_t * scaler,
                              const gavl_video_frame_t * input_frame,
                              gavl_video_frame_t * output_frame);
 
+/*! \ingroup video_scaler
+ *  \brief Opaque multi output scaler structure.
+ *
+ *  A multi output scaler scales one source frame to several destination
+ *  formats at once (e.g. the resolutions of an adaptive streaming ladder).
+ *  All outputs are processed in one multithreaded sweep, which goes
+ *  through the source from top to bottom, so the source rows are read
+ *  into the cache only once for all outputs. Optionally, smaller outputs can
+ *  be computed from larger ones (see
+ *  \ref gavl_video_multiscaler_set_cascade_ratio).
+ *
+ *  Since 2.0.0
+ */
+
+typedef struct gavl_video_multiscaler_s gavl_video_multiscaler_t;
+
+/*! \ingroup video_scaler
+ *  \brief Create a multi output scaler
+ *  \returns A newly allocated multi output scaler
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+gavl_video_multiscaler_t * gavl_video_multiscaler_create();
+
+/*! \ingroup video_scaler
+ *  \brief Destroy a multi output scaler
+ *  \param scaler A multi output scaler
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+void gavl_video_multiscaler_destroy(gavl_video_multiscaler_t * scaler);
+
+/*! \ingroup video_scaler
+ *  \brief gets options of a multi output scaler
+ *  \param scaler A multi output scaler
+ *
+ *  The options are used for all outputs. The destination rectangle is
+ *  ignored, each output frame is filled completely. Options become valid with
+ *  the next call to \ref gavl_video_multiscaler_init.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC gavl_video_options_t *
+gavl_video_multiscaler_get_options(gavl_video_multiscaler_t * scaler);
+
+/*! \ingroup video_scaler
+ *  \brief Set the quality policy for cascaded scaling
+ *  \param scaler A multi output scaler
+ *  \param ratio Minimum size ratio between an output and its source
+ *
+ *  If ratio is 0 (the default), all outputs are scaled from the
+ *  source frame, which gives the best quality. If ratio is >= 1.0, an
+ *  output is scaled from the smallest other output, which is at least
+ *  ratio times as large in both directions. This is much faster for
+ *  ladders with large downscaling factors. A ratio of 2.0 is a good
+ *  compromise, since the intermediate output has still twice the resolution
+ *  of the final one. Cascading is only done for progressive formats.
+ *  The ratio becomes valid with the next call to \ref gavl_video_multiscaler_init.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+void gavl_video_multiscaler_set_cascade_ratio(gavl_video_multiscaler_t * scaler,
+                                              float ratio);
+
+/*! \ingroup video_scaler
+ *  \brief Initialize a multi output scaler
+ *  \param scaler A multi output scaler
+ *  \param src_format Input format
+ *  \param dst_formats Output formats
+ *  \param num_outputs Number of output formats
+ *  \returns 1 on success, 0 on error
+ *
+ *  All formats must have the same pixelformat.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+int gavl_video_multiscaler_init(gavl_video_multiscaler_t * scaler,
+                                const gavl_video_format_t * src_format,
+                                const gavl_video_format_t * dst_formats,
+                                int num_outputs);
+
+/*! \ingroup video_scaler
+ *  \brief Get the input of an output
+ *  \param scaler A multi output scaler
+ *  \param output Index of the output
+ *  \returns The index of the output, from which this one is scaled, or -1 for the source frame
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+int gavl_video_multiscaler_get_parent(gavl_video_multiscaler_t * scaler,
+                                      int output);
+
+/*! \ingroup video_scaler
+ *  \brief Scale one frame to all outputs
+ *  \param scaler A multi output scaler
+ *  \param input_frame Input frame
+ *  \param output_frames Output frames (one for each output format)
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+void gavl_video_multiscaler_scale(gavl_video_multiscaler_t * scaler,
+                                  const gavl_video_frame_t * input_frame,
+                                  gavl_video_frame_t ** output_frames);
+
 /*! \defgroup video_deinterlacer Deinterlacer
  *  \ingroup video
  *  \brief Deinterlacer
@@ -3831,6 +4120,38 @@ void gavl_video_deinterlacer_deinterlace(gavl_video_deinterlacer_t * deinterlace
                                          const gavl_video_frame_t * input_frame,
                                          gavl_video_frame_t * output_frame);
 
+/*! \ingroup video_deinterlacer
+ *  \brief Deinterlace video to the field rate
+ *  \param deinterlacer A video deinterlacer
+ *  \param input_frame Input frame
+ *  \param output_frame_1 Picture at the time of the first field
+ *  \param output_frame_2 Picture at the time of the second field
+ *
+ *  Each output frame gets half of the duration of the input frame.
+ *  Only \ref GAVL_DEINTERLACE_TEMPORAL generates 2 different pictures,
+ *  for the other modes the second output is a copy of the first one.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+void gavl_video_deinterlacer_deinterlace_fields(gavl_video_deinterlacer_t * deinterlacer,
+                                                const gavl_video_frame_t * input_frame,
+                                                gavl_video_frame_t * output_frame_1,
+                                                gavl_video_frame_t * output_frame_2);
+
+/*! \ingroup video_deinterlacer
+ *  \brief Forget the previous frames
+ *  \param deinterlacer A video deinterlacer
+ *
+ *  Call this after seeking when using \ref GAVL_DEINTERLACE_TEMPORAL.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+void gavl_video_deinterlacer_reset(gavl_video_deinterlacer_t * deinterlacer);
+
   
   
 /**************************************************
@@ -3928,6 +4249,11 @@ int gavl_overlay_blend_context_init(gavl_overlay_blend_context_t * ctx,
  * 
  *  This function sets a new overlay, regardless of whether the last one has expired
  *  or not.
+ *
+ *  Since 2.0.0 the transparent areas of the overlay are detected and
+ *  (depending on the pixelformat) a premultiplied copy is made here,
+ *  so repeated calls of \ref gavl_overlay_blend are cheap. If you change
+ *  the overlay contents, you must set it again.
  */
   
 GAVL_PUBLIC
@@ -4343,6 +4669,12 @@ gavl_frame_table_dump(const gavl_frame_table_t * t);
  *
  * The frame pool takes care of the refcounts and allocates
  * frames on demand if necessary.
+ *
+ * Frames from \ref gavl_video_frame_pool_get are free if their refcount
+ * is zero, callers manage the refcounts themselves.
+ * For pipelines, where frames are passed between threads, use
+ * \ref gavl_video_frame_pool_acquire and
+ * \ref gavl_video_frame_pool_release instead.
  * 
  * @{
  */
@@ -4393,6 +4725,94 @@ void gavl_video_frame_pool_destroy(gavl_video_frame_pool_t *p);
 GAVL_PUBLIC
 void gavl_video_frame_pool_reset(gavl_video_frame_pool_t *p);
 
+/** \brief Set the maximum number of frames
+ *  \param p A frame pool
+ *  \param max_frames Maximum number of frames (0 means unlimited)
+ *
+ *  If the pool contains max_frames frames and none of them is free,
+ *  \ref gavl_video_frame_pool_acquire will either block or return NULL.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+void gavl_video_frame_pool_set_max_frames(gavl_video_frame_pool_t *p,
+                                          int max_frames);
+
+/** \brief Acquire a frame from a frame pool
+ *  \param p A frame pool
+ *  \param block If nonzero, wait until a frame is available
+ *  \returns A video frame with a reference count of 1 or NULL
+ *
+ *  This function is thread safe. Unused frames are taken from a lock-free
+ *  list in constant time. If there are no unused frames, a new one
+ *  is allocated unless the limit set with
+ *  \ref gavl_video_frame_pool_set_max_frames is reached. In that case,
+ *  the function waits until another thread releases a frame or returns
+ *  NULL if block is zero.
+ *
+ *  Frames obtained by this function must be given back with
+ *  \ref gavl_video_frame_pool_release. Don't mix this with
+ *  \ref gavl_video_frame_pool_get for the same pool.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+gavl_video_frame_t *
+gavl_video_frame_pool_acquire(gavl_video_frame_pool_t *p, int block);
+
+/** \brief Add a reference to a frame
+ *  \param f A frame obtained with \ref gavl_video_frame_pool_acquire
+ *
+ *  Atomically increments the reference count.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+void gavl_video_frame_pool_ref(gavl_video_frame_t * f);
+
+/** \brief Release a reference to a frame
+ *  \param p A frame pool
+ *  \param f A frame obtained with \ref gavl_video_frame_pool_acquire
+ *
+ *  Atomically decrements the reference count. If it drops to zero,
+ *  the frame is returned to the pool. This can be called from any thread.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+void gavl_video_frame_pool_release(gavl_video_frame_pool_t *p,
+                                   gavl_video_frame_t * f);
+
+/** \brief Free unused frames
+ *  \param p A frame pool
+ *  \param max_free Maximum number of unused frames to keep
+ *
+ *  Call this when the pipeline is idle to give back memory.
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+void gavl_video_frame_pool_trim(gavl_video_frame_pool_t *p, int max_free);
+
+/** \brief Get statistics of a frame pool
+ *  \param p A frame pool
+ *  \param hits Returns the number of requests served with existing frames (or NULL)
+ *  \param misses Returns the number of frames, which had to be allocated (or NULL)
+ *  \param peak Returns the maximum number of frames allocated at the same time (or NULL)
+ *
+ *  Since 2.0.0
+ */
+
+GAVL_PUBLIC
+void gavl_video_frame_pool_get_stats(gavl_video_frame_pool_t *p,
+                                     int64_t * hits, int64_t * misses,
+                                     int * peak);
+
 /**
  * @}
  */
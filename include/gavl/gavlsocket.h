@@ -145,6 +145,12 @@ int gavl_socket_read_data_noblock(int fd, uint8_t * data, int len);
 GAVL_PUBLIC
 int gavl_socket_write_data(int fd, const void * data, int len);
 
+/* Send several buffers with one syscall (if possible). Returns the total number of bytes */
+struct iovec;
+
+GAVL_PUBLIC
+int gavl_socket_writev_data(int fd, const struct iovec * iov, int iovcnt);
+
 GAVL_PUBLIC
 int gavl_socket_read_line(int fd, char ** ret,
                         int * ret_alloc, int milliseconds);
@@ -58,6 +58,9 @@ typedef struct
   int entries_alloc;
   int num_entries;
   gavl_dict_entry_t * entries;
+  /* Private: Hash index for large dictionaries. It changed the size of
+     the struct, so the library version was bumped (LTVERSION_CURRENT 3) */
+  struct gavl_dict_index_s * index;
   } gavl_dictionary_t;
 
 typedef void (*gavl_dictionary_foreach_func)(void * priv, const char * name,
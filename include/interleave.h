@@ -93,3 +93,7 @@ gavl_find_interleave_converter(gavl_interleave_table_t *,
                                gavl_audio_format_t * out);
 
 void gavl_init_interleave_funcs_c(gavl_interleave_table_t * t);
+
+#ifdef HAVE_SSE2
+void gavl_init_interleave_funcs_sse2(gavl_interleave_table_t * t);
+#endif
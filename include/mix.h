@@ -25,6 +25,34 @@ typedef void (*gavl_mix_func_t)(gavl_mix_output_channel_t * channel,
                                 const gavl_audio_frame_t * input_frame,
                                 gavl_audio_frame_t * output_frame);
                                 
+/*
+ *  Several output channels, which are mixed in one pass over the
+ *  union of their input channels (see mix.c)
+ */
+
+#define GAVL_MIX_GROUP_SIZE 4
+
+typedef struct
+  {
+  int num_outputs;
+  int outputs[GAVL_MIX_GROUP_SIZE];
+
+  /* Rounded up to an even number, the last input can have zero factors */
+  int num_inputs;
+  int inputs[GAVL_MAX_CHANNELS+1];
+
+  /* Factors for each input and output. Unused outputs have zero factors */
+  union
+    {
+    float f_float[GAVL_MAX_CHANNELS+1][GAVL_MIX_GROUP_SIZE];
+    int   f_int[GAVL_MAX_CHANNELS+1][GAVL_MIX_GROUP_SIZE];
+    } factors;
+  } gavl_mix_group_t;
+
+typedef void (*gavl_mix_group_func_t)(const gavl_mix_group_t * group,
+                                      const gavl_audio_frame_t * input_frame,
+                                      gavl_audio_frame_t * output_frame);
+
 typedef struct
   {
   gavl_mix_func_t copy_func;
@@ -35,6 +63,12 @@ typedef struct
   gavl_mix_func_t mix_5_to_1;
   gavl_mix_func_t mix_6_to_1;
   gavl_mix_func_t mix_all_to_1;
+
+  /* Optional */
+  gavl_mix_group_func_t mix_group;
+
+  /* Set if the integer functions need factors within the int16 range */
+  int factors_16;
   } gavl_mixer_table_t;
 
 typedef struct gavl_mix_input_channel_s
@@ -53,12 +87,17 @@ struct gavl_mix_output_channel_s
   int index;
   gavl_mix_input_channel_t inputs[GAVL_MAX_CHANNELS];
   gavl_mix_func_t func;
+  int grouped; /* Mixed by mix_group */
   };
 
 struct gavl_mix_matrix_s
   {
   gavl_mix_output_channel_t output_channels[GAVL_MAX_CHANNELS];
   gavl_mixer_table_t mixer_table;
+
+  gavl_mix_group_t * groups;
+  int num_groups;
+  gavl_mix_group_func_t group_func;
   };
 
 gavl_mix_matrix_t *
@@ -72,3 +111,13 @@ void gavl_mix_audio(gavl_audio_convert_context_t * ctx);
 
 void gavl_setup_mix_funcs_c(gavl_mixer_table_t * c,
                             gavl_audio_format_t * f);
+
+#ifdef HAVE_SSE2
+void gavl_setup_mix_funcs_sse2(gavl_mixer_table_t * c,
+                               gavl_audio_format_t * f);
+#endif
+
+#ifdef HAVE_AVX2
+void gavl_setup_mix_funcs_avx2(gavl_mixer_table_t * c,
+                               gavl_audio_format_t * f);
+#endif
@@ -19,6 +19,25 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  * *****************************************************************/
 
+/* Indices of the packed formats and the formats they can be
+   converted from and to in one pass */
+
+enum
+  {
+    GAVL_PACKED_S24LE = 0,
+    GAVL_PACKED_S24BE,
+    GAVL_NUM_PACKED
+  };
+
+enum
+  {
+    GAVL_UNPACKED_S16 = 0,
+    GAVL_UNPACKED_S32,
+    GAVL_UNPACKED_FLOAT,
+    GAVL_UNPACKED_DOUBLE,
+    GAVL_NUM_UNPACKED
+  };
+
 typedef struct
   {
 
@@ -101,6 +120,19 @@ typedef struct
   gavl_audio_func_t convert_double_to_float;
   gavl_audio_func_t convert_float_to_double;
 
+  /* Conversion and interleaving in one pass */
+
+  gavl_audio_func_t convert_s16_i_to_float_ni;
+  gavl_audio_func_t convert_s16_i_to_float_ni_stereo;
+
+  gavl_audio_func_t convert_float_ni_to_s16_i;
+  gavl_audio_func_t convert_float_ni_to_s16_i_stereo;
+
+  /* Packed formats. These work on arrays of samples and don't
+     depend on the interleave mode */
+
+  gavl_packed_func_t unpack[GAVL_NUM_PACKED][GAVL_NUM_UNPACKED];
+  gavl_packed_func_t pack[GAVL_NUM_PACKED][GAVL_NUM_UNPACKED];
   
   } gavl_sampleformat_table_t;
 
@@ -110,6 +142,14 @@ gavl_create_sampleformat_table(gavl_audio_options_t * opt,
 
 void gavl_init_sampleformat_funcs_c(gavl_sampleformat_table_t * t, gavl_interleave_mode_t interleave_mode);
 
+#ifdef HAVE_SSE2
+void gavl_init_sampleformat_funcs_sse2(gavl_sampleformat_table_t * t, gavl_interleave_mode_t interleave_mode);
+#endif
+
+#ifdef HAVE_AVX2
+void gavl_init_sampleformat_funcs_avx2(gavl_sampleformat_table_t * t, gavl_interleave_mode_t interleave_mode);
+#endif
+
 gavl_audio_func_t
 gavl_find_sampleformat_converter(gavl_sampleformat_table_t * t,
                                  gavl_audio_format_t * in,
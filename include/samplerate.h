@@ -140,6 +140,13 @@ int gavl_src_set_ratio (SRC_STATE *state, double new_ratio) ;
 
 int gavl_src_reset (SRC_STATE *state) ;
 
+/*
+**	Select the optimized routines of the sinc converters
+**	(GAVL_ACCEL_* flags). By default, all supported ones are used.
+*/
+
+int gavl_src_set_accel_flags (SRC_STATE *state, int accel_flags) ;
+
 /*
 ** Return TRUE if ratio is a valid conversion ratio, FALSE
 ** otherwise.
@@ -253,6 +253,19 @@ void gavl_init_scale_funcs_bicubic_x_noclip_sse3(gavl_scale_funcs_t * tab);
 void gavl_init_scale_funcs_generic_x_sse3(gavl_scale_funcs_t * tab);
 
 
+#endif
+
+#ifdef HAVE_AVX2
+void gavl_init_scale_funcs_generic_x_avx2(gavl_scale_funcs_t * tab);
+
+void gavl_init_scale_funcs_generic_x_noclip_avx2(gavl_scale_funcs_t * tab);
+
+void gavl_init_scale_funcs_generic_y_avx2(gavl_scale_funcs_t * tab,
+                                          int src_advance, int dst_advance);
+
+void gavl_init_scale_funcs_generic_y_noclip_avx2(gavl_scale_funcs_t * tab,
+                                                 int src_advance, int dst_advance);
+
 #endif
 
 void gavl_init_scale_funcs(gavl_scale_funcs_t * tab,
@@ -398,6 +411,37 @@ void gavl_video_scale_context_scale(gavl_video_scale_context_t * ctx,
                                     const gavl_video_frame_t * src,
                                     gavl_video_frame_t * dst);
 
+void gavl_video_scale_context_scale_begin(gavl_video_scale_context_t * ctx,
+                                          const gavl_video_frame_t * src);
+
+void gavl_video_scale_context_scale_rows(gavl_video_scale_context_t * ctx,
+                                         gavl_video_frame_t * dst,
+                                         int start, int end);
+
+/*
+ *  The steps of gavl_video_scale_context_scale() one by one, for callers
+ *  which distribute the rows of several contexts over the threads
+ *  themselves:
+ *
+ *  gavl_video_scale_context_first_begin() returns the number of rows
+ *  of the first step (0 if there is only one step), which are processed
+ *  with gavl_video_scale_context_first_rows(). After all of them are done,
+ *  gavl_video_scale_context_final_begin() prepares the final step, which
+ *  writes rows [start, end) of the destination rectangle.
+ */
+
+int gavl_video_scale_context_first_begin(gavl_video_scale_context_t * ctx,
+                                         const gavl_video_frame_t * src);
+
+void gavl_video_scale_context_first_rows(gavl_video_scale_context_t * ctx,
+                                         int start, int end);
+
+void gavl_video_scale_context_final_begin(gavl_video_scale_context_t * ctx,
+                                          gavl_video_frame_t * dst);
+
+void gavl_video_scale_context_final_rows(gavl_video_scale_context_t * ctx,
+                                         int start, int end);
+
 struct gavl_video_scaler_s
   {
   gavl_video_options_t opt;
@@ -429,5 +473,26 @@ struct gavl_video_scaler_s
 
   };
 
+/*
+ *  Row wise scaling for progressive frames, which cover the whole
+ *  destination frame. Used by the video converter to feed the output
+ *  scanlines directly into the pixelformat conversion.
+ *
+ *  gavl_video_scaler_scale_begin() must be called once per frame.
+ *  Then, gavl_video_scaler_scale_rows() writes the destination rows
+ *  [start, end) (luminance rows, aligned to the chroma subsampling) into
+ *  the first rows of dst. Different row ranges can be processed in
+ *  parallel.
+ */
+
+int gavl_video_scaler_can_scale_rows(gavl_video_scaler_t * s);
+
+void gavl_video_scaler_scale_begin(gavl_video_scaler_t * s,
+                                   const gavl_video_frame_t * src);
+
+void gavl_video_scaler_scale_rows(gavl_video_scaler_t * s,
+                                  gavl_video_frame_t * dst,
+                                  int start, int end);
+
 
 #endif // _GAVL_SCALE_H_
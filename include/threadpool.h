@@ -0,0 +1,69 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#ifndef _GAVL_THREADPOOL_H_
+#define _GAVL_THREADPOOL_H_
+
+/*
+ *  Builtin worker pool. It is used whenever multithreading is enabled
+ *  but the application didn't supply a run function.
+ *
+ *  The range [0, num) is split into tiles (multiples of align), which are
+ *  distributed over per-thread queues. Threads, which run out of work,
+ *  steal tiles from the end of other queues. The calling thread takes
+ *  part in the processing and the function returns after all tiles are
+ *  finished.
+ *
+ *  The pool is global and grows on demand. If it is already busy with
+ *  another job (e.g. a second converter running in another thread), the
+ *  calculation is done in the calling thread.
+ */
+
+void gavl_thread_pool_run(int num_threads,
+                          gavl_video_process_func func,
+                          void * data, int num, int align);
+
+/*
+ *  Default run- and stop functions of the video and audio options.
+ *  The run function executes the piece in the calling thread.
+ */
+
+void gavl_run_func_default(gavl_video_process_func func,
+                           void * gavl_data,
+                           int start, int end,
+                           void * client_data, int thread);
+
+void gavl_stop_func_default(void * client_data, int thread);
+
+/*
+ *  Run func for the range [0, num) with num_threads threads. If run_func
+ *  is the default (or NULL), the builtin pool is used, otherwise the range is split into
+ *  one slice per thread, which are passed to run_func and waited for with
+ *  stop_func. This is the common backend of the video and audio options.
+ */
+
+void gavl_threads_run(int num_threads,
+                      gavl_video_run_func run_func, void * run_data,
+                      gavl_video_stop_func stop_func, void * stop_data,
+                      gavl_video_process_func func,
+                      void * data, int num, int align);
+
+#endif // _GAVL_THREADPOOL_H_
@@ -75,6 +75,17 @@ struct gavl_video_options_s
   void * stop_data;
   };
 
+/*
+ *  Run func for the range [0, num) using the threading setup in opt.
+ *  Slice boundaries will be multiples of align (except the last one).
+ *  If num_threads > 1 and run_func is the default, the builtin thread pool
+ *  is used. Returns after all slices are done.
+ */
+
+void gavl_video_options_run(const gavl_video_options_t * opt,
+                            gavl_video_process_func func,
+                            void * data, int num, int align);
+
 typedef struct gavl_video_convert_context_s gavl_video_convert_context_t;
 
 typedef void (*gavl_video_func_t)(gavl_video_convert_context_t * ctx);
@@ -90,6 +101,13 @@ struct gavl_video_convert_context_s
 
   gavl_video_scaler_t * scaler;
   gavl_video_deinterlacer_t * deinterlacer;
+
+  /* Fused scaling and pixelformat conversion (see videoconverter.c) */
+  struct gavl_video_fuse_s * fuse;
+
+  /* Sliced pixelformat conversion (see videoconverter.c) */
+  gavl_video_func_t band_func;
+  int band_align;
   
   struct gavl_video_convert_context_s * next;
   gavl_video_func_t func;
@@ -131,6 +149,14 @@ int gavl_pixelformat_can_scale(gavl_pixelformat_t in_csp, gavl_pixelformat_t out
 gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
                                                    gavl_pixelformat_t out_csp);
 
+/*
+ *  Return the pixelformat through which conversions from or to
+ *  pixelformat are done if there is no direct converter
+ *  (GAVL_PIXELFORMAT_NONE for formats with complete conversion tables)
+ */
+
+gavl_pixelformat_t gavl_pixelformat_get_relay(gavl_pixelformat_t pixelformat);
+
 #define CLEAR_MASK_PLANE_0 (1<<0)
 #define CLEAR_MASK_PLANE_1 (1<<1)
 #define CLEAR_MASK_PLANE_2 (1<<2)
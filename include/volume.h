@@ -34,6 +34,11 @@ typedef struct
   void (*set_volume_s32)(gavl_volume_control_t * v, void * samples,
                          int num_samples);
 
+  void (*set_volume_s24le)(gavl_volume_control_t * v, void * samples,
+                           int num_samples);
+  void (*set_volume_s24be)(gavl_volume_control_t * v, void * samples,
+                           int num_samples);
+
   void (*set_volume_float)(gavl_volume_control_t * v, void * samples,
                          int num_samples);
   void (*set_volume_double)(gavl_volume_control_t * v, void * samples,
@@ -125,6 +125,20 @@ dnl
     AC_MSG_RESULT(no)
   fi
 
+dnl
+dnl Check for AVX2 intrinsics (the code gets compiled with -mavx2)
+dnl
+
+  AC_MSG_CHECKING([if C compiler accepts AVX2 intrinsics])
+  CFLAGS="$2 -mavx2"
+  AC_TRY_LINK([#include <immintrin.h>],[__m256i m1, m2; m1 = _mm256_set1_epi16(1); m2 = _mm256_madd_epi16(m1, m1)],HAVE_AVX2=true)
+  CFLAGS=$2
+  if test "$HAVE_AVX2" = true; then
+    AC_MSG_RESULT(yes)
+  else
+    AC_MSG_RESULT(no)
+  fi
+
 dnl
 dnl Check for MMX intrinsics
 dnl
@@ -223,6 +237,7 @@ AH_TEMPLATE([HAVE_SSE],    [SSE Supported])
 AH_TEMPLATE([HAVE_SSE2],   [SSE2 Supported])
 AH_TEMPLATE([HAVE_SSE3],   [SSE3 Supported])
 AH_TEMPLATE([HAVE_SSSE3],   [SSSE3 Supported])
+AH_TEMPLATE([HAVE_AVX2],    [AVX2 Supported])
 
 GAVL_CHECK_SIMD_INTERNAL($1, $2)
 
@@ -256,6 +271,11 @@ AC_DEFINE(HAVE_SSSE3)
 fi
 AM_CONDITIONAL(HAVE_SSSE3, test "x$HAVE_SSSE3" = "xtrue")
 
+if test x"$HAVE_AVX2" = "xtrue"; then
+AC_DEFINE(HAVE_AVX2)
+fi
+AM_CONDITIONAL(HAVE_AVX2, test "x$HAVE_AVX2" = "xtrue")
+
 if test x"$ARCH_X86" = "xtrue"; then
 AC_DEFINE(ARCH_X86)
 fi
@@ -431,13 +431,47 @@ static void benchmark_sampleformat()
   
   }
 
+/* Channel setups for mixing. Wide setups use a dense user defined
+   matrix, so every output channel depends on every input channel */
+
+static const struct
+  {
+  int in_channels;
+  int out_channels;
+  int dense;
+  }
+mix_setups[] =
+  {
+    {  6, 2, 0 }, /* 5.1 -> Stereo */
+    { 12, 6, 1 }, /* 7.1.4 -> 5.1 */
+    { 24, 2, 1 }, /* 22.2 -> Stereo */
+  };
+
+static const struct
+  {
+  int flags;
+  char * name;
+  }
+mix_accel[] =
+  {
+    { GAVL_ACCEL_C,    "C"    },
+    { GAVL_ACCEL_SSE2, "SSE2" },
+    { GAVL_ACCEL_AVX2, "AVX2" },
+  };
+
 static void benchmark_mix()
   {
   int num_sampleformats;
+  int num_setups;
+  int num_accel;
   gavl_sample_format_t in_format;
 
-  int i;
-
+  int i, j, k, l;
+  int accel_supported;
+  
+  double matrix_data[GAVL_MAX_CHANNELS][GAVL_MAX_CHANNELS];
+  const double * matrix[GAVL_MAX_CHANNELS];
+  
   audio_convert_context_t ctx;
   gavl_benchmark_t b;
   memset(&ctx, 0, sizeof(ctx));
@@ -446,72 +480,107 @@ static void benchmark_mix()
   b.init = audio_convert_init;
   b.func = audio_convert_func;
   b.data = &ctx;
-  
-  ctx.in_format.num_channels = 6;
-  ctx.in_format.samplerate = 48000;
-  ctx.in_format.interleave_mode = GAVL_INTERLEAVE_NONE;
-  ctx.in_format.channel_locations[0] = GAVL_CHID_NONE;
-  ctx.in_format.samples_per_frame = 102400;
-
-  gavl_set_channel_setup(&ctx.in_format);
-  
-  gavl_audio_format_copy(&ctx.out_format, &ctx.in_format);
 
-  ctx.out_format.num_channels = 2;
-  ctx.out_format.channel_locations[0] = GAVL_CHID_NONE;
-  gavl_set_channel_setup(&ctx.out_format);
+  for(i = 0; i < GAVL_MAX_CHANNELS; i++)
+    matrix[i] = matrix_data[i];
 
+  accel_supported = gavl_accel_supported();
+  
   num_sampleformats = sizeof(sampleformats)/sizeof(sampleformats[0]);
+  num_setups = sizeof(mix_setups)/sizeof(mix_setups[0]);
+  num_accel = sizeof(mix_accel)/sizeof(mix_accel[0]);
   audio_convert_context_create(&ctx);
 
-  printf("Mixing of %d samples, from %d to %d channels\n",
-         ctx.in_format.samples_per_frame,
-         ctx.in_format.num_channels,
-         ctx.out_format.num_channels);
-  
-  if(do_html)
-    {
-    printf("<p>\n<table border=\"1\" width=\"100%%\"><tr><td>Sampleformat</td>");
-    gavl_benchmark_print_header(&b);
-    printf("</tr>\n");
-    }
-  else
+  for(j = 0; j < num_setups; j++)
     {
-    printf("\nSampleformat     ");
-    gavl_benchmark_print_header(&b);
-    printf("\n");
-    }
+    ctx.in_format.num_channels = mix_setups[j].in_channels;
+    ctx.in_format.samplerate = 48000;
+    ctx.in_format.interleave_mode = GAVL_INTERLEAVE_NONE;
+    ctx.in_format.channel_locations[0] = GAVL_CHID_NONE;
+    ctx.in_format.samples_per_frame = 102400;
+
+    gavl_set_channel_setup(&ctx.in_format);
   
+    gavl_audio_format_copy(&ctx.out_format, &ctx.in_format);
+
+    ctx.out_format.num_channels = mix_setups[j].out_channels;
+    ctx.out_format.channel_locations[0] = GAVL_CHID_NONE;
+    gavl_set_channel_setup(&ctx.out_format);
+
+    if(mix_setups[j].dense)
+      {
+      for(k = 0; k < ctx.out_format.num_channels; k++)
+        {
+        for(l = 0; l < ctx.in_format.num_channels; l++)
+          matrix_data[k][l] = (double)(1 + (k + l) % 3) /
+            (2 * ctx.in_format.num_channels);
+        }
+      gavl_audio_options_set_mix_matrix(ctx.opt, matrix);
+      }
+    else
+      gavl_audio_options_set_mix_matrix(ctx.opt, NULL);
+    
+    printf("Mixing of %d samples, from %d to %d channels\n",
+           ctx.in_format.samples_per_frame,
+           ctx.in_format.num_channels,
+           ctx.out_format.num_channels);
   
-  for(i = 0; i < num_sampleformats; i++)
-    {
-    in_format = sampleformats[i];
-    ctx.in_format.sample_format = in_format;
-    ctx.out_format.sample_format = in_format;
     if(do_html)
       {
-      printf("<td>%s</td>", gavl_sample_format_to_string(in_format));
+      printf("<p>\n<table border=\"1\" width=\"100%%\"><tr><td>Sampleformat</td><td>Implementation</td>");
+      gavl_benchmark_print_header(&b);
+      printf("</tr>\n");
       }
     else
-      printf("%-16s ", gavl_sample_format_to_string(in_format));
-    audio_convert_context_init(&ctx);
-    gavl_benchmark_run(&b);
-    audio_convert_context_cleanup(&ctx);
-    gavl_benchmark_print_results(&b);
-
-    if(do_html)
       {
-      printf("</tr>");
+      printf("\nSampleformat     Impl. ");
+      gavl_benchmark_print_header(&b);
+      printf("\n");
       }
+  
+    for(i = 0; i < num_sampleformats; i++)
+      {
+      in_format = sampleformats[i];
+      ctx.in_format.sample_format = in_format;
+      ctx.out_format.sample_format = in_format;
+
+      for(k = 0; k < num_accel; k++)
+        {
+        if((mix_accel[k].flags != GAVL_ACCEL_C) &&
+           !(accel_supported & mix_accel[k].flags))
+          continue;
+        
+        if(do_html)
+          {
+          printf("<td>%s</td><td>%s</td>",
+                 gavl_sample_format_to_string(in_format), mix_accel[k].name);
+          }
+        else
+          printf("%-16s %-5s ", gavl_sample_format_to_string(in_format),
+                 mix_accel[k].name);
+
+        gavl_audio_options_set_accel_flags(ctx.opt, mix_accel[k].flags);
+        audio_convert_context_init(&ctx);
+        gavl_benchmark_run(&b);
+        audio_convert_context_cleanup(&ctx);
+        gavl_benchmark_print_results(&b);
+
+        if(do_html)
+          {
+          printf("</tr>");
+          }
+        printf("\n");
+        fflush(stdout);
+        }
+      }
+  
+    if(do_html)
+      printf("</table>\n");
     printf("\n");
-    fflush(stdout);
     }
   
+  gavl_audio_options_set_mix_matrix(ctx.opt, NULL);
   audio_convert_context_destroy(&ctx);
-  
-  if(do_html)
-    printf("</table>\n");
-  
   }
 
 static const struct
@@ -910,6 +979,10 @@ static void benchmark_pixelformat()
       gavl_video_options_set_accel_flags(ctx.opt, GAVL_ACCEL_SSE3);
       do_pixelformat(&ctx, &b, in_format, out_format, "SSE3");
       fflush(stdout);
+
+      gavl_video_options_set_accel_flags(ctx.opt, GAVL_ACCEL_AVX2);
+      do_pixelformat(&ctx, &b, in_format, out_format, "AVX2");
+      fflush(stdout);
       
       }
     }
@@ -1144,6 +1217,7 @@ deinterlace_modes[] =
     { "Scanline doubler", GAVL_DEINTERLACE_COPY },
     { "Upscale",          GAVL_DEINTERLACE_SCALE },
     { "Blend",            GAVL_DEINTERLACE_BLEND },
+    { "Motion adaptive",  GAVL_DEINTERLACE_TEMPORAL },
   };
 
 static void benchmark_deinterlace()
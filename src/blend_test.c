@@ -277,10 +277,11 @@ int main(int argc, char ** argv)
   char filename_buffer[1024];
   int i, j, imax;
   gavl_overlay_blend_context_t *blend;
+  gavl_overlay_blend_context_t *blend_c;
     
   gavl_video_format_t frame_format, overlay_format;
 
-  gavl_video_frame_t * frame, * overlay;
+  gavl_video_frame_t * frame, * overlay, * frame_c;
 
     
   gavl_pixelformat_t frame_csp;
@@ -298,6 +299,11 @@ int main(int argc, char ** argv)
   
   imax = gavl_num_pixelformats();
   blend = gavl_overlay_blend_context_create();
+
+  /* Reference for checking the optimized blenders */
+  blend_c = gavl_overlay_blend_context_create();
+  gavl_video_options_set_accel_flags(gavl_overlay_blend_context_get_options(blend_c),
+                                     GAVL_ACCEL_C);
   
   
   //  imax = 1;
@@ -305,6 +311,8 @@ int main(int argc, char ** argv)
   for(i = 0; i < imax; i++)
     {
     frame_csp = gavl_get_pixelformat(i);
+    if(frame_csp == GAVL_PIXELFORMAT_NONE)
+      continue;
 
     //    if(frame_csp != GAVL_YUVA_32)
     //      continue;
@@ -353,9 +361,21 @@ int main(int argc, char ** argv)
         continue;
         }
       
+      frame_c = gavl_video_frame_create(&frame_format);
+      gavl_video_frame_copy(&frame_format, frame_c, frame);
+      
       gavl_overlay_blend_context_set_overlay(blend, overlay);
     
       gavl_overlay_blend(blend, frame);
+
+      /* Check against the C version */
+      gavl_overlay_blend_context_init(blend_c, &frame_format, &overlay_format);
+      gavl_overlay_blend_context_set_overlay(blend_c, overlay);
+      gavl_overlay_blend(blend_c, frame_c);
+
+      if(!gavl_video_frames_equal(&frame_format, frame, frame_c))
+        fprintf(stderr, "Optimized version differs from C version\n");
+      gavl_video_frame_destroy(frame_c);
     
       sprintf(filename_buffer, "blend_%s_over_%s.png",
               gavl_pixelformat_to_string(overlay_csp),
@@ -369,5 +389,6 @@ int main(int argc, char ** argv)
     
     }
   gavl_overlay_blend_context_destroy(blend);
+  gavl_overlay_blend_context_destroy(blend_c);
   return 0;
   }
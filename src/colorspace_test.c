@@ -24,6 +24,7 @@
 #include <png.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <accel.h>
 
@@ -1307,6 +1308,170 @@ static void convert_UYVY_to_RGB24(gavl_video_frame_t * in_frame,
     }
   }
 
+/*
+ *  Semi planar and 10 bit formats are repacked from and to
+ *  YUV 420 Planar or YUV 422 Planar (16 bit) 
+ */
+
+static gavl_pixelformat_t get_relay(gavl_pixelformat_t pixelformat)
+  {
+  switch(pixelformat)
+    {
+    case GAVL_NV12:
+    case GAVL_NV21:
+      return GAVL_YUV_420_P;
+    case GAVL_P010:
+    case GAVL_P016:
+    case GAVL_YUV_420_P_10:
+      return GAVL_YUV_422_P_16;
+    default:
+      break;
+    }
+  return GAVL_PIXELFORMAT_NONE;
+  }
+
+static void semiplanar_to_relay(gavl_video_frame_t * in_frame,
+                                gavl_video_frame_t * out_frame,
+                                gavl_video_format_t * format)
+  {
+  int i, j;
+  int u_idx, v_idx;
+  uint8_t * src_8, * dst_8;
+  uint16_t * src_16, * dst_16;
+  
+  u_idx = (format->pixelformat == GAVL_NV21) ? 2 : 1;
+  v_idx = (format->pixelformat == GAVL_NV21) ? 1 : 2;
+  
+  for(i = 0; i < format->image_height; i++)
+    {
+    /* Luma */
+    if(get_relay(format->pixelformat) == GAVL_YUV_420_P)
+      memcpy(out_frame->planes[0] + i * out_frame->strides[0],
+             in_frame->planes[0] + i * in_frame->strides[0],
+             format->image_width);
+    else
+      {
+      src_16 = (uint16_t*)(in_frame->planes[0] + i * in_frame->strides[0]);
+      dst_16 = (uint16_t*)(out_frame->planes[0] + i * out_frame->strides[0]);
+      for(j = 0; j < format->image_width; j++)
+        dst_16[j] = (format->pixelformat == GAVL_YUV_420_P_10) ?
+          src_16[j] << 6 : src_16[j];
+      }
+
+    /* Chroma */
+    switch(format->pixelformat)
+      {
+      case GAVL_NV12:
+      case GAVL_NV21:
+        if(i >= format->image_height/2)
+          break;
+        src_8 = in_frame->planes[1] + i * in_frame->strides[1];
+        for(j = 0; j < format->image_width/2; j++)
+          {
+          dst_8 = out_frame->planes[u_idx] + i * out_frame->strides[u_idx];
+          dst_8[j] = src_8[2*j];
+          dst_8 = out_frame->planes[v_idx] + i * out_frame->strides[v_idx];
+          dst_8[j] = src_8[2*j+1];
+          }
+        break;
+      case GAVL_P010:
+      case GAVL_P016:
+        src_16 = (uint16_t*)(in_frame->planes[1] + (i/2) * in_frame->strides[1]);
+        for(j = 0; j < format->image_width/2; j++)
+          {
+          dst_16 = (uint16_t*)(out_frame->planes[1] + i * out_frame->strides[1]);
+          dst_16[j] = src_16[2*j];
+          dst_16 = (uint16_t*)(out_frame->planes[2] + i * out_frame->strides[2]);
+          dst_16[j] = src_16[2*j+1];
+          }
+        break;
+      default: /* YUV 420 P 10 */
+        for(j = 0; j < format->image_width/2; j++)
+          {
+          src_16 = (uint16_t*)(in_frame->planes[1] + (i/2) * in_frame->strides[1]);
+          dst_16 = (uint16_t*)(out_frame->planes[1] + i * out_frame->strides[1]);
+          dst_16[j] = src_16[j] << 6;
+          src_16 = (uint16_t*)(in_frame->planes[2] + (i/2) * in_frame->strides[2]);
+          dst_16 = (uint16_t*)(out_frame->planes[2] + i * out_frame->strides[2]);
+          dst_16[j] = src_16[j] << 6;
+          }
+        break;
+      }
+    }
+  }
+
+static void relay_to_semiplanar(gavl_video_frame_t * in_frame,
+                                gavl_video_frame_t * out_frame,
+                                gavl_video_format_t * format)
+  {
+  int i, j;
+  int u_idx, v_idx;
+  uint8_t * src_8, * dst_8;
+  uint16_t * src_16, * dst_16;
+  uint16_t mask = (format->pixelformat == GAVL_P010) ? 0xffc0 : 0xffff;
+  int shift = (format->pixelformat == GAVL_YUV_420_P_10) ? 6 : 0;
+  
+  u_idx = (format->pixelformat == GAVL_NV21) ? 2 : 1;
+  v_idx = (format->pixelformat == GAVL_NV21) ? 1 : 2;
+  
+  for(i = 0; i < format->image_height; i++)
+    {
+    /* Luma */
+    if(get_relay(format->pixelformat) == GAVL_YUV_420_P)
+      memcpy(out_frame->planes[0] + i * out_frame->strides[0],
+             in_frame->planes[0] + i * in_frame->strides[0],
+             format->image_width);
+    else
+      {
+      src_16 = (uint16_t*)(in_frame->planes[0] + i * in_frame->strides[0]);
+      dst_16 = (uint16_t*)(out_frame->planes[0] + i * out_frame->strides[0]);
+      for(j = 0; j < format->image_width; j++)
+        dst_16[j] = (src_16[j] & mask) >> shift;
+      }
+
+    /* Chroma (from the even lines of YUV 422 P 16) */
+    if(i >= format->image_height/2)
+      continue;
+    
+    switch(format->pixelformat)
+      {
+      case GAVL_NV12:
+      case GAVL_NV21:
+        dst_8 = out_frame->planes[1] + i * out_frame->strides[1];
+        for(j = 0; j < format->image_width/2; j++)
+          {
+          src_8 = in_frame->planes[u_idx] + i * in_frame->strides[u_idx];
+          dst_8[2*j] = src_8[j];
+          src_8 = in_frame->planes[v_idx] + i * in_frame->strides[v_idx];
+          dst_8[2*j+1] = src_8[j];
+          }
+        break;
+      case GAVL_P010:
+      case GAVL_P016:
+        dst_16 = (uint16_t*)(out_frame->planes[1] + i * out_frame->strides[1]);
+        for(j = 0; j < format->image_width/2; j++)
+          {
+          src_16 = (uint16_t*)(in_frame->planes[1] + 2 * i * in_frame->strides[1]);
+          dst_16[2*j] = src_16[j] & mask;
+          src_16 = (uint16_t*)(in_frame->planes[2] + 2 * i * in_frame->strides[2]);
+          dst_16[2*j+1] = src_16[j] & mask;
+          }
+        break;
+      default: /* YUV 420 P 10 */
+        for(j = 0; j < format->image_width/2; j++)
+          {
+          src_16 = (uint16_t*)(in_frame->planes[1] + 2 * i * in_frame->strides[1]);
+          dst_16 = (uint16_t*)(out_frame->planes[1] + i * out_frame->strides[1]);
+          dst_16[j] = src_16[j] >> 6;
+          src_16 = (uint16_t*)(in_frame->planes[2] + 2 * i * in_frame->strides[2]);
+          dst_16 = (uint16_t*)(out_frame->planes[2] + i * out_frame->strides[2]);
+          dst_16[j] = src_16[j] >> 6;
+          }
+        break;
+      }
+    }
+  }
+
 /*
  *  This function writes a png file of the video frame in the given format
  *  The format can have all supported colorspaces, so we'll convert them
@@ -1327,8 +1492,20 @@ static int write_file(const char * name,
   int i;
   char ** row_pointers;  
   png_structp png_ptr;  png_infop info_ptr;
+  FILE *fp;
+  
+  if(get_relay(format->pixelformat) != GAVL_PIXELFORMAT_NONE)
+    {
+    gavl_video_format_copy(&tmp_format, format);
+    tmp_format.pixelformat = get_relay(format->pixelformat);
+    tmp_frame = gavl_video_frame_create(&tmp_format);
+    semiplanar_to_relay(frame, tmp_frame, format);
+    i = write_file(name, tmp_frame, &tmp_format);
+    gavl_video_frame_destroy(tmp_frame);
+    return i;
+    }
   
-  FILE *fp = fopen(name, "wb");
+  fp = fopen(name, "wb");
   if (!fp)
     {
     fprintf(stderr, "Cannot open file %s, exiting \n", name);
@@ -1566,7 +1743,7 @@ static int write_file(const char * name,
                                  format->image_height);
       out_frame = tmp_frame;
       break;
-    case GAVL_PIXELFORMAT_NONE:
+    default: /* Handled above */
       break;
     }
 
@@ -1757,6 +1934,15 @@ static gavl_video_frame_t * create_picture(gavl_pixelformat_t pixelformat,
   format.pixel_width = 1;
   format.pixel_height = 1;
   
+  if(get_relay(pixelformat) != GAVL_PIXELFORMAT_NONE)
+    {
+    gavl_video_frame_t * tmp_frame;
+    tmp_frame = create_picture(get_relay(pixelformat), get_pixel);
+    ret = gavl_video_frame_create(&format);
+    relay_to_semiplanar(tmp_frame, ret, &format);
+    gavl_video_frame_destroy(tmp_frame);
+    return ret;
+    }
   
   ret = gavl_video_frame_create(&format);
 
@@ -2647,7 +2833,7 @@ static gavl_video_frame_t * create_picture(gavl_pixelformat_t pixelformat,
           }
         }
       break;
-    case GAVL_PIXELFORMAT_NONE:
+    default: /* Handled above */
       break;
     }
   
@@ -2840,6 +3026,20 @@ int main(int argc, char ** argv)
                    output_frame, &output_format);
         fprintf(stderr, "Wrote %s\n", filename_buffer);
         }
+
+      gavl_video_options_set_accel_flags(opt, GAVL_ACCEL_AVX2);
+      gavl_video_frame_clear(output_frame, &output_format);
+      sprintf(filename_buffer, "%s_to_%s_avx2.png", tmp1, tmp2);
+      if(gavl_video_converter_init(cnv, &input_format, &output_format) <= 0)
+        fprintf(stderr, "No AVX2 Conversion defined yet\n");
+      else
+        {
+        fprintf(stderr, "AVX2 Version:    ");
+        gavl_video_convert(cnv, input_frame, output_frame);
+        write_file(filename_buffer,
+                   output_frame, &output_format);
+        fprintf(stderr, "Wrote %s\n", filename_buffer);
+        }
 #endif
       
       gavl_video_frame_destroy(output_frame);
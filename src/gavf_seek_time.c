@@ -0,0 +1,158 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/* Measure the seek latency of gavf files with dense sync indices */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <gavl/gavf.h>
+
+#include "timeutils.h"
+
+#define PACKET_DURATION 40 /* Milliseconds */
+#define NUM_SEEKS       10000
+
+static int write_file(const char * filename, int num_packets)
+  {
+  int i, id;
+  FILE * f;
+  gavf_t * g;
+  gavf_io_t * io;
+  gavf_options_t * opt;
+  gavl_packet_sink_t * sink;
+  gavl_packet_t * p;
+
+  if(!(f = fopen(filename, "wb")))
+    return 0;
+  
+  g = gavf_create();
+  io = gavf_io_create_file(f, 1, 1, 1);
+
+  /* Sync header before each packet */
+  opt = gavf_get_options(g);
+  gavf_options_set_flags(opt, GAVF_OPT_FLAG_SYNC_INDEX);
+  gavf_options_set_sync_distance(opt, GAVL_TIME_SCALE / 100);
+  
+  if(!gavf_open_write(g, io, NULL))
+    return 0;
+  
+  id = gavf_append_text_stream(g, 1000, NULL);
+  gavf_start(g);
+  sink = gavf_get_packet_sink(g, id);
+  
+  for(i = 0; i < num_packets; i++)
+    {
+    p = gavl_packet_sink_get_packet(sink);
+    gavl_packet_reset(p);
+    gavl_packet_alloc(p, 8);
+    memcpy(p->data, "subtitle", 8);
+    p->data_len = 8;
+    p->pts = (int64_t)i * PACKET_DURATION;
+    p->duration = PACKET_DURATION;
+    gavl_packet_sink_put_packet(sink, p);
+    }
+  
+  gavf_close(g, 0);
+  gavf_io_destroy(io);
+  return 1;
+  }
+
+int main(int argc, char ** argv)
+  {
+  int i;
+  int num_packets = 100000;
+  const char * filename = "gavf_seek_time.gavf";
+  FILE * f;
+  gavf_t * g;
+  gavf_io_t * io;
+  const int64_t * pts;
+  int64_t duration;
+  uint64_t t;
+  
+  if(argc > 1)
+    num_packets = atoi(argv[1]);
+  if(argc > 2)
+    filename = argv[2];
+  
+  fprintf(stderr, "Writing %s (%d packets)...", filename, num_packets);
+  if(!write_file(filename, num_packets))
+    {
+    fprintf(stderr, "failed\n");
+    return EXIT_FAILURE;
+    }
+  fprintf(stderr, "done\n");
+
+  if(!(f = fopen(filename, "rb")))
+    return EXIT_FAILURE;
+  
+  g = gavf_create();
+  io = gavf_io_create_file(f, 0, 1, 1);
+
+  timer_init();
+  
+  if(!gavf_open_read(g, io) || !gavf_select_track(g, 0))
+    {
+    fprintf(stderr, "Opening %s failed\n", filename);
+    return EXIT_FAILURE;
+    }
+  t = timer_stop();
+  fprintf(stderr, "Open: %"PRId64" us\n", t);
+
+  if(!(pts = gavf_end_pts(g)))
+    {
+    fprintf(stderr, "%s has no sync index\n", filename);
+    return EXIT_FAILURE;
+    }
+  duration = pts[0];
+  
+  /* Cold seek: Loads the index pages on the way */
+  timer_init();
+  gavf_seek(g, duration / 2, 1000);
+  t = timer_stop();
+  fprintf(stderr, "First seek: %"PRId64" us\n", t);
+  
+  /* Scrubbing */
+  srand(0);
+  timer_init();
+  for(i = 0; i < NUM_SEEKS; i++)
+    {
+    int64_t time = (int64_t)(((double)rand() / RAND_MAX) * duration);
+
+    if(!(pts = gavf_seek(g, time, 1000)) || (pts[0] > time))
+      {
+      fprintf(stderr, "Seek to %"PRId64" failed\n", time);
+      return EXIT_FAILURE;
+      }
+    }
+  t = timer_stop();
+  fprintf(stderr, "%d random seeks: %"PRId64" us (%.3f us per seek)\n",
+          NUM_SEEKS, t, (double)t / NUM_SEEKS);
+
+  gavf_close(g, 0);
+  gavf_io_destroy(io);
+  remove(filename);
+  return EXIT_SUCCESS;
+  }
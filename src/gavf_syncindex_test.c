@@ -0,0 +1,181 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/* Write and read back gavf sync indices in the current and the old
+   (variable length) layout */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/* The sync index functions are not exported from the library.
+   This includes gavfprivate.h */
+#include "../gavl/gavf/syncindex.c"
+
+#define NUM_STREAMS 2
+
+static uint64_t entry_pos(int64_t i)
+  {
+  return 1000 + i * 4711;
+  }
+
+static int64_t entry_pts(int64_t i, int stream)
+  {
+  return i * 40 * (stream + 1) - 100;
+  }
+
+/* Old layout: Tag, number of entries and the entries as variable
+   length numbers */
+
+static void write_index_v0(gavf_io_t * io, int num)
+  {
+  int i, j;
+
+  gavf_io_write_data(io, (uint8_t*)GAVF_TAG_SYNC_INDEX, 8);
+  gavf_io_write_uint64v(io, num);
+
+  for(i = 0; i < num; i++)
+    {
+    gavf_io_write_uint64v(io, entry_pos(i));
+    for(j = 0; j < NUM_STREAMS; j++)
+      gavf_io_write_int64v(io, entry_pts(i, j));
+    }
+  }
+
+static void write_index(gavf_io_t * io, int num)
+  {
+  int i, j;
+  gavf_sync_index_t idx;
+
+  memset(&idx, 0, sizeof(idx));
+  gavf_sync_index_init(&idx, NUM_STREAMS);
+
+  idx.entries = calloc(num, sizeof(*idx.entries));
+  idx.num_entries = num;
+  idx.entries_alloc = num;
+
+  for(i = 0; i < num; i++)
+    {
+    idx.entries[i].pos = entry_pos(i);
+    idx.entries[i].pts = malloc(idx.pts_len);
+    for(j = 0; j < NUM_STREAMS; j++)
+      idx.entries[i].pts[j] = entry_pts(i, j);
+    }
+  gavf_sync_index_write(io, &idx);
+  gavf_sync_index_free(&idx);
+  }
+
+static int test_index(int num, int old)
+  {
+  int i, j;
+  int ret = 0;
+  gavf_io_t * io;
+  gavf_io_t * write_io;
+  gavl_buffer_t * buf;
+  gavf_sync_index_t idx;
+  const int64_t * pts;
+
+  write_io = gavf_io_create_buf_write();
+
+  if(old)
+    write_index_v0(write_io, num);
+  else
+    write_index(write_io, num);
+
+  buf = gavf_io_buf_get(write_io);
+
+  memset(&idx, 0, sizeof(idx));
+  gavf_sync_index_init(&idx, NUM_STREAMS);
+
+  io = gavf_io_create_mem_read(buf->buf, buf->len);
+
+  if(!gavf_sync_index_read_paged(io, &idx))
+    {
+    fprintf(stderr, "Reading the index failed\n");
+    goto fail;
+    }
+
+  if(idx.num_entries != (uint64_t)num)
+    {
+    fprintf(stderr, "Got %"PRId64" entries\n", idx.num_entries);
+    goto fail;
+    }
+
+  for(i = 0; i < num; i++)
+    {
+    if(gavf_sync_index_get_pos(&idx, i) != entry_pos(i))
+      {
+      fprintf(stderr, "Wrong position for entry %d\n", i);
+      goto fail;
+      }
+    pts = gavf_sync_index_get_pts(&idx, i);
+    for(j = 0; j < NUM_STREAMS; j++)
+      {
+      if(!pts || (pts[j] != entry_pts(i, j)))
+        {
+        fprintf(stderr, "Wrong pts for entry %d\n", i);
+        goto fail;
+        }
+      }
+    }
+  ret = 1;
+
+  fail:
+
+  gavf_sync_index_free(&idx);
+  gavf_io_destroy(io);
+  gavf_io_destroy(write_io);
+  return ret;
+  }
+
+int main(int argc, char ** argv)
+  {
+  int i, old;
+  int errors = 0;
+
+  /* 127 is a 1 byte variable length number starting with 0xff.
+     More than one page makes the paged reader seek */
+  static const int num_entries[] = { 1, 126, 127, 128, 1000 };
+
+  for(old = 0; old < 2; old++)
+    {
+    for(i = 0; i < sizeof(num_entries) / sizeof(num_entries[0]); i++)
+      {
+      fprintf(stderr, "%s index with %d entries: ",
+              old ? "Old" : "Current", num_entries[i]);
+
+      if(test_index(num_entries[i], old))
+        fprintf(stderr, "OK\n");
+      else
+        {
+        fprintf(stderr, "FAILED\n");
+        errors++;
+        }
+      }
+    }
+
+  if(errors)
+    {
+    fprintf(stderr, "%d errors\n", errors);
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+  }
@@ -39,14 +39,17 @@ int main(int argc, char ** argv)
                          GAVF_OPT_FLAG_DUMP_INDICES |
                          GAVF_OPT_FLAG_DUMP_PACKETS);
 
-  f = fopen(argv[1], "rb");
-  if(!f)
+  /* Local files are read through a memory mapping */
+  if(!(io = gavf_io_create_mmap_read(argv[1])))
     {
-    fprintf(stderr, "Opening file failed\n");
-    return 0;
+    f = fopen(argv[1], "rb");
+    if(!f)
+      {
+      fprintf(stderr, "Opening file failed\n");
+      return 0;
+      }
+    io = gavf_io_create_file(f, 0, 1, 1);
     }
-
-  io = gavf_io_create_file(f, 0, 1, 1);
   
   if(!gavf_open_read(dec, io))
     {
@@ -0,0 +1,523 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2012 Members of the Gmerlin project
+ * gmerlin-general@lists.sourceforge.net
+ * http://gmerlin.sourceforge.net
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/* Tests for the audio and packet ring buffers */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <gavl/gavl.h>
+#include <gavl/connectors.h>
+
+#define CAPACITY          1000
+#define SAMPLES_PER_FRAME 256
+#define NUM_CHANNELS      2
+
+#define START_PTS         1000
+
+/* Samples passed between the threads */
+#define THREAD_SAMPLES    1000000
+
+static int errors = 0;
+
+#define CHECK(cond, ...)                                \
+  do                                                    \
+    {                                                   \
+    if(!(cond))                                         \
+      {                                                 \
+      fprintf(stderr, "%s:%d: ", __FILE__, __LINE__);   \
+      fprintf(stderr, __VA_ARGS__);                     \
+      fprintf(stderr, "\n");                            \
+      errors++;                                         \
+      }                                                 \
+    } while(0)
+
+static void init_format(gavl_audio_format_t * format)
+  {
+  memset(format, 0, sizeof(*format));
+  format->num_channels = NUM_CHANNELS;
+  format->interleave_mode = GAVL_INTERLEAVE_ALL;
+  format->sample_format = GAVL_SAMPLE_S16;
+  format->samples_per_frame = SAMPLES_PER_FRAME;
+  format->samplerate = 48000;
+  gavl_set_channel_setup(format);
+  }
+
+/* Sample values encode the absolute position */
+
+static int16_t sample_value(int64_t pos, int channel)
+  {
+  return (int16_t)((pos * NUM_CHANNELS + channel) & 0x7fff);
+  }
+
+static void fill_frame(gavl_audio_frame_t * f, int64_t pos, int num)
+  {
+  int i, j;
+  for(i = 0; i < num; i++)
+    {
+    for(j = 0; j < NUM_CHANNELS; j++)
+      f->samples.s_16[i * NUM_CHANNELS + j] = sample_value(pos + i, j);
+    }
+  f->valid_samples = num;
+  f->timestamp = START_PTS + pos;
+  }
+
+static int check_frame(const gavl_audio_frame_t * f, int64_t pos)
+  {
+  int i, j;
+
+  if(f->timestamp != START_PTS + pos)
+    {
+    fprintf(stderr, "Got timestamp %"PRId64", expected %"PRId64"\n",
+            f->timestamp, START_PTS + pos);
+    return 0;
+    }
+
+  for(i = 0; i < f->valid_samples; i++)
+    {
+    for(j = 0; j < NUM_CHANNELS; j++)
+      {
+      if(f->samples.s_16[i * NUM_CHANNELS + j] != sample_value(pos + i, j))
+        {
+        fprintf(stderr, "Sample mismatch at position %"PRId64"\n", pos + i);
+        return 0;
+        }
+      }
+    }
+  return 1;
+  }
+
+/* Write one frame through the sink. If zerocopy is set, try to write
+   directly into the buffer */
+
+static int write_frame(gavl_audio_sink_t * sink, gavl_audio_frame_t * own,
+                       int64_t pos, int num, int zerocopy)
+  {
+  gavl_audio_frame_t * f = NULL;
+
+  if(zerocopy)
+    f = gavl_audio_sink_get_frame(sink);
+  if(!f)
+    f = own;
+
+  fill_frame(f, pos, num);
+  gavl_audio_sink_put_frame(sink, f);
+  return (f != own);
+  }
+
+/* Read everything available. Returns the source status of the last read */
+
+static gavl_source_status_t drain(gavl_audio_source_t * src, int64_t * pos)
+  {
+  gavl_source_status_t st;
+  gavl_audio_frame_t * f;
+
+  while(1)
+    {
+    f = NULL;
+    if((st = gavl_audio_source_read_frame(src, &f)) != GAVL_SOURCE_OK)
+      return st;
+
+    if(!check_frame(f, *pos))
+      errors++;
+    *pos += f->valid_samples;
+    }
+  }
+
+/* Fill and drain the buffer many times, so the positions wrap around */
+
+static void test_audio_wraparound(void)
+  {
+  int i, num;
+  int64_t write_pos = 0;
+  int64_t read_pos = 0;
+  int64_t overruns;
+  int zerocopy_frames = 0;
+  gavl_audio_format_t format;
+  gavl_audio_ringbuffer_t * rb;
+  gavl_audio_sink_t * sink;
+  gavl_audio_source_t * src;
+  gavl_audio_frame_t * own;
+
+  fprintf(stderr, "Audio wraparound\n");
+
+  init_format(&format);
+  rb = gavl_audio_ringbuffer_create(&format, CAPACITY);
+  sink = gavl_audio_ringbuffer_get_sink(rb);
+  src = gavl_audio_ringbuffer_get_source(rb);
+  gavl_audio_source_set_dst(src, 0, &format);
+  own = gavl_audio_frame_create(&format);
+
+  for(i = 0; i < 100; i++)
+    {
+    /* Frame sizes which don't divide the capacity */
+    num = 1 + (i * 97) % SAMPLES_PER_FRAME;
+
+    if(gavl_audio_ringbuffer_get_fill(rb) + num > CAPACITY)
+      {
+      CHECK(drain(src, &read_pos) == GAVL_SOURCE_AGAIN,
+            "Source didn't return GAVL_SOURCE_AGAIN");
+      }
+    zerocopy_frames += write_frame(sink, own, write_pos, num, i & 1);
+    write_pos += num;
+    }
+
+  gavl_audio_ringbuffer_set_eof(rb);
+  CHECK(drain(src, &read_pos) == GAVL_SOURCE_EOF,
+        "Source didn't return GAVL_SOURCE_EOF");
+  CHECK(read_pos == write_pos,
+        "Read %"PRId64" samples, wrote %"PRId64, read_pos, write_pos);
+  CHECK(write_pos > 10 * CAPACITY, "Buffer didn't wrap often enough");
+  CHECK(zerocopy_frames > 0, "No frame was written without copying");
+
+  gavl_audio_ringbuffer_get_stats(rb, &overruns, NULL);
+  CHECK(!overruns, "Got %"PRId64" overruns", overruns);
+
+  gavl_audio_frame_destroy(own);
+  gavl_audio_ringbuffer_destroy(rb);
+  }
+
+static void test_audio_overrun_underrun(void)
+  {
+  int num;
+  int64_t pos = 0;
+  int64_t overruns, underruns;
+  gavl_audio_format_t format;
+  gavl_audio_ringbuffer_t * rb;
+  gavl_audio_sink_t * sink;
+  gavl_audio_frame_t * own;
+  gavl_audio_frame_t * f;
+
+  fprintf(stderr, "Audio overruns and underruns\n");
+
+  init_format(&format);
+  rb = gavl_audio_ringbuffer_create(&format, CAPACITY);
+  sink = gavl_audio_ringbuffer_get_sink(rb);
+  own = gavl_audio_frame_create(&format);
+
+  /* Reading from the empty buffer */
+  CHECK(!gavl_audio_ringbuffer_read_begin(rb, &f),
+        "Got samples from the empty buffer");
+  gavl_audio_ringbuffer_get_stats(rb, &overruns, &underruns);
+  CHECK(underruns == 1, "Got %"PRId64" underruns, expected 1", underruns);
+
+  /* Fill completely, the last frame fits only partially */
+  while(pos < CAPACITY)
+    {
+    write_frame(sink, own, pos, SAMPLES_PER_FRAME, 0);
+    pos += SAMPLES_PER_FRAME;
+    }
+  CHECK(gavl_audio_ringbuffer_get_fill(rb) == CAPACITY,
+        "Fill is %d, expected %d", gavl_audio_ringbuffer_get_fill(rb), CAPACITY);
+
+  /* Full buffer: No zero-copy frame, the data are dropped */
+  CHECK(!gavl_audio_sink_get_frame(sink), "Got a frame from the full buffer");
+  write_frame(sink, own, pos, SAMPLES_PER_FRAME, 0);
+
+  gavl_audio_ringbuffer_get_stats(rb, &overruns, &underruns);
+  CHECK(overruns == 2, "Got %"PRId64" overruns, expected 2", overruns);
+  CHECK(underruns == 1, "Got %"PRId64" underruns, expected 1", underruns);
+
+  /* Not EOF before the samples are read */
+  gavl_audio_ringbuffer_set_eof(rb);
+  CHECK(!gavl_audio_ringbuffer_get_eof(rb), "EOF before draining");
+
+  num = gavl_audio_ringbuffer_read_begin(rb, &f);
+  CHECK(num == CAPACITY, "read_begin returned %d, expected %d", num, CAPACITY);
+  f->valid_samples = num;
+  CHECK(check_frame(f, 0), "Wrong data in the read window");
+  gavl_audio_ringbuffer_read_end(rb, num);
+
+  CHECK(gavl_audio_ringbuffer_get_eof(rb), "No EOF after draining");
+
+  /* Reads after EOF are no underruns */
+  CHECK(!gavl_audio_ringbuffer_read_begin(rb, &f), "Got samples after EOF");
+  gavl_audio_ringbuffer_get_stats(rb, NULL, &underruns);
+  CHECK(underruns == 1, "Got %"PRId64" underruns, expected 1", underruns);
+
+  gavl_audio_frame_destroy(own);
+  gavl_audio_ringbuffer_destroy(rb);
+  }
+
+/* The zero-copy sink frame is only handed out if a whole frame fits
+   before the end of the buffer. Otherwise the copy path splits the
+   frame into 2 parts */
+
+static void test_audio_sink_paths(void)
+  {
+  int64_t write_pos = 0;
+  int64_t read_pos = 0;
+  int64_t overruns;
+  gavl_audio_format_t format;
+  gavl_audio_ringbuffer_t * rb;
+  gavl_audio_sink_t * sink;
+  gavl_audio_source_t * src;
+  gavl_audio_frame_t * own;
+
+  fprintf(stderr, "Audio sink zero-copy and copy paths\n");
+
+  init_format(&format);
+  rb = gavl_audio_ringbuffer_create(&format, CAPACITY);
+  sink = gavl_audio_ringbuffer_get_sink(rb);
+  src = gavl_audio_ringbuffer_get_source(rb);
+  gavl_audio_source_set_dst(src, 0, &format);
+  own = gavl_audio_frame_create(&format);
+
+  /* 3 frames fit before the end of the buffer */
+  while(write_pos + SAMPLES_PER_FRAME <= CAPACITY)
+    {
+    CHECK(write_frame(sink, own, write_pos, SAMPLES_PER_FRAME, 1),
+          "No zero-copy frame at position %"PRId64, write_pos);
+    write_pos += SAMPLES_PER_FRAME;
+    }
+
+  drain(src, &read_pos);
+  
+  /* 232 samples left before the end */
+  CHECK(!write_frame(sink, own, write_pos, SAMPLES_PER_FRAME, 1),
+        "Got a zero-copy frame, which would wrap around");
+  write_pos += SAMPLES_PER_FRAME;
+
+  /* After the wraparound, zero-copy works again */
+  CHECK(write_frame(sink, own, write_pos, SAMPLES_PER_FRAME, 1),
+        "No zero-copy frame after wrapping around");
+  write_pos += SAMPLES_PER_FRAME;
+
+  gavl_audio_ringbuffer_set_eof(rb);
+  CHECK(drain(src, &read_pos) == GAVL_SOURCE_EOF,
+        "Source didn't return GAVL_SOURCE_EOF");
+  CHECK(read_pos == write_pos,
+        "Read %"PRId64" samples, wrote %"PRId64, read_pos, write_pos);
+
+  gavl_audio_ringbuffer_get_stats(rb, &overruns, NULL);
+  CHECK(!overruns, "Got %"PRId64" overruns", overruns);
+
+  gavl_audio_frame_destroy(own);
+  gavl_audio_ringbuffer_destroy(rb);
+  }
+
+/* Packets */
+
+#define PACKET_CAPACITY 16
+
+static void fill_packet(gavl_packet_t * p, int i)
+  {
+  gavl_packet_reset(p);
+  gavl_packet_alloc(p, 100 + i);
+  memset(p->data, i & 0xff, 100 + i);
+  p->data_len = 100 + i;
+  p->pts = i;
+  }
+
+static int check_packet(const gavl_packet_t * p, int i)
+  {
+  return (p->pts == i) && (p->data_len == 100 + i) &&
+    (p->data[0] == (i & 0xff)) && (p->data[p->data_len-1] == (i & 0xff));
+  }
+
+/* Write one packet. Returns 1 if it was written without copying */
+
+static int write_packet(gavl_packet_sink_t * sink, gavl_packet_t * own,
+                        int i, int zerocopy)
+  {
+  gavl_packet_t * p = NULL;
+  if(zerocopy)
+    p = gavl_packet_sink_get_packet(sink);
+  if(!p)
+    p = own;
+  fill_packet(p, i);
+  gavl_packet_sink_put_packet(sink, p);
+  return (p != own);
+  }
+
+/* Reads alternate between zero-copy and copying into own */
+
+static gavl_source_status_t drain_packets(gavl_packet_source_t * src,
+                                          gavl_packet_t * own, int * pos)
+  {
+  gavl_source_status_t st;
+  gavl_packet_t * p;
+
+  while(1)
+    {
+    p = (*pos & 1) ? own : NULL;
+    
+    if((st = gavl_packet_source_read_packet(src, &p)) != GAVL_SOURCE_OK)
+      return st;
+
+    CHECK(check_packet(p, *pos), "Packet %d is wrong", *pos);
+    (*pos)++;
+    }
+  }
+
+static void test_packets(void)
+  {
+  int i;
+  int write_pos = 0;
+  int read_pos = 0;
+  int zerocopy_packets = 0;
+  int64_t overruns, underruns;
+  gavl_packet_ringbuffer_t * rb;
+  gavl_packet_sink_t * sink;
+  gavl_packet_source_t * src;
+  gavl_packet_t own_w, own_r;
+
+  fprintf(stderr, "Packets\n");
+
+  gavl_packet_init(&own_w);
+  gavl_packet_init(&own_r);
+  
+  rb = gavl_packet_ringbuffer_create(PACKET_CAPACITY);
+  sink = gavl_packet_ringbuffer_get_sink(rb);
+  src = gavl_packet_ringbuffer_get_source(rb);
+
+  /* Wraparound */
+  for(i = 0; i < 10 * PACKET_CAPACITY; i++)
+    {
+    if(gavl_packet_ringbuffer_get_fill(rb) == PACKET_CAPACITY)
+      {
+      CHECK(drain_packets(src, &own_r, &read_pos) == GAVL_SOURCE_AGAIN,
+            "Source didn't return GAVL_SOURCE_AGAIN");
+      }
+    zerocopy_packets += write_packet(sink, &own_w, write_pos++, i & 1);
+    }
+  CHECK(drain_packets(src, &own_r, &read_pos) == GAVL_SOURCE_AGAIN,
+        "Source didn't return GAVL_SOURCE_AGAIN");
+  CHECK(read_pos == write_pos, "Read %d packets, wrote %d", read_pos, write_pos);
+  CHECK(zerocopy_packets == 5 * PACKET_CAPACITY,
+        "Wrote %d zero-copy packets, expected %d",
+        zerocopy_packets, 5 * PACKET_CAPACITY);
+
+  gavl_packet_ringbuffer_get_stats(rb, &overruns, &underruns);
+  CHECK(!overruns, "Got %"PRId64" overruns", overruns);
+  CHECK(underruns == 10, "Got %"PRId64" underruns, expected 10", underruns);
+
+  /* Overruns: The last 4 packets are dropped */
+  for(i = 0; i < PACKET_CAPACITY + 4; i++)
+    write_packet(sink, &own_w, write_pos + i, 0);
+
+  CHECK(!gavl_packet_sink_get_packet(sink), "Got a packet from the full buffer");
+  gavl_packet_ringbuffer_get_stats(rb, &overruns, NULL);
+  CHECK(overruns == 4, "Got %"PRId64" overruns, expected 4", overruns);
+  
+  /* EOF after draining */
+  gavl_packet_ringbuffer_set_eof(rb);
+  CHECK(!gavl_packet_ringbuffer_get_eof(rb), "EOF before draining");
+  CHECK(drain_packets(src, &own_r, &read_pos) == GAVL_SOURCE_EOF,
+        "Source didn't return GAVL_SOURCE_EOF");
+  CHECK(read_pos == write_pos + PACKET_CAPACITY,
+        "Read %d packets, expected %d", read_pos, write_pos + PACKET_CAPACITY);
+  CHECK(gavl_packet_ringbuffer_get_eof(rb), "No EOF after draining");
+
+  gavl_packet_free(&own_w);
+  gavl_packet_free(&own_r);
+  gavl_packet_ringbuffer_destroy(rb);
+  }
+
+/* One producer and one consumer thread */
+
+static void * producer_thread(void * data)
+  {
+  int num;
+  int64_t pos = 0;
+  unsigned int seed = 1;
+  gavl_audio_format_t format;
+  gavl_audio_ringbuffer_t * rb = data;
+  gavl_audio_sink_t * sink = gavl_audio_ringbuffer_get_sink(rb);
+  gavl_audio_frame_t * own;
+
+  init_format(&format);
+  own = gavl_audio_frame_create(&format);
+
+  while(pos < THREAD_SAMPLES)
+    {
+    num = 1 + rand_r(&seed) % SAMPLES_PER_FRAME;
+    if(pos + num > THREAD_SAMPLES)
+      num = THREAD_SAMPLES - pos;
+
+    /* Wait for space, so we don't get overruns */
+    while(gavl_audio_ringbuffer_get_fill(rb) + num > CAPACITY)
+      sched_yield();
+
+    write_frame(sink, own, pos, num, rand_r(&seed) & 1);
+    pos += num;
+    }
+
+  gavl_audio_ringbuffer_set_eof(rb);
+  gavl_audio_frame_destroy(own);
+  return NULL;
+  }
+
+static void test_threads(void)
+  {
+  pthread_t thread;
+  gavl_source_status_t st;
+  int64_t read_pos = 0;
+  int64_t overruns, underruns;
+  gavl_audio_format_t format;
+  gavl_audio_ringbuffer_t * rb;
+  gavl_audio_source_t * src;
+  
+  fprintf(stderr, "Producer and consumer thread\n");
+
+  init_format(&format);
+  rb = gavl_audio_ringbuffer_create(&format, CAPACITY);
+  src = gavl_audio_ringbuffer_get_source(rb);
+  gavl_audio_source_set_dst(src, 0, &format);
+
+  pthread_create(&thread, NULL, producer_thread, rb);
+
+  while((st = drain(src, &read_pos)) == GAVL_SOURCE_AGAIN)
+    sched_yield();
+  
+  pthread_join(thread, NULL);
+
+  CHECK(st == GAVL_SOURCE_EOF, "Source didn't return GAVL_SOURCE_EOF");
+  CHECK(read_pos == THREAD_SAMPLES,
+        "Read %"PRId64" samples, expected %d", read_pos, THREAD_SAMPLES);
+
+  gavl_audio_ringbuffer_get_stats(rb, &overruns, &underruns);
+  CHECK(!overruns, "Got %"PRId64" overruns", overruns);
+  fprintf(stderr, "  %"PRId64" underruns\n", underruns);
+  
+  gavl_audio_ringbuffer_destroy(rb);
+  }
+
+int main(int argc, char ** argv)
+  {
+  test_audio_wraparound();
+  test_audio_overrun_underrun();
+  test_audio_sink_paths();
+  test_packets();
+  test_threads();
+
+  if(errors)
+    {
+    fprintf(stderr, "%d errors\n", errors);
+    return EXIT_FAILURE;
+    }
+  fprintf(stderr, "All tests passed\n");
+  return EXIT_SUCCESS;
+  }
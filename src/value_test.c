@@ -1,7 +1,10 @@
 
 #include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 #include <gavl/gavl.h>
+#include <gavl/gavltime.h>
 #include <gavl/value.h>
 #include <gavl/msg.h>
 
@@ -29,6 +32,76 @@ static void set_msg(gavl_msg_t * msg)
   }
 #endif
 
+/* Measure the lookup cost depending on the number of entries */
+
+#define LOOKUPS  1000000
+#define MAX_KEYS 4096
+
+static void benchmark_dict(void)
+  {
+  int num, i, j, sum;
+  char (*names)[16];
+  char (*names_i)[16];
+  gavl_dictionary_t dict;
+  gavl_timer_t * timer;
+  gavl_time_t t, t_i;
+
+  timer = gavl_timer_create();
+
+  names = malloc(MAX_KEYS * sizeof(*names));
+  names_i = malloc(MAX_KEYS * sizeof(*names_i));
+  
+  for(i = 0; i < MAX_KEYS; i++)
+    {
+    snprintf(names[i], sizeof(names[i]), "Key%d", i);
+    snprintf(names_i[i], sizeof(names_i[i]), "KEY%d", i);
+    }
+  
+  printf("Entries  ns/lookup  ns/lookup (case insensitive)\n");
+  
+  for(num = 4; num <= MAX_KEYS; num *= 2)
+    {
+    gavl_dictionary_init(&dict);
+    for(i = 0; i < num; i++)
+      gavl_dictionary_set_int(&dict, names[i], i);
+    
+    sum = 0;
+    j = 0;
+    gavl_timer_set(timer, 0);
+    gavl_timer_start(timer);
+    for(i = 0; i < LOOKUPS; i++)
+      {
+      if(gavl_dictionary_get(&dict, names[j]))
+        sum++;
+      j = (j + 7919) % num;
+      }
+    gavl_timer_stop(timer);
+    t = gavl_timer_get(timer);
+
+    gavl_timer_set(timer, 0);
+    gavl_timer_start(timer);
+    for(i = 0; i < LOOKUPS; i++)
+      {
+      if(gavl_dictionary_get_i(&dict, names_i[j]))
+        sum++;
+      j = (j + 7919) % num;
+      }
+    gavl_timer_stop(timer);
+    t_i = gavl_timer_get(timer);
+    
+    if(sum != 2 * LOOKUPS)
+      fprintf(stderr, "Lookup failed\n");
+    
+    printf("%7d  %9.1f  %9.1f\n", num,
+           (double)t * 1000.0 / LOOKUPS, (double)t_i * 1000.0 / LOOKUPS);
+    
+    gavl_dictionary_free(&dict);
+    }
+  free(names);
+  free(names_i);
+  gavl_timer_destroy(timer);
+  }
+
 int main(int argc, char ** argv)
   {
   gavl_dictionary_t dict;
@@ -41,5 +114,7 @@ int main(int argc, char ** argv)
   set_dict(sub_dict);
 
   gavl_dictionary_free(&dict);
-  
+
+  benchmark_dict();
+  return 0;
   }